@@ -0,0 +1,541 @@
+#ifndef SORT_HPP
+#define SORT_HPP
+
+#include <algorithm>   // for std::make_heap, std::sort_heap, std::iter_swap
+#include <bit>         // for std::bit_cast
+#include <cstddef>     // for std::size_t, std::ptrdiff_t
+#include <cstdint>     // for std::uint8_t ... std::uint64_t
+#include <functional>  // for std::less, std::invoke
+#include <iterator>    // for std::iterator_traits
+#include <type_traits> // for std::is_integral_v, std::invoke_result_t
+#include <utility>     // for std::pair
+
+#include "../../std2/std2.hpp"          // for std2::move
+#include "../../std2/thread_pool.hpp"   // for std2::thread_pool, std2::parallel_for
+#include "../../vector/include/vector.hpp" // for std2::vector scratch buffers
+
+namespace std2 {
+
+namespace sort_detail {
+
+// below this size partitions are finished with insertion sort
+constexpr std::ptrdiff_t INSERTION_SORT_THRESHOLD = 24;
+// above this size the pivot is the pseudo median of nine instead of three
+constexpr std::ptrdiff_t NINTHER_THRESHOLD = 128;
+// element moves allowed before partial_insertion_sort gives up
+constexpr std::ptrdiff_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+// below this size std2::sort does not bother with radix sort
+constexpr std::size_t RADIX_SORT_THRESHOLD = 512;
+// smallest chunk handed to a worker by the parallel sorts
+constexpr std::size_t PARALLEL_CHUNK_MIN = 1 << 14;
+
+template <typename It>
+using value_t = typename std::iterator_traits<It>::value_type;
+
+template <typename It, typename Compare>
+void insertion_sort(It begin, It end, Compare& comp) {
+    if (begin == end) return;
+    for (It cur = begin + 1; cur != end; ++cur) {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            value_t<It> tmp = std2::move(*sift);
+            do {
+                *sift-- = std2::move(*sift_1);
+            } while (sift != begin && comp(tmp, *--sift_1));
+            *sift = std2::move(tmp);
+        }
+    }
+}
+
+// insertion sort that relies on an element to the left of begin being <= everything in the range
+template <typename It, typename Compare>
+void unguarded_insertion_sort(It begin, It end, Compare& comp) {
+    if (begin == end) return;
+    for (It cur = begin + 1; cur != end; ++cur) {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            value_t<It> tmp = std2::move(*sift);
+            do {
+                *sift-- = std2::move(*sift_1);
+            } while (comp(tmp, *--sift_1));
+            *sift = std2::move(tmp);
+        }
+    }
+}
+
+// insertion sort that bails out once it had to move too many elements
+template <typename It, typename Compare>
+bool partial_insertion_sort(It begin, It end, Compare& comp) {
+    if (begin == end) return true;
+    std::ptrdiff_t moved = 0;
+    for (It cur = begin + 1; cur != end; ++cur) {
+        if (moved > PARTIAL_INSERTION_SORT_LIMIT) return false;
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            value_t<It> tmp = std2::move(*sift);
+            do {
+                *sift-- = std2::move(*sift_1);
+            } while (sift != begin && comp(tmp, *--sift_1));
+            *sift = std2::move(tmp);
+            moved += cur - sift;
+        }
+    }
+    return true;
+}
+
+template <typename It, typename Compare>
+void sort2(It a, It b, Compare& comp) {
+    if (comp(*b, *a)) std::iter_swap(a, b);
+}
+
+template <typename It, typename Compare>
+void sort3(It a, It b, It c, Compare& comp) {
+    sort2(a, b, comp);
+    sort2(b, c, comp);
+    sort2(a, b, comp);
+}
+
+/* @brief  Partition around the pivot in *begin, elements equal to the pivot go right.
+ * @return the pivot position and whether the range was already partitioned.
+ */
+template <typename It, typename Compare>
+std::pair<It, bool> partition_right(It begin, It end, Compare& comp) {
+    value_t<It> pivot = std2::move(*begin);
+    It first = begin;
+    It last = end;
+
+    // median of three guarantees these scans stop without bounds checks
+    while (comp(*++first, pivot));
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot));
+    } else {
+        while (!comp(*--last, pivot));
+    }
+
+    const bool already_partitioned = first >= last;
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(*++first, pivot));
+        while (!comp(*--last, pivot));
+    }
+
+    It pivot_pos = first - 1;
+    *begin = std2::move(*pivot_pos);
+    *pivot_pos = std2::move(pivot);
+    return { pivot_pos, already_partitioned };
+}
+
+/* @brief  Partition around the pivot in *begin, elements equal to the pivot go left.
+ *         Used when the pivot equals its left neighbour, i.e. on runs of duplicates.
+ * @return the pivot position.
+ */
+template <typename It, typename Compare>
+It partition_left(It begin, It end, Compare& comp) {
+    value_t<It> pivot = std2::move(*begin);
+    It first = begin;
+    It last = end;
+
+    while (comp(pivot, *--last));
+    if (last + 1 == end) {
+        while (first < last && !comp(pivot, *++first));
+    } else {
+        while (!comp(pivot, *++first));
+    }
+
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(pivot, *--last));
+        while (!comp(pivot, *++first));
+    }
+
+    It pivot_pos = last;
+    *begin = std2::move(*pivot_pos);
+    *pivot_pos = std2::move(pivot);
+    return pivot_pos;
+}
+
+/* @brief  Pattern-defeating quicksort main loop (after Orson Peters' pdqsort).
+ * @param  bad_allowed  Number of highly unbalanced partitions tolerated before falling back to heapsort.
+ * @param  leftmost  False if there is an element left of begin that is <= everything in the range.
+ */
+template <typename It, typename Compare>
+void pdqsort_loop(It begin, It end, Compare& comp, int bad_allowed, bool leftmost = true) {
+    for (;;) {
+        const std::ptrdiff_t size = end - begin;
+
+        if (size < INSERTION_SORT_THRESHOLD) {
+            if (leftmost) insertion_sort(begin, end, comp);
+            else unguarded_insertion_sort(begin, end, comp);
+            return;
+        }
+
+        // choose the pivot and move it to *begin
+        const std::ptrdiff_t s2 = size / 2;
+        if (size > NINTHER_THRESHOLD) {
+            sort3(begin, begin + s2, end - 1, comp);
+            sort3(begin + 1, begin + (s2 - 1), end - 2, comp);
+            sort3(begin + 2, begin + (s2 + 1), end - 3, comp);
+            sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp);
+            std::iter_swap(begin, begin + s2);
+        } else {
+            sort3(begin + s2, begin, end - 1, comp);
+        }
+
+        // the pivot equals the element left of the range - everything equal
+        // to it can be skipped, which makes duplicate heavy input linear
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = partition_left(begin, end, comp) + 1;
+            continue;
+        }
+
+        auto [pivot_pos, already_partitioned] = partition_right(begin, end, comp);
+
+        const std::ptrdiff_t l_size = pivot_pos - begin;
+        const std::ptrdiff_t r_size = end - (pivot_pos + 1);
+        const bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        if (highly_unbalanced) {
+            if (--bad_allowed == 0) {
+                std::make_heap(begin, end, comp);
+                std::sort_heap(begin, end, comp);
+                return;
+            }
+
+            // break up patterns that keep producing bad pivots
+            if (l_size >= INSERTION_SORT_THRESHOLD) {
+                std::iter_swap(begin, begin + l_size / 4);
+                std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                if (l_size > NINTHER_THRESHOLD) {
+                    std::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+                    std::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+                    std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if (r_size >= INSERTION_SORT_THRESHOLD) {
+                std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                std::iter_swap(end - 1, end - r_size / 4);
+                if (r_size > NINTHER_THRESHOLD) {
+                    std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    std::iter_swap(end - 2, end - (1 + r_size / 4));
+                    std::iter_swap(end - 3, end - (2 + r_size / 4));
+                }
+            }
+        } else if (already_partitioned &&
+                   partial_insertion_sort(begin, pivot_pos, comp) &&
+                   partial_insertion_sort(pivot_pos + 1, end, comp)) {
+            // a well balanced partition that needed no swaps - probably sorted input
+            return;
+        }
+
+        // recurse on the left part, loop on the right part
+        pdqsort_loop(begin, pivot_pos, comp, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+template <typename It, typename Compare>
+void pdqsort(It begin, It end, Compare comp) {
+    if (end - begin < 2) return;
+    int log2 = 0;
+    for (std::ptrdiff_t n = end - begin; n > 1; n >>= 1) ++log2;
+    pdqsort_loop(begin, end, comp, log2);
+}
+
+/* @brief  Merge the sorted runs [first, mid) and [mid, last) using buffer for the left run.
+ */
+template <typename It, typename Compare, typename Buffer>
+void merge_with_buffer(It first, It mid, It last, Compare& comp, Buffer* buffer) {
+    Buffer* buf_end = buffer;
+    for (It it = first; it != mid; ++it) *buf_end++ = std2::move(*it);
+
+    Buffer* left = buffer;
+    It right = mid;
+    It out = first;
+    while (left != buf_end && right != last) {
+        // take from the right only if strictly smaller - keeps the merge stable
+        if (comp(*right, *left)) *out++ = std2::move(*right++);
+        else *out++ = std2::move(*left++);
+    }
+    while (left != buf_end) *out++ = std2::move(*left++);
+}
+
+template <typename It, typename Compare, typename Buffer>
+void merge_sort(It first, It last, Compare& comp, Buffer* buffer) {
+    const std::ptrdiff_t size = last - first;
+    if (size <= INSERTION_SORT_THRESHOLD) {
+        insertion_sort(first, last, comp);
+        return;
+    }
+    It mid = first + size / 2;
+    merge_sort(first, mid, comp, buffer);
+    merge_sort(mid, last, comp, buffer);
+    if (!comp(*mid, *(mid - 1))) return; // already in order
+    merge_with_buffer(first, mid, last, comp, buffer);
+}
+
+// map a key to an unsigned integer with the same ordering, -0.0 and +0.0 compare equal so share a key
+template <typename K>
+auto radix_bits(K key) {
+    if constexpr (std::is_same_v<K, float>) {
+        const std::uint32_t bits = std::bit_cast<std::uint32_t>(key == 0.0f ? 0.0f : key);
+        return (bits >> 31) ? ~bits : (bits | 0x80000000u);
+    } else if constexpr (std::is_same_v<K, double>) {
+        const std::uint64_t bits = std::bit_cast<std::uint64_t>(key == 0.0 ? 0.0 : key);
+        return (bits >> 63) ? ~bits : (bits | 0x8000000000000000ull);
+    } else if constexpr (std::is_same_v<K, bool>) {
+        return static_cast<std::uint8_t>(key);
+    } else {
+        static_assert(std::is_integral_v<K>, "radix_sort keys must be integral or float/double");
+        using U = std::make_unsigned_t<K>;
+        if constexpr (std::is_signed_v<K>) {
+            return static_cast<U>(static_cast<U>(key) ^ (U(1) << (sizeof(K) * 8 - 1)));
+        } else {
+            return static_cast<U>(key);
+        }
+    }
+}
+
+struct identity_key {
+    template <typename T>
+    const T& operator()(const T& value) const { return value; }
+};
+
+// element types radix_bits has a key transform for, with the default ordering
+template <typename T, typename Compare>
+constexpr bool radix_eligible =
+    (std::is_integral_v<T> || std::is_same_v<T, float> || std::is_same_v<T, double>) &&
+    (std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::less<>>);
+
+} // namespace sort_detail
+
+/**
+ *  @brief  LSD radix sort by an integral or floating point key. Stable.
+ *          Needs a default constructible element type for the scratch buffer.
+ *  @param  first  Start of the range.
+ *  @param  last  End of the range.
+ *  @param  key  Key extractor, e.g. [](const Record& r) { return r.id; }.
+ *  @return void.
+ */
+template <typename It, typename KeyFn = sort_detail::identity_key>
+void radix_sort(It first, It last, KeyFn key = KeyFn()) {
+    using T = sort_detail::value_t<It>;
+    using K = std::decay_t<std::invoke_result_t<KeyFn&, const T&>>;
+    using U = decltype(sort_detail::radix_bits(K()));
+    constexpr std::size_t DIGITS = sizeof(U);
+
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < 2) return;
+
+    // one pass to build the histograms of every digit
+    std::size_t counts[DIGITS][256] = {};
+    for (It it = first; it != last; ++it) {
+        const U bits = sort_detail::radix_bits(static_cast<K>(std::invoke(key, *it)));
+        for (std::size_t d = 0; d < DIGITS; ++d) counts[d][(bits >> (d * 8)) & 0xff]++;
+    }
+
+    std2::vector<T> scratch;
+    scratch.resize(n);
+    T* buffer = scratch.data();
+    bool in_buffer = false;
+
+    for (std::size_t d = 0; d < DIGITS; ++d) {
+        // skip digits where every key falls into the same bucket
+        if (counts[d][(sort_detail::radix_bits(static_cast<K>(std::invoke(key, *first))) >> (d * 8)) & 0xff] == n) {
+            continue;
+        }
+
+        std::size_t offsets[256];
+        std::size_t sum = 0;
+        for (std::size_t b = 0; b < 256; ++b) {
+            offsets[b] = sum;
+            sum += counts[d][b];
+        }
+
+        if (!in_buffer) {
+            for (It it = first; it != last; ++it) {
+                const U bits = sort_detail::radix_bits(static_cast<K>(std::invoke(key, *it)));
+                buffer[offsets[(bits >> (d * 8)) & 0xff]++] = std2::move(*it);
+            }
+        } else {
+            for (std::size_t i = 0; i < n; ++i) {
+                const U bits = sort_detail::radix_bits(static_cast<K>(std::invoke(key, buffer[i])));
+                first[offsets[(bits >> (d * 8)) & 0xff]++] = std2::move(buffer[i]);
+            }
+        }
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer) {
+        for (std::size_t i = 0; i < n; ++i) first[i] = std2::move(buffer[i]);
+    }
+}
+
+/**
+ *  @brief  Sort a range. Integral, float and double elements with the default ordering use
+ *          radix sort, everything else pattern-defeating quicksort. Not stable.
+ *  @param  first  Start of the range.
+ *  @param  last  End of the range.
+ *  @param  comp  Strict weak ordering.
+ *  @return void.
+ */
+template <typename It, typename Compare = std::less<>>
+void sort(It first, It last, Compare comp = Compare()) {
+    using T = sort_detail::value_t<It>;
+    if constexpr (sort_detail::radix_eligible<T, Compare>) {
+        if (static_cast<std::size_t>(last - first) >= sort_detail::RADIX_SORT_THRESHOLD) {
+            radix_sort(first, last);
+            return;
+        }
+    }
+    sort_detail::pdqsort(first, last, comp);
+}
+
+/**
+ *  @brief  Stable sort of a range - merge sort with a half sized buffer,
+ *          or radix sort for integral, float and double elements with the default ordering.
+ *          Needs a default constructible element type for the scratch buffer.
+ *  @param  first  Start of the range.
+ *  @param  last  End of the range.
+ *  @param  comp  Strict weak ordering.
+ *  @return void.
+ */
+template <typename It, typename Compare = std::less<>>
+void stable_sort(It first, It last, Compare comp = Compare()) {
+    using T = sort_detail::value_t<It>;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < 2) return;
+
+    if constexpr (sort_detail::radix_eligible<T, Compare>) {
+        if (n >= sort_detail::RADIX_SORT_THRESHOLD) {
+            radix_sort(first, last);
+            return;
+        }
+    }
+
+    std2::vector<T> scratch;
+    scratch.resize(n / 2 + 1);
+    sort_detail::merge_sort(first, last, comp, scratch.data());
+}
+
+/**
+ *  @brief  Sort a contiguous container such as std2::vector.
+ *  @param  container  Anything with data() and size().
+ *  @param  comp  Strict weak ordering.
+ *  @return void.
+ */
+template <typename Container, typename Compare = std::less<>>
+    requires requires(Container& c) { c.data(); c.size(); }
+void sort(Container& container, Compare comp = Compare()) {
+    std2::sort(container.data(), container.data() + container.size(), comp);
+}
+
+template <typename Container, typename Compare = std::less<>>
+    requires requires(Container& c) { c.data(); c.size(); }
+void stable_sort(Container& container, Compare comp = Compare()) {
+    std2::stable_sort(container.data(), container.data() + container.size(), comp);
+}
+
+/**
+ *  @brief  Radix sort a contiguous container by key.
+ *  @param  container  Anything with data() and size().
+ *  @param  key  Key extractor returning an integral or floating point key.
+ *  @return void.
+ */
+template <typename Container, typename KeyFn>
+    requires requires(Container& c) { c.data(); c.size(); }
+void sort_by_key(Container& container, KeyFn key) {
+    std2::radix_sort(container.data(), container.data() + container.size(), key);
+}
+
+namespace sort_detail {
+
+/* @brief  Sort chunks in parallel with chunk_sort, then merge neighbouring
+ *         runs pairwise in parallel rounds, ping-ponging with a scratch buffer.
+ */
+template <typename T, typename Compare, typename ChunkSort>
+void parallel_merge_sort(thread_pool& pool, T* data, std::size_t n, Compare comp, ChunkSort chunk_sort) {
+    std::size_t chunks = pool.size() * 2;
+    if (n / chunks < PARALLEL_CHUNK_MIN) chunks = n / PARALLEL_CHUNK_MIN;
+    if (chunks < 2) {
+        chunk_sort(data, data + n);
+        return;
+    }
+
+    std2::vector<std::size_t> bounds;
+    for (std::size_t c = 0; c <= chunks; ++c) bounds.push_back(n * c / chunks);
+
+    std2::parallel_for(pool, 0, chunks, 1, [&](std::size_t c) {
+        chunk_sort(data + bounds[c], data + bounds[c + 1]);
+    });
+
+    std2::vector<T> scratch;
+    scratch.resize(n);
+    T* from = data;
+    T* to = scratch.data();
+
+    for (std::size_t width = 1; width < chunks; width *= 2) {
+        const std::size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+        std2::parallel_for(pool, 0, pairs, 1, [&](std::size_t p) {
+            const std::size_t lo = bounds[p * 2 * width];
+            const std::size_t mid = bounds[std::min(p * 2 * width + width, chunks)];
+            const std::size_t hi = bounds[std::min(p * 2 * width + 2 * width, chunks)];
+
+            // stable two way merge into the other buffer
+            std::size_t i = lo, j = mid, out = lo;
+            while (i < mid && j < hi) {
+                if (comp(from[j], from[i])) to[out++] = std2::move(from[j++]);
+                else to[out++] = std2::move(from[i++]);
+            }
+            while (i < mid) to[out++] = std2::move(from[i++]);
+            while (j < hi) to[out++] = std2::move(from[j++]);
+        });
+        std::swap(from, to);
+    }
+
+    if (from != data) {
+        std2::parallel_for(pool, 0, n, PARALLEL_CHUNK_MIN, [&](std::size_t i) {
+            data[i] = std2::move(from[i]);
+        });
+    }
+}
+
+} // namespace sort_detail
+
+/**
+ *  @brief  Multi-threaded sort: chunks are sorted on the pool workers
+ *          (with std2::sort, so radix sort where eligible) and merged in parallel rounds.
+ *  @param  pool  The pool to run on.
+ *  @param  container  Anything with data() and size().
+ *  @param  comp  Strict weak ordering.
+ *  @return void.
+ */
+template <typename Container, typename Compare = std::less<>>
+    requires requires(Container& c) { c.data(); c.size(); }
+void parallel_sort(thread_pool& pool, Container& container, Compare comp = Compare()) {
+    sort_detail::parallel_merge_sort(pool, container.data(), container.size(), comp,
+        [&](auto* first, auto* last) { std2::sort(first, last, comp); });
+}
+
+/**
+ *  @brief  Multi-threaded stable sort, see parallel_sort.
+ *  @param  pool  The pool to run on.
+ *  @param  container  Anything with data() and size().
+ *  @param  comp  Strict weak ordering.
+ *  @return void.
+ */
+template <typename Container, typename Compare = std::less<>>
+    requires requires(Container& c) { c.data(); c.size(); }
+void parallel_stable_sort(thread_pool& pool, Container& container, Compare comp = Compare()) {
+    sort_detail::parallel_merge_sort(pool, container.data(), container.size(), comp,
+        [&](auto* first, auto* last) { std2::stable_sort(first, last, comp); });
+}
+
+} // namespace std2
+
+#endif // SORT_HPP
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/sort.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Record {
+    std::uint64_t key;
+    std::uint32_t payload;
+};
+
+class SortTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    // the input shapes used by both the tests and the benchmark
+    static std::vector<int> make_input(const std::string& shape, std::size_t n) {
+        std::mt19937 rng(12345);
+        std::vector<int> vals(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (shape == "random") vals[i] = static_cast<int>(rng());
+            else if (shape == "sorted") vals[i] = static_cast<int>(i);
+            else if (shape == "reversed") vals[i] = static_cast<int>(n - i);
+            else vals[i] = static_cast<int>(rng() % 16); // duplicates
+        }
+        return vals;
+    }
+
+    static std2::vector<int> to_std2(const std::vector<int>& in) {
+        std2::vector<int> out;
+        out.reserve(in.size());
+        for (int v : in) out.push_back(v);
+        return out;
+    }
+
+    static bool is_sorted(const std2::vector<int>& vals) {
+        for (std::size_t i = 1; i < vals.size(); ++i) {
+            if (vals[i] < vals[i - 1]) return false;
+        }
+        return true;
+    }
+};
+
+// Test pdqsort with a custom comparator on every input shape and many sizes
+TEST_F(SortTest, PdqsortWithComparator) {
+    for (const char* shape : {"random", "sorted", "reversed", "duplicates"}) {
+        for (std::size_t n : {0, 1, 2, 23, 24, 25, 127, 129, 1000, 100000}) {
+            std::vector<int> expected = make_input(shape, n);
+            std2::vector<int> vals = to_std2(expected);
+
+            std2::sort(vals, [](int a, int b) { return a > b; });
+            std::sort(expected.begin(), expected.end(), [](int a, int b) { return a > b; });
+
+            for (std::size_t i = 0; i < n; ++i) ASSERT_EQ(vals[i], expected[i]) << shape << " n=" << n;
+        }
+    }
+}
+
+// Test that the default ordering (radix path) sorts signed ints and floats correctly
+TEST_F(SortTest, RadixForArithmeticKeys) {
+    std2::vector<int> ints = to_std2(make_input("random", 50000));
+    std2::sort(ints);
+    EXPECT_TRUE(is_sorted(ints));
+
+    std2::vector<double> doubles;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+    for (int i = 0; i < 10000; ++i) doubles.push_back(dist(rng));
+    doubles.push_back(-0.0);
+    doubles.push_back(0.0);
+    std2::sort(doubles);
+    for (std::size_t i = 1; i < doubles.size(); ++i) ASSERT_LE(doubles[i - 1], doubles[i]);
+
+    // the zeros compare equal, so a stable sort keeps their input order
+    std2::vector<float> zeros;
+    for (int i = 0; i < 1000; ++i) zeros.push_back(i % 2 ? 0.0f : -0.0f);
+    std2::stable_sort(zeros);
+    for (std::size_t i = 0; i < zeros.size(); ++i) ASSERT_EQ(std::signbit(zeros[i]), i % 2 == 0) << i;
+
+    // no radix key transform for long double, it takes the comparison sorts
+    std2::vector<long double> wide;
+    for (int i = 0; i < 1000; ++i) wide.push_back(static_cast<long double>(dist(rng)));
+    std2::sort(wide);
+    for (std::size_t i = 1; i < wide.size(); ++i) ASSERT_LE(wide[i - 1], wide[i]);
+    std2::stable_sort(wide);
+    for (std::size_t i = 1; i < wide.size(); ++i) ASSERT_LE(wide[i - 1], wide[i]);
+}
+
+// Test stable sort keeps the order of equal elements
+TEST_F(SortTest, StableSortIsStable) {
+    std2::vector<Record> records;
+    std::mt19937 rng(99);
+    for (std::uint32_t i = 0; i < 20000; ++i) records.push_back(Record{rng() % 100, i});
+
+    std2::stable_sort(records, [](const Record& a, const Record& b) { return a.key < b.key; });
+    for (std::size_t i = 1; i < records.size(); ++i) {
+        ASSERT_LE(records[i - 1].key, records[i].key);
+        if (records[i - 1].key == records[i].key) {
+            ASSERT_LT(records[i - 1].payload, records[i].payload);
+        }
+    }
+}
+
+// Test radix sort with a key extractor is stable too
+TEST_F(SortTest, SortByKey) {
+    std2::vector<Record> records;
+    std::mt19937 rng(5);
+    for (std::uint32_t i = 0; i < 20000; ++i) records.push_back(Record{rng() % 1000, i});
+
+    std2::sort_by_key(records, [](const Record& r) { return r.key; });
+    for (std::size_t i = 1; i < records.size(); ++i) {
+        ASSERT_LE(records[i - 1].key, records[i].key);
+        if (records[i - 1].key == records[i].key) {
+            ASSERT_LT(records[i - 1].payload, records[i].payload);
+        }
+    }
+}
+
+// Test non trivial elements go through the comparison sorts
+TEST_F(SortTest, NonTrivialElements) {
+    std::vector<std::string> words;
+    std::mt19937 rng(3);
+    for (int i = 0; i < 2000; ++i) words.push_back(std::to_string(rng() % 500));
+    std::vector<std::string> expected = words;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::string> unstable = words;
+    std2::sort(unstable.begin(), unstable.end());
+    EXPECT_EQ(unstable, expected);
+
+    std2::stable_sort(words.begin(), words.end());
+    EXPECT_EQ(words, expected);
+}
+
+// Test the multi-threaded variants
+TEST_F(SortTest, ParallelSort) {
+    std2::thread_pool pool(4);
+    for (const char* shape : {"random", "sorted", "reversed", "duplicates"}) {
+        std2::vector<int> vals = to_std2(make_input(shape, 300000));
+        std2::parallel_sort(pool, vals);
+        EXPECT_TRUE(is_sorted(vals)) << shape;
+    }
+
+    std2::vector<Record> records;
+    std::mt19937 rng(11);
+    for (std::uint32_t i = 0; i < 200000; ++i) records.push_back(Record{rng() % 50, i});
+    std2::parallel_stable_sort(pool, records, [](const Record& a, const Record& b) { return a.key < b.key; });
+    for (std::size_t i = 1; i < records.size(); ++i) {
+        ASSERT_LE(records[i - 1].key, records[i].key);
+        if (records[i - 1].key == records[i].key) {
+            ASSERT_LT(records[i - 1].payload, records[i].payload);
+        }
+    }
+}
+
+// Benchmarks against std::sort and std::stable_sort on several input shapes
+TEST_F(SortTest, PerformanceBenchmark) {
+    const std::size_t n = 2000000;
+    std2::thread_pool pool;
+
+    auto time = [](auto&& fn) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+
+    for (const char* shape : {"random", "sorted", "reversed", "duplicates"}) {
+        const std::vector<int> input = make_input(shape, n);
+
+        std::vector<int> a = input;
+        std::vector<int> b = input;
+        std2::vector<int> c = to_std2(input);
+        std2::vector<int> d = to_std2(input);
+        std2::vector<int> e = to_std2(input);
+        std2::vector<int> f = to_std2(input);
+
+        std::cout << shape << ":\n";
+        std::cout << "  std::sort:          " << time([&] { std::sort(a.begin(), a.end()); }) << " microseconds\n";
+        std::cout << "  std::stable_sort:   " << time([&] { std::stable_sort(b.begin(), b.end()); }) << " microseconds\n";
+        std::cout << "  std2::sort (radix): " << time([&] { std2::sort(c); }) << " microseconds\n";
+        std::cout << "  std2::sort (pdq):   "
+                  << time([&] { std2::sort(d, [](int x, int y) { return x < y; }); }) << " microseconds\n";
+        std::cout << "  std2::stable_sort (merge): "
+                  << time([&] { std2::stable_sort(e, [](int x, int y) { return x < y; }); }) << " microseconds\n";
+        std::cout << "  std2::parallel_sort (" << pool.size() << " threads): "
+                  << time([&] { std2::parallel_sort(pool, f); }) << " microseconds\n";
+
+        EXPECT_TRUE(is_sorted(c));
+        EXPECT_TRUE(is_sorted(d));
+        EXPECT_TRUE(is_sorted(e));
+        EXPECT_TRUE(is_sorted(f));
+    }
+}
@@ -0,0 +1,955 @@
+#ifndef BTREE_MAP_HPP
+#define BTREE_MAP_HPP
+
+#include <cstddef>     // for std::size_t, std::ptrdiff_t
+#include <cstdint>     // for std::uint16_t
+#include <cstring>     // for std::memmove
+#include <functional>  // for std::less
+#include <iterator>    // for std::bidirectional_iterator_tag, std::forward_iterator
+#include <memory>      // for std::allocator, std::allocator_traits
+#include <new>         // for placement new
+#include <stdexcept>   // for std::out_of_range
+#include <type_traits> // for std::conditional_t, std::is_void_v
+#include <utility>     // for std::pair, std::swap
+#include "../../flat_map/include/flat_map.hpp" // for std2::sorted_unique, flat_detail::lower_bound_index
+#include "../../std2/ranges.hpp" // for std2::ranges::subrange
+#include "../../vector/include/vector.hpp"
+#include "../../std2/std2.hpp" // for std2::move, std2::forward, std2::is_trivially_relocatable_v
+
+namespace std2 {
+
+namespace btree_detail {
+
+// every node is sized to this many bytes, eight cache lines
+inline constexpr std::size_t NODE_BYTES = 512;
+// deepest path a descent records; with at least four children per node that is 4^32 elements
+inline constexpr std::size_t MAX_DEPTH = 32;
+
+constexpr std::size_t clamp_slots(std::size_t slots) {
+    return slots < 4 ? 4 : (slots > 255 ? 255 : slots);
+}
+
+template <typename T>
+constexpr std::size_t size_of() {
+    if constexpr (std::is_void_v<T>) return 0;
+    else return sizeof(T);
+}
+
+/*
+ * Uninitialized room for N objects. Elements are constructed and destroyed
+ * one by one as the node's count changes; sets use the void specialization
+ * and store no values at all.
+ */
+template <typename T, std::size_t N>
+struct slots {
+    alignas(T) unsigned char bytes[N * sizeof(T)];
+
+    T* data() noexcept { return reinterpret_cast<T*>(bytes); }
+    const T* data() const noexcept { return reinterpret_cast<const T*>(bytes); }
+    T& operator[](std::size_t i) noexcept { return data()[i]; }
+    const T& operator[](std::size_t i) const noexcept { return data()[i]; }
+};
+
+template <std::size_t N>
+struct slots<void, N> {};
+
+struct node_base {
+    explicit node_base(bool is_leaf) : leaf(is_leaf) {}
+
+    std::uint16_t count = 0;
+    bool leaf;
+};
+
+/*
+ * Leaves hold the elements, keys and values in separate arrays so a search
+ * only touches keys. Leaves are chained in key order for iteration.
+ */
+template <typename Key, typename Mapped, std::size_t N>
+struct leaf_node : node_base {
+    leaf_node() : node_base(true) {}
+
+    leaf_node* prev = nullptr;
+    leaf_node* next = nullptr;
+    slots<Key, N> keys;
+    [[no_unique_address]] slots<Mapped, N> values;
+};
+
+// separator keys[i] is greater than every key under children[i] and not greater than any under children[i + 1]
+template <typename Key, std::size_t N>
+struct internal_node : node_base {
+    internal_node() : node_base(false) {}
+
+    slots<Key, N> keys;
+    node_base* children[N + 1];
+};
+
+/* @brief  Move n objects from src to dst, ending the lifetime of the sources.
+ * The ranges may overlap; the copy direction follows from their order.
+ * @return void.
+ */
+template <typename T>
+void relocate(T* dst, T* src, std::size_t n) noexcept {
+    if (n == 0 || dst == src) return;
+    if constexpr (std2::is_trivially_relocatable_v<T>) {
+        std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+    } else if (dst < src) {
+        for (std::size_t i = 0; i < n; ++i) {
+            new (dst + i) T(std2::move(src[i]));
+            src[i].~T();
+        }
+    } else {
+        for (std::size_t i = n; i-- > 0;) {
+            new (dst + i) T(std2::move(src[i]));
+            src[i].~T();
+        }
+    }
+}
+
+// the element being inserted, built before the tree is touched so a throwing constructor changes nothing
+template <typename Key, typename Mapped>
+struct staged {
+    template <typename... Args>
+    explicit staged(const Key& k, Args&&... args) : key(k), value(std2::forward<Args>(args)...) {}
+
+    Key key;
+    Mapped value;
+};
+
+template <typename Key>
+struct staged<Key, void> {
+    explicit staged(const Key& k) : key(k) {}
+
+    Key key;
+};
+
+/*
+ * B+ tree shared by btree_map (Mapped = T) and btree_set (Mapped = void).
+ *
+ * Nodes are NODE_BYTES wide, so a node holds tens of keys and a lookup in a
+ * hundred million keys is five or six node visits. Within a node, arithmetic
+ * keys under std::less are counted with a linear branch free scan the
+ * compiler can vectorize, other keys use a branch free binary search.
+ *
+ * Erase rebalances by borrowing from or merging with a sibling. A split of
+ * the last leaf caused by appending past the largest key keeps the old leaf
+ * full, so ascending inserts pack leaves like bulk loading does.
+ * Any insert or erase invalidates iterators.
+ */
+template <typename Key, typename Mapped, typename Compare, typename Allocator>
+class tree {
+public:
+    static constexpr std::size_t LEAF_SLOTS =
+        clamp_slots((NODE_BYTES - 2 * sizeof(void*) - sizeof(node_base)) / (sizeof(Key) + size_of<Mapped>()));
+    static constexpr std::size_t INTERNAL_SLOTS =
+        clamp_slots((NODE_BYTES - sizeof(void*) - sizeof(node_base)) / (sizeof(Key) + sizeof(void*)));
+    static constexpr std::size_t LEAF_MIN = LEAF_SLOTS / 2;
+    static constexpr std::size_t INTERNAL_MIN = (INTERNAL_SLOTS - 1) / 2;
+
+    using leaf = leaf_node<Key, Mapped, LEAF_SLOTS>;
+    using internal = internal_node<Key, INTERNAL_SLOTS>;
+    using element = staged<Key, Mapped>;
+
+    // a position in a leaf; the end position is one past the last element of the last leaf
+    struct cursor {
+        leaf* node = nullptr;
+        std::size_t index = 0;
+
+        const Key& key() const { return node->keys[index]; }
+        auto& value() const requires (!std::is_void_v<Mapped>) { return node->values[index]; }
+
+        void next() {
+            if (++index == node->count && node->next) {
+                node = node->next;
+                index = 0;
+            }
+        }
+
+        void prev() {
+            if (index == 0) {
+                node = node->prev;
+                index = node->count;
+            }
+            --index;
+        }
+
+        bool operator==(const cursor& other) const { return node == other.node && index == other.index; }
+    };
+
+    tree() = default;
+
+    tree(const Compare& comp, const Allocator& alloc) : m_comp(comp), m_alloc(alloc) {}
+
+    tree(const tree& other) : m_comp(other.m_comp), m_alloc(other.m_alloc) {
+        cursor from = other.begin();
+        build(other.size(), [&from](leaf* l, std::size_t i) {
+            new (&l->keys[i]) Key(from.key());
+            if constexpr (!std::is_void_v<Mapped>) new (&l->values[i]) Mapped(from.value());
+            from.next();
+        });
+    }
+
+    tree(tree&& other) noexcept
+        : m_root(std2::exchange(other.m_root, nullptr)),
+        m_first(std2::exchange(other.m_first, nullptr)),
+        m_last(std2::exchange(other.m_last, nullptr)),
+        m_size(std2::exchange(other.m_size, std::size_t(0))),
+        m_comp(other.m_comp),
+        m_alloc(std2::move(other.m_alloc))
+    {}
+
+    tree& operator=(tree other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~tree() {
+        clear();
+    }
+
+    void swap(tree& other) noexcept {
+        std::swap(m_root, other.m_root);
+        std::swap(m_first, other.m_first);
+        std::swap(m_last, other.m_last);
+        std::swap(m_size, other.m_size);
+        std::swap(m_comp, other.m_comp);
+        std::swap(m_alloc, other.m_alloc);
+    }
+
+    std::size_t size() const noexcept { return m_size; }
+    const Compare& comp() const noexcept { return m_comp; }
+    const Allocator& allocator() const noexcept { return m_alloc; }
+
+    cursor begin() const noexcept { return cursor{m_first, 0}; }
+    cursor end() const noexcept { return cursor{m_last, m_last ? m_last->count : std::size_t(0)}; }
+
+    cursor lower_bound(const Key& key) const {
+        if (!m_root) return end();
+        leaf* l = descend(key, nullptr, nullptr);
+        return normalize(l, lower_index(l->keys.data(), l->count, key));
+    }
+
+    cursor upper_bound(const Key& key) const {
+        if (!m_root) return end();
+        leaf* l = descend(key, nullptr, nullptr);
+        return normalize(l, upper_index(l->keys.data(), l->count, key));
+    }
+
+    cursor find(const Key& key) const {
+        if (!m_root) return end();
+        leaf* l = descend(key, nullptr, nullptr);
+        const std::size_t pos = lower_index(l->keys.data(), l->count, key);
+        return pos < l->count && !m_comp(key, l->keys[pos]) ? cursor{l, pos} : end();
+    }
+
+    /**
+     *  @brief  Insert an element for key unless the key is already present.
+     *  @param  key  The key.
+     *  @param  args  Arguments to construct the mapped value from.
+     *  @return the element's position and whether it was inserted.
+     */
+    template <typename... Args>
+    std::pair<cursor, bool> try_emplace(const Key& key, Args&&... args) {
+        if (!m_root) {
+            leaf* l = new_leaf();
+            m_root = m_first = m_last = l;
+        }
+        path_entry path[MAX_DEPTH];
+        std::size_t depth = 0;
+        leaf* l = descend(key, path, &depth);
+        const std::size_t pos = lower_index(l->keys.data(), l->count, key);
+        if (pos < l->count && !m_comp(key, l->keys[pos])) return { cursor{l, pos}, false };
+        return { insert_at(l, pos, path, depth, element(key, std2::forward<Args>(args)...)), true };
+    }
+
+    /**
+     *  @brief  Erase the element with key.
+     *  @param  key  The key.
+     *  @return the number of elements erased (0 or 1).
+     */
+    std::size_t erase(const Key& key) {
+        if (!m_root) return 0;
+        path_entry path[MAX_DEPTH];
+        std::size_t depth = 0;
+        leaf* l = descend(key, path, &depth);
+        const std::size_t pos = lower_index(l->keys.data(), l->count, key);
+        if (pos == l->count || m_comp(key, l->keys[pos])) return 0;
+
+        destroy_element(l, pos);
+        relocate_elements(l, pos, l, pos + 1, l->count - pos - 1);
+        --l->count;
+        --m_size;
+
+        if (depth == 0) {
+            if (l->count == 0) {
+                free_leaf(l);
+                m_root = m_first = m_last = nullptr;
+            }
+        } else if (l->count < LEAF_MIN) {
+            rebalance_leaf(l, path, depth);
+        }
+        return 1;
+    }
+
+    /**
+     *  @brief  Build the tree from n elements already in key order, without duplicates.
+     *  Leaves are packed evenly, then each internal level is built over the
+     *  one below, so the result is as full as the node size allows.
+     *  @param  n  The number of elements.
+     *  @param  fill  Called as fill(leaf, index) to construct the next element in place.
+     *  @return void.
+     */
+    template <typename Fill>
+    void build(std::size_t n, Fill fill) {
+        if (n == 0) return;
+        clear();
+
+        std2::vector<node_base*> level;
+        std2::vector<const Key*> smallest; // the least key under each node of level
+        std2::vector<internal*> built;
+        try {
+            const std::size_t leaves = (n + LEAF_SLOTS - 1) / LEAF_SLOTS;
+            level.reserve(leaves);
+            smallest.reserve(leaves);
+            for (std::size_t i = 0; i < leaves; ++i) {
+                leaf* l = new_leaf();
+                l->prev = m_last;
+                if (m_last) m_last->next = l;
+                else m_first = l;
+                m_last = l;
+
+                const std::size_t take = n / leaves + (i < n % leaves ? 1 : 0);
+                for (std::size_t j = 0; j < take; ++j) {
+                    fill(l, j);
+                    ++l->count;
+                }
+                m_size += take;
+                level.push_back(l);
+                smallest.push_back(&l->keys[0]);
+            }
+
+            while (level.size() > 1) {
+                const std::size_t m = level.size();
+                const std::size_t groups = (m + INTERNAL_SLOTS) / (INTERNAL_SLOTS + 1);
+                std2::vector<node_base*> parents;
+                std2::vector<const Key*> parent_smallest;
+                parents.reserve(groups);
+                parent_smallest.reserve(groups);
+
+                std::size_t c = 0;
+                for (std::size_t g = 0; g < groups; ++g) {
+                    const std::size_t take = m / groups + (g < m % groups ? 1 : 0);
+                    internal* in = new_internal();
+                    built.push_back(in);
+                    in->children[0] = level[c];
+                    for (std::size_t j = 1; j < take; ++j) {
+                        new (&in->keys[j - 1]) Key(*smallest[c + j]);
+                        ++in->count;
+                        in->children[j] = level[c + j];
+                    }
+                    parents.push_back(in);
+                    parent_smallest.push_back(smallest[c]);
+                    c += take;
+                }
+                level = std2::move(parents);
+                smallest = std2::move(parent_smallest);
+            }
+            m_root = level[0];
+        } catch (...) {
+            // nothing is reachable from the root yet, so free what was built by walking the lists
+            for (internal* in : built) free_internal(in);
+            while (m_first) {
+                leaf* next = m_first->next;
+                free_leaf(m_first);
+                m_first = next;
+            }
+            m_last = nullptr;
+            m_size = 0;
+            throw;
+        }
+    }
+
+    void clear() noexcept {
+        if (m_root) free_subtree(m_root);
+        m_root = m_first = m_last = nullptr;
+        m_size = 0;
+    }
+
+private:
+    using leaf_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<leaf>;
+    using internal_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<internal>;
+
+    // arithmetic keys under the default ordering are cheaper to count than to bisect
+    static constexpr bool LINEAR_SEARCH = std::is_arithmetic_v<Key> &&
+        (std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>);
+
+    struct path_entry {
+        internal* node;
+        std::size_t child;
+    };
+
+    /* @brief  Index of the first key not less than key.
+     * @return a value in [0, n].
+     */
+    std::size_t lower_index(const Key* keys, std::size_t n, const Key& key) const {
+        if constexpr (LINEAR_SEARCH) {
+            std::size_t below = 0;
+            for (std::size_t i = 0; i < n; ++i) below += keys[i] < key;
+            return below;
+        } else {
+            return flat_detail::lower_bound_index(keys, n, key, m_comp);
+        }
+    }
+
+    /* @brief  Index of the first key greater than key.
+     * @return a value in [0, n].
+     */
+    std::size_t upper_index(const Key* keys, std::size_t n, const Key& key) const {
+        if constexpr (LINEAR_SEARCH) {
+            std::size_t not_above = 0;
+            for (std::size_t i = 0; i < n; ++i) not_above += !(key < keys[i]);
+            return not_above;
+        } else {
+            return flat_detail::lower_bound_index(keys, n, key,
+                [this](const Key& a, const Key& b) { return !m_comp(b, a); });
+        }
+    }
+
+    // walk to the leaf that holds key or would hold it, recording the way down when asked
+    leaf* descend(const Key& key, path_entry* path, std::size_t* depth) const {
+        node_base* n = m_root;
+        while (!n->leaf) {
+            internal* in = static_cast<internal*>(n);
+            const std::size_t child = upper_index(in->keys.data(), in->count, key);
+            if (path) path[(*depth)++] = path_entry{in, child};
+            n = in->children[child];
+        }
+        return static_cast<leaf*>(n);
+    }
+
+    cursor normalize(leaf* l, std::size_t pos) const {
+        if (pos == l->count && l->next) return cursor{l->next, 0};
+        return cursor{l, pos};
+    }
+
+    leaf* new_leaf() {
+        leaf_allocator alloc(m_alloc);
+        leaf* l = alloc.allocate(1);
+        return new (l) leaf();
+    }
+
+    internal* new_internal() {
+        internal_allocator alloc(m_alloc);
+        internal* in = alloc.allocate(1);
+        return new (in) internal();
+    }
+
+    void free_leaf(leaf* l) noexcept {
+        for (std::size_t i = 0; i < l->count; ++i) destroy_element(l, i);
+        l->~leaf();
+        leaf_allocator alloc(m_alloc);
+        alloc.deallocate(l, 1);
+    }
+
+    void free_internal(internal* in) noexcept {
+        for (std::size_t i = 0; i < in->count; ++i) in->keys[i].~Key();
+        in->~internal();
+        internal_allocator alloc(m_alloc);
+        alloc.deallocate(in, 1);
+    }
+
+    void free_subtree(node_base* n) noexcept {
+        if (n->leaf) {
+            free_leaf(static_cast<leaf*>(n));
+            return;
+        }
+        internal* in = static_cast<internal*>(n);
+        for (std::size_t i = 0; i <= in->count; ++i) free_subtree(in->children[i]);
+        free_internal(in);
+    }
+
+    void destroy_element(leaf* l, std::size_t i) noexcept {
+        l->keys[i].~Key();
+        if constexpr (!std::is_void_v<Mapped>) l->values[i].~Mapped();
+    }
+
+    void relocate_elements(leaf* dst, std::size_t at, leaf* src, std::size_t from, std::size_t n) noexcept {
+        relocate(dst->keys.data() + at, src->keys.data() + from, n);
+        if constexpr (!std::is_void_v<Mapped>) relocate(dst->values.data() + at, src->values.data() + from, n);
+    }
+
+    void place(leaf* l, std::size_t i, element& e) noexcept {
+        new (&l->keys[i]) Key(std2::move(e.key));
+        if constexpr (!std::is_void_v<Mapped>) new (&l->values[i]) Mapped(std2::move(e.value));
+    }
+
+    cursor insert_at(leaf* l, std::size_t pos, path_entry* path, std::size_t depth, element&& e) {
+        if (l->count < LEAF_SLOTS) {
+            relocate_elements(l, pos + 1, l, pos, l->count - pos);
+            place(l, pos, e);
+            ++l->count;
+            ++m_size;
+            return cursor{l, pos};
+        }
+
+        // allocate every node the split can need before anything is moved
+        std::size_t full = 0;
+        while (full < depth && path[depth - 1 - full].node->count == INTERNAL_SLOTS) ++full;
+        const std::size_t internals_needed = full + (full == depth ? 1 : 0);
+        internal* spare[MAX_DEPTH + 1];
+        std::size_t spares = 0;
+        leaf* r = new_leaf();
+        try {
+            while (spares < internals_needed) spare[spares++] = new_internal();
+        } catch (...) {
+            while (spares) free_internal(spare[--spares]);
+            free_leaf(r);
+            throw;
+        }
+
+        // appending past the last key leaves the old leaf full
+        const bool append = pos == LEAF_SLOTS && !l->next;
+        const std::size_t left_count = append ? LEAF_SLOTS : (LEAF_SLOTS + 1) / 2;
+        Key separator(pos < left_count ? l->keys[left_count - 1] : (pos == left_count ? e.key : l->keys[left_count]));
+
+        cursor at;
+        if (pos < left_count) {
+            const std::size_t moved = LEAF_SLOTS - (left_count - 1);
+            relocate_elements(r, 0, l, left_count - 1, moved);
+            l->count = static_cast<std::uint16_t>(left_count - 1);
+            r->count = static_cast<std::uint16_t>(moved);
+            relocate_elements(l, pos + 1, l, pos, l->count - pos);
+            place(l, pos, e);
+            ++l->count;
+            at = cursor{l, pos};
+        } else {
+            const std::size_t moved = LEAF_SLOTS - left_count;
+            relocate_elements(r, 0, l, left_count, moved);
+            l->count = static_cast<std::uint16_t>(left_count);
+            r->count = static_cast<std::uint16_t>(moved);
+            const std::size_t rpos = pos - left_count;
+            relocate_elements(r, rpos + 1, r, rpos, r->count - rpos);
+            place(r, rpos, e);
+            ++r->count;
+            at = cursor{r, rpos};
+        }
+        ++m_size;
+
+        r->prev = l;
+        r->next = l->next;
+        if (l->next) l->next->prev = r;
+        l->next = r;
+        if (m_last == l) m_last = r;
+
+        insert_into_parent(path, depth, std2::move(separator), r, spare, spares);
+        return at;
+    }
+
+    void insert_separator(internal* in, std::size_t i, Key&& separator, node_base* child) noexcept {
+        relocate(in->keys.data() + i + 1, in->keys.data() + i, in->count - i);
+        std::memmove(in->children + i + 2, in->children + i + 1, (in->count - i) * sizeof(node_base*));
+        new (&in->keys[i]) Key(std2::move(separator));
+        in->children[i + 1] = child;
+        ++in->count;
+    }
+
+    // hang right next to the child the path ends in, splitting full ancestors with the spare nodes
+    void insert_into_parent(path_entry* path, std::size_t depth, Key separator, node_base* right,
+                            internal** spare, std::size_t spares) noexcept {
+        while (depth > 0) {
+            const path_entry entry = path[--depth];
+            internal* in = entry.node;
+            if (in->count < INTERNAL_SLOTS) {
+                insert_separator(in, entry.child, std2::move(separator), right);
+                return;
+            }
+
+            internal* split = spare[--spares];
+            const std::size_t mid = INTERNAL_SLOTS / 2;
+            relocate(split->keys.data(), in->keys.data() + mid + 1, INTERNAL_SLOTS - mid - 1);
+            std::memcpy(split->children, in->children + mid + 1, (INTERNAL_SLOTS - mid) * sizeof(node_base*));
+            split->count = static_cast<std::uint16_t>(INTERNAL_SLOTS - mid - 1);
+            Key promoted(std2::move(in->keys[mid]));
+            in->keys[mid].~Key();
+            in->count = static_cast<std::uint16_t>(mid);
+
+            if (entry.child <= mid) insert_separator(in, entry.child, std2::move(separator), right);
+            else insert_separator(split, entry.child - mid - 1, std2::move(separator), right);
+
+            separator = std2::move(promoted);
+            right = split;
+        }
+
+        internal* root = spare[--spares];
+        new (&root->keys[0]) Key(std2::move(separator));
+        root->children[0] = m_root;
+        root->children[1] = right;
+        root->count = 1;
+        m_root = root;
+    }
+
+    void remove_separator(internal* in, std::size_t i) noexcept {
+        in->keys[i].~Key();
+        relocate(in->keys.data() + i, in->keys.data() + i + 1, in->count - i - 1);
+        std::memmove(in->children + i + 1, in->children + i + 2, (in->count - i - 1) * sizeof(node_base*));
+        --in->count;
+    }
+
+    void rebalance_leaf(leaf* l, path_entry* path, std::size_t depth) {
+        const path_entry entry = path[depth - 1];
+        internal* parent = entry.node;
+        const std::size_t ci = entry.child;
+
+        if (ci > 0) {
+            leaf* left = static_cast<leaf*>(parent->children[ci - 1]);
+            if (left->count > LEAF_MIN) {
+                relocate_elements(l, 1, l, 0, l->count);
+                relocate_elements(l, 0, left, left->count - 1, 1);
+                --left->count;
+                ++l->count;
+                parent->keys[ci - 1] = l->keys[0];
+                return;
+            }
+        }
+        if (ci < parent->count) {
+            leaf* right = static_cast<leaf*>(parent->children[ci + 1]);
+            if (right->count > LEAF_MIN) {
+                relocate_elements(l, l->count, right, 0, 1);
+                ++l->count;
+                relocate_elements(right, 0, right, 1, right->count - 1);
+                --right->count;
+                parent->keys[ci] = right->keys[0];
+                return;
+            }
+        }
+
+        if (ci > 0) merge_leaves(static_cast<leaf*>(parent->children[ci - 1]), l, parent, ci - 1);
+        else merge_leaves(l, static_cast<leaf*>(parent->children[ci + 1]), parent, ci);
+        rebalance_internal(path, depth - 1);
+    }
+
+    void merge_leaves(leaf* a, leaf* b, internal* parent, std::size_t separator) noexcept {
+        relocate_elements(a, a->count, b, 0, b->count);
+        a->count = static_cast<std::uint16_t>(a->count + b->count);
+        b->count = 0;
+        a->next = b->next;
+        if (b->next) b->next->prev = a;
+        if (m_last == b) m_last = a;
+        free_leaf(b);
+        remove_separator(parent, separator);
+    }
+
+    void rebalance_internal(path_entry* path, std::size_t level) noexcept {
+        internal* in = path[level].node;
+        if (level == 0) {
+            // a root left with a single child hands the root over to it
+            if (in->count == 0) {
+                m_root = in->children[0];
+                free_internal(in);
+            }
+            return;
+        }
+        if (in->count >= INTERNAL_MIN) return;
+
+        const path_entry entry = path[level - 1];
+        internal* parent = entry.node;
+        const std::size_t ci = entry.child;
+
+        if (ci > 0) {
+            internal* left = static_cast<internal*>(parent->children[ci - 1]);
+            if (left->count > INTERNAL_MIN) {
+                // rotate the separator down into in and left's last key up
+                relocate(in->keys.data() + 1, in->keys.data(), in->count);
+                std::memmove(in->children + 1, in->children, (in->count + 1) * sizeof(node_base*));
+                new (&in->keys[0]) Key(std2::move(parent->keys[ci - 1]));
+                in->children[0] = left->children[left->count];
+                parent->keys[ci - 1] = std2::move(left->keys[left->count - 1]);
+                left->keys[left->count - 1].~Key();
+                --left->count;
+                ++in->count;
+                return;
+            }
+        }
+        if (ci < parent->count) {
+            internal* right = static_cast<internal*>(parent->children[ci + 1]);
+            if (right->count > INTERNAL_MIN) {
+                new (&in->keys[in->count]) Key(std2::move(parent->keys[ci]));
+                in->children[in->count + 1] = right->children[0];
+                parent->keys[ci] = std2::move(right->keys[0]);
+                right->keys[0].~Key();
+                relocate(right->keys.data(), right->keys.data() + 1, right->count - 1);
+                std::memmove(right->children, right->children + 1, right->count * sizeof(node_base*));
+                --right->count;
+                ++in->count;
+                return;
+            }
+        }
+
+        if (ci > 0) merge_internal(static_cast<internal*>(parent->children[ci - 1]), in, parent, ci - 1);
+        else merge_internal(in, static_cast<internal*>(parent->children[ci + 1]), parent, ci);
+        rebalance_internal(path, level - 1);
+    }
+
+    void merge_internal(internal* a, internal* b, internal* parent, std::size_t separator) noexcept {
+        new (&a->keys[a->count]) Key(std2::move(parent->keys[separator]));
+        relocate(a->keys.data() + a->count + 1, b->keys.data(), b->count);
+        std::memcpy(a->children + a->count + 1, b->children, (b->count + 1) * sizeof(node_base*));
+        a->count = static_cast<std::uint16_t>(a->count + 1 + b->count);
+        b->count = 0;
+        free_internal(b);
+        remove_separator(parent, separator);
+    }
+
+    node_base* m_root = nullptr;
+    leaf* m_first = nullptr;
+    leaf* m_last = nullptr;
+    std::size_t m_size = 0;
+    [[no_unique_address]] Compare m_comp;
+    [[no_unique_address]] Allocator m_alloc;
+};
+
+} // namespace btree_detail
+
+/*
+ * Ordered map stored in a B+ tree of cache-line sized nodes.
+ * Elements sit packed in the leaves, so a map of small keys and values costs
+ * a little over their own size per element instead of a heap node each, and
+ * iteration walks whole leaves. Nodes come from Allocator, rebound to the
+ * node types. Any insert or erase invalidates iterators.
+ */
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, T>>>
+class btree_map {
+    using tree_type = btree_detail::tree<Key, T, Compare, Allocator>;
+    using cursor = typename tree_type::cursor;
+    template <bool IsConst> class basic_iterator;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    btree_map() = default;
+
+    explicit btree_map(const Compare& comp, const Allocator& alloc = Allocator()) : m_tree(comp, alloc) {}
+
+    explicit btree_map(const Allocator& alloc) : m_tree(Compare(), alloc) {}
+
+    /**
+     *  @brief  Construct from an unsorted range of key/value pairs, first occurrence of a key wins.
+     *  @param  first  Start of the range.
+     *  @param  last  End of the range.
+     */
+    template <typename InputIt>
+    btree_map(InputIt first, InputIt last, const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+        : m_tree(comp, alloc) {
+        insert(first, last);
+    }
+
+    /**
+     *  @brief  Bulk load a range already sorted by key and free of duplicates.
+     *  Builds packed nodes bottom up in O(n) instead of inserting one by one.
+     *  @param  first  Start of a range of key/value pairs.
+     *  @param  last  End of the range.
+     */
+    template <std::forward_iterator It>
+    btree_map(sorted_unique_t, It first, It last, const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+        : m_tree(comp, alloc) {
+        insert(sorted_unique, first, last);
+    }
+
+    allocator_type get_allocator() const { return m_tree.allocator(); }
+    key_compare key_comp() const { return m_tree.comp(); }
+
+    /**
+     *  @brief  Find an element.
+     *  @param  key  The key to search for.
+     *  @return iterator to the element, or end() if not found.
+     */
+    iterator find(const Key& key) { return iterator(m_tree.find(key)); }
+    const_iterator find(const Key& key) const { return const_iterator(m_tree.find(key)); }
+
+    bool contains(const Key& key) const { return m_tree.find(key) != m_tree.end(); }
+    size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    /**
+     *  @brief  First element whose key is not less than key.
+     *  @param  key  The key to search for.
+     *  @return iterator to the element, or end().
+     */
+    iterator lower_bound(const Key& key) { return iterator(m_tree.lower_bound(key)); }
+    const_iterator lower_bound(const Key& key) const { return const_iterator(m_tree.lower_bound(key)); }
+
+    /**
+     *  @brief  First element whose key is greater than key.
+     *  @param  key  The key to search for.
+     *  @return iterator to the element, or end().
+     */
+    iterator upper_bound(const Key& key) { return iterator(m_tree.upper_bound(key)); }
+    const_iterator upper_bound(const Key& key) const { return const_iterator(m_tree.upper_bound(key)); }
+
+    /**
+     *  @brief  The elements with keys in [low, high), in key order.
+     *  @param  low  Smallest key included.
+     *  @param  high  First key excluded.
+     *  @return a view over the elements.
+     */
+    std2::ranges::subrange<iterator> range(const Key& low, const Key& high) {
+        return { lower_bound(low), m_tree.comp()(low, high) ? lower_bound(high) : lower_bound(low) };
+    }
+
+    std2::ranges::subrange<const_iterator> range(const Key& low, const Key& high) const {
+        return { lower_bound(low), m_tree.comp()(low, high) ? lower_bound(high) : lower_bound(low) };
+    }
+
+    /**
+     *  @brief  Access the value for a key.
+     *  @param  key  The key.
+     *  @return reference to the mapped value.
+     *  @throws std::out_of_range if the key is not present.
+     */
+    T& at(const Key& key) {
+        const cursor c = m_tree.find(key);
+        if (c == m_tree.end()) throw std::out_of_range("std2::btree_map::at");
+        return c.value();
+    }
+
+    const T& at(const Key& key) const {
+        const cursor c = m_tree.find(key);
+        if (c == m_tree.end()) throw std::out_of_range("std2::btree_map::at");
+        return c.value();
+    }
+
+    /**
+     *  @brief  Access the value for a key, inserting a value initialized one if missing.
+     *  @param  key  The key.
+     *  @return reference to the mapped value.
+     */
+    T& operator[](const Key& key) {
+        return m_tree.try_emplace(key).first.value();
+    }
+
+    /**
+     *  @brief  Insert a value for key unless the key is already present.
+     *  @param  key  The key.
+     *  @param  args  Arguments to construct the value from.
+     *  @return iterator to the element and whether it was inserted.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        const auto [c, inserted] = m_tree.try_emplace(key, std2::forward<Args>(args)...);
+        return { iterator(c), inserted };
+    }
+
+    std::pair<iterator, bool> insert(const std::pair<Key, T>& value) {
+        return try_emplace(value.first, value.second);
+    }
+
+    /**
+     *  @brief  Insert each element of a range, existing keys and the first duplicate win.
+     *  @param  first  Start of a range of key/value pairs.
+     *  @param  last  End of the range.
+     *  @return void.
+     */
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) try_emplace(first->first, first->second);
+    }
+
+    /**
+     *  @brief  Insert a range already sorted by key and free of duplicates.
+     *  An empty map is bulk loaded, otherwise the elements are inserted one by one.
+     *  @param  first  Start of a range of key/value pairs.
+     *  @param  last  End of the range.
+     *  @return void.
+     */
+    template <std::forward_iterator It>
+    void insert(sorted_unique_t, It first, It last) {
+        if (!empty()) {
+            insert(first, last);
+            return;
+        }
+        m_tree.build(static_cast<std::size_t>(std::distance(first, last)), [&first](auto* leaf, std::size_t i) {
+            new (&leaf->keys[i]) Key(first->first);
+            new (&leaf->values[i]) T(first->second);
+            ++first;
+        });
+    }
+
+    /**
+     *  @brief  Erase an element.
+     *  @param  key  The key of the element to erase.
+     *  @return the number of elements erased (0 or 1).
+     */
+    size_type erase(const Key& key) {
+        return m_tree.erase(key);
+    }
+
+    /**
+     *  @brief  Erase the element at an iterator.
+     *  @param  pos  Iterator to the element, not end().
+     *  @return iterator to the element after it.
+     */
+    iterator erase(const_iterator pos) {
+        const Key key = pos->first;
+        m_tree.erase(key);
+        return lower_bound(key);
+    }
+
+    void clear() { m_tree.clear(); }
+
+    iterator begin() { return iterator(m_tree.begin()); }
+    iterator end() { return iterator(m_tree.end()); }
+    const_iterator begin() const { return const_iterator(m_tree.begin()); }
+    const_iterator end() const { return const_iterator(m_tree.end()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_type size() const { return m_tree.size(); }
+    bool empty() const { return m_tree.size() == 0; }
+
+private:
+    template <bool IsConst>
+    class basic_iterator {
+        using mapped_ref = std::conditional_t<IsConst, const T&, T&>;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::pair<Key, T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const Key&, mapped_ref>;
+
+        struct pointer {
+            reference ref;
+            reference* operator->() { return &ref; }
+        };
+
+        basic_iterator() = default;
+        explicit basic_iterator(cursor c) : m_cursor(c) {}
+
+        reference operator*() const { return reference(m_cursor.key(), m_cursor.value()); }
+        pointer operator->() const { return pointer{ **this }; }
+
+        basic_iterator& operator++() { m_cursor.next(); return *this; }
+        basic_iterator operator++(int) { basic_iterator temp = *this; m_cursor.next(); return temp; }
+        basic_iterator& operator--() { m_cursor.prev(); return *this; }
+        basic_iterator operator--(int) { basic_iterator temp = *this; m_cursor.prev(); return temp; }
+
+        bool operator==(const basic_iterator& other) const { return m_cursor == other.m_cursor; }
+
+        operator basic_iterator<true>() const requires (!IsConst) { return basic_iterator<true>(m_cursor); }
+
+    private:
+        cursor m_cursor;
+    };
+
+    tree_type m_tree;
+};
+
+} // namespace std2
+
+#endif // BTREE_MAP_HPP
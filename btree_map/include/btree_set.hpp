@@ -0,0 +1,180 @@
+#ifndef BTREE_SET_HPP
+#define BTREE_SET_HPP
+
+#include <cstddef>     // for std::size_t, std::ptrdiff_t
+#include <functional>  // for std::less
+#include <iterator>    // for std::bidirectional_iterator_tag, std::forward_iterator
+#include <memory>      // for std::allocator
+#include <utility>     // for std::pair
+#include "btree_map.hpp" // for btree_detail::tree, std2::sorted_unique
+#include "../../std2/ranges.hpp" // for std2::ranges::subrange
+#include "../../std2/std2.hpp" // for std2::move
+
+namespace std2 {
+
+/*
+ * Ordered set stored in a B+ tree of cache-line sized nodes.
+ * Shares the node layout, search and bulk loading of std2::btree_map; leaves
+ * hold keys only, so a node of small keys carries over a hundred of them.
+ */
+template <typename Key, typename Compare = std::less<Key>, typename Allocator = std::allocator<Key>>
+class btree_set {
+    using tree_type = btree_detail::tree<Key, void, Compare, Allocator>;
+    using cursor = typename tree_type::cursor;
+
+public:
+    class const_iterator;
+
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using iterator = const_iterator;
+
+    btree_set() = default;
+
+    explicit btree_set(const Compare& comp, const Allocator& alloc = Allocator()) : m_tree(comp, alloc) {}
+
+    explicit btree_set(const Allocator& alloc) : m_tree(Compare(), alloc) {}
+
+    /**
+     *  @brief  Construct from an unsorted range, duplicates are dropped.
+     *  @param  first  Start of the range.
+     *  @param  last  End of the range.
+     */
+    template <typename InputIt>
+    btree_set(InputIt first, InputIt last, const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+        : m_tree(comp, alloc) {
+        insert(first, last);
+    }
+
+    /**
+     *  @brief  Bulk load a range already sorted and free of duplicates.
+     *  @param  first  Start of the range.
+     *  @param  last  End of the range.
+     */
+    template <std::forward_iterator It>
+    btree_set(sorted_unique_t, It first, It last, const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+        : m_tree(comp, alloc) {
+        insert(sorted_unique, first, last);
+    }
+
+    allocator_type get_allocator() const { return m_tree.allocator(); }
+    key_compare key_comp() const { return m_tree.comp(); }
+
+    const_iterator find(const Key& key) const { return const_iterator(m_tree.find(key)); }
+    bool contains(const Key& key) const { return m_tree.find(key) != m_tree.end(); }
+    size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    /**
+     *  @brief  First key not less than key.
+     *  @param  key  The key to search for.
+     *  @return iterator to the key, or end().
+     */
+    const_iterator lower_bound(const Key& key) const { return const_iterator(m_tree.lower_bound(key)); }
+
+    /**
+     *  @brief  First key greater than key.
+     *  @param  key  The key to search for.
+     *  @return iterator to the key, or end().
+     */
+    const_iterator upper_bound(const Key& key) const { return const_iterator(m_tree.upper_bound(key)); }
+
+    /**
+     *  @brief  The keys in [low, high), in order.
+     *  @param  low  Smallest key included.
+     *  @param  high  First key excluded.
+     *  @return a view over the keys.
+     */
+    std2::ranges::subrange<const_iterator> range(const Key& low, const Key& high) const {
+        return { lower_bound(low), m_tree.comp()(low, high) ? lower_bound(high) : lower_bound(low) };
+    }
+
+    /**
+     *  @brief  Insert a key unless it is already present.
+     *  @param  key  The key.
+     *  @return iterator to the key and whether it was inserted.
+     */
+    std::pair<const_iterator, bool> insert(const Key& key) {
+        const auto [c, inserted] = m_tree.try_emplace(key);
+        return { const_iterator(c), inserted };
+    }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) m_tree.try_emplace(*first);
+    }
+
+    /**
+     *  @brief  Insert a range already sorted and free of duplicates.
+     *  An empty set is bulk loaded, otherwise the keys are inserted one by one.
+     *  @param  first  Start of the range.
+     *  @param  last  End of the range.
+     *  @return void.
+     */
+    template <std::forward_iterator It>
+    void insert(sorted_unique_t, It first, It last) {
+        if (!empty()) {
+            insert(first, last);
+            return;
+        }
+        m_tree.build(static_cast<std::size_t>(std::distance(first, last)), [&first](auto* leaf, std::size_t i) {
+            new (&leaf->keys[i]) Key(*first);
+            ++first;
+        });
+    }
+
+    size_type erase(const Key& key) {
+        return m_tree.erase(key);
+    }
+
+    const_iterator erase(const_iterator pos) {
+        const Key key = *pos;
+        m_tree.erase(key);
+        return lower_bound(key);
+    }
+
+    void clear() { m_tree.clear(); }
+
+    const_iterator begin() const { return const_iterator(m_tree.begin()); }
+    const_iterator end() const { return const_iterator(m_tree.end()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_type size() const { return m_tree.size(); }
+    bool empty() const { return m_tree.size() == 0; }
+
+    // keys are immutable in place, so there is only a const iterator
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Key;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Key*;
+        using reference = const Key&;
+
+        const_iterator() = default;
+        explicit const_iterator(cursor c) : m_cursor(c) {}
+
+        reference operator*() const { return m_cursor.key(); }
+        pointer operator->() const { return &m_cursor.key(); }
+
+        const_iterator& operator++() { m_cursor.next(); return *this; }
+        const_iterator operator++(int) { const_iterator temp = *this; m_cursor.next(); return temp; }
+        const_iterator& operator--() { m_cursor.prev(); return *this; }
+        const_iterator operator--(int) { const_iterator temp = *this; m_cursor.prev(); return temp; }
+
+        bool operator==(const const_iterator& other) const { return m_cursor == other.m_cursor; }
+
+    private:
+        cursor m_cursor;
+    };
+
+private:
+    tree_type m_tree;
+};
+
+} // namespace std2
+
+#endif // BTREE_SET_HPP
@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/btree_map.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Allocator that counts the bytes it hands out, shared by all rebound copies
+struct AllocationCounter {
+    static inline std::size_t live_bytes = 0;
+    static inline std::size_t peak_bytes = 0;
+};
+
+template <typename T>
+class CountingAllocator {
+public:
+    using value_type = T;
+
+    CountingAllocator() noexcept {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        AllocationCounter::live_bytes += n * sizeof(T);
+        AllocationCounter::peak_bytes = std::max(AllocationCounter::peak_bytes, AllocationCounter::live_bytes);
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        AllocationCounter::live_bytes -= n * sizeof(T);
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const noexcept { return true; }
+};
+
+class BtreeMapTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+        AllocationCounter::live_bytes = 0;
+        AllocationCounter::peak_bytes = 0;
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    template <typename Map, typename Reference>
+    static void expect_same(const Map& map, const Reference& reference) {
+        ASSERT_EQ(map.size(), reference.size());
+        auto it = map.begin();
+        for (const auto& [key, value] : reference) {
+            ASSERT_EQ((*it).first, key);
+            ASSERT_EQ((*it).second, value);
+            ++it;
+        }
+        ASSERT_TRUE(it == map.end());
+    }
+};
+
+// Test single inserts, lookups and erasures
+TEST_F(BtreeMapTest, InsertFindErase) {
+    std2::btree_map<int, std::string> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.begin() == map.end());
+
+    EXPECT_TRUE(map.try_emplace(5, "five").second);
+    EXPECT_TRUE(map.insert({1, "one"}).second);
+    EXPECT_TRUE(map.insert({3, "three"}).second);
+    EXPECT_FALSE(map.insert({3, "again"}).second);
+    map[9] = "nine";
+
+    ASSERT_EQ(map.size(), 4);
+    EXPECT_EQ(map.at(3), "three");
+    EXPECT_EQ(map.find(5)->second, "five");
+    EXPECT_TRUE(map.find(4) == map.end());
+    EXPECT_TRUE(map.contains(1));
+    EXPECT_EQ(map.count(2), 0);
+    EXPECT_EQ(map.lower_bound(4)->first, 5);
+    EXPECT_EQ(map.upper_bound(5)->first, 9);
+    EXPECT_TRUE(map.upper_bound(9) == map.end());
+    EXPECT_THROW(map.at(42), std::out_of_range);
+
+    EXPECT_EQ(map.erase(3), 1);
+    EXPECT_EQ(map.erase(3), 0);
+    EXPECT_EQ(map.size(), 3);
+    map.find(1)->second = "uno";
+    EXPECT_EQ(map.at(1), "uno");
+
+    std::vector<int> keys;
+    for (auto [key, value] : map) keys.push_back(key);
+    EXPECT_THAT(keys, ::testing::ElementsAre(1, 5, 9));
+}
+
+// Test random inserts and erasures against std::map across many node splits and merges
+TEST_F(BtreeMapTest, RandomizedAgainstStdMap) {
+    std::mt19937 rng(17);
+    std2::btree_map<std::int64_t, std::int64_t> map;
+    std::map<std::int64_t, std::int64_t> reference;
+
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < 30000; ++i) {
+            const std::int64_t key = rng() % 40000;
+            ASSERT_EQ(map.try_emplace(key, key * 3).second, reference.emplace(key, key * 3).second);
+        }
+        expect_same(map, reference);
+        for (int i = 0; i < 30000; ++i) {
+            const std::int64_t key = rng() % 40000;
+            ASSERT_EQ(map.erase(key), reference.erase(key));
+        }
+        expect_same(map, reference);
+        for (int i = 0; i < 1000; ++i) {
+            const std::int64_t key = rng() % 41000;
+            auto lower = map.lower_bound(key);
+            auto expected = reference.lower_bound(key);
+            ASSERT_EQ(lower == map.end(), expected == reference.end());
+            if (expected != reference.end()) {
+                ASSERT_EQ(lower->first, expected->first);
+            }
+            auto upper = map.upper_bound(key);
+            auto expected_upper = reference.upper_bound(key);
+            ASSERT_EQ(upper == map.end(), expected_upper == reference.end());
+            if (expected_upper != reference.end()) {
+                ASSERT_EQ(upper->first, expected_upper->first);
+            }
+        }
+    }
+
+    // drain everything, the tree collapses back to empty
+    for (int key = 0; key < 40000; ++key) map.erase(key);
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.begin() == map.end());
+    map[1] = 2;
+    EXPECT_EQ(map.at(1), 2);
+}
+
+// Test keys that are neither arithmetic nor trivially relocatable, with a custom order
+TEST_F(BtreeMapTest, StringKeysDescending) {
+    std::mt19937 rng(23);
+    std2::btree_map<std::string, int, std::greater<std::string>> map;
+    std::map<std::string, int, std::greater<std::string>> reference;
+    for (int i = 0; i < 20000; ++i) {
+        const std::string key = "key_" + std::to_string(rng() % 5000) + std::string(rng() % 20, 'x');
+        if (rng() % 3) {
+            map[key] = i;
+            reference[key] = i;
+        } else {
+            ASSERT_EQ(map.erase(key), reference.erase(key));
+        }
+    }
+    expect_same(map, reference);
+
+    // walk backwards from end()
+    auto it = map.end();
+    for (auto expected = reference.rbegin(); expected != reference.rend(); ++expected) {
+        --it;
+        ASSERT_EQ(it->first, expected->first);
+    }
+    EXPECT_TRUE(it == map.begin());
+}
+
+// Test bulk loading sorted input of every awkward size, then mutating the result
+TEST_F(BtreeMapTest, BulkLoad) {
+    for (int n : {0, 1, 2, 29, 30, 31, 61, 1000, 50000}) {
+        std::vector<std::pair<int, int>> sorted;
+        for (int i = 0; i < n; ++i) sorted.emplace_back(2 * i, i);
+
+        std2::btree_map<int, int> map(std2::sorted_unique, sorted.begin(), sorted.end());
+        std::map<int, int> reference(sorted.begin(), sorted.end());
+        expect_same(map, reference);
+
+        // the packed tree still splits and merges correctly
+        std::mt19937 rng(n);
+        for (int i = 0; i < n; ++i) {
+            const int key = static_cast<int>(rng() % (2 * n + 2));
+            if (i % 2) {
+                ASSERT_EQ(map.erase(key), reference.erase(key));
+            } else {
+                map[key] = -key;
+                reference[key] = -key;
+            }
+        }
+        expect_same(map, reference);
+    }
+
+    // inserting sorted input into a non-empty map falls back to single inserts
+    std2::btree_map<int, int> map;
+    map[5] = 0;
+    std::vector<std::pair<int, int>> more{{1, 1}, {5, 5}, {7, 7}};
+    map.insert(std2::sorted_unique, more.begin(), more.end());
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map.at(5), 0);
+}
+
+// Test range queries and erasing through iterators
+TEST_F(BtreeMapTest, RangeIteration) {
+    std2::btree_map<int, int> map;
+    for (int i = 0; i < 10000; ++i) map[i * 10] = i;
+
+    int count = 0;
+    long long sum = 0;
+    for (auto [key, value] : map.range(995, 2005)) {
+        ++count;
+        sum += key;
+    }
+    EXPECT_EQ(count, 101); // 1000, 1010, ..., 2000
+    EXPECT_EQ(sum, 101LL * 1500);
+    EXPECT_TRUE(map.range(2005, 995).empty());
+    EXPECT_TRUE(map.range(200000, 300000).empty());
+
+    const auto& view = map;
+    EXPECT_EQ(std::ranges::distance(view.range(0, 100)), 10);
+
+    // erase every other element while walking forward
+    for (auto it = map.begin(); it != map.end();) {
+        if (it->second % 2) it = map.erase(it);
+        else ++it;
+    }
+    EXPECT_EQ(map.size(), 5000);
+    for (auto [key, value] : map) ASSERT_EQ(value % 2, 0);
+}
+
+// Test nodes come from the allocator and are all returned
+TEST_F(BtreeMapTest, AllocatorAndCopies) {
+    {
+        std2::btree_map<int, std::string, std::less<int>, CountingAllocator<std::pair<const int, std::string>>> map;
+        for (int i = 0; i < 5000; ++i) map[i] = std::to_string(i);
+        EXPECT_GT(AllocationCounter::live_bytes, 0);
+
+        auto copy = map;
+        copy[1] = "changed";
+        EXPECT_EQ(map.at(1), "1");
+        EXPECT_EQ(copy.size(), map.size());
+
+        auto moved = std2::move(copy);
+        EXPECT_TRUE(copy.empty());
+        EXPECT_EQ(moved.at(1), "changed");
+
+        map = moved;
+        EXPECT_EQ(map.at(1), "changed");
+        moved.clear();
+        EXPECT_TRUE(moved.empty());
+    }
+    EXPECT_EQ(AllocationCounter::live_bytes, 0);
+}
+
+// Memory per key and insert, lookup and scan throughput against std::map
+TEST_F(BtreeMapTest, PerformanceBenchmark) {
+    const int n = 1000000;
+    std::mt19937_64 rng(42);
+    std::vector<std::int64_t> keys(n);
+    for (auto& k : keys) k = static_cast<std::int64_t>(rng() >> 24);
+    std::vector<std::int64_t> probes(n);
+    for (auto& p : probes) p = keys[rng() % n];
+
+    auto time = [](auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        body();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+
+    using pair_allocator = CountingAllocator<std::pair<const std::int64_t, std::int64_t>>;
+    std::map<std::int64_t, std::int64_t, std::less<std::int64_t>, pair_allocator> std_map;
+    std2::btree_map<std::int64_t, std::int64_t, std::less<std::int64_t>, pair_allocator> btree;
+
+    const auto std_insert = time([&] { for (auto k : keys) std_map.emplace(k, k); });
+    const double std_bytes = double(AllocationCounter::live_bytes) / double(std_map.size());
+    AllocationCounter::live_bytes = 0;
+    const auto btree_insert = time([&] { for (auto k : keys) btree.try_emplace(k, k); });
+    const double btree_bytes = double(AllocationCounter::live_bytes) / double(btree.size());
+    EXPECT_EQ(std_map.size(), btree.size());
+
+    std::int64_t std_found = 0, btree_found = 0;
+    const auto std_lookup = time([&] { for (auto p : probes) std_found += std_map.find(p)->second; });
+    const auto btree_lookup = time([&] { for (auto p : probes) btree_found += btree.find(p)->second; });
+    EXPECT_EQ(std_found, btree_found);
+
+    std::int64_t std_scanned = 0, btree_scanned = 0;
+    const auto std_scan = time([&] { for (const auto& [k, v] : std_map) std_scanned += v; });
+    const auto btree_scan = time([&] { for (const auto& [k, v] : btree) btree_scanned += v; });
+    EXPECT_EQ(std_scanned, btree_scanned);
+
+    std::vector<std::pair<std::int64_t, std::int64_t>> sorted(std_map.begin(), std_map.end());
+    AllocationCounter::live_bytes = 0;
+    std2::btree_map<std::int64_t, std::int64_t, std::less<std::int64_t>, pair_allocator> loaded;
+    const auto bulk_load = time([&] { loaded.insert(std2::sorted_unique, sorted.begin(), sorted.end()); });
+    const double loaded_bytes = double(AllocationCounter::live_bytes) / double(loaded.size());
+    EXPECT_EQ(loaded.size(), btree.size());
+
+    std::cout << n << " random int64 -> int64\n"
+              << "  bytes per key       std::map " << std_bytes << ", std2::btree_map " << btree_bytes
+              << ", bulk loaded " << loaded_bytes << "\n"
+              << "  insert              std::map " << std_insert << " us, std2::btree_map " << btree_insert << " us\n"
+              << "  lookup              std::map " << std_lookup << " us, std2::btree_map " << btree_lookup << " us\n"
+              << "  full scan           std::map " << std_scan << " us, std2::btree_map " << btree_scan << " us\n"
+              << "  bulk load sorted    std2::btree_map " << bulk_load << " us\n";
+}
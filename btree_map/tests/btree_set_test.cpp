@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/btree_set.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+class BtreeSetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+// Test single inserts, lookups and erasures
+TEST_F(BtreeSetTest, InsertFindErase) {
+    std2::btree_set<std::string> set;
+    EXPECT_TRUE(set.insert("pear").second);
+    EXPECT_TRUE(set.insert("apple").second);
+    EXPECT_FALSE(set.insert("pear").second);
+    EXPECT_EQ(*set.insert("fig").first, "fig");
+
+    EXPECT_THAT(std::vector<std::string>(set.begin(), set.end()), ::testing::ElementsAre("apple", "fig", "pear"));
+    EXPECT_TRUE(set.contains("fig"));
+    EXPECT_EQ(*set.lower_bound("b"), "fig");
+    EXPECT_EQ(set.erase("fig"), 1);
+    EXPECT_EQ(set.count("fig"), 0);
+    EXPECT_TRUE(set.find("fig") == set.end());
+}
+
+// Test random inserts and erasures of small keys against std::set
+TEST_F(BtreeSetTest, RandomizedAgainstStdSet) {
+    std::mt19937 rng(29);
+    std2::btree_set<std::int32_t> set;
+    std::set<std::int32_t> reference;
+    for (int i = 0; i < 200000; ++i) {
+        const std::int32_t key = static_cast<std::int32_t>(rng() % 50000) - 25000;
+        if (rng() % 3) {
+            ASSERT_EQ(set.insert(key).second, reference.insert(key).second);
+        } else {
+            ASSERT_EQ(set.erase(key), reference.erase(key));
+        }
+    }
+    ASSERT_EQ(set.size(), reference.size());
+    EXPECT_TRUE(std::equal(set.begin(), set.end(), reference.begin(), reference.end()));
+    EXPECT_TRUE(std::equal(reference.rbegin(), reference.rend(), std::make_reverse_iterator(set.end()),
+                           std::make_reverse_iterator(set.begin())));
+}
+
+// Test bulk loading and range queries
+TEST_F(BtreeSetTest, BulkLoadAndRange) {
+    std::vector<int> sorted;
+    for (int i = 0; i < 100000; ++i) sorted.push_back(3 * i);
+    std2::btree_set<int> set(std2::sorted_unique, sorted.begin(), sorted.end());
+    ASSERT_EQ(set.size(), sorted.size());
+    EXPECT_TRUE(std::equal(set.begin(), set.end(), sorted.begin(), sorted.end()));
+
+    std::vector<int> window;
+    for (int key : set.range(10, 25)) window.push_back(key);
+    EXPECT_THAT(window, ::testing::ElementsAre(12, 15, 18, 21, 24));
+
+    std2::btree_set<int> copy = set;
+    for (int i = 0; i < 100000; i += 2) copy.erase(3 * i);
+    EXPECT_EQ(copy.size(), 50000);
+    EXPECT_EQ(set.size(), 100000);
+    EXPECT_EQ(*copy.begin(), 3);
+}
+
+// Lookup throughput of small keys against std::set
+TEST_F(BtreeSetTest, PerformanceBenchmark) {
+    const int n = 1000000;
+    std::mt19937 rng(42);
+    std::vector<std::int32_t> keys(n);
+    for (auto& k : keys) k = static_cast<std::int32_t>(rng());
+    std::vector<std::int32_t> probes(n);
+    for (auto& p : probes) p = keys[rng() % n];
+
+    auto time = [](auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        body();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+
+    std::set<std::int32_t> std_set;
+    std2::btree_set<std::int32_t> btree;
+    const auto std_insert = time([&] { for (auto k : keys) std_set.insert(k); });
+    const auto btree_insert = time([&] { for (auto k : keys) btree.insert(k); });
+
+    std::size_t std_found = 0, btree_found = 0;
+    const auto std_lookup = time([&] { for (auto p : probes) std_found += std_set.count(p); });
+    const auto btree_lookup = time([&] { for (auto p : probes) btree_found += btree.count(p); });
+    EXPECT_EQ(std_found, btree_found);
+    EXPECT_EQ(std_set.size(), btree.size());
+
+    std::cout << n << " random int32\n"
+              << "  insert  std::set " << std_insert << " us, std2::btree_set " << btree_insert << " us\n"
+              << "  lookup  std::set " << std_lookup << " us, std2::btree_set " << btree_lookup << " us\n";
+}
@@ -0,0 +1,805 @@
+#ifndef CONCURRENT_HASH_MAP_HPP
+#define CONCURRENT_HASH_MAP_HPP
+
+#include <algorithm>    // for std::clamp, std::max, std::min
+#include <atomic>       // for std::atomic, std::atomic_ref, std::atomic_thread_fence
+#include <bit>          // for std::bit_ceil
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t, std::uint64_t, UINT64_MAX
+#include <cstring>      // for std::memcpy
+#include <functional>   // for std::hash, std::equal_to
+#include <memory>       // for std::unique_ptr, std::make_unique
+#include <mutex>        // for std::unique_lock
+#include <new>          // for placement new, std::launder
+#include <optional>     // for std::optional
+#include <shared_mutex> // for std::shared_mutex, std::shared_lock
+#include <tuple>        // for std::forward_as_tuple
+#include <type_traits>  // for std::is_trivially_copyable_v
+#include <utility>      // for std::pair, std::piecewise_construct, std::as_const
+#include "../../vector/include/vector.hpp" // for std2::vector
+#include "../../std2/std2.hpp" // for std2::move, std2::forward
+
+namespace std2 {
+
+namespace hash_map_detail {
+
+/*
+ * Epoch based reclamation for the tables optimistic readers may be probing.
+ * Every reading thread owns a slot on its own cache line and publishes the
+ * global epoch it entered in, so the read path writes nothing shared. A
+ * drained table is tagged with the epoch it was retired in and may be freed
+ * once every thread still inside entered in a later epoch.
+ */
+class epoch_domain {
+public:
+    static constexpr std::uint64_t QUIESCENT = 0;
+
+    struct alignas(64) reader_slot {
+        std::atomic<std::uint64_t> epoch{QUIESCENT};
+        std::atomic<bool> in_use{false};
+        reader_slot* next = nullptr;
+    };
+
+    static epoch_domain& instance() {
+        static epoch_domain domain;
+        return domain;
+    }
+
+    /**
+     *  @brief  The calling thread's slot, taken on first use and handed back on thread exit.
+     *  @return the slot.
+     */
+    reader_slot& local() {
+        thread_local slot_owner owner(acquire_slot());
+        return *owner.slot;
+    }
+
+    void enter(reader_slot& slot) {
+        // release: a writer that reads this epoch also sees the previous read section as finished
+        slot.epoch.store(m_epoch.load(std::memory_order_acquire), std::memory_order_release);
+        // pairs with the fence in oldest_active: either the writer sees this slot,
+        // or this reader sees the snapshot the writer published before retiring
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void exit(reader_slot& slot) { slot.epoch.store(QUIESCENT, std::memory_order_release); }
+
+    /**
+     *  @brief  Tag for a table that was just unlinked from its shard.
+     *  @return the epoch the table was retired in.
+     */
+    std::uint64_t retire() { return m_epoch.fetch_add(1, std::memory_order_seq_cst); }
+
+    /**
+     *  @brief  Oldest epoch a reader still inside entered in.
+     *  A table retired in an earlier epoch is unreachable for every reader.
+     *  @return the epoch, UINT64_MAX if no reader is inside.
+     */
+    std::uint64_t oldest_active() const {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::uint64_t oldest = UINT64_MAX;
+        for (const reader_slot* slot = m_slots.load(std::memory_order_acquire); slot; slot = slot->next) {
+            const std::uint64_t epoch = slot->epoch.load(std::memory_order_acquire);
+            if (epoch != QUIESCENT && epoch < oldest) oldest = epoch;
+        }
+        return oldest;
+    }
+
+private:
+    struct slot_owner {
+        explicit slot_owner(reader_slot* s) : slot(s) {}
+        ~slot_owner() { slot->in_use.store(false, std::memory_order_release); }
+        reader_slot* slot;
+    };
+
+    epoch_domain() = default;
+
+    // slots are never freed, a slot released by an exited thread is reused by the next new one
+    reader_slot* acquire_slot() {
+        for (reader_slot* slot = m_slots.load(std::memory_order_acquire); slot; slot = slot->next) {
+            bool expected = false;
+            if (!slot->in_use.load(std::memory_order_relaxed) &&
+                slot->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return slot;
+            }
+        }
+        reader_slot* slot = new reader_slot();
+        slot->in_use.store(true, std::memory_order_relaxed);
+        slot->next = m_slots.load(std::memory_order_relaxed);
+        while (!m_slots.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed)) {}
+        return slot;
+    }
+
+    std::atomic<reader_slot*> m_slots{nullptr};
+    alignas(64) std::atomic<std::uint64_t> m_epoch{QUIESCENT + 1};
+};
+
+} // namespace hash_map_detail
+
+/*
+ * Hash map shared by many threads.
+ * Keys are spread over a power-of-two number of shards by the high bits of
+ * their hash. Each shard is an open-addressing table (linear probing, one
+ * control byte per bucket holding 7 bits of the hash) in std2::vector-backed
+ * arrays, guarded by its own lock, so writers on different shards never meet.
+ *
+ * Reads of trivially copyable keys and values take no lock: they follow the
+ * shard's sequence counter (a seqlock), copy the entry out and retry if a
+ * writer got in between. The tables such a reader probes are published as an
+ * immutable snapshot behind an atomic pointer, and every control byte and
+ * slot word it copies is accessed through std::atomic_ref on both sides, so
+ * a torn read is a stale value rather than a data race. Readers announce
+ * themselves in a per-thread epoch slot; a replaced snapshot, and a table a
+ * resize has drained, are kept until every reader that was inside when they
+ * were retired has left, so a reader never touches released memory. Drained
+ * tables are reused by later resizes of the same capacity; each finished
+ * resize frees what no reader can reach any more, except one spare of the
+ * current capacity. Other types are read under the shard's shared lock.
+ *
+ * There are no iterators and nothing returns a reference into the table:
+ * entries are reached through visit()/cvisit(), which run the callback while
+ * the entry is guaranteed alive. A callback must not call back into the map.
+ *
+ * Growing a shard allocates the new table and moves MIGRATE_STEP buckets of
+ * the old one per write, so no single insert pays for the whole rehash.
+ */
+template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class concurrent_hash_map {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+    static constexpr size_type DEFAULT_SHARD_COUNT = 64;
+    static constexpr size_type MAX_SHARD_COUNT = size_type(1) << 16;
+    static constexpr size_type MIN_CAPACITY = 16;
+    static constexpr size_type MAX_LOAD_NUM = 3; // a table grows past 3/4 full, tombstones included
+    static constexpr size_type MAX_LOAD_DEN = 4;
+    static constexpr size_type MIGRATE_STEP = 16; // old buckets moved per write while a resize runs
+    static constexpr size_type OPTIMISTIC_ATTEMPTS = 16; // seqlock retries before a reader takes the lock
+    static constexpr bool OPTIMISTIC_READS = std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<T>;
+
+    /**
+     *  @brief  Construct an empty map.
+     *  @param  shard_count  Number of shards, rounded up to a power of two.
+     *  @param  hash  The hash function.
+     *  @param  equal  The key equality.
+     */
+    explicit concurrent_hash_map(size_type shard_count = DEFAULT_SHARD_COUNT, const Hash& hash = Hash(),
+                                 const KeyEqual& equal = KeyEqual())
+        : m_shard_mask(std::bit_ceil(std::clamp(shard_count, size_type(1), MAX_SHARD_COUNT)) - 1),
+          m_shards(new shard[m_shard_mask + 1]), m_hash(hash), m_equal(equal) {}
+
+    concurrent_hash_map(const concurrent_hash_map&) = delete;
+    concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+    /**
+     *  @brief  Insert a key and a value constructed in place, unless the key is present.
+     *  @param  key  The key.
+     *  @param  args  Arguments to forward to the constructor of T.
+     *  @return true if the entry was inserted.
+     */
+    template <typename... Args>
+    bool try_emplace(const Key& key, Args&&... args) {
+        return emplace_or_visit(key, [](value_type&) {}, std2::forward<Args>(args)...);
+    }
+
+    bool insert(const value_type& value) { return try_emplace(value.first, value.second); }
+
+    bool insert(value_type&& value) { return try_emplace(value.first, std2::move(value.second)); }
+
+    /**
+     *  @brief  Insert an entry, or assign its value if the key is present.
+     *  @param  key  The key.
+     *  @param  obj  The value.
+     *  @return true if the entry was inserted, false if it was assigned.
+     */
+    template <typename M>
+    bool insert_or_assign(const Key& key, M&& obj) {
+        // exactly one of the two uses of obj runs
+        return emplace_or_visit(key, [&obj](value_type& v) { v.second = std2::forward<M>(obj); }, std2::forward<M>(obj));
+    }
+
+    /**
+     *  @brief  Insert an entry, or run f on the entry already holding its key.
+     *  f runs under the shard's lock and may modify the mapped value.
+     *  @param  value  The entry to insert.
+     *  @param  f  Callable taking value_type&.
+     *  @return true if the entry was inserted, false if f ran.
+     */
+    template <typename F>
+    bool insert_or_visit(const value_type& value, F f) {
+        return emplace_or_visit(value.first, f, value.second);
+    }
+
+    template <typename F>
+    bool insert_or_visit(value_type&& value, F f) {
+        return emplace_or_visit(value.first, f, std2::move(value.second));
+    }
+
+    /**
+     *  @brief  Run f on the entry for key under the shard's lock.
+     *  @param  key  The key to look up.
+     *  @param  f  Callable taking value_type&, may modify the mapped value.
+     *  @return true if the key was found.
+     */
+    template <typename F>
+    bool visit(const Key& key, F f) {
+        const std::uint64_t h = hash_of(key);
+        shard& s = shard_for(h);
+        write_guard guard(s);
+        value_type* entry = find_locked(s, key, h);
+        if (entry) update(*entry, f);
+        return entry != nullptr;
+    }
+
+    /**
+     *  @brief  Run f on the entry for key without blocking writers where possible.
+     *  With OPTIMISTIC_READS f sees a consistent copy of the entry, otherwise
+     *  it runs under the shard's shared lock.
+     *  @param  key  The key to look up.
+     *  @param  f  Callable taking const value_type&.
+     *  @return true if the key was found.
+     */
+    template <typename F>
+    bool cvisit(const Key& key, F f) const {
+        const std::uint64_t h = hash_of(key);
+        const shard& s = shard_for(h);
+        if constexpr (OPTIMISTIC_READS) {
+            slot copy;
+            const lookup result = find_optimistic(s, key, h, copy);
+            if (result == lookup::found) f(*std::launder(reinterpret_cast<const value_type*>(copy.bytes)));
+            if (result != lookup::contended) return result == lookup::found;
+        }
+        std::shared_lock<std::shared_mutex> lock(s.lock);
+        const value_type* entry = find_locked(s, key, h);
+        if (entry) f(*entry);
+        return entry != nullptr;
+    }
+
+    template <typename F>
+    bool visit(const Key& key, F f) const { return cvisit(key, f); }
+
+    /**
+     *  @brief  Copy of the value for key.
+     *  @param  key  The key to look up.
+     *  @return the value, or an empty optional if the key is absent.
+     */
+    std::optional<T> get(const Key& key) const {
+        std::optional<T> result;
+        cvisit(key, [&result](const value_type& v) { result.emplace(v.second); });
+        return result;
+    }
+
+    bool contains(const Key& key) const {
+        return cvisit(key, [](const value_type&) {});
+    }
+
+    size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    /**
+     *  @brief  Erase the entry for key.
+     *  @param  key  The key to erase.
+     *  @return the number of entries erased, 0 or 1.
+     */
+    size_type erase(const Key& key) {
+        const std::uint64_t h = hash_of(key);
+        shard& s = shard_for(h);
+        write_guard guard(s);
+        migrate(s, MIGRATE_STEP);
+        for (table* t : {&s.current, &s.previous}) {
+            const size_type i = find_index(*t, key, h);
+            if (i != NPOS) {
+                t->destroy(i);
+                s.size.fetch_sub(1, std::memory_order_relaxed);
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     *  @brief  Erase every entry matching pred, locking one shard at a time.
+     *  @param  pred  Callable taking const value_type&.
+     *  @return the number of entries erased.
+     */
+    template <typename Pred>
+    size_type erase_if(Pred pred) {
+        size_type erased = 0;
+        for (size_type n = 0; n <= m_shard_mask; ++n) {
+            shard& s = m_shards[n];
+            write_guard guard(s);
+            for (table* t : {&s.current, &s.previous}) {
+                for (size_type i = 0; i < t->capacity(); ++i) {
+                    if (is_full(t->ctrl[i]) && pred(std::as_const(t->at(i)))) {
+                        t->destroy(i);
+                        s.size.fetch_sub(1, std::memory_order_relaxed);
+                        ++erased;
+                    }
+                }
+            }
+        }
+        return erased;
+    }
+
+    /**
+     *  @brief  Run f on every entry, locking one shard at a time.
+     *  Entries inserted or erased in other shards meanwhile may or may not be seen.
+     *  @param  f  Callable taking value_type&.
+     *  @return void.
+     */
+    template <typename F>
+    void visit_all(F f) {
+        for (size_type n = 0; n <= m_shard_mask; ++n) {
+            shard& s = m_shards[n];
+            write_guard guard(s);
+            for (table* t : {&s.current, &s.previous}) {
+                for (size_type i = 0; i < t->capacity(); ++i) {
+                    if (is_full(t->ctrl[i])) update(t->at(i), f);
+                }
+            }
+        }
+    }
+
+    template <typename F>
+    void cvisit_all(F f) const {
+        for (size_type n = 0; n <= m_shard_mask; ++n) {
+            const shard& s = m_shards[n];
+            std::shared_lock<std::shared_mutex> lock(s.lock);
+            for (const table* t : {&s.current, &s.previous}) {
+                for (size_type i = 0; i < t->capacity(); ++i) {
+                    if (is_full(t->ctrl[i])) f(t->at(i));
+                }
+            }
+        }
+    }
+
+    /**
+     *  @brief  Erase all entries, keeping the tables.
+     *  @return void.
+     */
+    void clear() {
+        for (size_type n = 0; n <= m_shard_mask; ++n) {
+            shard& s = m_shards[n];
+            write_guard guard(s);
+            s.current.destroy_all();
+            if (s.previous.capacity()) {
+                s.previous.destroy_all();
+                release_previous(s);
+            }
+            s.size.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     *  @brief  Size every shard for n entries spread evenly, rehashing now rather than incrementally.
+     *  @param  n  The number of entries.
+     *  @return void.
+     */
+    void reserve(size_type n) {
+        const size_type per_shard = (n + m_shard_mask) / (m_shard_mask + 1);
+        const size_type capacity = std::bit_ceil(std::max(MIN_CAPACITY, per_shard * MAX_LOAD_DEN / MAX_LOAD_NUM + 1));
+        for (size_type i = 0; i <= m_shard_mask; ++i) {
+            shard& s = m_shards[i];
+            write_guard guard(s);
+            if (s.current.capacity() >= capacity) continue;
+            start_resize(s, capacity);
+            migrate(s, s.previous.capacity());
+        }
+    }
+
+    /**
+     *  @brief  Number of entries. Exact only while no writer is running.
+     *  @return the size.
+     */
+    size_type size() const {
+        size_type total = 0;
+        for (size_type i = 0; i <= m_shard_mask; ++i) total += m_shards[i].size.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    bool empty() const { return size() == 0; }
+    size_type shard_count() const { return m_shard_mask + 1; }
+
+private:
+    static constexpr std::uint8_t EMPTY = 0;
+    static constexpr std::uint8_t TOMBSTONE = 1;
+    static constexpr size_type NPOS = size_type(-1);
+    static constexpr unsigned SHARD_SHIFT = 40; // buckets use the low bits, control bytes the top 7
+
+    enum class lookup { found, missing, contended };
+
+    // slots are whole words so optimistic readers and writers can copy them with word sized atomics
+    static constexpr size_type SLOT_WORDS = (sizeof(value_type) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    struct alignas(std::max(alignof(value_type), alignof(std::uint64_t))) slot {
+        unsigned char bytes[SLOT_WORDS * sizeof(std::uint64_t)];
+    };
+
+    struct table {
+        std2::vector<std::uint8_t> ctrl;
+        std2::vector<slot> slots;
+        size_type count = 0; // live entries
+        size_type used = 0;  // live entries plus tombstones
+
+        size_type capacity() const { return ctrl.size(); }
+
+        value_type& at(size_type i) { return *std::launder(reinterpret_cast<value_type*>(slots.data()[i].bytes)); }
+
+        const value_type& at(size_type i) const {
+            return *std::launder(reinterpret_cast<const value_type*>(slots.data()[i].bytes));
+        }
+
+        void destroy(size_type i) {
+            at(i).~value_type();
+            store_ctrl(ctrl.data(), i, TOMBSTONE);
+            --count;
+        }
+
+        void destroy_all() {
+            for (size_type i = 0; i < capacity(); ++i) {
+                if (is_full(ctrl[i])) at(i).~value_type();
+                store_ctrl(ctrl.data(), i, EMPTY);
+            }
+            count = used = 0;
+        }
+    };
+
+    // where one table's arrays live, as an optimistic reader probes them
+    struct table_view {
+        const std::uint8_t* ctrl = nullptr;
+        const slot* slots = nullptr;
+        size_type capacity = 0;
+    };
+
+    // the tables of a shard, published as a whole and never modified afterwards
+    struct snapshot {
+        table_view current;
+        table_view previous;
+    };
+
+    // a snapshot that was replaced and the epoch it was retired in
+    struct retired_snapshot {
+        std::unique_ptr<const snapshot> tables;
+        std::uint64_t retired = 0;
+    };
+
+    // a drained table and the epoch it was retired in
+    struct spare_table {
+        table t;
+        std::uint64_t retired = 0;
+    };
+
+    struct alignas(64) shard {
+        ~shard() {
+            current.destroy_all();
+            previous.destroy_all();
+        }
+
+        mutable std::shared_mutex lock;
+        std::atomic<std::uint64_t> seq{0}; // odd while a writer is inside
+        std::atomic<size_type> size{0};
+        table current;
+        table previous;           // draining into current, capacity 0 when no resize is running
+        size_type cursor = 0;     // next bucket of previous to migrate
+        std::atomic<const snapshot*> published{nullptr}; // what optimistic readers probe, null while empty
+        std::unique_ptr<const snapshot> live;            // owns published
+        std2::vector<retired_snapshot> retired;          // replaced snapshots readers may still hold
+        std2::vector<spare_table> spare; // drained tables, optimistic readers may still be probing them
+    };
+
+    /* @brief  Marks the calling thread as an optimistic reader while it may be probing tables. */
+    class read_guard {
+    public:
+        read_guard() : m_slot(hash_map_detail::epoch_domain::instance().local()) {
+            hash_map_detail::epoch_domain::instance().enter(m_slot);
+        }
+
+        ~read_guard() { hash_map_detail::epoch_domain::instance().exit(m_slot); }
+
+    private:
+        hash_map_detail::epoch_domain::reader_slot& m_slot;
+    };
+
+    /* @brief  Exclusive lock on a shard that also keeps its sequence counter odd while held. */
+    class write_guard {
+    public:
+        explicit write_guard(shard& s) : m_shard(s), m_lock(s.lock) {
+            m_shard.seq.store(m_shard.seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        ~write_guard() {
+            m_shard.seq.store(m_shard.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+    private:
+        shard& m_shard;
+        std::unique_lock<std::shared_mutex> m_lock;
+    };
+
+    static bool is_full(std::uint8_t c) { return c & 0x80; }
+    static std::uint8_t fragment(std::uint64_t h) { return static_cast<std::uint8_t>(0x80 | (h >> 57)); }
+
+    std::uint64_t hash_of(const Key& key) const {
+        // murmur3 finalizer, std::hash of an integer is the identity
+        std::uint64_t h = static_cast<std::uint64_t>(m_hash(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    shard& shard_for(std::uint64_t h) { return m_shards[(h >> SHARD_SHIFT) & m_shard_mask]; }
+    const shard& shard_for(std::uint64_t h) const { return m_shards[(h >> SHARD_SHIFT) & m_shard_mask]; }
+
+    static table_view view_of(const table& t) { return { t.ctrl.data(), t.slots.data(), t.capacity() }; }
+
+    // Every control byte and slot word an optimistic reader may load concurrently is stored
+    // through atomic_ref. Accesses under the shard's lock that only read may stay plain.
+    static void store_ctrl(std::uint8_t* ctrl, size_type i, std::uint8_t c) {
+        std::atomic_ref<std::uint8_t>(ctrl[i]).store(c, std::memory_order_relaxed);
+    }
+
+    static std::uint8_t load_ctrl(const std::uint8_t* ctrl, size_type i) {
+        return std::atomic_ref<std::uint8_t>(const_cast<std::uint8_t&>(ctrl[i])).load(std::memory_order_relaxed);
+    }
+
+    static void store_slot(unsigned char* to, const unsigned char* from) {
+        for (size_type w = 0; w < SLOT_WORDS; ++w) {
+            std::uint64_t word;
+            std::memcpy(&word, from + w * sizeof(word), sizeof(word));
+            std::atomic_ref<std::uint64_t>(reinterpret_cast<std::uint64_t*>(to)[w]).store(word, std::memory_order_relaxed);
+        }
+    }
+
+    static void load_slot(unsigned char* to, const unsigned char* from) {
+        for (size_type w = 0; w < SLOT_WORDS; ++w) {
+            std::uint64_t& source = const_cast<std::uint64_t*>(reinterpret_cast<const std::uint64_t*>(from))[w];
+            const std::uint64_t word = std::atomic_ref<std::uint64_t>(source).load(std::memory_order_relaxed);
+            std::memcpy(to + w * sizeof(word), &word, sizeof(word));
+        }
+    }
+
+    /* @brief  Run f on an entry under the shard's exclusive lock.
+     * With OPTIMISTIC_READS f works on a copy that is stored back word by word, so readers never see a plain write.
+     */
+    template <typename F>
+    static void update(value_type& entry, F& f) {
+        if constexpr (OPTIMISTIC_READS) {
+            unsigned char* where = reinterpret_cast<unsigned char*>(&entry);
+            slot copy;
+            std::memcpy(copy.bytes, where, sizeof(slot));
+            f(*std::launder(reinterpret_cast<value_type*>(copy.bytes)));
+            store_slot(where, copy.bytes);
+        } else {
+            f(entry);
+        }
+    }
+
+    static bool unchanged(const shard& s, std::uint64_t before) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return s.seq.load(std::memory_order_relaxed) == before;
+    }
+
+    /* @brief  Seqlock lookup inside an epoch, copying the entry out. The callback runs outside the epoch.
+     * @return contended if writers kept the shard busy for every attempt.
+     */
+    lookup find_optimistic(const shard& s, const Key& key, std::uint64_t h, slot& copy) const {
+        read_guard reading;
+        for (size_type attempt = 0; attempt < OPTIMISTIC_ATTEMPTS; ++attempt) {
+            const std::uint64_t before = s.seq.load(std::memory_order_acquire);
+            if (before & 1) continue; // a writer is inside
+            const snapshot* tables = s.published.load(std::memory_order_acquire);
+            if (!tables) return unchanged(s, before) ? lookup::missing : lookup::contended;
+            const bool found = probe_copy(tables->current, key, h, copy) || probe_copy(tables->previous, key, h, copy);
+            if (!unchanged(s, before)) continue;
+            return found ? lookup::found : lookup::missing;
+        }
+        return lookup::contended;
+    }
+
+    /* @brief  Probe a published table, copying the matching entry out. The copy may be torn until validated. */
+    bool probe_copy(const table_view& t, const Key& key, std::uint64_t h, slot& out) const {
+        if (t.capacity == 0) return false;
+        const size_type mask = t.capacity - 1;
+        const std::uint8_t tag = fragment(h);
+        for (size_type i = h & mask, probes = 0; probes <= mask; i = (i + 1) & mask, ++probes) {
+            const std::uint8_t c = load_ctrl(t.ctrl, i);
+            if (c == EMPTY) return false;
+            if (c != tag) continue;
+            load_slot(out.bytes, t.slots[i].bytes);
+            if (m_equal(std::launder(reinterpret_cast<const value_type*>(out.bytes))->first, key)) return true;
+        }
+        return false;
+    }
+
+    size_type find_index(const table& t, const Key& key, std::uint64_t h) const {
+        if (t.capacity() == 0) return NPOS;
+        const size_type mask = t.capacity() - 1;
+        const std::uint8_t tag = fragment(h);
+        const std::uint8_t* ctrl = t.ctrl.data();
+        for (size_type i = h & mask, probes = 0; probes <= mask; i = (i + 1) & mask, ++probes) {
+            if (ctrl[i] == EMPTY) return NPOS;
+            if (ctrl[i] == tag && m_equal(t.at(i).first, key)) return i;
+        }
+        return NPOS;
+    }
+
+    static size_type free_index(const table& t, std::uint64_t h) {
+        const size_type mask = t.capacity() - 1;
+        const std::uint8_t* ctrl = t.ctrl.data();
+        size_type i = h & mask;
+        while (is_full(ctrl[i])) i = (i + 1) & mask;
+        return i;
+    }
+
+    const value_type* find_locked(const shard& s, const Key& key, std::uint64_t h) const {
+        for (const table* t : {&s.current, &s.previous}) {
+            const size_type i = find_index(*t, key, h);
+            if (i != NPOS) return &t->at(i);
+        }
+        return nullptr;
+    }
+
+    value_type* find_locked(shard& s, const Key& key, std::uint64_t h) {
+        return const_cast<value_type*>(std::as_const(*this).find_locked(std::as_const(s), key, h));
+    }
+
+    /* @brief  Construct an entry in a free bucket of t, which must have room. */
+    template <typename... Args>
+    static void place(table& t, std::uint64_t h, Args&&... args) {
+        const size_type i = free_index(t, h);
+        if constexpr (OPTIMISTIC_READS) {
+            // built aside and stored word by word, a reader may be copying this bucket
+            slot built{};
+            new (built.bytes) value_type(std2::forward<Args>(args)...);
+            store_slot(t.slots.data()[i].bytes, built.bytes);
+        } else {
+            new (t.slots.data()[i].bytes) value_type(std2::forward<Args>(args)...);
+        }
+        if (t.ctrl[i] == EMPTY) ++t.used;
+        store_ctrl(t.ctrl.data(), i, fragment(h));
+        ++t.count;
+    }
+
+    template <typename F, typename... Args>
+    bool emplace_or_visit(const Key& key, F f, Args&&... args) {
+        const std::uint64_t h = hash_of(key);
+        shard& s = shard_for(h);
+        write_guard guard(s);
+        migrate(s, MIGRATE_STEP);
+        if (value_type* entry = find_locked(s, key, h)) {
+            update(*entry, f);
+            return false;
+        }
+        make_room(s);
+        place(s.current, h, std::piecewise_construct, std::forward_as_tuple(key),
+              std::forward_as_tuple(std2::forward<Args>(args)...));
+        s.size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /* @brief  Start a resize if one more entry would push current past the load limit. */
+    void make_room(shard& s) {
+        // everything still in previous is headed for current, so it counts against current's load
+        const table& t = s.current;
+        if ((t.used + s.previous.count + 1) * MAX_LOAD_DEN <= t.capacity() * MAX_LOAD_NUM) return;
+        const size_type live = t.count + s.previous.count;
+        // mostly tombstones: rebuild at the same size, otherwise double
+        start_resize(s, live * 2 < t.capacity() ? t.capacity() : std::max(MIN_CAPACITY, t.capacity() * 2));
+    }
+
+    /* @brief  Make current a fresh table of the given capacity and start draining the old one into it. */
+    void start_resize(shard& s, size_type capacity) {
+        migrate(s, s.previous.capacity()); // finish a resize still running
+        s.previous = std2::move(s.current);
+        s.current = acquire_table(s, capacity);
+        s.cursor = 0;
+        if (s.previous.count == 0) release_previous(s);
+        else publish(s);
+    }
+
+    /* @brief  Move up to n buckets of previous into current, releasing previous once it is empty. */
+    void migrate(shard& s, size_type n) {
+        table& from = s.previous;
+        if (from.capacity() == 0) return;
+        const size_type end = std::min(from.capacity(), s.cursor + n);
+        for (; s.cursor < end && from.count; ++s.cursor) {
+            if (!is_full(from.ctrl[s.cursor])) continue;
+            value_type& entry = from.at(s.cursor);
+            place(s.current, hash_of(entry.first), std2::move(entry));
+            from.destroy(s.cursor);
+        }
+        if (s.cursor == from.capacity() || from.count == 0) release_previous(s);
+    }
+
+    table acquire_table(shard& s, size_type capacity) {
+        // a spare may still be probed by a reader, but its memory stays valid and the seqlock rejects what it reads
+        for (size_type i = 0; i < s.spare.size(); ++i) {
+            if (s.spare[i].t.capacity() != capacity) continue;
+            table t = std2::move(s.spare[i].t);
+            if (i + 1 != s.spare.size()) s.spare[i] = std2::move(s.spare[s.spare.size() - 1]);
+            s.spare.pop_back();
+            return t;
+        }
+        table t;
+        t.ctrl.resize(capacity);
+        t.slots.resize(capacity);
+        return t;
+    }
+
+    /* @brief  Publish the shard's current tables to optimistic readers and retire the snapshot they replace.
+     * @return the epoch the replaced snapshot was retired in, anything unlinked by this publish is tagged with it.
+     */
+    std::uint64_t publish(shard& s) {
+        if constexpr (OPTIMISTIC_READS) {
+            auto next = std::make_unique<const snapshot>(snapshot{ view_of(s.current), view_of(s.previous) });
+            s.published.store(next.get(), std::memory_order_release);
+            std::unique_ptr<const snapshot> replaced = std2::exchange(s.live, std2::move(next));
+            // tagged once unlinked, so readers entering later cannot reach it
+            const std::uint64_t retired = hash_map_detail::epoch_domain::instance().retire();
+            if (replaced) s.retired.push_back(retired_snapshot{ std2::move(replaced), retired });
+            return retired;
+        } else {
+            return 0;
+        }
+    }
+
+    /* @brief  Retire the drained previous table: freed for locked readers, kept as a spare for optimistic ones. */
+    void release_previous(shard& s) {
+        if constexpr (OPTIMISTIC_READS) {
+            for (size_type i = 0; i < s.previous.capacity(); ++i) store_ctrl(s.previous.ctrl.data(), i, EMPTY);
+            s.previous.count = s.previous.used = 0;
+            table drained = std2::move(s.previous);
+            s.previous = table();
+            const std::uint64_t retired = publish(s);
+            s.spare.push_back(spare_table{ std2::move(drained), retired });
+            trim_spares(s);
+        } else {
+            s.previous = table();
+        }
+        s.cursor = 0;
+    }
+
+    /* @brief  Free the snapshots and spares no optimistic reader can reach, keeping one spare of the current capacity. */
+    void trim_spares(shard& s) {
+        const std::uint64_t oldest = hash_map_detail::epoch_domain::instance().oldest_active();
+        for (size_type i = 0; i < s.retired.size();) {
+            if (s.retired[i].retired >= oldest) {
+                ++i;
+                continue;
+            }
+            if (i + 1 != s.retired.size()) s.retired[i] = std2::move(s.retired[s.retired.size() - 1]);
+            s.retired.pop_back();
+        }
+        bool kept = false;
+        for (size_type i = 0; i < s.spare.size();) {
+            if (!kept && s.spare[i].t.capacity() == s.current.capacity()) {
+                kept = true;
+                ++i;
+                continue;
+            }
+            if (s.spare[i].retired >= oldest) {
+                ++i;
+                continue;
+            }
+            if (i + 1 != s.spare.size()) s.spare[i] = std2::move(s.spare[s.spare.size() - 1]);
+            s.spare.pop_back();
+        }
+    }
+
+    size_type m_shard_mask;
+    std::unique_ptr<shard[]> m_shards;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_equal;
+};
+
+} // namespace std2
+
+#endif // CONCURRENT_HASH_MAP_HPP
@@ -0,0 +1,267 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/concurrent_hash_map.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class ConcurrentHashMapTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    // both halves are always written together, a torn read shows up as a mismatch
+    struct pair_value {
+        std::uint64_t low;
+        std::uint64_t high;
+    };
+};
+
+// Test the single threaded interface
+TEST_F(ConcurrentHashMapTest, SingleThreaded) {
+    std2::concurrent_hash_map<int, int> map(3);
+    EXPECT_EQ(map.shard_count(), 4);
+    EXPECT_TRUE(map.empty());
+
+    EXPECT_TRUE(map.insert({1, 10}));
+    EXPECT_FALSE(map.insert({1, 11}));
+    EXPECT_TRUE(map.try_emplace(2, 20));
+    EXPECT_FALSE(map.insert_or_assign(2, 21));
+    EXPECT_TRUE(map.insert_or_assign(3, 30));
+    EXPECT_EQ(map.size(), 3);
+
+    EXPECT_EQ(map.get(1), 10);
+    EXPECT_EQ(map.get(2), 21);
+    EXPECT_EQ(map.get(4), std::nullopt);
+    EXPECT_TRUE(map.contains(3));
+    EXPECT_EQ(map.count(4), 0);
+
+    EXPECT_FALSE(map.insert_or_visit({3, 0}, [](auto& entry) { entry.second += 5; }));
+    EXPECT_EQ(map.get(3), 35);
+    EXPECT_TRUE(map.visit(1, [](auto& entry) { entry.second = -1; }));
+    EXPECT_FALSE(map.visit(9, [](auto&) { FAIL(); }));
+
+    int seen = 0;
+    EXPECT_TRUE(map.cvisit(1, [&seen](const auto& entry) { seen = entry.second; }));
+    EXPECT_EQ(seen, -1);
+
+    EXPECT_EQ(map.erase(1), 1);
+    EXPECT_EQ(map.erase(1), 0);
+    EXPECT_FALSE(map.contains(1));
+    EXPECT_EQ(map.size(), 2);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(2));
+    EXPECT_TRUE(map.insert({2, 2}));
+}
+
+// Test entries survive incremental resizes, tombstone rebuilds and reserve
+TEST_F(ConcurrentHashMapTest, IncrementalResize) {
+    std2::concurrent_hash_map<std::uint64_t, std::uint64_t> map(4);
+    for (std::uint64_t i = 0; i < 100000; ++i) {
+        ASSERT_TRUE(map.try_emplace(i, i * 7));
+        // erase as we go so lookups also cross tables that are mid-migration
+        if (i % 3 == 0) {
+            ASSERT_EQ(map.erase(i / 3), 1);
+        }
+    }
+    for (std::uint64_t i = 0; i < 100000; ++i) {
+        const bool erased = i < 100000 / 3 + 1;
+        ASSERT_EQ(map.contains(i), !erased) << i;
+        if (!erased) {
+            ASSERT_EQ(map.get(i), i * 7);
+        }
+    }
+
+    // steady churn at a fixed size reuses tables instead of growing
+    for (std::uint64_t round = 0; round < 5; ++round) {
+        for (std::uint64_t i = 0; i < 50000; ++i) map.erase(i + round * 50000);
+        for (std::uint64_t i = 0; i < 50000; ++i) map.try_emplace(i + (round + 1) * 50000, i);
+    }
+    std::size_t total = 0;
+    map.cvisit_all([&total](const auto&) { ++total; });
+    EXPECT_EQ(total, map.size());
+
+    std2::concurrent_hash_map<int, int> reserved;
+    reserved.reserve(100000);
+    for (int i = 0; i < 100000; ++i) reserved.try_emplace(i, i);
+    EXPECT_EQ(reserved.size(), 100000);
+    EXPECT_EQ(reserved.get(99999), 99999);
+}
+
+// Test non trivially copyable entries, which are read under the shard lock
+TEST_F(ConcurrentHashMapTest, StringEntries) {
+    static_assert(!std2::concurrent_hash_map<std::string, std::string>::OPTIMISTIC_READS);
+    std2::concurrent_hash_map<std::string, std::string> map;
+    for (int i = 0; i < 5000; ++i) map.try_emplace("key" + std::to_string(i), std::string(i % 40, 'v'));
+    EXPECT_EQ(map.get("key39"), std::string(39, 'v'));
+    EXPECT_EQ(map.erase_if([](const auto& entry) { return entry.second.size() < 20; }), 2500);
+    EXPECT_FALSE(map.contains("key0"));
+    EXPECT_TRUE(map.contains("key20"));
+
+    map.visit_all([](auto& entry) { entry.second = entry.first; });
+    EXPECT_EQ(map.get("key20"), "key20");
+}
+
+// Test counting through insert_or_visit from many threads loses no update
+TEST_F(ConcurrentHashMapTest, ConcurrentCounters) {
+    std2::concurrent_hash_map<int, long> map(8);
+    const int threads = 8;
+    const int per_thread = 20000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&map, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                const int key = (i * 31 + t) % 1000;
+                map.insert_or_visit({key, 1}, [](auto& entry) { ++entry.second; });
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    long total = 0;
+    map.cvisit_all([&total](const auto& entry) { total += entry.second; });
+    EXPECT_EQ(total, long(threads) * per_thread);
+    EXPECT_EQ(map.size(), 1000);
+}
+
+// Test lock-free readers never see a half written value while writers resize, update, erase and clear
+TEST_F(ConcurrentHashMapTest, ConcurrentReadersAndWriters) {
+    static_assert(std2::concurrent_hash_map<std::uint64_t, pair_value>::OPTIMISTIC_READS);
+    std2::concurrent_hash_map<std::uint64_t, pair_value> map(4);
+    std::atomic<bool> done{false};
+    std::atomic<long> torn{0}, hits{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&, r] {
+            std::mt19937_64 rng(r);
+            while (!done.load(std::memory_order_relaxed)) {
+                const std::uint64_t key = rng() % 20000;
+                map.cvisit(key, [&](const auto& entry) {
+                    if (entry.first != key || entry.second.low != entry.second.high) ++torn;
+                    ++hits;
+                });
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 2; ++w) {
+        writers.emplace_back([&, w] {
+            std::mt19937_64 rng(100 + w);
+            for (int i = 0; i < 100000; ++i) {
+                const std::uint64_t key = rng() % 20000;
+                const std::uint64_t stamp = rng();
+                if (i % 4 == 3) map.erase(key);
+                else if (i % 4 == 2) map.visit(key, [](auto& entry) { ++entry.second.low; ++entry.second.high; });
+                else map.insert_or_assign(key, pair_value{stamp, stamp});
+                if (w == 0 && i % 25000 == 24999) map.clear();
+            }
+        });
+    }
+    for (auto& writer : writers) writer.join();
+    done = true;
+    for (auto& reader : readers) reader.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_GT(hits.load(), 0);
+    std::size_t total = 0;
+    map.cvisit_all([&total](const auto& entry) {
+        EXPECT_EQ(entry.second.low, entry.second.high);
+        ++total;
+    });
+    EXPECT_EQ(total, map.size());
+}
+
+// Throughput of read-heavy and write-heavy mixes against one std::unordered_map behind a shared_mutex
+TEST_F(ConcurrentHashMapTest, PerformanceBenchmark) {
+    const std::uint64_t keys = 1 << 18;
+    const int ops_per_thread = 400000;
+
+    auto time = [](auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        body();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+    // run body(thread index) on n threads and report the wall time
+    auto run = [&time](int n, auto body) {
+        return time([&] {
+            std::vector<std::thread> workers;
+            for (int t = 0; t < n; ++t) workers.emplace_back(body, t);
+            for (auto& worker : workers) worker.join();
+        });
+    };
+
+    std::cout << keys << " keys, " << ops_per_thread << " ops per thread, "
+              << std::thread::hardware_concurrency() << " hardware threads\n";
+    for (int write_percent : {5, 50}) {
+        for (int threads : {1, 2, 4, 8}) {
+            std2::concurrent_hash_map<std::uint64_t, std::uint64_t> map;
+            std::unordered_map<std::uint64_t, std::uint64_t> locked_map;
+            std::shared_mutex global;
+            for (std::uint64_t k = 0; k < keys; k += 2) {
+                map.try_emplace(k, k);
+                locked_map.emplace(k, k);
+            }
+            std::atomic<std::uint64_t> map_sum{0}, locked_sum{0};
+
+            const auto locked_time = run(threads, [&](int t) {
+                std::mt19937_64 rng(t);
+                std::uint64_t sum = 0;
+                for (int i = 0; i < ops_per_thread; ++i) {
+                    const std::uint64_t key = rng() % keys;
+                    if (int(rng() % 100) < write_percent) {
+                        std::unique_lock<std::shared_mutex> lock(global);
+                        if (key & 1) locked_map.erase(key ^ 1);
+                        else locked_map.insert_or_assign(key, key);
+                    } else {
+                        std::shared_lock<std::shared_mutex> lock(global);
+                        auto it = locked_map.find(key);
+                        if (it != locked_map.end()) sum += it->second;
+                    }
+                }
+                locked_sum += sum;
+            });
+            const auto map_time = run(threads, [&](int t) {
+                std::mt19937_64 rng(t);
+                std::uint64_t sum = 0;
+                for (int i = 0; i < ops_per_thread; ++i) {
+                    const std::uint64_t key = rng() % keys;
+                    if (int(rng() % 100) < write_percent) {
+                        if (key & 1) map.erase(key ^ 1);
+                        else map.insert_or_assign(key, key);
+                    } else {
+                        map.cvisit(key, [&sum](const auto& entry) { sum += entry.second; });
+                    }
+                }
+                map_sum += sum;
+            });
+
+            // with one thread the two runs see the same operations in the same order
+            if (threads == 1) {
+                EXPECT_EQ(map_sum.load(), locked_sum.load());
+                EXPECT_EQ(map.size(), locked_map.size());
+            }
+            const double total_ops = double(threads) * ops_per_thread;
+            std::cout << "  " << write_percent << "% writes, " << threads << " threads: "
+                      << "unordered_map + shared_mutex " << total_ops / locked_time << " Mops/s, "
+                      << "std2::concurrent_hash_map " << total_ops / map_time << " Mops/s\n";
+        }
+    }
+}
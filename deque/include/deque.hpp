@@ -0,0 +1,386 @@
+#ifndef DEQUE_HPP
+#define DEQUE_HPP
+
+#include <algorithm> // for std::copy, std::copy_backward, std::fill
+#include <cstddef>   // for std::size_t, std::ptrdiff_t
+#include <initializer_list>
+#include <iterator>  // for std::random_access_iterator_tag
+#include <memory>    // for std::allocator, std::allocator_traits
+#include <stdexcept> // for std::out_of_range
+#include <type_traits> // for std::conditional_t
+#include "../../std2/std2.hpp" // for std2::move, std2::forward
+
+namespace std2 {
+
+/*
+ * Segmented double-ended queue.
+ * Elements live in fixed-size blocks that are never moved once allocated,
+ * a separate "map" of block pointers is the only thing that gets reallocated.
+ * This gives O(1) push/pop at both ends, O(1) random access and stable
+ * references to existing elements when inserting at either end.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class deque {
+    template <bool IsConst> class basic_iterator;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // number of elements per block - roughly 4KiB worth, but at least 16
+    static constexpr std::size_t BLOCK_SIZE = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+
+    deque() : m_alloc(Allocator()), m_map_alloc(m_alloc) {}
+
+    explicit deque(const Allocator& alloc) : m_alloc(alloc), m_map_alloc(m_alloc) {}
+
+    deque(std::initializer_list<T> init, const Allocator& alloc = Allocator()) : deque(alloc) {
+        for (const auto& value : init) {
+            push_back(value);
+        }
+    }
+
+    deque(const deque& other) : deque(other.m_alloc) {
+        for (std::size_t i = 0; i < other.m_size; ++i) {
+            push_back(other[i]);
+        }
+    }
+
+    deque(deque&& other) noexcept
+        : m_map(std2::exchange(other.m_map, nullptr)),
+        m_map_capacity(std2::exchange(other.m_map_capacity, std::size_t(0))),
+        m_begin(std2::exchange(other.m_begin, std::size_t(0))),
+        m_size(std2::exchange(other.m_size, std::size_t(0))),
+        m_spare(std2::exchange(other.m_spare, nullptr)),
+        m_alloc(std2::move(other.m_alloc)),
+        m_map_alloc(std2::move(other.m_map_alloc))
+    {}
+
+    deque& operator=(deque other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~deque() {
+        clear();
+        if (m_spare) m_alloc.deallocate(m_spare, BLOCK_SIZE);
+        if (m_map) m_map_alloc.deallocate(m_map, m_map_capacity);
+    }
+
+    /**
+     *  @brief  Add an element to the end of the deque.
+     *  @param  value  The value to add.
+     *  @return void.
+     */
+    void push_back(const T& value) { emplace_back(value); }
+
+    /**
+     *  @brief  Add an element to the end of the deque.
+     *  @param  value  The (R-value ref) value to add.
+     *  @return void.
+     */
+    void push_back(T&& value) { emplace_back(std2::move(value)); }
+
+    /**
+     *  @brief  Add an element to the front of the deque.
+     *  @param  value  The value to add.
+     *  @return void.
+     */
+    void push_front(const T& value) { emplace_front(value); }
+
+    /**
+     *  @brief  Add an element to the front of the deque.
+     *  @param  value  The (R-value ref) value to add.
+     *  @return void.
+     */
+    void push_front(T&& value) { emplace_front(std2::move(value)); }
+
+    /**
+     *  @brief  Construct an element in place at the end of the deque.
+     *  @param  args  Arguments to forward to the constructor of T.
+     *  @return T reference.
+     */
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (m_begin + m_size == m_map_capacity * BLOCK_SIZE) make_room(false);
+
+        T* slot = construct_at(m_begin + m_size, std2::forward<Args>(args)...);
+        ++m_size;
+        return *slot;
+    }
+
+    /**
+     *  @brief  Construct an element in place at the front of the deque.
+     *  @param  args  Arguments to forward to the constructor of T.
+     *  @return T reference.
+     */
+    template <typename... Args>
+    T& emplace_front(Args&&... args) {
+        if (m_begin == 0) make_room(true);
+
+        const std::size_t pos = m_begin - 1;
+        T* slot = construct_at(pos, std2::forward<Args>(args)...);
+        m_begin = pos;
+        ++m_size;
+        return *slot;
+    }
+
+    /**
+     *  @brief  Remove the last element from the deque.
+     *  @return void.
+     */
+    void pop_back() {
+        if (m_size == 0) return;
+
+        const std::size_t pos = m_begin + m_size - 1;
+        element_at(pos).~T();
+        --m_size;
+
+        // release the block once nothing lives in it anymore
+        if (m_size == 0 || pos % BLOCK_SIZE == 0) release_block(pos / BLOCK_SIZE);
+        if (m_size == 0) recenter_empty();
+    }
+
+    /**
+     *  @brief  Remove the first element from the deque.
+     *  @return void.
+     */
+    void pop_front() {
+        if (m_size == 0) return;
+
+        const std::size_t pos = m_begin;
+        element_at(pos).~T();
+        ++m_begin;
+        --m_size;
+
+        if (m_size == 0 || m_begin % BLOCK_SIZE == 0) release_block(pos / BLOCK_SIZE);
+        if (m_size == 0) recenter_empty();
+    }
+
+    /**
+     *  @brief  Clear the deque - remove all elements and release their blocks.
+     *  @return void.
+     */
+    void clear() {
+        for (std::size_t i = 0; i < m_size; ++i) {
+            element_at(m_begin + i).~T();
+        }
+        for (std::size_t b = 0; b < m_map_capacity; ++b) {
+            if (m_map[b]) release_block(b);
+        }
+        m_size = 0;
+        recenter_empty();
+    }
+
+    /**
+     *  @brief  Index operator - access element at the given index.
+     *  @param  index  The index of the element to access.
+     *  @return the reference to the value at the index.
+     */
+    T& operator[](std::size_t index) { return element_at(m_begin + index); }
+
+    /**
+     *  @brief  Index operator - access element at the given index.
+     *  @param  index  The index of the element to access.
+     *  @return the value at the index.
+     */
+    const T& operator[](std::size_t index) const { return element_at(m_begin + index); }
+
+    /**
+     *  @brief  Bounds checked access to the element at the given index.
+     *  @param  index  The index of the element to access.
+     *  @return the reference to the value at the index.
+     */
+    T& at(std::size_t index) {
+        if (index >= m_size) throw std::out_of_range("std2::deque::at");
+        return (*this)[index];
+    }
+
+    const T& at(std::size_t index) const {
+        if (index >= m_size) throw std::out_of_range("std2::deque::at");
+        return (*this)[index];
+    }
+
+    T& front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+    T& back() { return (*this)[m_size - 1]; }
+    const T& back() const { return (*this)[m_size - 1]; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, m_size); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    /**
+     *  @brief  Get the number of elements in the deque.
+     *  @return the number of elements in the deque.
+     */
+    std::size_t size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    void swap(deque& other) noexcept {
+        std::swap(m_map, other.m_map);
+        std::swap(m_map_capacity, other.m_map_capacity);
+        std::swap(m_begin, other.m_begin);
+        std::swap(m_size, other.m_size);
+        std::swap(m_spare, other.m_spare);
+        std::swap(m_alloc, other.m_alloc);
+        std::swap(m_map_alloc, other.m_map_alloc);
+    }
+
+private:
+    using map_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T*>;
+
+    static constexpr std::size_t INITIAL_MAP_CAPACITY = 8;
+
+    T& element_at(std::size_t pos) const {
+        return m_map[pos / BLOCK_SIZE][pos % BLOCK_SIZE];
+    }
+
+    /* @brief  Get the block holding the absolute position, allocating it if needed.
+     * @param  pos  Absolute position inside the map.
+     * @return pointer to the start of the block.
+     */
+    T* block_for(std::size_t pos) {
+        T*& block = m_map[pos / BLOCK_SIZE];
+        if (!block) {
+            block = m_spare ? std2::exchange(m_spare, nullptr) : m_alloc.allocate(BLOCK_SIZE);
+        }
+        return block;
+    }
+
+    /* @brief  Construct an element at an absolute position just outside the used range.
+     *         A block taken for it is given back if the constructor throws, otherwise
+     *         make_room would later drop it with the unused map slots.
+     * @param  pos  Absolute position inside the map.
+     * @param  args  Arguments to forward to the constructor of T.
+     * @return pointer to the new element.
+     */
+    template <typename... Args>
+    T* construct_at(std::size_t pos, Args&&... args) {
+        const bool fresh = !m_map[pos / BLOCK_SIZE];
+        T* slot = block_for(pos) + pos % BLOCK_SIZE;
+        try {
+            new (slot) T(std2::forward<Args>(args)...);
+        } catch (...) {
+            if (fresh) release_block(pos / BLOCK_SIZE);
+            throw;
+        }
+        return slot;
+    }
+
+    /* @brief  Give a block back - keeps one spare block around so a deque
+     *         used as a FIFO queue does not allocate on every block boundary.
+     * @param  index  Index of the block in the map.
+     * @return void.
+     */
+    void release_block(std::size_t index) {
+        T* block = std2::exchange(m_map[index], nullptr);
+        if (!m_spare) m_spare = block;
+        else m_alloc.deallocate(block, BLOCK_SIZE);
+    }
+
+    void recenter_empty() {
+        m_begin = (m_map_capacity / 2) * BLOCK_SIZE;
+    }
+
+    /* @brief  Make room for one more block at the front or the back of the map.
+     *         Only block pointers are moved, so element addresses stay stable.
+     * @param  at_front  True if the free slot is needed in front of the first block.
+     * @return void.
+     */
+    void make_room(bool at_front) {
+        const std::size_t first_block = m_begin / BLOCK_SIZE;
+        const std::size_t used_blocks = m_size ? (m_begin + m_size - 1) / BLOCK_SIZE - first_block + 1 : 0;
+        const std::size_t needed = used_blocks + 1;
+        const std::size_t offset = m_size ? m_begin % BLOCK_SIZE : 0;
+
+        if (m_map && 2 * needed < m_map_capacity) {
+            // plenty of free slots - slide the used block pointers to the middle
+            const std::size_t new_first = (m_map_capacity - needed) / 2 + (at_front ? 1 : 0);
+            if (new_first < first_block) {
+                std::copy(m_map + first_block, m_map + first_block + used_blocks, m_map + new_first);
+            } else {
+                std::copy_backward(m_map + first_block, m_map + first_block + used_blocks,
+                                   m_map + new_first + used_blocks);
+            }
+            std::fill(m_map, m_map + new_first, nullptr);
+            std::fill(m_map + new_first + used_blocks, m_map + m_map_capacity, nullptr);
+            m_begin = new_first * BLOCK_SIZE + offset;
+            return;
+        }
+
+        const std::size_t new_capacity = std::max(INITIAL_MAP_CAPACITY, m_map_capacity * 2);
+        T** new_map = m_map_alloc.allocate(new_capacity);
+        std::fill(new_map, new_map + new_capacity, nullptr);
+
+        const std::size_t new_first = (new_capacity - needed) / 2 + (at_front ? 1 : 0);
+        if (m_map) {
+            std::copy(m_map + first_block, m_map + first_block + used_blocks, new_map + new_first);
+            m_map_alloc.deallocate(m_map, m_map_capacity);
+        }
+
+        m_map = new_map;
+        m_map_capacity = new_capacity;
+        m_begin = new_first * BLOCK_SIZE + offset;
+    }
+
+    template <bool IsConst>
+    class basic_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+        using container = std::conditional_t<IsConst, const deque, deque>;
+
+        basic_iterator() = default;
+        basic_iterator(container* owner, std::size_t index) : m_owner(owner), m_index(index) {}
+
+        // allow iterator -> const_iterator conversion
+        operator basic_iterator<true>() const requires (!IsConst) { return basic_iterator<true>(m_owner, m_index); }
+
+        reference operator*() const { return (*m_owner)[m_index]; }
+        pointer operator->() const { return &(*m_owner)[m_index]; }
+        reference operator[](difference_type n) const { return (*m_owner)[m_index + n]; }
+
+        basic_iterator& operator++() { ++m_index; return *this; }
+        basic_iterator operator++(int) { basic_iterator temp = *this; ++m_index; return temp; }
+        basic_iterator& operator--() { --m_index; return *this; }
+        basic_iterator operator--(int) { basic_iterator temp = *this; --m_index; return temp; }
+
+        basic_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+        basic_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+        basic_iterator operator+(difference_type n) const { return basic_iterator(m_owner, m_index + n); }
+        friend basic_iterator operator+(difference_type n, const basic_iterator& it) { return it + n; }
+        basic_iterator operator-(difference_type n) const { return basic_iterator(m_owner, m_index - n); }
+        difference_type operator-(const basic_iterator& other) const {
+            return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+        }
+
+        bool operator==(const basic_iterator& other) const { return m_index == other.m_index; }
+        auto operator<=>(const basic_iterator& other) const { return m_index <=> other.m_index; }
+
+    private:
+        container* m_owner = nullptr;
+        std::size_t m_index = 0;
+    };
+
+    T** m_map = nullptr;               // array of block pointers
+    std::size_t m_map_capacity = 0;    // number of slots in m_map
+    std::size_t m_begin = 0;           // absolute position of the front element
+    std::size_t m_size = 0;
+    T* m_spare = nullptr;              // one cached empty block
+    Allocator m_alloc;
+    map_allocator m_map_alloc;
+};
+
+} // namespace std2
+
+#endif // DEQUE_HPP
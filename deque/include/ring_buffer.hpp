@@ -0,0 +1,210 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <cstddef>     // for std::size_t
+#include <cstring>     // for std::memcpy
+#include <memory>      // for std::allocator
+#include <span>        // for std::span
+#include <type_traits> // for std::is_trivially_copyable_v
+#include <utility>     // for std::pair
+#include "../../std2/std2.hpp" // for std2::move, std2::forward
+
+namespace std2 {
+
+/*
+ * Fixed capacity FIFO ring buffer.
+ * The capacity is always rounded up to a power of two so wrapping an index
+ * is a single mask. Head and tail are free running counters, the buffer is
+ * full when they are exactly capacity apart.
+ * The readable (and for trivially copyable T, the writable) region is exposed
+ * as at most two contiguous spans so batch I/O can be done with two copies.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class ring_buffer {
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using span_pair = std::pair<std::span<T>, std::span<T>>;
+    using const_span_pair = std::pair<std::span<const T>, std::span<const T>>;
+
+    explicit ring_buffer(std::size_t capacity, const Allocator& alloc = Allocator())
+        : m_capacity(round_up_pow2(capacity)), m_mask(m_capacity - 1), m_alloc(alloc) {
+        m_data = m_alloc.allocate(m_capacity);
+    }
+
+    ring_buffer(const ring_buffer&) = delete;
+    ring_buffer& operator=(const ring_buffer&) = delete;
+
+    ~ring_buffer() {
+        clear();
+        m_alloc.deallocate(m_data, m_capacity);
+    }
+
+    /**
+     *  @brief  Add an element to the back of the buffer.
+     *  @param  value  The value to add.
+     *  @return false if the buffer was full and nothing was added.
+     */
+    bool push_back(const T& value) { return try_emplace_back(value); }
+
+    /**
+     *  @brief  Add an element to the back of the buffer.
+     *  @param  value  The (R-value ref) value to add.
+     *  @return false if the buffer was full and nothing was added.
+     */
+    bool push_back(T&& value) { return try_emplace_back(std2::move(value)); }
+
+    /**
+     *  @brief  Construct an element in place at the back of the buffer.
+     *  @param  args  Arguments to forward to the constructor of T.
+     *  @return false if the buffer was full and nothing was added.
+     */
+    template <typename... Args>
+    bool try_emplace_back(Args&&... args) {
+        if (full()) return false;
+        new (&m_data[m_tail & m_mask]) T(std2::forward<Args>(args)...);
+        ++m_tail;
+        return true;
+    }
+
+    /**
+     *  @brief  Remove the front element of the buffer.
+     *  @return void.
+     */
+    void pop_front() {
+        if (empty()) return;
+        m_data[m_head & m_mask].~T();
+        ++m_head;
+    }
+
+    /**
+     *  @brief  Remove all elements.
+     *  @return void.
+     */
+    void clear() {
+        consume(size());
+        m_head = m_tail = 0;
+    }
+
+    T& front() { return m_data[m_head & m_mask]; }
+    const T& front() const { return m_data[m_head & m_mask]; }
+    T& back() { return m_data[(m_tail - 1) & m_mask]; }
+    const T& back() const { return m_data[(m_tail - 1) & m_mask]; }
+
+    /**
+     *  @brief  Index operator - access element relative to the front.
+     *  @param  index  The index of the element to access.
+     *  @return the reference to the value at the index.
+     */
+    T& operator[](std::size_t index) { return m_data[(m_head + index) & m_mask]; }
+    const T& operator[](std::size_t index) const { return m_data[(m_head + index) & m_mask]; }
+
+    std::size_t size() const { return m_tail - m_head; }
+    std::size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_head == m_tail; }
+    bool full() const { return size() == m_capacity; }
+
+    /**
+     *  @brief  Get the readable elements as (at most) two contiguous spans, in FIFO order.
+     *  @return pair of spans, the second one is empty unless the data wraps around.
+     */
+    span_pair data_spans() {
+        return make_spans(m_head, size());
+    }
+
+    const_span_pair data_spans() const {
+        auto [first, second] = const_cast<ring_buffer*>(this)->data_spans();
+        return { first, second };
+    }
+
+    /**
+     *  @brief  Get the free slots as (at most) two contiguous spans that can be
+     *          filled directly, e.g. by read(2)/recv(2). Follow with commit().
+     *  @return pair of spans, the second one is empty unless the free region wraps around.
+     */
+    span_pair free_spans() requires std::is_trivially_copyable_v<T> {
+        return make_spans(m_tail, m_capacity - size());
+    }
+
+    /**
+     *  @brief  Publish elements that were written through free_spans().
+     *          count is clamped to the free space, so the buffer never reports more than capacity().
+     *  @param  count  Number of elements written.
+     *  @return void.
+     */
+    void commit(std::size_t count) requires std::is_trivially_copyable_v<T> {
+        const std::size_t available = m_capacity - size();
+        if (count > available) count = available;
+        m_tail += count;
+    }
+
+    /**
+     *  @brief  Drop elements from the front, e.g. after writing data_spans() out.
+     *  @param  count  Number of elements to drop.
+     *  @return void.
+     */
+    void consume(std::size_t count) {
+        if (count > size()) count = size();
+        if constexpr (std::is_trivially_destructible_v<T>) {
+            m_head += count;
+        } else {
+            for (std::size_t i = 0; i < count; ++i) pop_front();
+        }
+    }
+
+    /**
+     *  @brief  Copy up to count elements into the buffer with at most two memcpy calls.
+     *  @param  src  Source elements.
+     *  @param  count  Number of elements available in src.
+     *  @return number of elements actually written.
+     */
+    std::size_t write(const T* src, std::size_t count) requires std::is_trivially_copyable_v<T> {
+        auto [first, second] = free_spans();
+        const std::size_t n1 = count < first.size() ? count : first.size();
+        const std::size_t n2 = count - n1 < second.size() ? count - n1 : second.size();
+        if (n1) std::memcpy(first.data(), src, n1 * sizeof(T));
+        if (n2) std::memcpy(second.data(), src + n1, n2 * sizeof(T));
+        commit(n1 + n2);
+        return n1 + n2;
+    }
+
+    /**
+     *  @brief  Move up to count elements out of the buffer with at most two memcpy calls.
+     *  @param  dst  Destination for the elements.
+     *  @param  count  Space available in dst.
+     *  @return number of elements actually read.
+     */
+    std::size_t read(T* dst, std::size_t count) requires std::is_trivially_copyable_v<T> {
+        auto [first, second] = data_spans();
+        const std::size_t n1 = count < first.size() ? count : first.size();
+        const std::size_t n2 = count - n1 < second.size() ? count - n1 : second.size();
+        if (n1) std::memcpy(dst, first.data(), n1 * sizeof(T));
+        if (n2) std::memcpy(dst + n1, second.data(), n2 * sizeof(T));
+        consume(n1 + n2);
+        return n1 + n2;
+    }
+
+private:
+    static std::size_t round_up_pow2(std::size_t n) {
+        std::size_t result = 1;
+        while (result < n) result <<= 1;
+        return result;
+    }
+
+    span_pair make_spans(std::size_t start, std::size_t count) {
+        const std::size_t offset = start & m_mask;
+        const std::size_t first = count < m_capacity - offset ? count : m_capacity - offset;
+        return { std::span<T>(m_data + offset, first), std::span<T>(m_data, count - first) };
+    }
+
+    T* m_data = nullptr;
+    std::size_t m_head = 0; // free running read counter
+    std::size_t m_tail = 0; // free running write counter
+    std::size_t m_capacity;
+    std::size_t m_mask;
+    Allocator m_alloc;
+};
+
+} // namespace std2
+
+#endif // RING_BUFFER_HPP
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/deque.hpp"
+#include "../../list/include/list.hpp"
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+class DequeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+// Test basic construction and destruction
+TEST_F(DequeTest, BasicConstructionAndDestruction) {
+    std2::deque<int> vals;
+    EXPECT_TRUE(vals.empty());
+
+    vals.push_back(10);
+    vals.push_back(20);
+    vals.push_front(5);
+
+    EXPECT_EQ(vals.size(), 3);
+    EXPECT_EQ(vals.front(), 5);
+    EXPECT_EQ(vals.back(), 20);
+}
+
+// Test push/pop at both ends across many block boundaries
+TEST_F(DequeTest, PushPopBothEnds) {
+    std2::deque<int> vals;
+    const int count = 10000;
+
+    for (int i = 0; i < count; ++i) {
+        vals.push_back(i);
+        vals.push_front(-i - 1);
+    }
+    EXPECT_EQ(vals.size(), 2 * count);
+
+    for (int i = 0; i < 2 * count; ++i) {
+        EXPECT_EQ(vals[i], i - count);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        vals.pop_front();
+        vals.pop_back();
+    }
+    EXPECT_TRUE(vals.empty());
+
+    // reuse after being emptied
+    vals.push_front(42);
+    EXPECT_EQ(vals.front(), 42);
+    EXPECT_EQ(vals.back(), 42);
+}
+
+// Test that references stay valid while pushing at either end
+TEST_F(DequeTest, ReferenceStability) {
+    std2::deque<int> vals;
+    vals.push_back(1);
+    int& first = vals.front();
+    int* first_ptr = &first;
+
+    for (int i = 0; i < 100000; ++i) {
+        if (i % 2) vals.push_back(i);
+        else vals.push_front(i);
+    }
+
+    EXPECT_EQ(first_ptr, &first);
+    EXPECT_EQ(first, 1);
+}
+
+// Test FIFO usage where the live window keeps sliding through the map
+TEST_F(DequeTest, SlidingQueue) {
+    std2::deque<int> vals;
+    int next_out = 0;
+    for (int i = 0; i < 50000; ++i) {
+        vals.push_back(i);
+        if (i % 3 != 0) {
+            EXPECT_EQ(vals.front(), next_out++);
+            vals.pop_front();
+        }
+    }
+    EXPECT_EQ(vals.size(), 50000 - next_out);
+    EXPECT_EQ(vals.front(), next_out);
+}
+
+// Test non trivial element types are constructed and destroyed correctly
+TEST_F(DequeTest, NonTrivialElements) {
+    std2::deque<std::string> vals;
+    for (int i = 0; i < 1000; ++i) {
+        vals.emplace_back(std::to_string(i));
+        vals.emplace_front(std::string(40, 'x'));
+    }
+    EXPECT_EQ(vals[1000], "0");
+    EXPECT_EQ(vals.back(), "999");
+
+    std2::deque<std::string> copy(vals);
+    vals.clear();
+    EXPECT_TRUE(vals.empty());
+    EXPECT_EQ(copy.size(), 2000);
+    EXPECT_EQ(copy.back(), "999");
+
+    std2::deque<std::string> moved(std2::move(copy));
+    EXPECT_EQ(moved.size(), 2000);
+    EXPECT_EQ(copy.size(), 0);  // NOLINT: testing moved-from state
+}
+
+// allocator that counts the allocations still outstanding
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+    static inline long live = 0;
+
+    counting_allocator() = default;
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        ++live;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        --live;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(const counting_allocator&) const { return true; }
+};
+
+// element whose constructor throws on request
+struct Fragile {
+    static inline bool fail = false;
+    int value;
+
+    explicit Fragile(int v) : value(v) {
+        if (fail) throw std::runtime_error("construct");
+    }
+};
+
+// Test a throwing constructor gives back the block taken for it
+TEST_F(DequeTest, ThrowingConstructorReleasesBlock) {
+    using fragile_deque = std2::deque<Fragile, counting_allocator<Fragile>>;
+    {
+        fragile_deque vals;
+        for (int i = 0; i < 20 * static_cast<int>(fragile_deque::BLOCK_SIZE); ++i) {
+            if (i % fragile_deque::BLOCK_SIZE == 0) {
+                // both ends sit on a block boundary, so each attempt takes a fresh block
+                Fragile::fail = true;
+                EXPECT_THROW(vals.emplace_back(i), std::runtime_error);
+                EXPECT_THROW(vals.emplace_front(i), std::runtime_error);
+                Fragile::fail = false;
+            }
+            vals.emplace_back(i);
+            vals.emplace_front(-i);
+        }
+        EXPECT_EQ(vals.back().value, 20 * static_cast<int>(fragile_deque::BLOCK_SIZE) - 1);
+    }
+    EXPECT_EQ(counting_allocator<Fragile>::live, 0);
+    EXPECT_EQ(counting_allocator<Fragile*>::live, 0);
+}
+
+// Test iterators and bounds checked access
+TEST_F(DequeTest, IteratorsAndAt) {
+    static_assert(std::random_access_iterator<std2::deque<int>::iterator>);
+    static_assert(std::random_access_iterator<std2::deque<int>::const_iterator>);
+
+    std2::deque<int> vals = {1, 2, 3, 4, 5};
+
+    int sum = 0;
+    for (int v : vals) sum += v;
+    EXPECT_EQ(sum, 15);
+
+    auto it = vals.begin();
+    it += 3;
+    EXPECT_EQ(*it, 4);
+    EXPECT_EQ(vals.end() - it, 2);
+    EXPECT_EQ(*(1 + vals.begin()), 2);
+
+    const std2::deque<int>& const_vals = vals;
+    EXPECT_EQ(*(const_vals.end() - 1), 5);
+
+    EXPECT_EQ(vals.at(2), 3);
+    EXPECT_THROW(vals.at(5), std::out_of_range);
+}
+
+// Queue workload benchmark against std2::list and std::deque
+TEST_F(DequeTest, PerformanceBenchmark) {
+    const int iterations = 1000000;
+    const int window = 1024;
+
+    auto run = [&](auto& queue) {
+        auto start = std::chrono::high_resolution_clock::now();
+        long long sum = 0;
+        for (int i = 0; i < iterations; ++i) {
+            queue.push_back(i);
+            if (i >= window) {
+                sum += queue.front();
+                queue.pop_front();
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        EXPECT_GT(sum, 0);
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+
+    std2::deque<int> deque;
+    std2::list<int> list;
+    std::deque<int> std_deque;
+
+    // std2::list has no front(), so adapt it through its iterator
+    struct list_queue {
+        std2::list<int>& list;
+        void push_back(int v) { list.push_back(v); }
+        int front() { return *list.begin(); }
+        void pop_front() { list.pop_front(); }
+    } list_adapter{list};
+
+    std::cout << "std2::deque queue workload: " << run(deque) << " microseconds\n";
+    std::cout << "std2::list  queue workload: " << run(list_adapter) << " microseconds\n";
+    std::cout << "std::deque  queue workload: " << run(std_deque) << " microseconds\n";
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/ring_buffer.hpp"
+#include "../../list/include/list.hpp"
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <string>
+
+class RingBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+// Test capacity is rounded up to a power of two
+TEST_F(RingBufferTest, PowerOfTwoCapacity) {
+    std2::ring_buffer<int> buf(5);
+    EXPECT_EQ(buf.capacity(), 8);
+    EXPECT_TRUE(buf.empty());
+
+    std2::ring_buffer<int> exact(16);
+    EXPECT_EQ(exact.capacity(), 16);
+}
+
+// Test push/pop order and the full condition
+TEST_F(RingBufferTest, PushPopFifo) {
+    std2::ring_buffer<int> buf(4);
+    EXPECT_TRUE(buf.push_back(1));
+    EXPECT_TRUE(buf.push_back(2));
+    EXPECT_TRUE(buf.push_back(3));
+    EXPECT_TRUE(buf.push_back(4));
+    EXPECT_TRUE(buf.full());
+    EXPECT_FALSE(buf.push_back(5));
+
+    EXPECT_EQ(buf.front(), 1);
+    EXPECT_EQ(buf.back(), 4);
+    buf.pop_front();
+    EXPECT_TRUE(buf.push_back(5));
+    EXPECT_EQ(buf[0], 2);
+    EXPECT_EQ(buf[3], 5);
+}
+
+// Test the two span views when the data wraps around the end of storage
+TEST_F(RingBufferTest, TwoSpanAccess) {
+    std2::ring_buffer<int> buf(8);
+    for (int i = 0; i < 6; ++i) buf.push_back(i);
+    buf.consume(4);
+    for (int i = 6; i < 10; ++i) buf.push_back(i);
+
+    auto [first, second] = buf.data_spans();
+    EXPECT_EQ(first.size(), 4);
+    EXPECT_EQ(second.size(), 2);
+    EXPECT_EQ(first[0], 4);
+    EXPECT_EQ(second[1], 9);
+
+    auto [free_first, free_second] = buf.free_spans();
+    EXPECT_EQ(free_first.size() + free_second.size(), 2);
+    free_first[0] = 10;
+    free_first[1] = 11;
+    buf.commit(2);
+    EXPECT_TRUE(buf.full());
+    EXPECT_EQ(buf.back(), 11);
+
+    // committing more than the free space is clamped
+    buf.consume(3);
+    buf.commit(100);
+    EXPECT_EQ(buf.size(), buf.capacity());
+    EXPECT_EQ(buf.front(), 7);
+}
+
+// Test bulk write and read
+TEST_F(RingBufferTest, BulkReadWrite) {
+    std2::ring_buffer<char> buf(16);
+    const char input[] = "abcdefghijklmnopqrstuvwxyz";
+    EXPECT_EQ(buf.write(input, 10), 10);
+
+    char out[32] = {};
+    EXPECT_EQ(buf.read(out, 6), 6);
+    EXPECT_EQ(std::string(out, 6), "abcdef");
+
+    // this write wraps around the end of storage
+    EXPECT_EQ(buf.write(input + 10, 16), 12);
+    EXPECT_TRUE(buf.full());
+    EXPECT_EQ(buf.read(out, 32), 16);
+    EXPECT_EQ(std::string(out, 16), "ghijklmnopqrstuv");
+}
+
+// Test non trivial element types
+TEST_F(RingBufferTest, NonTrivialElements) {
+    std2::ring_buffer<std::string> buf(4);
+    for (int i = 0; i < 100; ++i) {
+        if (buf.full()) buf.pop_front();
+        buf.try_emplace_back(std::string(32, 'a' + i % 26));
+    }
+    EXPECT_EQ(buf.size(), 4);
+    EXPECT_EQ(buf.back(), std::string(32, 'a' + 99 % 26));
+}
+
+// Batched queue workload benchmark against std2::list and std::deque
+TEST_F(RingBufferTest, PerformanceBenchmark) {
+    const int iterations = 1000;
+    const int batch = 4096;
+    std2::ring_buffer<int> ring(batch);
+    int scratch[batch];
+    for (int i = 0; i < batch; ++i) scratch[i] = i;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        ring.write(scratch, batch);
+        ring.read(scratch, batch);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "std2::ring_buffer batch workload: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " microseconds\n";
+
+    std2::list<int> list;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (int j = 0; j < batch; ++j) list.push_back(scratch[j]);
+        auto it = list.begin();
+        for (int j = 0; j < batch; ++j) { scratch[j] = *it; ++it; }
+        for (int j = 0; j < batch; ++j) list.pop_front();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "std2::list  batch workload: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " microseconds\n";
+
+    std::deque<int> std_deque;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        std_deque.insert(std_deque.end(), scratch, scratch + batch);
+        std::copy(std_deque.begin(), std_deque.end(), scratch);
+        std_deque.clear();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "std::deque  batch workload: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " microseconds\n";
+
+    EXPECT_EQ(scratch[batch - 1], batch - 1);
+}
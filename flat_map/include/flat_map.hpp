@@ -0,0 +1,412 @@
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include <cstddef>     // for std::size_t, std::ptrdiff_t
+#include <functional>  // for std::less
+#include <iterator>    // for std::random_access_iterator_tag
+#include <stdexcept>   // for std::out_of_range
+#include <type_traits> // for std::conditional_t
+#include <utility>     // for std::pair, std::swap
+#include "../../vector/include/vector.hpp"
+#include "../../algorithm/include/sort.hpp"
+#include "../../std2/std2.hpp" // for std2::move, std2::forward
+
+namespace std2 {
+
+/*
+ * Tag for adopting input that is already sorted and free of duplicate keys.
+ * Skips the sort and dedupe step of construction and bulk insertion.
+ */
+struct sorted_unique_t { explicit sorted_unique_t() = default; };
+inline constexpr sorted_unique_t sorted_unique{};
+
+namespace flat_detail {
+
+/* @brief  Branchless lower bound over a sorted array.
+ * The loop body has no data dependent branch, the compare feeds a conditional
+ * move, so the search costs log2(n) dependent loads and no mispredictions.
+ * The two possible next midpoints are prefetched one level ahead.
+ * @param  base  First element of the sorted array.
+ * @param  n  Number of elements.
+ * @param  key  The key to search for.
+ * @param  comp  Strict weak ordering.
+ * @return index of the first element not less than key.
+ */
+template <typename K, typename Key, typename Compare>
+std::size_t lower_bound_index(const K* base, std::size_t n, const Key& key, const Compare& comp) {
+    if (n == 0) return 0;
+    const K* first = base;
+    while (n > 1) {
+        const std::size_t half = n / 2;
+#if defined(__GNUC__)
+        __builtin_prefetch(first + half / 2);
+        __builtin_prefetch(first + half + half / 2);
+#endif
+        first = comp(first[half], key) ? first + half : first;
+        n -= half;
+    }
+    return static_cast<std::size_t>(first - base) + (comp(*first, key) ? 1 : 0);
+}
+
+/* @brief  Open a gap at index by shifting the tail one slot up, then fill it.
+ * @param  vec  The vector.
+ * @param  index  Position of the new element.
+ * @param  args  Arguments to construct the new element from.
+ * @return void.
+ */
+template <typename T, typename... Args>
+void insert_at(std2::vector<T>& vec, std::size_t index, Args&&... args) {
+    T value(std2::forward<Args>(args)...);
+    if (index == vec.size()) {
+        vec.push_back(std2::move(value));
+        return;
+    }
+
+    // grow first so moving the last element does not read from a freed block
+    if (vec.size() == vec.capacity()) vec.reserve(vec.capacity() ? vec.capacity() * 2 : 4);
+    vec.push_back(std2::move(vec[vec.size() - 1]));
+    for (std::size_t i = vec.size() - 2; i > index; --i) {
+        vec[i] = std2::move(vec[i - 1]);
+    }
+    vec[index] = std2::move(value);
+}
+
+/* @brief  Close the gap at index by shifting the tail one slot down.
+ * @param  vec  The vector.
+ * @param  index  Position of the element to remove.
+ * @return void.
+ */
+template <typename T>
+void erase_at(std2::vector<T>& vec, std::size_t index) {
+    for (std::size_t i = index + 1; i < vec.size(); ++i) {
+        vec[i - 1] = std2::move(vec[i]);
+    }
+    vec.pop_back();
+}
+
+/* @brief  Drop elements equal to their predecessor from a sorted vector, keeping the first.
+ * @param  vec  The sorted vector.
+ * @param  equal  Equivalence predicate.
+ * @return void.
+ */
+template <typename T, typename Equal>
+void unique_sorted(std2::vector<T>& vec, const Equal& equal) {
+    if (vec.size() < 2) return;
+    std::size_t out = 1;
+    for (std::size_t i = 1; i < vec.size(); ++i) {
+        if (!equal(vec[out - 1], vec[i])) {
+            if (out != i) vec[out] = std2::move(vec[i]);
+            ++out;
+        }
+    }
+    while (vec.size() > out) vec.pop_back();
+}
+
+} // namespace flat_detail
+
+/*
+ * Sorted associative container with keys and values in two parallel std2::vectors.
+ * Lookups only touch the dense key array, iteration is a linear walk.
+ * Inserting one element is O(n), bulk insert appends, sorts and merges in one pass.
+ */
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class flat_map {
+    template <bool IsConst> class basic_iterator;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    flat_map() = default;
+
+    explicit flat_map(const Compare& comp) : m_comp(comp) {}
+
+    /**
+     *  @brief  Construct from an unsorted range of key/value pairs, first occurrence of a key wins.
+     *  @param  first  Start of the range.
+     *  @param  last  End of the range.
+     */
+    template <typename InputIt>
+    flat_map(InputIt first, InputIt last, const Compare& comp = Compare()) : m_comp(comp) {
+        insert(first, last);
+    }
+
+    /**
+     *  @brief  Adopt key and value vectors that are already sorted and unique, no sorting is done.
+     *  @param  keys  Sorted unique keys.
+     *  @param  values  Values matching the keys index for index.
+     */
+    flat_map(sorted_unique_t, std2::vector<Key> keys, std2::vector<T> values, const Compare& comp = Compare())
+        : m_keys(std2::move(keys)), m_values(std2::move(values)), m_comp(comp) {
+        if (m_keys.size() != m_values.size()) {
+            throw std::logic_error("std2::flat_map key and value counts differ");
+        }
+    }
+
+    /**
+     *  @brief  Find an element.
+     *  @param  key  The key to search for.
+     *  @return iterator to the element, or end() if not found.
+     */
+    iterator find(const Key& key) { return iterator(this, find_index(key)); }
+    const_iterator find(const Key& key) const { return const_iterator(this, find_index(key)); }
+
+    bool contains(const Key& key) const { return find_index(key) != size(); }
+    size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    /**
+     *  @brief  First element whose key is not less than key.
+     *  @param  key  The key to search for.
+     *  @return iterator to the element, or end().
+     */
+    iterator lower_bound(const Key& key) { return iterator(this, lower_index(key)); }
+    const_iterator lower_bound(const Key& key) const { return const_iterator(this, lower_index(key)); }
+
+    /**
+     *  @brief  Access the value for a key.
+     *  @param  key  The key.
+     *  @return reference to the mapped value.
+     *  @throws std::out_of_range if the key is not present.
+     */
+    T& at(const Key& key) {
+        const std::size_t index = find_index(key);
+        if (index == size()) throw std::out_of_range("std2::flat_map::at");
+        return m_values[index];
+    }
+
+    const T& at(const Key& key) const {
+        const std::size_t index = find_index(key);
+        if (index == size()) throw std::out_of_range("std2::flat_map::at");
+        return m_values[index];
+    }
+
+    /**
+     *  @brief  Access the value for a key, inserting a value initialized one if missing.
+     *  @param  key  The key.
+     *  @return reference to the mapped value.
+     */
+    T& operator[](const Key& key) {
+        return (*try_emplace(key).first).second;
+    }
+
+    /**
+     *  @brief  Insert a value for key unless the key is already present.
+     *  @param  key  The key.
+     *  @param  args  Arguments to construct the value from.
+     *  @return iterator to the element and whether it was inserted.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        const std::size_t index = lower_index(key);
+        if (index < size() && !m_comp(key, m_keys[index])) return { iterator(this, index), false };
+        flat_detail::insert_at(m_keys, index, key);
+        try {
+            flat_detail::insert_at(m_values, index, std2::forward<Args>(args)...);
+        } catch (...) {
+            // keep the key and value arrays the same length
+            flat_detail::erase_at(m_keys, index);
+            throw;
+        }
+        return { iterator(this, index), true };
+    }
+
+    std::pair<iterator, bool> insert(const std::pair<Key, T>& value) {
+        return try_emplace(value.first, value.second);
+    }
+
+    /**
+     *  @brief  Bulk insert: append the range, sort it, then merge with the existing
+     *          elements in one pass. Existing keys and the first duplicate win.
+     *          The staging sort is stable, so Key and T must be default constructible.
+     *  @param  first  Start of a range of key/value pairs.
+     *  @param  last  End of the range.
+     *  @return void.
+     */
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        std2::vector<std::pair<Key, T>> staged;
+        for (; first != last; ++first) staged.emplace_back(first->first, first->second);
+        if (staged.size() == 0) return;
+
+        std2::stable_sort(staged.data(), staged.data() + staged.size(),
+            [this](const auto& a, const auto& b) { return m_comp(a.first, b.first); });
+        flat_detail::unique_sorted(staged,
+            [this](const auto& a, const auto& b) { return !m_comp(a.first, b.first); });
+        merge(staged);
+    }
+
+    /**
+     *  @brief  Bulk insert a range that is already sorted and unique, skipping the sort.
+     *  @param  first  Start of a range of key/value pairs.
+     *  @param  last  End of the range.
+     *  @return void.
+     */
+    template <typename InputIt>
+    void insert(sorted_unique_t, InputIt first, InputIt last) {
+        std2::vector<std::pair<Key, T>> staged;
+        for (; first != last; ++first) staged.emplace_back(first->first, first->second);
+        merge(staged);
+    }
+
+    /**
+     *  @brief  Erase an element.
+     *  @param  key  The key of the element to erase.
+     *  @return the number of elements erased (0 or 1).
+     */
+    size_type erase(const Key& key) {
+        const std::size_t index = find_index(key);
+        if (index == size()) return 0;
+        flat_detail::erase_at(m_keys, index);
+        flat_detail::erase_at(m_values, index);
+        return 1;
+    }
+
+    void reserve(size_type n) {
+        m_keys.reserve(n);
+        m_values.reserve(n);
+    }
+
+    void clear() {
+        m_keys.clear();
+        m_values.clear();
+    }
+
+    /**
+     *  @brief  The sorted key array, suitable for scanning directly.
+     *  @return const reference to the keys.
+     */
+    const std2::vector<Key>& keys() const { return m_keys; }
+
+    /**
+     *  @brief  The value array, in key order.
+     *  @return const reference to the values.
+     */
+    const std2::vector<T>& values() const { return m_values; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    size_type size() const { return m_keys.size(); }
+    bool empty() const { return m_keys.size() == 0; }
+
+private:
+    std::size_t lower_index(const Key& key) const {
+        return flat_detail::lower_bound_index(m_keys.data(), m_keys.size(), key, m_comp);
+    }
+
+    std::size_t find_index(const Key& key) const {
+        const std::size_t index = lower_index(key);
+        return index < size() && !m_comp(key, m_keys[index]) ? index : size();
+    }
+
+    /* @brief  Merge a sorted unique run into the container, existing keys win.
+     * @param  staged  The run to merge, consumed.
+     * @return void.
+     */
+    void merge(std2::vector<std::pair<Key, T>>& staged) {
+        const std::size_t n = size();
+        const std::size_t m = staged.size();
+
+        // common case: the run sorts after everything already present
+        if (n == 0 || (m > 0 && m_comp(m_keys[n - 1], staged[0].first))) {
+            reserve(n + m);
+            for (std::size_t j = 0; j < m; ++j) {
+                m_keys.push_back(std2::move(staged[j].first));
+                m_values.push_back(std2::move(staged[j].second));
+            }
+            return;
+        }
+
+        std2::vector<Key> keys;
+        std2::vector<T> values;
+        keys.reserve(n + m);
+        values.reserve(n + m);
+
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i < n && j < m) {
+            if (m_comp(staged[j].first, m_keys[i])) {
+                keys.push_back(std2::move(staged[j].first));
+                values.push_back(std2::move(staged[j].second));
+                ++j;
+            } else {
+                if (!m_comp(m_keys[i], staged[j].first)) ++j; // equal key, keep existing
+                keys.push_back(std2::move(m_keys[i]));
+                values.push_back(std2::move(m_values[i]));
+                ++i;
+            }
+        }
+        for (; i < n; ++i) {
+            keys.push_back(std2::move(m_keys[i]));
+            values.push_back(std2::move(m_values[i]));
+        }
+        for (; j < m; ++j) {
+            keys.push_back(std2::move(staged[j].first));
+            values.push_back(std2::move(staged[j].second));
+        }
+
+        m_keys = std2::move(keys);
+        m_values = std2::move(values);
+    }
+
+    template <bool IsConst>
+    class basic_iterator {
+        using owner_type = std::conditional_t<IsConst, const flat_map, flat_map>;
+        using mapped_ref = std::conditional_t<IsConst, const T&, T&>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<Key, T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const Key&, mapped_ref>;
+
+        struct pointer {
+            reference ref;
+            reference* operator->() { return &ref; }
+        };
+
+        basic_iterator() = default;
+        basic_iterator(owner_type* owner, std::size_t index) : m_owner(owner), m_index(index) {}
+
+        reference operator*() const { return reference(m_owner->m_keys[m_index], m_owner->m_values[m_index]); }
+        pointer operator->() const { return pointer{ **this }; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        basic_iterator& operator++() { ++m_index; return *this; }
+        basic_iterator operator++(int) { basic_iterator temp = *this; ++m_index; return temp; }
+        basic_iterator& operator--() { --m_index; return *this; }
+        basic_iterator operator--(int) { basic_iterator temp = *this; --m_index; return temp; }
+
+        basic_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+        basic_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+        basic_iterator operator+(difference_type n) const { return basic_iterator(m_owner, m_index + n); }
+        friend basic_iterator operator+(difference_type n, const basic_iterator& it) { return it + n; }
+        basic_iterator operator-(difference_type n) const { return basic_iterator(m_owner, m_index - n); }
+        difference_type operator-(const basic_iterator& other) const {
+            return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+        }
+
+        bool operator==(const basic_iterator& other) const { return m_index == other.m_index; }
+        auto operator<=>(const basic_iterator& other) const { return m_index <=> other.m_index; }
+
+        operator basic_iterator<true>() const requires (!IsConst) { return basic_iterator<true>(m_owner, m_index); }
+
+    private:
+        owner_type* m_owner = nullptr;
+        std::size_t m_index = 0;
+    };
+
+    std2::vector<Key> m_keys;
+    std2::vector<T> m_values;
+    Compare m_comp;
+};
+
+} // namespace std2
+
+#endif // FLAT_MAP_HPP
@@ -0,0 +1,172 @@
+#ifndef FLAT_SET_HPP
+#define FLAT_SET_HPP
+
+#include <cstddef>     // for std::size_t
+#include <functional>  // for std::less
+#include <utility>     // for std::pair
+#include "flat_map.hpp" // for std2::sorted_unique, flat_detail search helpers
+#include "../../vector/include/vector.hpp"
+#include "../../algorithm/include/sort.hpp"
+#include "../../std2/std2.hpp" // for std2::move
+
+namespace std2 {
+
+/*
+ * Sorted set stored in one std2::vector.
+ * Shares the branchless search and bulk merge strategy of std2::flat_map.
+ */
+template <typename Key, typename Compare = std::less<Key>>
+class flat_set {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using iterator = const Key*;
+    using const_iterator = const Key*;
+
+    flat_set() = default;
+
+    explicit flat_set(const Compare& comp) : m_comp(comp) {}
+
+    /**
+     *  @brief  Construct from an unsorted range, duplicates are dropped.
+     *  @param  first  Start of the range.
+     *  @param  last  End of the range.
+     */
+    template <typename InputIt>
+    flat_set(InputIt first, InputIt last, const Compare& comp = Compare()) : m_comp(comp) {
+        insert(first, last);
+    }
+
+    /**
+     *  @brief  Adopt a vector that is already sorted and unique, no sorting is done.
+     *  @param  keys  Sorted unique keys.
+     */
+    flat_set(sorted_unique_t, std2::vector<Key> keys, const Compare& comp = Compare())
+        : m_keys(std2::move(keys)), m_comp(comp) {}
+
+    const_iterator find(const Key& key) const { return m_keys.data() + find_index(key); }
+    const_iterator lower_bound(const Key& key) const { return m_keys.data() + lower_index(key); }
+    bool contains(const Key& key) const { return find_index(key) != size(); }
+    size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    /**
+     *  @brief  Insert a key.
+     *  @param  key  The key.
+     *  @return iterator to the element and whether it was inserted.
+     */
+    std::pair<iterator, bool> insert(const Key& key) {
+        const std::size_t index = lower_index(key);
+        if (index < size() && !m_comp(key, m_keys[index])) return { m_keys.data() + index, false };
+        flat_detail::insert_at(m_keys, index, key);
+        return { m_keys.data() + index, true };
+    }
+
+    /**
+     *  @brief  Bulk insert: append the range, sort it, then merge with the existing
+     *          keys in one pass.
+     *  @param  first  Start of the range.
+     *  @param  last  End of the range.
+     *  @return void.
+     */
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        std2::vector<Key> staged;
+        for (; first != last; ++first) staged.push_back(*first);
+        if (staged.size() == 0) return;
+
+        std2::sort(staged.data(), staged.data() + staged.size(), m_comp);
+        flat_detail::unique_sorted(staged, [this](const Key& a, const Key& b) { return !m_comp(a, b); });
+        merge(staged);
+    }
+
+    /**
+     *  @brief  Bulk insert a range that is already sorted and unique, skipping the sort.
+     *  @param  first  Start of the range.
+     *  @param  last  End of the range.
+     *  @return void.
+     */
+    template <typename InputIt>
+    void insert(sorted_unique_t, InputIt first, InputIt last) {
+        std2::vector<Key> staged;
+        for (; first != last; ++first) staged.push_back(*first);
+        merge(staged);
+    }
+
+    /**
+     *  @brief  Erase a key.
+     *  @param  key  The key to erase.
+     *  @return the number of elements erased (0 or 1).
+     */
+    size_type erase(const Key& key) {
+        const std::size_t index = find_index(key);
+        if (index == size()) return 0;
+        flat_detail::erase_at(m_keys, index);
+        return 1;
+    }
+
+    void reserve(size_type n) { m_keys.reserve(n); }
+    void clear() { m_keys.clear(); }
+
+    /**
+     *  @brief  The sorted key array.
+     *  @return const reference to the keys.
+     */
+    const std2::vector<Key>& keys() const { return m_keys; }
+
+    const_iterator begin() const { return m_keys.data(); }
+    const_iterator end() const { return m_keys.data() + m_keys.size(); }
+
+    size_type size() const { return m_keys.size(); }
+    bool empty() const { return m_keys.size() == 0; }
+
+private:
+    std::size_t lower_index(const Key& key) const {
+        return flat_detail::lower_bound_index(m_keys.data(), m_keys.size(), key, m_comp);
+    }
+
+    std::size_t find_index(const Key& key) const {
+        const std::size_t index = lower_index(key);
+        return index < size() && !m_comp(key, m_keys[index]) ? index : size();
+    }
+
+    /* @brief  Merge a sorted unique run into the set.
+     * @param  staged  The run to merge, consumed.
+     * @return void.
+     */
+    void merge(std2::vector<Key>& staged) {
+        const std::size_t n = size();
+        const std::size_t m = staged.size();
+
+        if (n == 0 || (m > 0 && m_comp(m_keys[n - 1], staged[0]))) {
+            m_keys.reserve(n + m);
+            for (std::size_t j = 0; j < m; ++j) m_keys.push_back(std2::move(staged[j]));
+            return;
+        }
+
+        std2::vector<Key> keys;
+        keys.reserve(n + m);
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i < n && j < m) {
+            if (m_comp(staged[j], m_keys[i])) {
+                keys.push_back(std2::move(staged[j++]));
+            } else {
+                if (!m_comp(m_keys[i], staged[j])) ++j; // already present
+                keys.push_back(std2::move(m_keys[i++]));
+            }
+        }
+        for (; i < n; ++i) keys.push_back(std2::move(m_keys[i]));
+        for (; j < m; ++j) keys.push_back(std2::move(staged[j]));
+
+        m_keys = std2::move(keys);
+    }
+
+    std2::vector<Key> m_keys;
+    Compare m_comp;
+};
+
+} // namespace std2
+
+#endif // FLAT_SET_HPP
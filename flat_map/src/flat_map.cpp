@@ -0,0 +1,2 @@
+// Currently, there is no implementation needed in the .cpp file for flat_map and flat_set
+// All methods are implemented in the header file
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/flat_map.hpp"
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <version>
+#include <vector>
+#if __has_include(<flat_map>)
+#include <flat_map>
+#endif
+
+class FlatMapTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+// Test single inserts keep keys sorted and values aligned with them
+TEST_F(FlatMapTest, InsertFindErase) {
+    static_assert(std::random_access_iterator<std2::flat_map<int, std::string>::iterator>);
+#if defined(__cpp_lib_ranges_zip)
+    // const proxy references need the C++23 pair/tuple common_reference specializations
+    static_assert(std::random_access_iterator<std2::flat_map<int, std::string>::const_iterator>);
+#endif
+
+    std2::flat_map<int, std::string> map;
+    EXPECT_TRUE(map.empty());
+
+    EXPECT_TRUE(map.try_emplace(5, "five").second);
+    EXPECT_TRUE(map.insert({1, "one"}).second);
+    EXPECT_TRUE(map.insert({3, "three"}).second);
+    EXPECT_FALSE(map.insert({3, "again"}).second);
+    map[9] = "nine";
+
+    ASSERT_EQ(map.size(), 4);
+    int previous = -1;
+    for (auto [key, value] : map) {
+        EXPECT_LT(previous, key);
+        previous = key;
+    }
+
+    EXPECT_EQ(map.at(3), "three");
+    EXPECT_EQ(map.find(5)->second, "five");
+    EXPECT_EQ(map.find(4), map.end());
+    EXPECT_TRUE(map.contains(1));
+    EXPECT_EQ(map.count(2), 0);
+    EXPECT_EQ(map.lower_bound(4)->first, 5);
+    EXPECT_EQ((2 + map.begin())->first, 5);
+    EXPECT_THROW(map.at(42), std::out_of_range);
+
+    EXPECT_EQ(map.erase(3), 1);
+    EXPECT_EQ(map.erase(3), 0);
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map.keys()[1], 5);
+    EXPECT_EQ(map.values()[1], "five");
+}
+
+// Test bulk insert against std::map semantics, including duplicates and existing keys
+TEST_F(FlatMapTest, BulkInsert) {
+    std::mt19937 rng(17);
+    std2::flat_map<int, int> map;
+    std::map<int, int> expected;
+
+    for (int round = 0; round < 5; ++round) {
+        std::vector<std::pair<int, int>> batch;
+        for (int i = 0; i < 2000; ++i) batch.emplace_back(static_cast<int>(rng() % 5000), round * 10000 + i);
+
+        map.insert(batch.begin(), batch.end());
+        expected.insert(batch.begin(), batch.end());
+
+        ASSERT_EQ(map.size(), expected.size());
+        auto it = map.begin();
+        for (const auto& [key, value] : expected) {
+            ASSERT_EQ(it->first, key);
+            ASSERT_EQ(it->second, value);
+            ++it;
+        }
+    }
+
+    // appending past the end takes the no-merge path
+    std::vector<std::pair<int, int>> tail = {{9000, 1}, {9001, 2}};
+    map.insert(tail.begin(), tail.end());
+    EXPECT_EQ(map.at(9001), 2);
+}
+
+// Test adopting pre-sorted input without sorting
+TEST_F(FlatMapTest, SortedUnique) {
+    std2::vector<int> keys;
+    std2::vector<double> values;
+    for (int i = 0; i < 100; ++i) {
+        keys.push_back(i * 2);
+        values.push_back(i * 0.5);
+    }
+
+    std2::flat_map<int, double> map(std2::sorted_unique, std2::move(keys), std2::move(values));
+    EXPECT_EQ(map.size(), 100);
+    EXPECT_EQ(map.at(42), 10.5);
+    EXPECT_FALSE(map.contains(43));
+
+    std::vector<std::pair<int, double>> more = {{1, 1.0}, {3, 3.0}, {500, 5.0}};
+    map.insert(std2::sorted_unique, more.begin(), more.end());
+    EXPECT_EQ(map.size(), 103);
+    EXPECT_EQ(map.at(3), 3.0);
+    EXPECT_EQ(map.keys()[2], 2);
+
+    std2::vector<int> bad_keys;
+    bad_keys.push_back(1);
+    EXPECT_THROW((std2::flat_map<int, double>(std2::sorted_unique, bad_keys, std2::vector<double>())), std::logic_error);
+}
+
+// Test a custom comparator
+TEST_F(FlatMapTest, CustomCompare) {
+    std::vector<std::pair<int, char>> input = {{1, 'a'}, {3, 'c'}, {2, 'b'}};
+    std2::flat_map<int, char, std::greater<int>> map(input.begin(), input.end());
+    EXPECT_EQ(map.begin()->first, 3);
+    EXPECT_EQ((map.end() - 1)->second, 'a');
+}
+
+// Test a value constructor that throws leaves the keys and values in step
+TEST_F(FlatMapTest, ThrowingValueRollsBackKey) {
+    struct Picky {
+        std::string text;
+        explicit Picky(const std::string& s = "ok") : text(s) {
+            if (s.empty()) throw std::invalid_argument("empty");
+        }
+    };
+    std2::flat_map<int, Picky> map;
+    map.try_emplace(1, "one");
+    map.try_emplace(3, "three");
+    EXPECT_THROW(map.try_emplace(2, ""), std::invalid_argument);
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.keys().size(), map.values().size());
+    EXPECT_FALSE(map.contains(2));
+    EXPECT_EQ(map.at(3).text, "three");
+    EXPECT_TRUE(map.try_emplace(2, "two").second);
+    EXPECT_EQ((map.begin() + 1)->second.text, "two");
+}
+
+// Lookup and bulk load against std::map (and std::flat_map where the library has it)
+TEST_F(FlatMapTest, PerformanceBenchmark) {
+    const std::size_t n = 1000000;
+    const std::size_t lookups = 2000000;
+
+    std::mt19937_64 rng(1);
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> input(n);
+    for (std::size_t i = 0; i < n; ++i) input[i] = {rng(), i};
+    std::vector<std::uint64_t> probes(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) probes[i] = input[rng() % n].first;
+
+    auto time = [](auto&& fn) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+
+    std::map<std::uint64_t, std::uint64_t> tree;
+    std::cout << "std::map bulk load:        " << time([&] { tree.insert(input.begin(), input.end()); }) << " microseconds\n";
+
+    std2::flat_map<std::uint64_t, std::uint64_t> flat;
+    std::cout << "std2::flat_map bulk load:  " << time([&] { flat.insert(input.begin(), input.end()); }) << " microseconds\n";
+
+    std::uint64_t tree_sum = 0;
+    std::cout << "std::map lookups:          " << time([&] {
+        for (std::uint64_t key : probes) tree_sum += tree.find(key)->second;
+    }) << " microseconds\n";
+
+    std::uint64_t flat_sum = 0;
+    std::cout << "std2::flat_map lookups:    " << time([&] {
+        for (std::uint64_t key : probes) flat_sum += flat.find(key)->second;
+    }) << " microseconds\n";
+    EXPECT_EQ(tree_sum, flat_sum);
+
+#if defined(__cpp_lib_flat_map)
+    std::flat_map<std::uint64_t, std::uint64_t> std_flat;
+    std::cout << "std::flat_map bulk load:   " << time([&] { std_flat.insert(input.begin(), input.end()); }) << " microseconds\n";
+    std::uint64_t std_flat_sum = 0;
+    std::cout << "std::flat_map lookups:     " << time([&] {
+        for (std::uint64_t key : probes) std_flat_sum += std_flat.find(key)->second;
+    }) << " microseconds\n";
+    EXPECT_EQ(std_flat_sum, flat_sum);
+#else
+    std::cout << "std::flat_map not available in this standard library\n";
+#endif
+}
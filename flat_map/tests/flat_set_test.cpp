@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/flat_set.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+class FlatSetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+// Test single inserts, lookups and erase
+TEST_F(FlatSetTest, InsertFindErase) {
+    std2::flat_set<std::string> set;
+    EXPECT_TRUE(set.insert("pear").second);
+    EXPECT_TRUE(set.insert("apple").second);
+    EXPECT_FALSE(set.insert("pear").second);
+    EXPECT_TRUE(set.insert("fig").second);
+
+    ASSERT_EQ(set.size(), 3);
+    EXPECT_EQ(*set.begin(), "apple");
+    EXPECT_EQ(*set.find("fig"), "fig");
+    EXPECT_EQ(set.find("kiwi"), set.end());
+    EXPECT_EQ(*set.lower_bound("b"), "fig");
+
+    EXPECT_EQ(set.erase("apple"), 1);
+    EXPECT_EQ(set.erase("apple"), 0);
+    EXPECT_FALSE(set.contains("apple"));
+    EXPECT_EQ(set.size(), 2);
+}
+
+// Test bulk insert matches std::set
+TEST_F(FlatSetTest, BulkInsert) {
+    std::mt19937 rng(23);
+    std2::flat_set<int> set;
+    std::set<int> expected;
+    for (int round = 0; round < 4; ++round) {
+        std::vector<int> batch;
+        for (int i = 0; i < 5000; ++i) batch.push_back(static_cast<int>(rng() % 20000) - 10000);
+        set.insert(batch.begin(), batch.end());
+        expected.insert(batch.begin(), batch.end());
+
+        ASSERT_EQ(set.size(), expected.size());
+        EXPECT_TRUE(std::equal(set.begin(), set.end(), expected.begin()));
+    }
+}
+
+// Test adopting sorted input
+TEST_F(FlatSetTest, SortedUnique) {
+    std2::vector<int> keys;
+    for (int i = 0; i < 10; ++i) keys.push_back(i * 10);
+    std2::flat_set<int> set(std2::sorted_unique, std2::move(keys));
+    EXPECT_TRUE(set.contains(90));
+
+    std::vector<int> more = {5, 15, 95};
+    set.insert(std2::sorted_unique, more.begin(), more.end());
+    EXPECT_EQ(set.size(), 13);
+    EXPECT_EQ(set.keys()[1], 5);
+    EXPECT_EQ(*(set.end() - 1), 95);
+}
+
+// Membership tests against std::set
+TEST_F(FlatSetTest, PerformanceBenchmark) {
+    const std::size_t n = 1000000;
+    std::mt19937 rng(2);
+    std::vector<std::uint32_t> input(n);
+    for (auto& v : input) v = rng();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::set<std::uint32_t> tree(input.begin(), input.end());
+    std::size_t tree_hits = 0;
+    for (std::uint32_t i = 0; i < n; ++i) tree_hits += tree.count(input[i] ^ (i & 1));
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "std::set load + lookups:       "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " microseconds\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    std2::flat_set<std::uint32_t> flat(input.begin(), input.end());
+    std::size_t flat_hits = 0;
+    for (std::uint32_t i = 0; i < n; ++i) flat_hits += flat.count(input[i] ^ (i & 1));
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "std2::flat_set load + lookups: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " microseconds\n";
+
+    EXPECT_EQ(tree_hits, flat_hits);
+}
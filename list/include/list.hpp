@@ -1,42 +1,129 @@
 #ifndef LIST_HPP
 #define LIST_HPP
 
-#include "../../std2/std2.hpp" // for std2::move, std2::forward
+#include "../../std2/std2.hpp" // for std2::move, std2::forward, std2::prefetch
 #include "../../memory/memory.hpp" // for std2::unique_ptr
-#include <iostream>
+#include "../../std2/trace.hpp" // for STD2_TRACE_SCOPE
+#include <cstddef> // for std::size_t, std::ptrdiff_t
+#include <initializer_list>
+#include <iterator> // for std::bidirectional_iterator_tag, std::reverse_iterator, std::input_iterator
+#include <limits> // for std::numeric_limits
+#include <new> // for placement new, std::align_val_t
+#include <ranges> // for std::ranges::begin, std::ranges::end
+#include <stdexcept> // for std::length_error
+#include <type_traits> // for std::conditional_t, std::is_nothrow_move_constructible_v
+#include <utility> // for std::swap, std::pair
 
 namespace std2 {
 
     template <typename T>
     class list {
+        struct block;     // Header of a block of nodes, defined below
     public:
         struct Node;      // Forward declaration of Node
-        struct iterator;  // Forward declaration of iterator
+        template <bool IsConst> struct basic_iterator;
+
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr std::size_t PREFETCH_DISTANCE = 8;
 
         list() = default;
 
+        // the bulk constructors allocate every node in one block, linked in memory order
         list(std::initializer_list<T> init) : list() {
-            for (const auto& value : init) {
-                push_back(value);
-            }
+            append_block(init.size(), [it = init.begin()]() mutable -> const T& { return *it++; });
         }
 
         list(std::size_t count, const T& value) : list() {
-            for (std::size_t i = 0; i < count; ++i) {
-                push_back(value);
-            }
+            append_block(count, [&value]() -> const T& { return value; });
+        }
+
+        template <std::input_iterator It>
+        list(It first, It last) : list() {
+            insert(cend(), first, last);
+        }
+
+        list(const list& other) : list() {
+            append_block(other.m_size, [node = other.m_head]() mutable -> const T& {
+                const T& value = node->data;
+                node = node->next;
+                return value;
+            });
+        }
+
+        // nodes change owner, only end() iterators of other are invalidated
+        list(list&& other) noexcept
+            : m_head(std2::exchange(other.m_head, nullptr)),
+            m_tail(std2::exchange(other.m_tail, nullptr)),
+            m_size(std2::exchange(other.m_size, std::size_t(0)))
+        {}
+
+        list& operator=(list other) noexcept {
+            std::swap(m_head, other.m_head);
+            std::swap(m_tail, other.m_tail);
+            std::swap(m_size, other.m_size);
+            return *this;
         }
 
         ~list() {
-            while (m_head) pop_front();
+            clear();
         }
 
         iterator begin() {
-            return iterator(m_head);
+            return iterator(m_head, this);
         }
 
         iterator end() {
-            return iterator(nullptr);
+            return iterator(nullptr, this);
+        }
+
+        const_iterator begin() const {
+            return const_iterator(m_head, this);
+        }
+
+        const_iterator end() const {
+            return const_iterator(nullptr, this);
+        }
+
+        const_iterator cbegin() const {
+            return begin();
+        }
+
+        const_iterator cend() const {
+            return end();
+        }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crbegin() const { return rbegin(); }
+        const_reverse_iterator crend() const { return rend(); }
+
+        /**
+         *  @brief  Call f on every element in order while a scout runs distance nodes ahead
+         *  prefetching every cache line of the node it reaches.
+         *  The scout still follows the links one miss at a time, so this only hides those
+         *  misses behind f's own work when f does enough per node; to overlap the link
+         *  misses themselves, walk several lists with std2::for_each_interleaved.
+         *  @param  f  Callable taking T&.
+         *  @param  distance  How many nodes ahead to prefetch.
+         *  @return void.
+         */
+        template <typename F>
+        void for_each_prefetched(F f, std::size_t distance = PREFETCH_DISTANCE) {
+            walk_prefetched(m_head, f, distance);
+        }
+
+        template <typename F>
+        void for_each_prefetched(F f, std::size_t distance = PREFETCH_DISTANCE) const {
+            walk_prefetched(static_cast<const Node*>(m_head), f, distance);
         }
 
 
@@ -64,19 +151,102 @@ namespace std2 {
             add_node(it, element);
         }
 
+        /**
+         *  @brief  Insert a range before pos.
+         *  A forward range of at least BULK_MIN_NODES elements is allocated as one
+         *  block of nodes, shorter and single pass ranges get a node each.
+         *  @param  pos  The position to insert before, cend() appends.
+         *  @param  first  Start of the range.
+         *  @param  last  End of the range.
+         *  @return iterator to the first inserted element, or pos if the range is empty.
+         */
+        template <std::input_iterator It>
+        iterator insert(const_iterator pos, It first, It last) {
+            if constexpr (std::forward_iterator<It>) {
+                const auto n = static_cast<std::size_t>(std::distance(first, last));
+                if (n >= BULK_MIN_NODES) {
+                    auto [head, tail] = make_block(n, [&first]() -> decltype(auto) { return *first++; });
+                    link_before(pos.m_node, head, tail, n);
+                    return iterator(head, this);
+                }
+            }
+            Node* inserted = nullptr;
+            for (; first != last; ++first) {
+                Node* node = new Node(*first);
+                link_before(pos.m_node, node, node, 1);
+                if (!inserted) inserted = node;
+            }
+            return iterator(inserted ? inserted : pos.m_node, this);
+        }
+
+        /**
+         *  @brief  Replace the contents with count copies of value, in one block of nodes.
+         *  The list is unchanged if a copy throws.
+         *  @param  count  The number of elements.
+         *  @param  value  The value to copy.
+         *  @return void.
+         */
+        void assign(std::size_t count, const T& value) {
+            *this = list(count, value);
+        }
+
+        /**
+         *  @brief  Replace the contents with a range, in one block of nodes if it is a forward range.
+         *  The list is unchanged if a copy throws.
+         *  @param  first  Start of the range, may point into this list.
+         *  @param  last  End of the range.
+         *  @return void.
+         */
+        template <std::input_iterator It>
+        void assign(It first, It last) {
+            list fresh;
+            if constexpr (std::forward_iterator<It>) {
+                const auto n = static_cast<std::size_t>(std::distance(first, last));
+                fresh.append_block(n, [&first]() -> decltype(auto) { return *first++; });
+            } else {
+                fresh.insert(fresh.cend(), first, last);
+            }
+            *this = std2::move(fresh);
+        }
+
+        void assign(std::initializer_list<T> init) {
+            assign(init.begin(), init.end());
+        }
+
+        /**
+         *  @brief  Move the elements into one fresh block of nodes in traversal order.
+         *  Invalidates all iterators. Elements are copied instead of moved if moving may throw,
+         *  so the list is unchanged when an exception escapes.
+         *  @return void.
+         */
+        void compact() {
+            if (m_size == 0) return;
+            STD2_TRACE_SCOPE("std2::list::compact", m_size);
+            list fresh;
+            fresh.append_block(m_size, [node = m_head]() mutable -> decltype(auto) {
+                T& value = node->data;
+                node = node->next;
+                if constexpr (std::is_nothrow_move_constructible_v<T>) return std2::move(value);
+                else return static_cast<const T&>(value);
+            });
+            *this = std2::move(fresh);
+        }
+
         iterator erase(iterator& it) {
             if (!it.m_node) return end();
+            STD2_TRACE_SCOPE("std2::list::erase", m_size);
 
             Node* node = it.m_node;
+            Node* next = node->next;
 
             if (node->prev) node->prev->next = node->next;
             else m_head = node->next;
             if (node->next) node->next->prev = node->prev;
             else m_tail = node->prev;
 
-            delete node;
+            destroy_node(node);
             --m_size;
-            it = iterator(node->next);
+            it = iterator(next, this);
             return  it;
         }
 
@@ -85,8 +255,8 @@ namespace std2 {
                 Node* node = m_tail;
                 m_tail = m_tail->prev;
                 if (m_tail) m_tail->next = nullptr;
-                else m_tail = nullptr;
-                delete node;
+                else m_head = nullptr;
+                destroy_node(node);
                 --m_size; 
             }
         }
@@ -96,48 +266,176 @@ namespace std2 {
                 Node* node = m_head;
                 m_head = m_head->next;
                 if (m_head) m_head->prev = nullptr;
-                else m_head = nullptr;
-                delete node;
+                else m_tail = nullptr;
+                destroy_node(node);
                 --m_size;
             }
         }
 
-        std::size_t size() {
+        void clear() {
+            STD2_TRACE_SCOPE_IF(m_size >= trace::LARGE_CLEAR_THRESHOLD, "std2::list::clear", m_size);
+            while (m_head) pop_front();
+        }
+
+        std::size_t size() const {
             return m_size;
         }
 
+        bool empty() const {
+            return m_size == 0;
+        }
+
         struct Node {
             T data;
             Node* next;
             Node* prev;
-            Node(const T& value) : data(value), next(nullptr), prev(nullptr) {}
+            block* owner; // the block the node was carved from, null if allocated on its own
+            Node(const T& value) : data(value), next(nullptr), prev(nullptr), owner(nullptr) {}
+            Node(T&& value) : data(std2::move(value)), next(nullptr), prev(nullptr), owner(nullptr) {}
         };
 
-        struct iterator {
+        /*
+         * Bidirectional iterator. end() holds a null node, so the iterator
+         * also remembers its list to step back from end() to the tail.
+         */
+        template <bool IsConst>
+        struct basic_iterator {
         public:
-            explicit iterator(Node* node) : m_node(node) {}
-            T& operator*() const { return m_node->data; }
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<IsConst, const T*, T*>;
+            using reference = std::conditional_t<IsConst, const T&, T&>;
+            using owner = std::conditional_t<IsConst, const list, list>;
+
+            basic_iterator() = default;
+            basic_iterator(Node* node, owner* parent) : m_node(node), m_list(parent) {}
+
+            // iterator converts to const_iterator (a template, so it is never the copy constructor)
+            template <bool Other> requires (IsConst && !Other)
+            basic_iterator(const basic_iterator<Other>& other) : m_node(other.m_node), m_list(other.m_list) {}
+
+            reference operator*() const { return m_node->data; }
+            pointer operator->() const { return &m_node->data; }
+
             // pre-incrementer: increments this and returns current value
-            iterator& operator++() {
+            basic_iterator& operator++() {
                 if(m_node) m_node = m_node->next;
                 return *this;
             }
             // post-incrementer: increments this and returns the un-incremented value
-            iterator operator++(int) {
-                iterator temp = *this;
+            basic_iterator operator++(int) {
+                basic_iterator temp = *this;
                 if(m_node) m_node = m_node->next;
                 return temp;
             }
-            bool operator==(const iterator& other) const { return m_node == other.m_node; }
-            bool operator!=(const iterator& other) const { return m_node != other.m_node; }
+            // stepping back from end() lands on the tail
+            basic_iterator& operator--() {
+                m_node = m_node ? m_node->prev : m_list->m_tail;
+                return *this;
+            }
+            basic_iterator operator--(int) {
+                basic_iterator temp = *this;
+                --*this;
+                return temp;
+            }
+            bool operator==(const basic_iterator& other) const { return m_node == other.m_node; }
+            bool operator!=(const basic_iterator& other) const { return m_node != other.m_node; }
 
-            Node* m_node;
+            Node* m_node = nullptr;
+            owner* m_list = nullptr;
         };
     private:
+        static constexpr std::size_t BULK_MIN_NODES = 8;
+
+        /*
+         * Header of a block of nodes allocated together. The nodes follow the
+         * header and point back at it, a block is freed once its last node is erased.
+         */
+        struct alignas(Node) block {
+            std::size_t live; // nodes carved from the block that are still in a list
+            Node* nodes() { return reinterpret_cast<Node*>(this + 1); }
+        };
+
+        static void free_block(block* b) {
+            b->~block();
+            ::operator delete(b, std::align_val_t(alignof(block)));
+        }
+
+        /* @brief  Construct n nodes in one new block from successive next_value() calls, linked in order. */
+        template <typename Next>
+        static std::pair<Node*, Node*> make_block(std::size_t n, Next next_value) {
+            if (n > (std::numeric_limits<std::size_t>::max() - sizeof(block)) / sizeof(Node)) {
+                throw std::length_error("std2::list: too many nodes for one block");
+            }
+            void* raw = ::operator new(sizeof(block) + n * sizeof(Node), std::align_val_t(alignof(block)));
+            block* b = new (raw) block{n};
+            Node* nodes = b->nodes();
+            std::size_t built = 0;
+            try {
+                for (; built < n; ++built) {
+                    Node* node = new (&nodes[built]) Node(next_value());
+                    node->prev = built ? &nodes[built - 1] : nullptr;
+                    node->next = built + 1 < n ? &nodes[built + 1] : nullptr;
+                    node->owner = b;
+                }
+            } catch (...) {
+                while (built) nodes[--built].~Node();
+                free_block(b);
+                throw;
+            }
+            return { nodes, nodes + n - 1 };
+        }
+
+        template <typename Next>
+        void append_block(std::size_t n, Next next_value) {
+            if (n == 0) return;
+            auto [head, tail] = make_block(n, next_value);
+            link_before(nullptr, head, tail, n);
+        }
+
+        // link the chain first..last of n nodes in before pos, a null pos appends
+        void link_before(Node* pos, Node* first, Node* last, std::size_t n) {
+            Node* before = pos ? pos->prev : m_tail;
+            first->prev = before;
+            last->next = pos;
+            if (before) before->next = first;
+            else m_head = first;
+            if (pos) pos->prev = last;
+            else m_tail = last;
+            m_size += n;
+        }
+
+        // nodes from a block are destroyed in place, the block goes with its last node
+        static void destroy_node(Node* node) {
+            block* b = node->owner;
+            if (!b) {
+                delete node;
+                return;
+            }
+            node->~Node();
+            if (--b->live == 0) free_block(b);
+        }
+
+        template <typename NodePtr, typename F>
+        static void walk_prefetched(NodePtr node, F& f, std::size_t distance) {
+            NodePtr scout = node;
+            for (std::size_t i = 0; i < distance && scout; ++i) scout = scout->next;
+            for (; node; node = node->next) {
+                if (scout) {
+                    for (std::size_t offset = 0; offset < sizeof(Node); offset += 64) {
+                        std2::prefetch(reinterpret_cast<const char*>(scout) + offset);
+                    }
+                    scout = scout->next;
+                }
+                f(node->data);
+            }
+        }
 
         // position == 0 is front of head, position == m_size is behind tail
         bool add_node(iterator it, T element) {
             if (m_size > 0 && !it.m_node) return false;
+            STD2_TRACE_SCOPE("std2::list::add_node", m_size);
 
             if (!it.m_node) push_back(element);
             else if (it.m_node == m_head) push_front(element);
@@ -158,6 +456,43 @@ namespace std2 {
         Node* m_tail = nullptr;
         std::size_t m_size = 0;
     };
+
+    /**
+     *  @brief  Call f on every element of several lists, stepping through up to
+     *  INTERLEAVE_WIDTH of them in turn so their node misses are in flight together.
+     *  Each list is visited front to back; the order across lists is unspecified.
+     *  @param  lists  A range of std2::list.
+     *  @param  f  Callable taking the lists' element reference.
+     *  @return void.
+     */
+    template <std::ranges::range Lists, typename F>
+    void for_each_interleaved(Lists&& lists, F f) {
+        constexpr std::size_t INTERLEAVE_WIDTH = 8;
+        using cursor = decltype(std::ranges::begin(lists)->begin());
+
+        auto next_list = std::ranges::begin(lists);
+        const auto last_list = std::ranges::end(lists);
+        cursor lanes[INTERLEAVE_WIDTH];
+        std::size_t active = 0;
+        for (;;) {
+            // lists that run out hand their lane to the next list
+            for (; active < INTERLEAVE_WIDTH && next_list != last_list; ++next_list) {
+                if (!next_list->empty()) lanes[active++] = next_list->begin();
+            }
+            if (active == 0) return;
+            for (std::size_t lane = 0; lane < active;) {
+                cursor& it = lanes[lane];
+                f(*it);
+                ++it;
+                if (it.m_node) {
+                    std2::prefetch(it.m_node);
+                    ++lane;
+                } else {
+                    lanes[lane] = lanes[--active];
+                }
+            }
+        }
+    }
 }
 
 #endif // LIST_HPP
\ No newline at end of file
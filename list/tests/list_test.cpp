@@ -1,7 +1,21 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "../include/list.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // for __rdtsc
+#endif
 
 template <typename T>
 void print_list(std2::list<T>& vals) {
@@ -104,3 +118,416 @@ TEST_F(ListTest, FillConstructor) {
     EXPECT_EQ(vals.size(), 5);
     print_list(vals);
 }
+
+// Test iterating forwards and backwards, and through a const list
+TEST_F(ListTest, BidirectionalAndConstIterators) {
+    std2::list<int> vals{1, 2, 3, 4};
+
+    std::vector<int> backwards;
+    for (auto it = vals.end(); it != vals.begin();) backwards.push_back(*--it);
+    EXPECT_THAT(backwards, ::testing::ElementsAre(4, 3, 2, 1));
+
+    const std2::list<int>& view = vals;
+    int sum = 0;
+    for (const int& value : view) sum += value;
+    EXPECT_EQ(sum, 10);
+
+    std2::list<int>::const_iterator first = vals.begin(); // iterator converts to const_iterator
+    EXPECT_EQ(*first, 1);
+    EXPECT_TRUE(first == view.cbegin());
+    EXPECT_EQ(std::distance(view.begin(), view.end()), 4);
+
+    std::vector<int> sorted(view.begin(), view.end());
+    EXPECT_THAT(sorted, ::testing::ElementsAre(1, 2, 3, 4));
+}
+
+// Test copies are deep and moves hand over the nodes
+TEST_F(ListTest, CopyAndMove) {
+    std2::list<std::string> original{"a", "b", "c"};
+    std2::list<std::string> copy(original);
+    *copy.begin() = "changed";
+    EXPECT_EQ(*original.begin(), "a");
+
+    std2::list<std::string> moved(std2::move(copy));
+    EXPECT_EQ(copy.size(), 0);
+    EXPECT_EQ(moved.size(), 3);
+    EXPECT_EQ(*moved.begin(), "changed");
+
+    original = moved;
+    EXPECT_EQ(*original.begin(), "changed");
+    EXPECT_EQ(*--original.end(), "c");
+}
+
+// Element type that counts live instances and can be told to throw on a copy
+struct Tracked {
+    static inline int live = 0;
+    static inline int copies_until_throw = -1;
+
+    int value;
+    Tracked(int v) : value(v) { ++live; }
+    Tracked(const Tracked& other) : value(other.value) {
+        if (copies_until_throw == 0) throw std::runtime_error("copy");
+        if (copies_until_throw > 0) --copies_until_throw;
+        ++live;
+    }
+    Tracked(Tracked&& other) noexcept : value(other.value) { ++live; }
+    Tracked& operator=(const Tracked&) = default;
+    ~Tracked() { --live; }
+};
+
+// true if the nodes holding the elements sit back to back in memory, in traversal order
+template <typename T>
+bool contiguous(const std2::list<T>& vals) {
+    using Node = typename std2::list<T>::Node;
+    const Node* prev = nullptr;
+    for (auto it = vals.begin(); it != vals.end(); ++it) {
+        if (prev && it.m_node != prev + 1) return false;
+        prev = it.m_node;
+    }
+    return true;
+}
+
+// Test the bulk constructors allocate one block of nodes in traversal order
+TEST_F(ListTest, BulkConstruction) {
+    std2::list<int> filled(1000, 7);
+    EXPECT_EQ(filled.size(), 1000);
+    EXPECT_TRUE(contiguous(filled));
+    EXPECT_EQ(*--filled.end(), 7);
+
+    std2::list<std::string> init{"a", "b", "c", "d"};
+    EXPECT_TRUE(contiguous(init));
+    EXPECT_THAT(std::vector<std::string>(init.begin(), init.end()), ::testing::ElementsAre("a", "b", "c", "d"));
+
+    std::vector<int> source{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    std2::list<int> ranged(source.begin(), source.end());
+    EXPECT_TRUE(contiguous(ranged));
+    EXPECT_THAT(std::vector<int>(ranged.begin(), ranged.end()), ::testing::ElementsAreArray(source));
+
+    std2::list<int> copy(ranged);
+    EXPECT_TRUE(contiguous(copy));
+    EXPECT_EQ(copy.size(), 10);
+
+    // block nodes mix with single nodes and are freed as the last one goes
+    {
+        std2::list<Tracked> tracked(100, Tracked(1));
+        tracked.push_back(Tracked(2));
+        tracked.push_front(Tracked(0));
+        auto it = ++tracked.begin();
+        for (int i = 0; i < 50; ++i) tracked.erase(it);
+        EXPECT_EQ(tracked.size(), 52);
+        while (!tracked.empty()) tracked.pop_back();
+        tracked.push_back(Tracked(3));
+        EXPECT_EQ(Tracked::live, 1);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+// Test assign and range insert, including the short range and single pass paths
+TEST_F(ListTest, AssignAndInsertRange) {
+    std2::list<int> vals{1, 2};
+    vals.assign(5, 3);
+    EXPECT_THAT(std::vector<int>(vals.begin(), vals.end()), ::testing::ElementsAre(3, 3, 3, 3, 3));
+    vals.assign({4, 5, 6});
+    EXPECT_THAT(std::vector<int>(vals.begin(), vals.end()), ::testing::ElementsAre(4, 5, 6));
+    EXPECT_TRUE(contiguous(vals));
+
+    std::vector<int> many(20);
+    for (int i = 0; i < 20; ++i) many[i] = 100 + i;
+    auto it = vals.insert(++vals.cbegin(), many.begin(), many.end());
+    EXPECT_EQ(*it, 100);
+    EXPECT_EQ(vals.size(), 23);
+    EXPECT_EQ(*std::next(vals.begin(), 21), 5);
+
+    std::vector<int> few{-1, -2};
+    it = vals.insert(vals.cbegin(), few.begin(), few.end());
+    EXPECT_EQ(*it, -1);
+    EXPECT_EQ(*vals.begin(), -1);
+    it = vals.insert(vals.cend(), few.begin(), few.begin());
+    EXPECT_TRUE(it == vals.end());
+
+    std::istringstream words("7 8 9");
+    vals.insert(vals.cend(), std::istream_iterator<int>(words), std::istream_iterator<int>());
+    EXPECT_EQ(vals.size(), 28);
+    EXPECT_EQ(*--vals.end(), 9);
+
+    std::vector<int> expected{-1, -2, 4};
+    for (int i = 0; i < 20; ++i) expected.push_back(100 + i);
+    for (int v : {5, 6, 7, 8, 9}) expected.push_back(v);
+    EXPECT_THAT(std::vector<int>(vals.begin(), vals.end()), ::testing::ElementsAreArray(expected));
+
+    std::vector<int> backwards;
+    for (auto back = vals.end(); back != vals.begin();) backwards.push_back(*--back);
+    EXPECT_THAT(backwards, ::testing::ElementsAreArray(expected.rbegin(), expected.rend()));
+}
+
+// Test a throwing copy during bulk construction leaks nothing and leaves the target unchanged
+TEST_F(ListTest, BulkConstructionIsExceptionSafe) {
+    std::vector<Tracked> source;
+    for (int i = 0; i < 20; ++i) source.emplace_back(i);
+    const int before = Tracked::live;
+
+    Tracked::copies_until_throw = 10;
+    EXPECT_THROW(std2::list<Tracked>(source.begin(), source.end()), std::runtime_error);
+    EXPECT_EQ(Tracked::live, before);
+
+    Tracked::copies_until_throw = -1;
+    std2::list<Tracked> vals(3, Tracked(5));
+    Tracked::copies_until_throw = 10;
+    EXPECT_THROW(vals.insert(vals.cend(), source.begin(), source.end()), std::runtime_error);
+    EXPECT_EQ(vals.size(), 3);
+    Tracked::copies_until_throw = 10;
+    EXPECT_THROW(vals.assign(source.begin(), source.end()), std::runtime_error);
+    EXPECT_EQ(vals.size(), 3);
+    EXPECT_EQ(vals.begin()->value, 5);
+    Tracked::copies_until_throw = -1;
+
+    EXPECT_THROW(vals.assign(std::numeric_limits<std::size_t>::max(), Tracked(0)), std::length_error);
+    EXPECT_EQ(vals.size(), 3);
+}
+
+// Test nodes from many blocks can be erased in any order, each block going with its last node
+TEST_F(ListTest, ManyBlocks) {
+    std2::list<int> vals;
+    std::vector<int> chunk(8);
+    for (int b = 0; b < 20000; ++b) {
+        std::iota(chunk.begin(), chunk.end(), b * 8);
+        vals.insert(vals.cbegin(), chunk.begin(), chunk.end());
+    }
+    EXPECT_EQ(vals.size(), 160000);
+
+    // drop every other node front to back, then the rest from the back
+    std::size_t index = 0;
+    for (auto it = vals.begin(); it != vals.end(); ++index) {
+        if (index % 2) vals.erase(it);
+        else ++it;
+    }
+    EXPECT_EQ(vals.size(), 80000);
+    EXPECT_EQ(*vals.begin(), 159992);
+    while (vals.size() > 1) vals.pop_back();
+    EXPECT_EQ(*vals.begin(), 159992);
+}
+
+// Test compact() relinks a scattered list into one block and keeps its order
+TEST_F(ListTest, Compact) {
+    std2::list<std::string> vals;
+    for (int i = 0; i < 100; ++i) {
+        if (i % 2) vals.push_back(std::to_string(i));
+        else vals.push_front(std::to_string(i));
+    }
+    std::vector<std::string> order(vals.begin(), vals.end());
+    EXPECT_FALSE(contiguous(vals));
+
+    vals.compact();
+    EXPECT_TRUE(contiguous(vals));
+    EXPECT_THAT(std::vector<std::string>(vals.begin(), vals.end()), ::testing::ElementsAreArray(order));
+
+    // still an ordinary list afterwards
+    auto it = vals.begin();
+    vals.erase(it);
+    vals.push_back("tail");
+    EXPECT_EQ(vals.size(), 100);
+    EXPECT_EQ(*--vals.end(), "tail");
+    vals.compact();
+    EXPECT_EQ(*vals.begin(), order[1]);
+
+    std2::list<int> empty;
+    empty.compact();
+    EXPECT_TRUE(empty.empty());
+}
+
+// Construction cost and traversal speed of a scattered list before and after compact()
+TEST_F(ListTest, PerformanceBenchmark) {
+    struct payload {
+        std::uint64_t a, b;
+    };
+    const std::size_t n = 2000000;
+
+    auto time = [](auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        body();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+    auto sum = [](const std2::list<payload>& vals) {
+        std::uint64_t total = 0;
+        for (const payload& p : vals) total += p.a;
+        return total;
+    };
+
+    std2::list<payload> pushed;
+    const auto push_time = time([&] { for (std::size_t i = 0; i < n; ++i) pushed.push_back(payload{1, 0}); });
+    std2::list<payload> bulk;
+    const auto bulk_time = time([&] { bulk = std2::list<payload>(n, payload{1, 0}); });
+
+    // free a list of nodes in random order so the next list's nodes land all over the heap
+    {
+        std2::list<payload> scatter;
+        std::vector<std2::list<payload>::iterator> nodes;
+        for (std::size_t i = 0; i < n; ++i) {
+            scatter.push_back(payload{0, 0});
+            nodes.push_back(--scatter.end());
+        }
+        std::shuffle(nodes.begin(), nodes.end(), std::mt19937(42));
+        for (auto& node : nodes) scatter.erase(node);
+    }
+    std2::list<payload> scattered;
+    for (std::size_t i = 0; i < n; ++i) scattered.push_back(payload{1, 0});
+
+    std::uint64_t totals[4] = {};
+    const auto scattered_time = time([&] { totals[0] = sum(scattered); });
+    const auto compact_time = time([&] { scattered.compact(); });
+    const auto compacted_time = time([&] { totals[1] = sum(scattered); });
+    const auto pushed_time = time([&] { totals[2] = sum(pushed); });
+    const auto bulk_walk_time = time([&] { totals[3] = sum(bulk); });
+
+    std::cout << n << " nodes\n"
+              << "  construct   push_back loop " << push_time << " us, bulk " << bulk_time << " us\n"
+              << "  traverse    scattered " << scattered_time << " us, after compact() " << compacted_time
+              << " us (compact took " << compact_time << " us)\n"
+              << "  traverse    push_back built " << pushed_time << " us, bulk built " << bulk_walk_time << " us\n";
+
+    for (std::uint64_t total : totals) EXPECT_EQ(total, n);
+    EXPECT_TRUE(contiguous(scattered));
+}
+
+// Test reverse iteration, through mutable and const lists
+TEST_F(ListTest, ReverseIterators) {
+    std2::list<int> vals{1, 2, 3, 4, 5};
+    EXPECT_THAT(std::vector<int>(vals.rbegin(), vals.rend()), ::testing::ElementsAre(5, 4, 3, 2, 1));
+
+    for (auto it = vals.rbegin(); it != vals.rend(); ++it) *it *= 10;
+    const std2::list<int>& view = vals;
+    EXPECT_THAT(std::vector<int>(view.crbegin(), view.crend()), ::testing::ElementsAre(50, 40, 30, 20, 10));
+    EXPECT_EQ(*std::next(view.rbegin(), 2), 30);
+    EXPECT_TRUE(std::next(vals.rbegin(), 5) == vals.rend());
+
+    std2::list<int> empty;
+    EXPECT_TRUE(empty.rbegin() == empty.rend());
+}
+
+// Test prefetched and interleaved traversal visit every element in list order
+TEST_F(ListTest, PrefetchedAndInterleavedTraversal) {
+    std2::list<int> vals;
+    for (int i = 0; i < 50; ++i) vals.push_back(i);
+    for (std::size_t distance : {0, 1, 3, 8, 100}) {
+        std::vector<int> seen;
+        vals.for_each_prefetched([&seen](int& value) { seen.push_back(value); }, distance);
+        ASSERT_EQ(seen.size(), 50);
+        for (int i = 0; i < 50; ++i) ASSERT_EQ(seen[i], i);
+    }
+    vals.for_each_prefetched([](int& value) { value += 1; });
+    const std2::list<int>& view = vals;
+    int sum = 0;
+    view.for_each_prefetched([&sum](const int& value) { sum += value; });
+    EXPECT_EQ(sum, 50 * 51 / 2);
+
+    // more lists than lanes, of different lengths, some empty
+    std::vector<std2::list<int>> lists(20);
+    int total = 0;
+    for (int l = 0; l < 20; ++l) {
+        for (int i = 0; i < (l * 7) % 13; ++i, ++total) lists[l].push_back(l * 1000 + i);
+    }
+    std::vector<std::vector<int>> seen(20);
+    std2::for_each_interleaved(lists, [&seen](int& value) { seen[value / 1000].push_back(value % 1000); });
+    int visited = 0;
+    for (int l = 0; l < 20; ++l) {
+        ASSERT_EQ(seen[l].size(), lists[l].size());
+        for (std::size_t i = 0; i < seen[l].size(); ++i) ASSERT_EQ(seen[l][i], int(i));
+        visited += int(seen[l].size());
+    }
+    EXPECT_EQ(visited, total);
+
+    const auto& const_lists = lists;
+    long long checksum = 0;
+    std2::for_each_interleaved(const_lists, [&checksum](const int& value) { checksum += value; });
+    long long expected = 0;
+    for (const auto& list : lists) for (int value : list) expected += value;
+    EXPECT_EQ(checksum, expected);
+}
+
+// Cycles per node walking lists bigger than the last level cache whose nodes are in random memory order
+TEST_F(ListTest, PrefetchBenchmark) {
+    struct payload {
+        std::uint64_t words[24]; // 192 bytes, a node spans four cache lines
+    };
+    const std::size_t lanes = 8;
+    const std::size_t per_list = 16384; // about 28 MiB of nodes in total, past a typical last level cache
+
+    // insert each node before a random earlier one, so list order and address order are unrelated
+    std::mt19937 rng(7);
+    std::vector<std2::list<payload>> lists(lanes);
+    for (auto& list : lists) {
+        std::vector<std2::list<payload>::iterator> nodes;
+        nodes.reserve(per_list);
+        list.push_back(payload{{1}});
+        nodes.push_back(list.begin());
+        for (std::size_t i = 1; i < per_list; ++i) {
+            auto it = nodes[rng() % nodes.size()];
+            payload p{};
+            p.words[0] = 1;
+            p.words[23] = i;
+            list.insert(it, p);
+            nodes.push_back(std::prev(it));
+        }
+    }
+    const std::size_t total = lanes * per_list;
+
+    // TSC ticks on x86, nanoseconds elsewhere
+    auto ticks = [] {
+#if defined(__x86_64__) || defined(__i386__)
+        return std::uint64_t(__rdtsc());
+#else
+        return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    };
+    auto cycles_per_node = [total, &ticks](auto&& body) {
+        const std::uint64_t start = ticks();
+        body();
+        return double(ticks() - start) / double(total);
+    };
+    // light work touches two lines of a node, heavy work hashes all of it
+    auto light = [](std::uint64_t& sum) { return [&sum](const payload& p) { sum += p.words[0] + p.words[23]; }; };
+    auto heavy = [](std::uint64_t& sum) {
+        return [&sum](const payload& p) {
+            std::uint64_t h = sum;
+            for (std::uint64_t w : p.words) h = (h ^ w) * 0x100000001b3ULL;
+            sum = h;
+        };
+    };
+    // plain, prefetched and interleaved walks of the same lists, as cycles per node
+    auto measure = [&](auto make, std::uint64_t (&sums)[3]) {
+        double plain = cycles_per_node([&] {
+            auto f = make(sums[0]);
+            for (const auto& list : lists) for (const payload& p : list) f(p);
+        });
+        double prefetched = cycles_per_node([&] {
+            for (const auto& list : lists) list.for_each_prefetched(make(sums[1]));
+        });
+        double interleaved = cycles_per_node([&] { std2::for_each_interleaved(lists, make(sums[2])); });
+        return std::vector<double>{plain, prefetched, interleaved};
+    };
+
+    std::uint64_t light_sums[3] = {}, heavy_sums[3] = {}, compact_light[3] = {}, compact_heavy[3] = {};
+    const auto scattered_light = measure(light, light_sums);
+    const auto scattered_heavy = measure(heavy, heavy_sums);
+    for (auto& list : lists) list.compact();
+    const auto compacted_light = measure(light, compact_light);
+    const auto compacted_heavy = measure(heavy, compact_heavy);
+
+    auto row = [](const char* name, const std::vector<double>& c) {
+        std::cout << "  " << name << "plain " << c[0] << ", prefetched " << c[1] << ", interleaved " << c[2] << "\n";
+    };
+    std::cout << lanes << " lists x " << per_list << " nodes of " << sizeof(payload) << " bytes, cycles per node\n";
+    row("scattered, light work   ", scattered_light);
+    row("scattered, heavy work   ", scattered_heavy);
+    row("compacted, light work   ", compacted_light);
+    row("compacted, heavy work   ", compacted_heavy);
+
+    // the hash depends on visiting order, which only matches within one list at a time
+    EXPECT_EQ(light_sums[0], light_sums[1]);
+    EXPECT_EQ(light_sums[0], light_sums[2]);
+    EXPECT_EQ(heavy_sums[0], heavy_sums[1]);
+    EXPECT_EQ(compact_light[0], light_sums[0]);
+    EXPECT_EQ(compact_heavy[0], heavy_sums[0]);
+}
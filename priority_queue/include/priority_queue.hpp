@@ -0,0 +1,437 @@
+#ifndef PRIORITY_QUEUE_HPP
+#define PRIORITY_QUEUE_HPP
+
+#include <cstddef>     // for std::size_t
+#include <functional>  // for std::less
+#include <iterator>    // for std::input_iterator, std::sentinel_for
+#include <limits>      // for std::numeric_limits
+#include <stdexcept>   // for std::out_of_range
+#include <string>      // for std::string
+#include "../../std2/std2.hpp" // for std2::move, std2::forward, std2::prefetch
+#include "../../vector/include/vector.hpp" // for std2::vector
+
+namespace std2 {
+
+namespace heap_detail {
+
+/*
+ * Sift helpers shared by both queues. The hole technique moves every element
+ * once per level instead of swapping, and place(i) is called whenever an
+ * element lands at index i so the indexed queue can keep its position table
+ * current; the plain queue passes a no-op that compiles away.
+ */
+
+template <std::size_t Arity, typename Vec, typename Less, typename Place>
+void sift_up(Vec& heap, std::size_t index, Less& less, Place place) {
+    auto value = std2::move(heap[index]);
+    while (index > 0) {
+        const std::size_t parent = (index - 1) / Arity;
+        if (!less(heap[parent], value)) break;
+        heap[index] = std2::move(heap[parent]);
+        place(index);
+        index = parent;
+    }
+    heap[index] = std2::move(value);
+    place(index);
+}
+
+/* @brief  Index of the highest priority child among the children starting at first. */
+template <std::size_t Arity, typename Vec, typename Less>
+std::size_t best_child(Vec& heap, std::size_t first, std::size_t n, Less& less) {
+    std::size_t best = first;
+    if (first + Arity <= n) {
+        // full group: fixed trip count, unrolled and compiled to conditional moves
+        for (std::size_t k = 1; k < Arity; ++k) {
+            best = less(heap[best], heap[first + k]) ? first + k : best;
+        }
+    } else {
+        for (std::size_t child = first + 1; child < n; ++child) {
+            if (less(heap[best], heap[child])) best = child;
+        }
+    }
+    // the next level's children are needed next iteration, fetch them while moving
+    if (best * Arity + 1 < n) std2::prefetch(heap.data() + best * Arity + 1);
+    return best;
+}
+
+template <std::size_t Arity, typename Vec, typename Less, typename Place>
+void sift_down(Vec& heap, std::size_t index, Less& less, Place place) {
+    const std::size_t n = heap.size();
+    auto value = std2::move(heap[index]);
+    while (index * Arity + 1 < n) {
+        const std::size_t best = best_child<Arity>(heap, index * Arity + 1, n, less);
+        if (!less(value, heap[best])) break;
+        heap[index] = std2::move(heap[best]);
+        place(index);
+        index = best;
+    }
+    heap[index] = std2::move(value);
+    place(index);
+}
+
+/*
+ * Sift-down for the element that replaced the top. It came from the bottom
+ * of the heap and almost always belongs there again, so walk the hole down
+ * to a leaf without comparing against it, then sift it up the few levels it
+ * may have overshot: one comparison per level fewer than sift_down.
+ */
+template <std::size_t Arity, typename Vec, typename Less, typename Place>
+void sift_down_from_top(Vec& heap, Less& less, Place place) {
+    const std::size_t n = heap.size();
+    auto value = std2::move(heap[0]);
+    std::size_t index = 0;
+    while (index * Arity + 1 < n) {
+        const std::size_t best = best_child<Arity>(heap, index * Arity + 1, n, less);
+        heap[index] = std2::move(heap[best]);
+        place(index);
+        index = best;
+    }
+    heap[index] = std2::move(value);
+    sift_up<Arity>(heap, index, less, place);
+}
+
+/* @brief  Floyd's bottom-up heap construction, O(n). */
+template <std::size_t Arity, typename Vec, typename Less, typename Place>
+void heapify(Vec& heap, Less& less, Place place) {
+    const std::size_t n = heap.size();
+    if (n < 2) return;
+    for (std::size_t i = (n - 2) / Arity + 1; i-- > 0;) {
+        sift_down<Arity>(heap, i, less, place);
+    }
+}
+
+} // namespace heap_detail
+
+/*
+ * Priority queue on a d-ary heap stored in a std2::vector. Like
+ * std::priority_queue, top() is the element for which Compare orders every
+ * other element before it (the largest with std::less).
+ *
+ * Arity 4 is the default: the heap is half as deep as a binary heap and the
+ * four children of a node are adjacent, so a sift-down level touches one
+ * cache line for small T. Arity 8 suits pop-light workloads with cheap
+ * comparisons, arity 2 favours pop-heavy ones.
+ */
+template <typename T, typename Compare = std::less<T>, std::size_t Arity = 4>
+class priority_queue {
+    static_assert(Arity == 2 || Arity == 4 || Arity == 8, "std2::priority_queue arity must be 2, 4 or 8");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    static constexpr std::size_t ARITY = Arity;
+
+    priority_queue() = default;
+
+    explicit priority_queue(const Compare& comp) : m_comp(comp) {}
+
+    /**
+     *  @brief  Build a queue from a range in O(n).
+     *  @param  first  Start of the range.
+     *  @param  last  End of the range.
+     *  @param  comp  The ordering.
+     */
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    priority_queue(It first, S last, const Compare& comp = Compare()) : m_comp(comp) {
+        for (; first != last; ++first) m_heap.push_back(*first);
+        heap_detail::heapify<Arity>(m_heap, m_comp, no_place);
+    }
+
+    /**
+     *  @brief  Add a range of elements. Large batches are appended and re-heapified
+     *          in O(n), small ones are sifted in one by one.
+     *  @param  first  Start of the range.
+     *  @param  last  End of the range.
+     *  @return void.
+     */
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    void push_range(It first, S last) {
+        const std::size_t before = m_heap.size();
+        for (; first != last; ++first) m_heap.push_back(*first);
+        const std::size_t added = m_heap.size() - before;
+
+        // sifting k elements up costs about k log n, rebuilding costs about n
+        if (added > before / 4) {
+            heap_detail::heapify<Arity>(m_heap, m_comp, no_place);
+        } else {
+            for (std::size_t i = before; i < m_heap.size(); ++i) heap_detail::sift_up<Arity>(m_heap, i, m_comp, no_place);
+        }
+    }
+
+    void push(const T& value) {
+        m_heap.push_back(value);
+        heap_detail::sift_up<Arity>(m_heap, m_heap.size() - 1, m_comp, no_place);
+    }
+
+    void push(T&& value) {
+        m_heap.push_back(std2::move(value));
+        heap_detail::sift_up<Arity>(m_heap, m_heap.size() - 1, m_comp, no_place);
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        m_heap.emplace_back(std2::forward<Args>(args)...);
+        heap_detail::sift_up<Arity>(m_heap, m_heap.size() - 1, m_comp, no_place);
+    }
+
+    /**
+     *  @brief  The highest priority element.
+     *  @return const reference to the top element.
+     *  @throws std::out_of_range if the queue is empty.
+     */
+    const T& top() const {
+        if (m_heap.empty()) throw std::out_of_range("std2::priority_queue::top: queue is empty");
+        return m_heap[0];
+    }
+
+    /**
+     *  @brief  Remove the top element, does nothing when empty.
+     *  @return void.
+     */
+    void pop() {
+        if (m_heap.empty()) return;
+        remove_top();
+    }
+
+    /**
+     *  @brief  Remove the top element and hand it back.
+     *  @return the former top element.
+     *  @throws std::out_of_range if the queue is empty.
+     */
+    T extract_top() {
+        if (m_heap.empty()) throw std::out_of_range("std2::priority_queue::extract_top: queue is empty");
+        T value = std2::move(m_heap[0]);
+        remove_top();
+        return value;
+    }
+
+    void reserve(std::size_t n) { m_heap.reserve(n); }
+    void clear() { m_heap.clear(); }
+
+    std::size_t size() const { return m_heap.size(); }
+    bool empty() const { return m_heap.empty(); }
+
+private:
+    static constexpr auto no_place = [](std::size_t) {};
+
+    void remove_top() {
+        const std::size_t last = m_heap.size() - 1;
+        if (last > 0) m_heap[0] = std2::move(m_heap[last]);
+        m_heap.pop_back();
+        if (!m_heap.empty()) heap_detail::sift_down_from_top<Arity>(m_heap, m_comp, no_place);
+    }
+
+    std2::vector<T> m_heap;
+    Compare m_comp;
+};
+
+/*
+ * Priority queue whose elements can be changed or removed after insertion.
+ * push() returns a handle that stays valid until its element is popped or
+ * erased; handles are then recycled. A position table maps every handle to
+ * its heap slot, so update, erase and contains are O(log n) / O(1) without
+ * searching. Queues built from a range hand out handles 0..n-1 in range
+ * order, which lets graph algorithms use vertex ids as handles.
+ */
+template <typename T, typename Compare = std::less<T>, std::size_t Arity = 4>
+class indexed_priority_queue {
+    static_assert(Arity == 2 || Arity == 4 || Arity == 8, "std2::indexed_priority_queue arity must be 2, 4 or 8");
+
+public:
+    using value_type = T;
+    using handle = std::size_t;
+    static constexpr std::size_t ARITY = Arity;
+    static constexpr handle npos = std::numeric_limits<std::size_t>::max();
+
+    indexed_priority_queue() = default;
+
+    explicit indexed_priority_queue(const Compare& comp) : m_less{comp} {}
+
+    /**
+     *  @brief  Build a queue from a range in O(n); the i-th element gets handle i.
+     *  @param  first  Start of the range.
+     *  @param  last  End of the range.
+     *  @param  comp  The ordering.
+     */
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    indexed_priority_queue(It first, S last, const Compare& comp = Compare()) : m_less{comp} {
+        for (; first != last; ++first) {
+            m_position.push_back(m_heap.size());
+            m_heap.push_back(entry{*first, m_heap.size()});
+        }
+        heap_detail::heapify<Arity>(m_heap, m_less, placer{this});
+    }
+
+    /**
+     *  @brief  Add an element.
+     *  @param  value  The element.
+     *  @return its handle.
+     */
+    handle push(const T& value) { return insert(T(value)); }
+    handle push(T&& value) { return insert(std2::move(value)); }
+
+    /**
+     *  @brief  The highest priority element.
+     *  @return const reference to the top element.
+     *  @throws std::out_of_range if the queue is empty.
+     */
+    const T& top() const {
+        if (m_heap.empty()) throw std::out_of_range("std2::indexed_priority_queue::top: queue is empty");
+        return m_heap[0].value;
+    }
+
+    /**
+     *  @brief  Handle of the highest priority element.
+     *  @return the handle.
+     *  @throws std::out_of_range if the queue is empty.
+     */
+    handle top_handle() const {
+        if (m_heap.empty()) throw std::out_of_range("std2::indexed_priority_queue::top_handle: queue is empty");
+        return m_heap[0].id;
+    }
+
+    /**
+     *  @brief  Remove the top element, does nothing when empty.
+     *  @return void.
+     */
+    void pop() {
+        if (!m_heap.empty()) remove_at(0);
+    }
+
+    /**
+     *  @brief  Whether the handle refers to an element still in the queue.
+     *  @param  h  The handle.
+     *  @return true if h is live.
+     */
+    bool contains(handle h) const {
+        return h < m_position.size() && m_position[h] != npos;
+    }
+
+    /**
+     *  @brief  The element behind a handle.
+     *  @param  h  The handle.
+     *  @return const reference to the element.
+     *  @throws std::out_of_range if h is not live.
+     */
+    const T& value(handle h) const {
+        return m_heap[checked_position(h, "std2::indexed_priority_queue::value")].value;
+    }
+
+    /**
+     *  @brief  Replace an element and restore the heap in O(log n).
+     *  @param  h  The handle.
+     *  @param  value  The new value, higher or lower priority than the old one.
+     *  @return void.
+     *  @throws std::out_of_range if h is not live.
+     */
+    void update(handle h, T value) {
+        const std::size_t index = checked_position(h, "std2::indexed_priority_queue::update");
+        const bool raised = m_less.comp(m_heap[index].value, value);
+        m_heap[index].value = std2::move(value);
+        if (raised) heap_detail::sift_up<Arity>(m_heap, index, m_less, placer{this});
+        else heap_detail::sift_down<Arity>(m_heap, index, m_less, placer{this});
+    }
+
+    /**
+     *  @brief  The classic names for update. Whether a smaller key moves an element
+     *          towards the top depends on Compare (it does for std::greater, the
+     *          min-heap of Dijkstra and Prim), so both sift whichever way the new
+     *          value requires.
+     *  @param  h  The handle.
+     *  @param  value  The new value.
+     *  @return void.
+     *  @throws std::out_of_range if h is not live.
+     */
+    void decrease_key(handle h, T value) { update(h, std2::move(value)); }
+    void increase_key(handle h, T value) { update(h, std2::move(value)); }
+
+    /**
+     *  @brief  Remove an element in O(log n); its handle becomes free for reuse.
+     *  @param  h  The handle.
+     *  @return void.
+     *  @throws std::out_of_range if h is not live.
+     */
+    void erase(handle h) {
+        remove_at(checked_position(h, "std2::indexed_priority_queue::erase"));
+    }
+
+    void reserve(std::size_t n) {
+        m_heap.reserve(n);
+        m_position.reserve(n);
+    }
+
+    void clear() {
+        m_heap.clear();
+        m_position.clear();
+        m_free.clear();
+    }
+
+    std::size_t size() const { return m_heap.size(); }
+    bool empty() const { return m_heap.empty(); }
+
+private:
+    struct entry {
+        T value;
+        handle id;
+    };
+
+    /* @brief  Compare entries by value. */
+    struct entry_less {
+        bool operator()(const entry& a, const entry& b) { return comp(a.value, b.value); }
+        Compare comp;
+    };
+
+    /* @brief  Record where an entry landed. */
+    struct placer {
+        void operator()(std::size_t index) const { queue->m_position[queue->m_heap[index].id] = index; }
+        indexed_priority_queue* queue;
+    };
+
+    handle insert(T&& value) {
+        handle h;
+        if (!m_free.empty()) {
+            h = m_free[m_free.size() - 1];
+            m_free.pop_back();
+        } else {
+            h = m_position.size();
+            m_position.push_back(npos);
+        }
+        m_heap.push_back(entry{std2::move(value), h});
+        heap_detail::sift_up<Arity>(m_heap, m_heap.size() - 1, m_less, placer{this});
+        return h;
+    }
+
+    std::size_t checked_position(handle h, const char* what) const {
+        if (!contains(h)) throw std::out_of_range(std::string(what) + ": handle is not in the queue");
+        return m_position[h];
+    }
+
+    /* @brief  Fill the slot with the last entry and sift it whichever way it needs to go. */
+    void remove_at(std::size_t index) {
+        const handle removed = m_heap[index].id;
+        const std::size_t last = m_heap.size() - 1;
+        if (index != last) m_heap[index] = std2::move(m_heap[last]);
+        m_heap.pop_back();
+        m_position[removed] = npos;
+        m_free.push_back(removed);
+
+        if (index == 0 && !m_heap.empty()) {
+            heap_detail::sift_down_from_top<Arity>(m_heap, m_less, placer{this});
+        } else if (index < m_heap.size()) {
+            if (index > 0 && m_less(m_heap[(index - 1) / Arity], m_heap[index])) {
+                heap_detail::sift_up<Arity>(m_heap, index, m_less, placer{this});
+            } else {
+                heap_detail::sift_down<Arity>(m_heap, index, m_less, placer{this});
+            }
+        }
+    }
+
+    std2::vector<entry> m_heap;
+    std2::vector<std::size_t> m_position; // heap slot of every handle, npos when free
+    std2::vector<handle> m_free;
+    entry_less m_less;
+};
+
+} // namespace std2
+
+#endif // PRIORITY_QUEUE_HPP
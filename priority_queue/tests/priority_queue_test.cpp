@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/priority_queue.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+class PriorityQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    // random graph as an adjacency list of (target, weight)
+    static std::vector<std::vector<std::pair<int, long long>>> random_graph(int vertices, int edges_per_vertex, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> target(0, vertices - 1);
+        std::uniform_int_distribution<int> weight(1, 1000);
+        std::vector<std::vector<std::pair<int, long long>>> graph(vertices);
+        for (int v = 0; v < vertices; ++v) {
+            for (int e = 0; e < edges_per_vertex; ++e) graph[v].emplace_back(target(rng), weight(rng));
+        }
+        return graph;
+    }
+
+    // textbook Dijkstra with lazy deletion on std::priority_queue
+    static std::vector<long long> dijkstra_lazy(const std::vector<std::vector<std::pair<int, long long>>>& graph) {
+        std::vector<long long> dist(graph.size(), std::numeric_limits<long long>::max());
+        std::priority_queue<std::pair<long long, int>, std::vector<std::pair<long long, int>>, std::greater<>> queue;
+        dist[0] = 0;
+        queue.emplace(0, 0);
+        while (!queue.empty()) {
+            auto [d, v] = queue.top();
+            queue.pop();
+            if (d != dist[v]) continue;
+            for (auto [to, w] : graph[v]) {
+                if (d + w < dist[to]) {
+                    dist[to] = d + w;
+                    queue.emplace(dist[to], to);
+                }
+            }
+        }
+        return dist;
+    }
+
+    // Dijkstra with one heap slot per vertex and decrease_key; vertex ids are the handles
+    template <std::size_t Arity>
+    static std::vector<long long> dijkstra_indexed(const std::vector<std::vector<std::pair<int, long long>>>& graph) {
+        const long long inf = std::numeric_limits<long long>::max();
+        std::vector<long long> dist(graph.size(), inf);
+        dist[0] = 0;
+        std2::indexed_priority_queue<long long, std::greater<long long>, Arity> queue(dist.begin(), dist.end());
+        while (!queue.empty() && queue.top() != inf) {
+            const auto v = queue.top_handle();
+            const long long d = queue.top();
+            queue.pop();
+            for (auto [to, w] : graph[v]) {
+                if (d + w < dist[to] && queue.contains(to)) {
+                    dist[to] = d + w;
+                    queue.decrease_key(to, dist[to]);
+                }
+            }
+        }
+        return dist;
+    }
+};
+
+// Test pops come out in priority order for every arity and both orderings
+TEST_F(PriorityQueueTest, OrderMatchesStd) {
+    std::mt19937 rng(7);
+    std::vector<int> values(5000);
+    for (int& v : values) v = static_cast<int>(rng() % 1000);
+
+    auto check = [&values](auto queue, auto reference) {
+        for (int v : values) {
+            queue.push(v);
+            reference.push(v);
+        }
+        ASSERT_EQ(queue.size(), values.size());
+        while (!reference.empty()) {
+            ASSERT_EQ(queue.top(), reference.top());
+            queue.pop();
+            reference.pop();
+        }
+        EXPECT_TRUE(queue.empty());
+    };
+
+    check(std2::priority_queue<int, std::less<int>, 2>(), std::priority_queue<int>());
+    check(std2::priority_queue<int, std::less<int>, 4>(), std::priority_queue<int>());
+    check(std2::priority_queue<int, std::less<int>, 8>(), std::priority_queue<int>());
+    check(std2::priority_queue<int, std::greater<int>, 4>(), std::priority_queue<int, std::vector<int>, std::greater<int>>());
+}
+
+// Test heapify from a range, push_range and move-only elements
+TEST_F(PriorityQueueTest, HeapifyAndBulkPush) {
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) values.push_back((i * 7919) % 1000);
+
+    std2::priority_queue<int, std::greater<int>, 8> queue(values.begin(), values.end());
+    for (int expected = 0; expected < 10; ++expected) {
+        EXPECT_EQ(queue.extract_top(), expected);
+    }
+
+    std::vector<int> more{-5, -1, 2000};
+    queue.push_range(more.begin(), more.end());
+    EXPECT_EQ(queue.top(), -5);
+    EXPECT_EQ(queue.size(), 993);
+
+    std2::priority_queue<std::string> words;
+    words.emplace("pear");
+    words.push(std::string("apple"));
+    words.emplace(3, 'z');
+    EXPECT_EQ(words.extract_top(), "zzz");
+    EXPECT_EQ(words.extract_top(), "pear");
+
+    std2::priority_queue<int> empty;
+    EXPECT_THROW(empty.top(), std::out_of_range);
+    EXPECT_THROW(empty.extract_top(), std::out_of_range);
+    empty.pop();
+    EXPECT_TRUE(empty.empty());
+}
+
+// Test handles follow their elements through updates and erasures
+TEST_F(PriorityQueueTest, IndexedUpdates) {
+    std2::indexed_priority_queue<int, std::greater<int>> queue;
+    std::vector<std::size_t> handles;
+    for (int i = 0; i < 100; ++i) handles.push_back(queue.push(100 + i));
+    EXPECT_EQ(queue.top(), 100);
+
+    queue.decrease_key(handles[50], 1);
+    EXPECT_EQ(queue.top(), 1);
+    EXPECT_EQ(queue.top_handle(), handles[50]);
+
+    queue.increase_key(handles[50], 500);
+    EXPECT_EQ(queue.top(), 100);
+    EXPECT_EQ(queue.value(handles[50]), 500);
+
+    queue.erase(handles[0]);
+    EXPECT_FALSE(queue.contains(handles[0]));
+    EXPECT_EQ(queue.top(), 101);
+    EXPECT_THROW(queue.erase(handles[0]), std::out_of_range);
+    EXPECT_THROW(queue.update(12345, 0), std::out_of_range);
+
+    // the freed handle is reused
+    EXPECT_EQ(queue.push(7), handles[0]);
+    EXPECT_EQ(queue.top(), 7);
+
+    std::vector<int> drained;
+    while (!queue.empty()) {
+        drained.push_back(queue.top());
+        queue.pop();
+    }
+    EXPECT_TRUE(std::is_sorted(drained.begin(), drained.end()));
+    EXPECT_EQ(drained.size(), 100);
+    EXPECT_EQ(drained.back(), 500);
+}
+
+// Test random updates and erasures against a brute force model
+TEST_F(PriorityQueueTest, IndexedRandomized) {
+    std::mt19937 rng(11);
+    std2::indexed_priority_queue<int, std::less<int>, 8> queue;
+    std::vector<std::pair<std::size_t, int>> model; // live (handle, value)
+
+    for (int step = 0; step < 20000; ++step) {
+        const unsigned op = rng() % 4;
+        if (op == 0 || model.empty()) {
+            const int value = static_cast<int>(rng() % 100000);
+            model.emplace_back(queue.push(value), value);
+        } else if (op == 1) {
+            auto& [h, value] = model[rng() % model.size()];
+            value = static_cast<int>(rng() % 100000);
+            queue.update(h, value);
+        } else if (op == 2) {
+            const std::size_t i = rng() % model.size();
+            queue.erase(model[i].first);
+            model.erase(model.begin() + i);
+        } else {
+            auto best = std::max_element(model.begin(), model.end(),
+                                         [](const auto& a, const auto& b) { return a.second < b.second; });
+            ASSERT_EQ(queue.top(), best->second);
+            ASSERT_EQ(queue.value(queue.top_handle()), best->second);
+        }
+        ASSERT_EQ(queue.size(), model.size());
+    }
+    for (const auto& [h, value] : model) ASSERT_EQ(queue.value(h), value);
+}
+
+// Test Dijkstra with decrease_key agrees with the lazy deletion version
+TEST_F(PriorityQueueTest, Dijkstra) {
+    const auto graph = random_graph(2000, 6, 3);
+    const auto expected = dijkstra_lazy(graph);
+    EXPECT_EQ(dijkstra_indexed<2>(graph), expected);
+    EXPECT_EQ(dijkstra_indexed<4>(graph), expected);
+    EXPECT_EQ(dijkstra_indexed<8>(graph), expected);
+}
+
+// Push/pop throughput per arity against std::priority_queue, then Dijkstra workloads
+TEST_F(PriorityQueueTest, PerformanceBenchmark) {
+    const int n = 2000000;
+    std::mt19937 rng(42);
+    std::vector<int> values(n);
+    for (int& v : values) v = static_cast<int>(rng());
+
+    auto time = [](auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        body();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+
+    long long checksum_std = 0;
+    const auto std_time = time([&] {
+        std::priority_queue<int> queue;
+        for (int v : values) queue.push(v);
+        while (!queue.empty()) { checksum_std += queue.top(); queue.pop(); }
+    });
+    std::cout << "push + pop " << n << " ints, std::priority_queue: " << std_time << " us\n";
+
+    auto run = [&](auto queue, const char* label) {
+        long long checksum = 0;
+        const auto elapsed = time([&] {
+            for (int v : values) queue.push(v);
+            while (!queue.empty()) { checksum += queue.top(); queue.pop(); }
+        });
+        std::cout << "push + pop " << n << " ints, " << label << ": " << elapsed << " us\n";
+        EXPECT_EQ(checksum, checksum_std);
+    };
+    run(std2::priority_queue<int, std::less<int>, 2>(), "std2::priority_queue arity 2");
+    run(std2::priority_queue<int, std::less<int>, 4>(), "std2::priority_queue arity 4");
+    run(std2::priority_queue<int, std::less<int>, 8>(), "std2::priority_queue arity 8");
+
+    const auto heapify_time = time([&] {
+        std2::priority_queue<int> queue(values.begin(), values.end());
+        EXPECT_EQ(queue.size(), values.size());
+    });
+    const auto make_heap_time = time([&] {
+        std::vector<int> copy(values);
+        std::make_heap(copy.begin(), copy.end());
+    });
+    std::cout << "heapify " << n << " ints: std2 arity 4 " << heapify_time << " us, std::make_heap " << make_heap_time << " us\n";
+
+    const auto graph = random_graph(200000, 8, 5);
+    std::vector<long long> lazy, indexed2, indexed4, indexed8;
+    const auto lazy_time = time([&] { lazy = dijkstra_lazy(graph); });
+    const auto indexed2_time = time([&] { indexed2 = dijkstra_indexed<2>(graph); });
+    const auto indexed4_time = time([&] { indexed4 = dijkstra_indexed<4>(graph); });
+    const auto indexed8_time = time([&] { indexed8 = dijkstra_indexed<8>(graph); });
+    std::cout << "Dijkstra, 200000 vertices x 8 edges:\n"
+              << "  std::priority_queue, lazy deletion:      " << lazy_time << " us\n"
+              << "  indexed_priority_queue arity 2, decrease: " << indexed2_time << " us\n"
+              << "  indexed_priority_queue arity 4, decrease: " << indexed4_time << " us\n"
+              << "  indexed_priority_queue arity 8, decrease: " << indexed8_time << " us\n";
+    EXPECT_EQ(lazy, indexed4);
+}
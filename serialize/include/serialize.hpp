@@ -0,0 +1,558 @@
+#ifndef SERIALIZE_HPP
+#define SERIALIZE_HPP
+
+#include <cerrno>       // for errno, EINTR
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t
+#include <cstring>      // for std::memcpy
+#include <limits>       // for std::numeric_limits
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+#include <system_error> // for std::system_error
+#include <type_traits>  // for std::is_trivially_copyable_v
+
+#include <fcntl.h>      // for open
+#include <sys/stat.h>   // for fstat, S_ISREG
+#include <sys/uio.h>    // for writev, iovec
+#include <unistd.h>     // for read, close, lseek
+
+#include "../../std2/std2.hpp"                 // for std2::move
+#include "../../vector/include/vector.hpp"     // for std2::vector
+#include "../../list/include/list.hpp"         // for std2::list
+#include "../../memory/include/unique_ptr.hpp" // for std2::unique_ptr
+
+namespace std2 {
+
+/*
+ * Compact binary serialization for std2 containers.
+ *
+ * Stream layout (native byte order, checked on read):
+ *   stream header : u32 magic "S2SR", u16 version, u16 byte order mark
+ *   scalar        : raw bytes of any trivially copyable value
+ *   vector / list : u8 tag, u32 element size (0 unless bulk), u64 count, elements
+ *   unique_ptr    : u8 tag, u8 engaged, payload if engaged
+ *
+ * A std2::vector of trivially copyable elements is written as one bulk block,
+ * which goes out together with the buffered record header in a single writev.
+ */
+
+enum class record_tag : std::uint8_t {
+    vector = 1,
+    list = 2,
+    unique_ptr = 3
+};
+
+/*
+ * Buffered writer on top of a file descriptor.
+ * Small writes are gathered in the buffer, large writes skip it.
+ */
+class binary_writer {
+public:
+    static constexpr std::uint32_t MAGIC = 0x52533253; // "S2SR"
+    static constexpr std::uint16_t VERSION = 1;
+    static constexpr std::uint16_t BYTE_ORDER_MARK = 0x0102;
+
+    /**
+     *  @brief  Write to an already open file descriptor, the caller keeps ownership.
+     *  @param  fd  A descriptor open for writing.
+     */
+    explicit binary_writer(int fd) : m_fd(fd), m_owns_fd(false) {
+        init();
+    }
+
+    /**
+     *  @brief  Create (or truncate) the file at path and write to it.
+     *  @param  path  The output file.
+     */
+    explicit binary_writer(const std::string& path)
+        : m_fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)), m_owns_fd(true) {
+        if (m_fd < 0) throw std::system_error(errno, std::generic_category(), "std2::binary_writer open " + path);
+        init();
+    }
+
+    binary_writer(const binary_writer&) = delete;
+    binary_writer& operator=(const binary_writer&) = delete;
+
+    ~binary_writer() {
+        try {
+            flush();
+        } catch (...) {
+            // destructors must not throw - call flush() explicitly to see errors
+        }
+        if (m_owns_fd) ::close(m_fd);
+    }
+
+    /**
+     *  @brief  Write raw bytes.
+     *  @param  data  The bytes to write.
+     *  @param  count  Number of bytes.
+     *  @return void.
+     */
+    void write_bytes(const void* data, std::size_t count) {
+        if (count >= BULK_THRESHOLD) {
+            // one writev for whatever is buffered plus the whole payload
+            iovec iov[2] = {
+                { m_buffer.data(), m_used },
+                { const_cast<void*>(data), count }
+            };
+            write_all(iov, 2);
+            m_used = 0;
+            return;
+        }
+
+        if (m_used + count > m_buffer.size()) flush();
+        std::memcpy(m_buffer.data() + m_used, data, count);
+        m_used += count;
+    }
+
+    /**
+     *  @brief  Write a trivially copyable value as raw bytes.
+     *  @param  value  The value to write.
+     *  @return void.
+     */
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void write_value(const T& value) {
+        write_bytes(&value, sizeof(T));
+    }
+
+    /**
+     *  @brief  Push buffered bytes to the file descriptor.
+     *  @return void.
+     */
+    void flush() {
+        if (m_used == 0) return;
+        iovec iov[1] = { { m_buffer.data(), m_used } };
+        write_all(iov, 1);
+        m_used = 0;
+    }
+
+    /**
+     *  @brief  Total number of bytes accepted so far, including the stream header.
+     *  @return byte count.
+     */
+    std::size_t bytes_written() const { return m_total + m_used; }
+
+private:
+    static constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+    static constexpr std::size_t BULK_THRESHOLD = 16 * 1024;
+
+    void init() {
+        m_buffer.resize(BUFFER_SIZE);
+        write_value(MAGIC);
+        write_value(VERSION);
+        write_value(BYTE_ORDER_MARK);
+    }
+
+    /* @brief  writev until everything is out, handling short writes and EINTR.
+     * @param  iov  The io vectors, modified while writing.
+     * @param  count  Number of io vectors.
+     * @return void.
+     */
+    void write_all(iovec* iov, int count) {
+        while (count > 0) {
+            const ssize_t written = ::writev(m_fd, iov, count);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "std2::binary_writer writev");
+            }
+            m_total += static_cast<std::size_t>(written);
+
+            std::size_t left = static_cast<std::size_t>(written);
+            while (count > 0 && left >= iov->iov_len) {
+                left -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+                iov->iov_len -= left;
+            }
+        }
+    }
+
+    int m_fd;
+    bool m_owns_fd;
+    std2::vector<char> m_buffer;
+    std::size_t m_used = 0;
+    std::size_t m_total = 0;
+};
+
+/*
+ * Buffered reader on top of a file descriptor.
+ * Large reads go straight into the destination.
+ */
+class binary_reader {
+public:
+    static constexpr std::uint64_t UNKNOWN_LENGTH = std::numeric_limits<std::uint64_t>::max();
+
+    /**
+     *  @brief  Read from an already open file descriptor, the caller keeps ownership.
+     *  @param  fd  A descriptor open for reading.
+     */
+    explicit binary_reader(int fd) : m_fd(fd), m_owns_fd(false) {
+        init();
+    }
+
+    /**
+     *  @brief  Open the file at path and read from it.
+     *  @param  path  The input file.
+     */
+    explicit binary_reader(const std::string& path)
+        : m_fd(::open(path.c_str(), O_RDONLY)), m_owns_fd(true) {
+        if (m_fd < 0) throw std::system_error(errno, std::generic_category(), "std2::binary_reader open " + path);
+        init();
+    }
+
+    binary_reader(const binary_reader&) = delete;
+    binary_reader& operator=(const binary_reader&) = delete;
+
+    ~binary_reader() {
+        if (m_owns_fd) ::close(m_fd);
+    }
+
+    /**
+     *  @brief  Read exactly count bytes, throws if the stream ends early.
+     *  @param  data  Destination for the bytes.
+     *  @param  count  Number of bytes.
+     *  @return void.
+     */
+    void read_bytes(void* data, std::size_t count) {
+        char* dst = static_cast<char*>(data);
+
+        const std::size_t buffered = m_end - m_pos;
+        const std::size_t from_buffer = count < buffered ? count : buffered;
+        std::memcpy(dst, m_buffer.data() + m_pos, from_buffer);
+        m_pos += from_buffer;
+        dst += from_buffer;
+        count -= from_buffer;
+
+        if (count >= BULK_THRESHOLD) {
+            read_all(dst, count);
+            return;
+        }
+
+        while (count > 0) {
+            refill();
+            const std::size_t n = count < m_end ? count : m_end;
+            std::memcpy(dst, m_buffer.data(), n);
+            m_pos = n;
+            dst += n;
+            count -= n;
+        }
+    }
+
+    /**
+     *  @brief  Read a trivially copyable value.
+     *  @return the value.
+     */
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    T read_value() {
+        T value;
+        read_bytes(&value, sizeof(T));
+        return value;
+    }
+
+    /**
+     *  @brief  Bytes left in the stream, known when the descriptor is a regular file.
+     *  @return the byte count, or UNKNOWN_LENGTH for pipes, sockets and the like.
+     */
+    std::uint64_t remaining() const {
+        if (m_file_left == UNKNOWN_LENGTH) return UNKNOWN_LENGTH;
+        return (m_end - m_pos) + m_file_left;
+    }
+
+private:
+    static constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+    static constexpr std::size_t BULK_THRESHOLD = 16 * 1024;
+
+    void init() {
+        struct stat st;
+        if (::fstat(m_fd, &st) == 0 && S_ISREG(st.st_mode)) {
+            const off_t offset = ::lseek(m_fd, 0, SEEK_CUR);
+            if (offset >= 0) m_file_left = offset < st.st_size ? static_cast<std::uint64_t>(st.st_size - offset) : 0;
+        }
+        m_buffer.resize(BUFFER_SIZE);
+        if (read_value<std::uint32_t>() != binary_writer::MAGIC) {
+            throw std::runtime_error("std2::binary_reader: not a std2 stream");
+        }
+        if (read_value<std::uint16_t>() != binary_writer::VERSION) {
+            throw std::runtime_error("std2::binary_reader: unsupported version");
+        }
+        if (read_value<std::uint16_t>() != binary_writer::BYTE_ORDER_MARK) {
+            throw std::runtime_error("std2::binary_reader: byte order mismatch");
+        }
+    }
+
+    void refill() {
+        const ssize_t got = read_some(m_buffer.data(), m_buffer.size());
+        if (got == 0) throw std::runtime_error("std2::binary_reader: unexpected end of stream");
+        m_pos = 0;
+        m_end = static_cast<std::size_t>(got);
+    }
+
+    void read_all(char* dst, std::size_t count) {
+        while (count > 0) {
+            const ssize_t got = read_some(dst, count);
+            if (got == 0) throw std::runtime_error("std2::binary_reader: unexpected end of stream");
+            dst += got;
+            count -= static_cast<std::size_t>(got);
+        }
+    }
+
+    ssize_t read_some(char* dst, std::size_t count) {
+        for (;;) {
+            const ssize_t got = ::read(m_fd, dst, count);
+            if (got >= 0) {
+                // a file that grew since it was opened just reads as having nothing left
+                if (m_file_left != UNKNOWN_LENGTH) {
+                    const auto read = static_cast<std::uint64_t>(got);
+                    m_file_left = read < m_file_left ? m_file_left - read : 0;
+                }
+                return got;
+            }
+            if (errno != EINTR) throw std::system_error(errno, std::generic_category(), "std2::binary_reader read");
+        }
+    }
+
+    int m_fd;
+    bool m_owns_fd;
+    std2::vector<char> m_buffer;
+    std::size_t m_pos = 0;
+    std::size_t m_end = 0;
+    std::uint64_t m_file_left = UNKNOWN_LENGTH; // bytes of a regular file not read from the descriptor yet
+};
+
+namespace serialize_detail {
+
+inline void write_record(binary_writer& writer, record_tag tag, std::uint32_t element_size, std::uint64_t count) {
+    writer.write_value(tag);
+    writer.write_value(element_size);
+    writer.write_value(count);
+}
+
+inline std::uint64_t read_record(binary_reader& reader, record_tag expected, std::uint32_t element_size) {
+    if (reader.read_value<record_tag>() != expected) {
+        throw std::runtime_error("std2::deserialize: unexpected record type");
+    }
+    if (reader.read_value<std::uint32_t>() != element_size) {
+        throw std::runtime_error("std2::deserialize: element size mismatch");
+    }
+    return reader.read_value<std::uint64_t>();
+}
+
+template <typename T>
+constexpr std::uint32_t bulk_size() {
+    return std::is_trivially_copyable_v<T> ? sizeof(T) : 0;
+}
+
+// fewest bytes an element can take in the stream, every record starts with its tag byte
+template <typename T>
+constexpr std::uint64_t min_size() {
+    return std::is_trivially_copyable_v<T> ? sizeof(T) : sizeof(record_tag);
+}
+
+// elements a vector grows by at a time when the stream length is unknown
+constexpr std::uint64_t UNVERIFIED_GROWTH = 4096;
+
+// reject an element count the rest of the stream cannot hold before allocating for it
+template <typename T>
+void check_count(const binary_reader& reader, std::uint64_t count) {
+    if (count > reader.remaining() / min_size<T>() || count > std::numeric_limits<std::size_t>::max()) {
+        throw std::runtime_error("std2::deserialize: element count exceeds the stream");
+    }
+}
+
+} // namespace serialize_detail
+
+/**
+ *  @brief  Serialize a trivially copyable value as raw bytes.
+ *  @param  writer  The output stream.
+ *  @param  value  The value to write.
+ *  @return void.
+ */
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+void serialize(binary_writer& writer, const T& value) {
+    writer.write_value(value);
+}
+
+/**
+ *  @brief  Serialize a std2::vector - trivially copyable elements go out as one block.
+ *  @param  writer  The output stream.
+ *  @param  vec  The vector to write.
+ *  @return void.
+ */
+template <typename T, typename Allocator>
+void serialize(binary_writer& writer, const std2::vector<T, Allocator>& vec) {
+    serialize_detail::write_record(writer, record_tag::vector, serialize_detail::bulk_size<T>(), vec.size());
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        writer.write_bytes(vec.data(), vec.size() * sizeof(T));
+    } else {
+        for (std::size_t i = 0; i < vec.size(); ++i) {
+            serialize(writer, vec[i]);
+        }
+    }
+}
+
+/**
+ *  @brief  Serialize a std2::list element by element.
+ *  @param  writer  The output stream.
+ *  @param  lst  The list to write.
+ *  @return void.
+ */
+template <typename T>
+void serialize(binary_writer& writer, const std2::list<T>& lst) {
+    serialize_detail::write_record(writer, record_tag::list, serialize_detail::bulk_size<T>(), lst.size());
+    for (const T& value : lst) {
+        serialize(writer, value);
+    }
+}
+
+/**
+ *  @brief  Serialize the object owned by a std2::unique_ptr (or its absence).
+ *  @param  writer  The output stream.
+ *  @param  ptr  The pointer whose payload is written.
+ *  @return void.
+ */
+template <typename T, typename Deleter>
+void serialize(binary_writer& writer, const std2::unique_ptr<T, Deleter>& ptr) {
+    writer.write_value(record_tag::unique_ptr);
+    writer.write_value(static_cast<std::uint8_t>(ptr.get() != nullptr));
+    if (ptr.get()) serialize(writer, *ptr);
+}
+
+/**
+ *  @brief  Deserialize a trivially copyable value.
+ *  @param  reader  The input stream.
+ *  @param  value  Receives the value.
+ *  @return void.
+ */
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+void deserialize(binary_reader& reader, T& value) {
+    reader.read_bytes(&value, sizeof(T));
+}
+
+/**
+ *  @brief  Deserialize a std2::vector, replacing its contents.
+ *  @param  reader  The input stream.
+ *  @param  vec  Receives the elements.
+ *  @return void.
+ *  @throws std::runtime_error if the element count does not fit in the rest of the stream.
+ */
+template <typename T, typename Allocator>
+void deserialize(binary_reader& reader, std2::vector<T, Allocator>& vec) {
+    const std::uint64_t count = serialize_detail::read_record(reader, record_tag::vector, serialize_detail::bulk_size<T>());
+    serialize_detail::check_count<T>(reader, count);
+    vec.clear();
+
+    // the count is only verified against regular files, otherwise grow as the elements arrive
+    std::uint64_t filled = 0;
+    std::uint64_t target = count;
+    if (reader.remaining() == binary_reader::UNKNOWN_LENGTH && count > serialize_detail::UNVERIFIED_GROWTH) {
+        target = serialize_detail::UNVERIFIED_GROWTH;
+    }
+    while (filled < count) {
+        vec.resize(target);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            reader.read_bytes(vec.data() + filled, (target - filled) * sizeof(T));
+        } else {
+            for (std::size_t i = filled; i < target; ++i) {
+                deserialize(reader, vec[i]);
+            }
+        }
+        filled = target;
+        target = count - filled < filled ? count : 2 * filled;
+    }
+}
+
+/**
+ *  @brief  Deserialize a whole std2::list, replacing its contents.
+ *          Use list_chunk_reader to stream huge lists instead.
+ *  @param  reader  The input stream.
+ *  @param  lst  Receives the elements.
+ *  @return void.
+ *  @throws std::runtime_error if the element count does not fit in the rest of the stream.
+ */
+template <typename T>
+void deserialize(binary_reader& reader, std2::list<T>& lst) {
+    const std::uint64_t count = serialize_detail::read_record(reader, record_tag::list, serialize_detail::bulk_size<T>());
+    serialize_detail::check_count<T>(reader, count);
+    lst.clear();
+    for (std::uint64_t i = 0; i < count; ++i) {
+        T value{};
+        deserialize(reader, value);
+        lst.push_back(std2::move(value));
+    }
+}
+
+/**
+ *  @brief  Deserialize a std2::unique_ptr payload, resetting the pointer.
+ *          Only for the default deleter, since the object is allocated with new;
+ *          a pointer with a custom deleter has no matching overload.
+ *  @param  reader  The input stream.
+ *  @param  ptr  Receives a newly allocated object, or nullptr.
+ *  @return void.
+ */
+template <typename T>
+void deserialize(binary_reader& reader, std2::unique_ptr<T, std2::default_delete<T>>& ptr) {
+    if (reader.read_value<record_tag>() != record_tag::unique_ptr) {
+        throw std::runtime_error("std2::deserialize: unexpected record type");
+    }
+    if (!reader.read_value<std::uint8_t>()) {
+        ptr.reset();
+        return;
+    }
+    ptr.reset(new T());
+    deserialize(reader, *ptr);
+}
+
+/*
+ * Streams a serialized std2::list in chunks so huge lists never have to be
+ * fully resident in memory.
+ */
+template <typename T>
+class list_chunk_reader {
+public:
+    /**
+     *  @brief  Consume the list record header from the stream.
+     *  @param  reader  The input stream, positioned at a list record.
+     */
+    explicit list_chunk_reader(binary_reader& reader)
+        : m_reader(reader),
+        m_remaining(serialize_detail::read_record(reader, record_tag::list, serialize_detail::bulk_size<T>()))
+    {}
+
+    /**
+     *  @brief  Append up to max_elements of the next elements to out.
+     *  @param  out  The list to append to.
+     *  @param  max_elements  Upper bound on the chunk size.
+     *  @return number of elements appended, 0 once the list is exhausted.
+     */
+    std::size_t read_chunk(std2::list<T>& out, std::size_t max_elements) {
+        const std::size_t count = m_remaining < max_elements ? m_remaining : max_elements;
+        for (std::size_t i = 0; i < count; ++i) {
+            T value{};
+            deserialize(m_reader, value);
+            out.push_back(std2::move(value));
+        }
+        m_remaining -= count;
+        return count;
+    }
+
+    /**
+     *  @brief  Number of elements not read yet.
+     *  @return element count.
+     */
+    std::uint64_t remaining() const { return m_remaining; }
+
+private:
+    binary_reader& m_reader;
+    std::uint64_t m_remaining;
+};
+
+} // namespace std2
+
+#endif // SERIALIZE_HPP
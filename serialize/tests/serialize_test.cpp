@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/serialize.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+
+struct Sample {
+    std::int32_t id;
+    float weight;
+};
+
+class SerializeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = (std::filesystem::temp_directory_path() /
+                ("std2_serialize_" + std::to_string(::getpid()) + ".bin")).string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    std::string path;
+};
+
+// Test scalar and vector round trip
+TEST_F(SerializeTest, VectorRoundTrip) {
+    std2::vector<Sample> out;
+    for (int i = 0; i < 10000; ++i) out.push_back(Sample{i, i * 0.25f});
+    {
+        std2::binary_writer writer(path);
+        std2::serialize(writer, 42);
+        std2::serialize(writer, out);
+        std2::serialize(writer, 7.5);
+    }
+
+    std2::binary_reader reader(path);
+    int head = 0;
+    double tail = 0;
+    std2::vector<Sample> in;
+    std2::deserialize(reader, head);
+    std2::deserialize(reader, in);
+    std2::deserialize(reader, tail);
+
+    EXPECT_EQ(head, 42);
+    EXPECT_EQ(tail, 7.5);
+    ASSERT_EQ(in.size(), out.size());
+    EXPECT_EQ(in[9999].id, 9999);
+    EXPECT_EQ(in[9999].weight, 9999 * 0.25f);
+}
+
+// Test list and unique_ptr round trip
+TEST_F(SerializeTest, ListAndUniquePtrRoundTrip) {
+    std2::list<int> lst = {1, 2, 3, 4};
+    std2::unique_ptr<int> engaged(new int(99));
+    std2::unique_ptr<int> empty;
+    {
+        std2::binary_writer writer(path);
+        std2::serialize(writer, lst);
+        std2::serialize(writer, engaged);
+        std2::serialize(writer, empty);
+    }
+
+    std2::binary_reader reader(path);
+    std2::list<int> lst_in;
+    std2::unique_ptr<int> engaged_in;
+    std2::unique_ptr<int> empty_in(new int(1));
+    std2::deserialize(reader, lst_in);
+    std2::deserialize(reader, engaged_in);
+    std2::deserialize(reader, empty_in);
+
+    EXPECT_EQ(lst_in.size(), 4);
+    EXPECT_EQ(*lst_in.begin(), 1);
+    ASSERT_NE(engaged_in.get(), nullptr);
+    EXPECT_EQ(*engaged_in, 99);
+    EXPECT_EQ(empty_in.get(), nullptr);
+}
+
+// a deleter that did not allocate with new
+struct free_deleter {
+    void operator()(int* p) const { std::free(p); }
+};
+
+template <typename Ptr>
+concept deserializable = requires(std2::binary_reader& reader, Ptr& ptr) { std2::deserialize(reader, ptr); };
+
+static_assert(deserializable<std2::unique_ptr<int>>);
+static_assert(!deserializable<std2::unique_ptr<int, free_deleter>>,
+              "deserialize allocates with new, so it must not accept a custom deleter");
+
+// Test nested combinations
+TEST_F(SerializeTest, NestedContainers) {
+    std2::vector<std2::vector<int>> nested;
+    for (int i = 0; i < 50; ++i) {
+        std2::vector<int> inner;
+        for (int j = 0; j < i; ++j) inner.push_back(j);
+        nested.push_back(std2::move(inner));
+    }
+    std2::list<std2::vector<double>> list_of_vectors;
+    std2::vector<double> doubles;
+    doubles.push_back(1.5);
+    list_of_vectors.push_back(doubles);
+    std2::unique_ptr<std2::vector<int>> owned(new std2::vector<int>());
+    owned->push_back(5);
+    {
+        std2::binary_writer writer(path);
+        std2::serialize(writer, nested);
+        std2::serialize(writer, list_of_vectors);
+        std2::serialize(writer, owned);
+    }
+
+    std2::binary_reader reader(path);
+    std2::vector<std2::vector<int>> nested_in;
+    std2::list<std2::vector<double>> list_in;
+    std2::unique_ptr<std2::vector<int>> owned_in;
+    std2::deserialize(reader, nested_in);
+    std2::deserialize(reader, list_in);
+    std2::deserialize(reader, owned_in);
+
+    ASSERT_EQ(nested_in.size(), 50);
+    EXPECT_EQ(nested_in[49].size(), 49);
+    EXPECT_EQ(nested_in[49][48], 48);
+    EXPECT_EQ((*list_in.begin())[0], 1.5);
+    EXPECT_EQ((*owned_in)[0], 5);
+}
+
+// Test reading a huge list in fixed size chunks
+TEST_F(SerializeTest, ChunkedListReading) {
+    const int count = 100000;
+    {
+        std2::list<int> lst;
+        for (int i = 0; i < count; ++i) lst.push_back(i);
+        std2::binary_writer writer(path);
+        std2::serialize(writer, lst);
+    }
+
+    std2::binary_reader reader(path);
+    std2::list_chunk_reader<int> chunks(reader);
+    EXPECT_EQ(chunks.remaining(), count);
+
+    long long sum = 0;
+    std::size_t chunk_count = 0;
+    std2::list<int> chunk;
+    while (chunks.read_chunk(chunk, 4096) > 0) {
+        EXPECT_LE(chunk.size(), 4096);
+        for (int v : chunk) sum += v;
+        while (chunk.size()) chunk.pop_front();
+        ++chunk_count;
+    }
+    EXPECT_EQ(chunk_count, (count + 4095) / 4096);
+    EXPECT_EQ(sum, static_cast<long long>(count) * (count - 1) / 2);
+}
+
+// Test malformed input is rejected
+TEST_F(SerializeTest, RejectsMismatchedInput) {
+    {
+        std2::binary_writer writer(path);
+        std2::vector<int> vals;
+        vals.push_back(1);
+        std2::serialize(writer, vals);
+    }
+    {
+        std2::binary_reader reader(path);
+        std2::list<int> wrong_kind;
+        EXPECT_THROW(std2::deserialize(reader, wrong_kind), std::runtime_error);
+    }
+    {
+        std2::binary_reader reader(path);
+        std2::vector<double> wrong_size;
+        EXPECT_THROW(std2::deserialize(reader, wrong_size), std::runtime_error);
+    }
+    {
+        std2::binary_reader reader(path);
+        std2::vector<int> vals;
+        std2::deserialize(reader, vals);
+        int past_end = 0;
+        EXPECT_THROW(std2::deserialize(reader, past_end), std::runtime_error);
+    }
+}
+
+// Test a corrupt element count fails cleanly instead of allocating for it
+TEST_F(SerializeTest, RejectsOversizedCount) {
+    // a vector record claiming 2^40 ints followed by only three of them
+    auto write_forged = [](std2::binary_writer& writer) {
+        std2::serialize(writer, std2::record_tag::vector);
+        std2::serialize(writer, std::uint32_t(sizeof(int)));
+        std2::serialize(writer, std::uint64_t(1) << 40);
+        for (int i = 0; i < 3; ++i) std2::serialize(writer, i);
+    };
+    {
+        std2::binary_writer writer(path);
+        write_forged(writer);
+    }
+    {
+        std2::binary_reader reader(path);
+        std2::vector<int> vals;
+        EXPECT_THROW(std2::deserialize(reader, vals), std::runtime_error);
+    }
+    {
+        std2::binary_reader reader(path);
+        std2::vector<std2::vector<int>> nested;
+        EXPECT_THROW(std2::deserialize(reader, nested), std::runtime_error);
+    }
+
+    // a pipe has no length to check against, the vector grows only as far as the data goes
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    {
+        std2::binary_writer writer(fds[1]);
+        write_forged(writer);
+    }
+    ::close(fds[1]);
+    {
+        std2::binary_reader reader(fds[0]);
+        EXPECT_EQ(reader.remaining(), std2::binary_reader::UNKNOWN_LENGTH);
+        std2::vector<int> vals;
+        EXPECT_THROW(std2::deserialize(reader, vals), std::runtime_error);
+        EXPECT_LE(vals.size(), 4096);
+    }
+    ::close(fds[0]);
+}
+
+// Test deserializing into a non-empty container replaces its contents
+TEST_F(SerializeTest, DeserializeReplaces) {
+    {
+        std2::binary_writer writer(path);
+        std2::list<int> lst = {1, 2};
+        std2::serialize(writer, lst);
+        std2::serialize(writer, lst);
+    }
+    std2::binary_reader reader(path);
+    EXPECT_EQ(reader.remaining(), 2 * (1 + 4 + 8 + 2 * sizeof(int)));
+    std2::list<int> lst = {7, 8, 9};
+    std2::deserialize(reader, lst);
+    EXPECT_EQ(lst.size(), 2);
+    EXPECT_EQ(*lst.begin(), 1);
+    std2::deserialize(reader, lst);
+    EXPECT_EQ(lst.size(), 2);
+    EXPECT_EQ(reader.remaining(), 0);
+}
+
+// Throughput benchmark in GB/s
+TEST_F(SerializeTest, PerformanceBenchmark) {
+    const std::size_t count = 16 * 1024 * 1024; // 128 MiB of doubles
+    std2::vector<double> vals;
+    vals.resize(count, 1.0);
+    const double gigabytes = count * sizeof(double) / 1e9;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        std2::binary_writer writer(path);
+        std2::serialize(writer, vals);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "std2::vector<double> write: " << gigabytes / seconds << " GB/s\n";
+
+    std2::vector<double> in;
+    start = std::chrono::high_resolution_clock::now();
+    {
+        std2::binary_reader reader(path);
+        std2::deserialize(reader, in);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "std2::vector<double> read: " << gigabytes / seconds << " GB/s\n";
+    EXPECT_EQ(in.size(), count);
+
+    const int list_count = 1000000;
+    std2::list<int> lst;
+    for (int i = 0; i < list_count; ++i) lst.push_back(i);
+    start = std::chrono::high_resolution_clock::now();
+    {
+        std2::binary_writer writer(path);
+        std2::serialize(writer, lst);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "std2::list<int> write: " << list_count * sizeof(int) / 1e9 / seconds << " GB/s\n";
+}
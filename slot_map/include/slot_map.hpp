@@ -0,0 +1,296 @@
+#ifndef SLOT_MAP_HPP
+#define SLOT_MAP_HPP
+
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint32_t, std::uint64_t
+#include <functional>  // for std::hash
+#include <limits>      // for std::numeric_limits
+#include <stdexcept>   // for std::out_of_range, std::length_error
+#include <utility>     // for std::swap
+#include "../../vector/include/vector.hpp"
+#include "../../std2/std2.hpp" // for std2::move, std2::forward, std2::exchange
+
+namespace std2 {
+
+/*
+ * Handle to an element of a slot_map. The index names a slot in the
+ * indirection table and the generation says which occupant of that slot the
+ * key was issued for, so a key outliving its element is detected instead of
+ * silently reaching whatever moved in later. A default key is never valid.
+ */
+struct slot_key {
+    std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t generation = 0;
+
+    bool operator==(const slot_key&) const = default;
+};
+
+/*
+ * Unordered container with stable generational keys over dense storage.
+ *
+ * Values live packed in one std2::vector, so iteration is a linear walk. A
+ * slot table maps each key to the value's current position; erase moves the
+ * last value into the hole (swap and pop) and patches that one slot, so
+ * insert, erase and lookup are all O(1). Erasing reorders the values, and
+ * pointers and iterators into the dense storage are invalidated by any insert
+ * or erase - hold on to keys instead.
+ *
+ * A slot's generation is odd while occupied and even while free. When it
+ * would wrap around the slot is retired rather than reused, so a stale key can
+ * never match again.
+ */
+template <typename T>
+class slot_map {
+public:
+    using value_type = T;
+    using key_type = slot_key;
+    using size_type = std::size_t;
+    using iterator = typename std2::vector<T>::iterator;
+    using const_iterator = typename std2::vector<T>::const_iterator;
+
+    slot_map() = default;
+
+    slot_map(const slot_map& other) = default;
+
+    // the free list of other refers to slots that move with it, so other restarts empty
+    slot_map(slot_map&& other) noexcept
+        : m_values(std2::move(other.m_values)),
+        m_owners(std2::move(other.m_owners)),
+        m_slots(std2::move(other.m_slots)),
+        m_free_head(std2::exchange(other.m_free_head, NONE))
+    {}
+
+    slot_map& operator=(slot_map other) noexcept {
+        std::swap(m_values, other.m_values);
+        std::swap(m_owners, other.m_owners);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_free_head, other.m_free_head);
+        return *this;
+    }
+
+    /**
+     *  @brief  Construct a value at the end of the dense storage.
+     *  @param  args  Arguments to forward to the constructor of T.
+     *  @return the key of the new element.
+     *  @throws std::length_error if the map already holds the maximum number of elements.
+     */
+    template <typename... Args>
+    slot_key emplace(Args&&... args) {
+        if (m_values.size() >= MAX_SIZE) throw std::length_error("std2::slot_map: too many elements");
+
+        // a fresh slot joins the free list first, so a throw below leaves it merely unused
+        if (m_free_head == NONE) {
+            m_slots.push_back(slot{NONE, 0});
+            m_free_head = static_cast<std::uint32_t>(m_slots.size() - 1);
+        }
+        const std::uint32_t s = m_free_head;
+        m_owners.push_back(s);
+        try {
+            m_values.emplace_back(std2::forward<Args>(args)...);
+        } catch (...) {
+            m_owners.pop_back();
+            throw;
+        }
+
+        slot& entry = m_slots[s];
+        m_free_head = entry.index;
+        entry.index = static_cast<std::uint32_t>(m_values.size() - 1);
+        ++entry.generation;
+        return slot_key{s, entry.generation};
+    }
+
+    slot_key insert(const T& value) {
+        return emplace(value);
+    }
+
+    slot_key insert(T&& value) {
+        return emplace(std2::move(value));
+    }
+
+    /**
+     *  @brief  Erase the element a key refers to.
+     *  @param  key  The key of the element to erase.
+     *  @return the number of elements erased (0 for a stale or invalid key).
+     */
+    size_type erase(slot_key key) {
+        if (!contains(key)) return 0;
+        erase_dense(m_slots[key.index].index);
+        return 1;
+    }
+
+    /**
+     *  @brief  Erase the element at an iterator position.
+     *  The last element moves into the position, so erasing while iterating
+     *  continues from the returned iterator without advancing it.
+     *  @param  pos  Iterator to the element to erase.
+     *  @return iterator to the element now at that position, or end().
+     */
+    iterator erase(const_iterator pos) {
+        const std::size_t index = static_cast<std::size_t>(pos - m_values.cbegin());
+        erase_dense(index);
+        return m_values.begin() + index;
+    }
+
+    /**
+     *  @brief  Erase every element a predicate selects, in one pass.
+     *  @param  pred  Predicate called with each element.
+     *  @return the number of elements erased.
+     */
+    template <typename Predicate>
+    size_type erase_if(Predicate pred) {
+        size_type erased = 0;
+        for (std::size_t i = 0; i < m_values.size();) {
+            if (pred(m_values[i])) {
+                erase_dense(i);
+                ++erased;
+            } else {
+                ++i;
+            }
+        }
+        return erased;
+    }
+
+    bool contains(slot_key key) const noexcept {
+        return key.index < m_slots.size() && (key.generation & 1) && m_slots[key.index].generation == key.generation;
+    }
+
+    /**
+     *  @brief  Look up an element by key.
+     *  @param  key  The key of the element.
+     *  @return pointer to the element, or nullptr for a stale or invalid key.
+     */
+    T* find(slot_key key) noexcept {
+        return contains(key) ? &m_values[m_slots[key.index].index] : nullptr;
+    }
+
+    const T* find(slot_key key) const noexcept {
+        return contains(key) ? &m_values[m_slots[key.index].index] : nullptr;
+    }
+
+    /**
+     *  @brief  Checked access to an element by key.
+     *  @param  key  The key of the element.
+     *  @return reference to the element.
+     *  @throws std::out_of_range if the key is stale or invalid.
+     */
+    T& at(slot_key key) {
+        if (!contains(key)) throw std::out_of_range("std2::slot_map::at: stale or invalid key");
+        return m_values[m_slots[key.index].index];
+    }
+
+    const T& at(slot_key key) const {
+        if (!contains(key)) throw std::out_of_range("std2::slot_map::at: stale or invalid key");
+        return m_values[m_slots[key.index].index];
+    }
+
+    // unchecked, the key must be valid
+    T& operator[](slot_key key) noexcept {
+        return m_values[m_slots[key.index].index];
+    }
+
+    const T& operator[](slot_key key) const noexcept {
+        return m_values[m_slots[key.index].index];
+    }
+
+    /**
+     *  @brief  The key of the element at a dense position, for iteration that needs keys.
+     *  @param  index  Position in the dense storage, less than size().
+     *  @return the key of that element.
+     */
+    slot_key key_at(std::size_t index) const noexcept {
+        const std::uint32_t s = m_owners[index];
+        return slot_key{s, m_slots[s].generation};
+    }
+
+    slot_key key_of(const_iterator pos) const noexcept {
+        return key_at(static_cast<std::size_t>(pos - m_values.cbegin()));
+    }
+
+    void reserve(size_type n) {
+        m_values.reserve(n);
+        m_owners.reserve(n);
+        m_slots.reserve(n);
+    }
+
+    /**
+     *  @brief  Erase all elements; every outstanding key becomes stale.
+     *  @return void.
+     */
+    void clear() {
+        for (std::size_t i = 0; i < m_owners.size(); ++i) free_slot(m_owners[i]);
+        m_values.clear();
+        m_owners.clear();
+    }
+
+    size_type size() const noexcept {
+        return m_values.size();
+    }
+
+    bool empty() const noexcept {
+        return m_values.empty();
+    }
+
+    /**
+     *  @brief  Iterators over the dense values, in no particular order.
+     *  @return pointer to the first value, or one past the last.
+     */
+    iterator begin() { return m_values.begin(); }
+    iterator end() { return m_values.end(); }
+    const_iterator begin() const { return m_values.begin(); }
+    const_iterator end() const { return m_values.end(); }
+    const_iterator cbegin() const { return m_values.cbegin(); }
+    const_iterator cend() const { return m_values.cend(); }
+
+    T* data() { return m_values.data(); }
+    const T* data() const { return m_values.data(); }
+
+private:
+    static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::size_t MAX_SIZE = NONE - 1;
+
+    /*
+     * Occupied: index is the value's dense position, generation is odd.
+     * Free: index is the next free slot (or NONE), generation is even.
+     */
+    struct slot {
+        std::uint32_t index;
+        std::uint32_t generation;
+    };
+
+    // move the last value into the hole and repoint its slot
+    void erase_dense(std::size_t index) {
+        const std::uint32_t s = m_owners[index];
+        const std::size_t last = m_values.size() - 1;
+        if (index != last) {
+            m_values[index] = std2::move(m_values[last]);
+            m_owners[index] = m_owners[last];
+            m_slots[m_owners[index]].index = static_cast<std::uint32_t>(index);
+        }
+        m_values.pop_back();
+        m_owners.pop_back();
+        free_slot(s);
+    }
+
+    void free_slot(std::uint32_t s) noexcept {
+        slot& entry = m_slots[s];
+        if (++entry.generation == 0) return; // exhausted, retire the slot
+        entry.index = m_free_head;
+        m_free_head = s;
+    }
+
+    std2::vector<T> m_values;
+    std2::vector<std::uint32_t> m_owners; // slot of each dense value
+    std2::vector<slot> m_slots;
+    std::uint32_t m_free_head = NONE;
+};
+
+} // namespace std2
+
+template <>
+struct std::hash<std2::slot_key> {
+    std::size_t operator()(const std2::slot_key& key) const noexcept {
+        return std::hash<std::uint64_t>{}((std::uint64_t(key.generation) << 32) | key.index);
+    }
+};
+
+#endif // SLOT_MAP_HPP
@@ -0,0 +1,250 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/slot_map.hpp"
+#include "../../list/include/list.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class SlotMapTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    struct particle {
+        float x, y, vx, vy;
+        int id;
+    };
+};
+
+// Test keys find their values and the values stay dense
+TEST_F(SlotMapTest, InsertLookupErase) {
+    std2::slot_map<std::string> map;
+    const auto a = map.insert("alpha");
+    const auto b = map.emplace(4, 'b');
+    const auto c = map.insert(std::string("gamma"));
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map[a], "alpha");
+    EXPECT_EQ(map.at(b), "bbbb");
+    EXPECT_EQ(*map.find(c), "gamma");
+
+    // erasing the first element moves the last one into its place
+    EXPECT_EQ(map.erase(a), 1);
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.data()[0], "gamma");
+    EXPECT_EQ(map[c], "gamma");
+    EXPECT_EQ(map[b], "bbbb");
+    EXPECT_EQ(map.key_at(0), c);
+
+    std::vector<std::string> values(map.begin(), map.end());
+    EXPECT_THAT(values, ::testing::UnorderedElementsAre("bbbb", "gamma"));
+}
+
+// Test stale, default and forged keys are all rejected
+TEST_F(SlotMapTest, StaleKeys) {
+    std2::slot_map<int> map;
+    const auto first = map.insert(1);
+    map.erase(first);
+    EXPECT_FALSE(map.contains(first));
+    EXPECT_EQ(map.find(first), nullptr);
+    EXPECT_THROW(map.at(first), std::out_of_range);
+    EXPECT_EQ(map.erase(first), 0);
+
+    // the slot is reused with a new generation, the old key still misses
+    const auto second = map.insert(2);
+    EXPECT_EQ(second.index, first.index);
+    EXPECT_NE(second.generation, first.generation);
+    EXPECT_FALSE(map.contains(first));
+    EXPECT_EQ(map.at(second), 2);
+
+    EXPECT_FALSE(map.contains(std2::slot_key{}));
+    EXPECT_FALSE(map.contains(std2::slot_key{second.index, 0}));     // even generation, never issued
+    EXPECT_FALSE(map.contains(std2::slot_key{100, second.generation})); // no such slot
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(second));
+    const auto third = map.insert(3);
+    EXPECT_TRUE(map.contains(third));
+    EXPECT_FALSE(map.contains(second));
+}
+
+// Test erasing through iterators and predicates while walking the dense storage
+TEST_F(SlotMapTest, EraseWhileIterating) {
+    std2::slot_map<int> map;
+    std::vector<std2::slot_key> keys;
+    for (int i = 0; i < 100; ++i) keys.push_back(map.insert(i));
+
+    for (auto it = map.begin(); it != map.end();) {
+        if (*it % 2) it = map.erase(it);
+        else ++it;
+    }
+    EXPECT_EQ(map.size(), 50);
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(map.contains(keys[i]), i % 2 == 0);
+
+    EXPECT_EQ(map.erase_if([](int v) { return v % 4 == 0; }), 25);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(map.contains(keys[i]), i % 4 == 2);
+        if (map.contains(keys[i])) {
+            EXPECT_EQ(map[keys[i]], i);
+        }
+    }
+    for (std::size_t i = 0; i < map.size(); ++i) EXPECT_EQ(map[map.key_at(i)], map.data()[i]);
+}
+
+// Test random churn against a hash map model
+TEST_F(SlotMapTest, Randomized) {
+    std::mt19937 rng(3);
+    std2::slot_map<std::unique_ptr<int>> map; // move-only values
+    std::unordered_map<std::uint64_t, int> model;
+    std::vector<std2::slot_key> live, dead;
+    auto id = [](std2::slot_key k) { return (std::uint64_t(k.generation) << 32) | k.index; };
+
+    for (int step = 0; step < 50000; ++step) {
+        const unsigned op = rng() % 3;
+        if (op == 0 || live.empty()) {
+            const int value = static_cast<int>(rng());
+            const auto key = map.emplace(std::make_unique<int>(value));
+            live.push_back(key);
+            model[id(key)] = value;
+        } else if (op == 1) {
+            const std::size_t i = rng() % live.size();
+            ASSERT_EQ(map.erase(live[i]), 1);
+            model.erase(id(live[i]));
+            dead.push_back(live[i]);
+            live[i] = live.back();
+            live.pop_back();
+        } else {
+            const auto key = live[rng() % live.size()];
+            ASSERT_EQ(*map.at(key), model[id(key)]);
+            if (!dead.empty()) {
+                ASSERT_FALSE(map.contains(dead[rng() % dead.size()]));
+            }
+        }
+        ASSERT_EQ(map.size(), model.size());
+    }
+
+    std::unordered_set<std::uint64_t> seen;
+    for (std::size_t i = 0; i < map.size(); ++i) {
+        const auto key = map.key_at(i);
+        ASSERT_TRUE(seen.insert(id(key)).second);
+        ASSERT_EQ(*map.data()[i], model[id(key)]);
+    }
+}
+
+// Test copies are independent and moves leave a usable empty map
+TEST_F(SlotMapTest, CopyAndMove) {
+    std2::slot_map<std::string> map;
+    const auto a = map.insert("a");
+    const auto b = map.insert("b");
+    map.erase(a);
+
+    std2::slot_map<std::string> copy = map;
+    copy[b] = "changed";
+    EXPECT_EQ(map[b], "b");
+    EXPECT_NE(copy.insert("c"), std2::slot_key{});
+
+    std2::slot_map<std::string> moved = std2::move(map);
+    EXPECT_EQ(moved[b], "b");
+    EXPECT_TRUE(map.empty());
+    const auto fresh = map.insert("fresh");
+    EXPECT_EQ(map[fresh], "fresh");
+
+    map = moved;
+    EXPECT_EQ(map.at(b), "b");
+    EXPECT_FALSE(map.contains(fresh));
+}
+
+// Iteration after churn and the churn itself against handles into a std2::list
+TEST_F(SlotMapTest, PerformanceBenchmark) {
+    const int n = 1000000;
+    const int churn = 2000000;
+    std::mt19937 rng(42);
+
+    auto time = [](auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        body();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+    auto make = [](int id) { return particle{float(id), float(id), 1.0f, -1.0f, id}; };
+
+    // std2::list: iterators are the stable handles
+    std2::list<particle> list;
+    std::vector<std2::list<particle>::iterator> list_handles;
+    list_handles.reserve(n);
+    const auto list_fill = time([&] {
+        for (int i = 0; i < n; ++i) {
+            list.push_back(make(i));
+            list_handles.push_back(--list.end());
+        }
+    });
+    const auto list_churn = time([&] {
+        std::mt19937 pick(7);
+        for (int i = 0; i < churn; ++i) {
+            auto& handle = list_handles[pick() % n];
+            auto victim = handle;
+            list.erase(victim);
+            list.push_back(make(i));
+            handle = --list.end();
+        }
+    });
+    double list_sum = 0;
+    const auto list_iterate = time([&] {
+        for (auto& p : list) {
+            p.x += p.vx;
+            p.y += p.vy;
+            list_sum += p.x + p.y;
+        }
+    });
+
+    std2::slot_map<particle> map;
+    std::vector<std2::slot_key> keys;
+    keys.reserve(n);
+    const auto map_fill = time([&] {
+        for (int i = 0; i < n; ++i) keys.push_back(map.insert(make(i)));
+    });
+    const auto map_churn = time([&] {
+        std::mt19937 pick(7);
+        for (int i = 0; i < churn; ++i) {
+            auto& key = keys[pick() % n];
+            map.erase(key);
+            key = map.insert(make(i));
+        }
+    });
+    double map_sum = 0;
+    const auto map_iterate = time([&] {
+        for (auto& p : map) {
+            p.x += p.vx;
+            p.y += p.vy;
+            map_sum += p.x + p.y;
+        }
+    });
+
+    long long list_lookup = 0, map_lookup = 0;
+    std::vector<std::size_t> probes(n);
+    for (auto& p : probes) p = rng() % n;
+    const auto list_lookup_time = time([&] { for (auto i : probes) list_lookup += list_handles[i]->id; });
+    const auto map_lookup_time = time([&] { for (auto i : probes) map_lookup += map[keys[i]].id; });
+
+    std::cout << n << " particles, " << churn << " erase + insert\n"
+              << "  fill                       std2::list " << list_fill << " us, std2::slot_map " << map_fill << " us\n"
+              << "  churn                      std2::list " << list_churn << " us, std2::slot_map " << map_churn << " us\n"
+              << "  iterate after churn        std2::list " << list_iterate << " us, std2::slot_map " << map_iterate << " us\n"
+              << "  random lookup by handle    std2::list " << list_lookup_time << " us, std2::slot_map " << map_lookup_time << " us\n";
+
+    EXPECT_EQ(list.size(), map.size());
+    EXPECT_DOUBLE_EQ(list_sum, map_sum);
+    EXPECT_EQ(list_lookup, map_lookup);
+}
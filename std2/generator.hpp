@@ -0,0 +1,128 @@
+#ifndef STD2_GENERATOR_HPP
+#define STD2_GENERATOR_HPP
+
+#include <coroutine>   // for std::coroutine_handle, std::suspend_always
+#include <cstddef>     // for std::ptrdiff_t
+#include <exception>   // for std::exception_ptr, std::rethrow_exception
+#include <iterator>    // for std::default_sentinel_t, std::input_iterator_tag
+#include <memory>      // for std::addressof
+#include <ranges>      // for std::ranges::view_interface
+#include <type_traits> // for std::conditional_t, std::remove_cvref_t, std::add_pointer_t
+#include <utility>     // for std::swap
+
+#include "std2.hpp" // for std2::exchange
+
+namespace std2 {
+
+/*
+ * Coroutine that produces a sequence on demand: the body runs until its next
+ * co_yield each time the iterator is incremented, so nothing is computed or
+ * stored ahead of the consumer.
+ *
+ *     std2::generator<int> iota(int n) { for (int i = 0; i < n; ++i) co_yield i; }
+ *
+ * A generator is a move only input view; it can be iterated once and used as
+ * the source of the std2::views adaptors. Yielded values are referred to, not
+ * copied, while the coroutine is suspended. An exception thrown by the body
+ * propagates out of begin() or operator++.
+ */
+template <typename T>
+class generator : public std::ranges::view_interface<generator<T>> {
+public:
+    using value_type = std::remove_cvref_t<T>;
+    using reference = std::conditional_t<std::is_reference_v<T>, T, const T&>;
+
+    struct promise_type {
+        generator get_return_object() noexcept {
+            return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+
+        std::suspend_always yield_value(reference value) noexcept {
+            m_value = std::addressof(value);
+            return {};
+        }
+
+        void return_void() const noexcept {}
+
+        void unhandled_exception() noexcept { m_exception = std::current_exception(); }
+
+        // generators produce values, they do not wait on anything
+        template <typename U>
+        std::suspend_never await_transform(U&&) = delete;
+
+        std::add_pointer_t<reference> m_value = nullptr;
+        std::exception_ptr m_exception;
+    };
+
+    using handle = std::coroutine_handle<promise_type>;
+
+    class iterator {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = generator::value_type;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(handle coroutine) : m_coroutine(coroutine) {}
+
+        reference operator*() const { return static_cast<reference>(*m_coroutine.promise().m_value); }
+
+        iterator& operator++() {
+            resume(m_coroutine);
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) {
+            return !it.m_coroutine || it.m_coroutine.done();
+        }
+
+    private:
+        handle m_coroutine = nullptr;
+    };
+
+    generator() = default;
+
+    generator(generator&& other) noexcept : m_coroutine(std2::exchange(other.m_coroutine, nullptr)) {}
+
+    generator& operator=(generator other) noexcept {
+        std::swap(m_coroutine, other.m_coroutine);
+        return *this;
+    }
+
+    ~generator() {
+        if (m_coroutine) m_coroutine.destroy();
+    }
+
+    /**
+     *  @brief  Run the body up to its first co_yield.
+     *  @return iterator to the first value; call once.
+     */
+    iterator begin() {
+        if (m_coroutine) resume(m_coroutine);
+        return iterator(m_coroutine);
+    }
+
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    explicit generator(handle coroutine) : m_coroutine(coroutine) {}
+
+    /* @brief  Resume to the next co_yield, rethrowing what the body threw. */
+    static void resume(handle coroutine) {
+        coroutine.resume();
+        if (coroutine.promise().m_exception) {
+            std::rethrow_exception(std2::exchange(coroutine.promise().m_exception, nullptr));
+        }
+    }
+
+    handle m_coroutine = nullptr;
+};
+
+} // namespace std2
+
+#endif // STD2_GENERATOR_HPP
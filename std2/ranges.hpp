@@ -0,0 +1,769 @@
+#ifndef STD2_RANGES_HPP
+#define STD2_RANGES_HPP
+
+#include <algorithm>   // for std::min
+#include <concepts>    // for std::convertible_to, std::derived_from
+#include <cstddef>     // for std::size_t, std::ptrdiff_t
+#include <functional>  // for std::invoke
+#include <iterator>    // for std::input_iterator_tag ... std::random_access_iterator_tag
+#include <optional>    // for std::optional
+#include <ranges>      // for std::ranges::begin, std::ranges::view_interface and the range concepts
+#include <stdexcept>   // for std::invalid_argument
+#include <tuple>       // for std::tuple, std::apply
+#include <type_traits> // for std::conditional_t, std::remove_cvref_t, std::invoke_result_t
+#include <utility>     // for std::index_sequence, std::declval
+
+#include "std2.hpp" // for std2::move, std2::forward
+
+namespace std2 {
+
+/*
+ * Lazy range adaptors. A view holds its source and the adaptor's function and
+ * does the work inside its iterator, so a chain such as
+ *
+ *     vec | views::filter(pred) | views::transform(fn) | views::take(n)
+ *
+ * compiles into one loop over vec with no intermediate container. Views refer
+ * to lvalue sources, which must outlive them, and take ownership of rvalue
+ * ones. They model the standard range concepts, so std::ranges algorithms and
+ * range-for accept them, and they accept any standard range as a source.
+ */
+namespace ranges {
+
+template <typename R>
+using iterator_t = std::ranges::iterator_t<R>;
+
+template <typename R>
+using sentinel_t = std::ranges::sentinel_t<R>;
+
+namespace ranges_detail {
+
+template <bool Const, typename T>
+using maybe_const = std::conditional_t<Const, const T, T>;
+
+/* @brief  The strongest iterator category Base supports, capped at Cap. */
+template <typename Base, typename Cap>
+constexpr auto iterator_concept_for() {
+    if constexpr (std::ranges::random_access_range<Base> && std::derived_from<Cap, std::random_access_iterator_tag>) {
+        return std::random_access_iterator_tag{};
+    } else if constexpr (std::ranges::bidirectional_range<Base> && std::derived_from<Cap, std::bidirectional_iterator_tag>) {
+        return std::bidirectional_iterator_tag{};
+    } else if constexpr (std::ranges::forward_range<Base>) {
+        return std::forward_iterator_tag{};
+    } else {
+        return std::input_iterator_tag{};
+    }
+}
+
+template <typename Base, typename Cap = std::random_access_iterator_tag>
+using iterator_concept_t = decltype(iterator_concept_for<Base, Cap>());
+
+/*
+ * Holds a function object and stays assignable even when the function is
+ * not (lambdas are not), so views storing one are still std::ranges::view.
+ */
+template <typename F>
+class movable_box {
+public:
+    movable_box() = default;
+    explicit movable_box(F fn) : m_fn(std2::move(fn)) {}
+
+    movable_box(const movable_box&) = default;
+    movable_box(movable_box&&) = default;
+
+    movable_box& operator=(const movable_box& other) requires std::copy_constructible<F> {
+        if (this != &other) {
+            if (other.m_fn) m_fn.emplace(*other.m_fn);
+            else m_fn.reset();
+        }
+        return *this;
+    }
+
+    movable_box& operator=(movable_box&& other) {
+        if (this != &other) {
+            if (other.m_fn) m_fn.emplace(std2::move(*other.m_fn));
+            else m_fn.reset();
+        }
+        return *this;
+    }
+
+    F& operator*() { return *m_fn; }
+    const F& operator*() const { return *m_fn; }
+
+private:
+    std::optional<F> m_fn;
+};
+
+} // namespace ranges_detail
+
+/*
+ * An iterator and sentinel pair viewed as a range.
+ */
+template <std::input_or_output_iterator It, std::sentinel_for<It> S = It>
+class subrange : public std::ranges::view_interface<subrange<It, S>> {
+public:
+    subrange() = default;
+    subrange(It first, S last) : m_begin(std2::move(first)), m_end(std2::move(last)) {}
+
+    It begin() const { return m_begin; }
+    S end() const { return m_end; }
+
+private:
+    It m_begin{};
+    S m_end{};
+};
+
+/*
+ * Non owning view of an lvalue range.
+ */
+template <std::ranges::range R>
+class ref_view : public std::ranges::view_interface<ref_view<R>> {
+public:
+    explicit ref_view(R& range) : m_range(&range) {}
+
+    iterator_t<R> begin() const { return std::ranges::begin(*m_range); }
+    sentinel_t<R> end() const { return std::ranges::end(*m_range); }
+
+    auto size() const requires std::ranges::sized_range<R> { return std::ranges::size(*m_range); }
+
+private:
+    R* m_range;
+};
+
+/*
+ * View that owns an rvalue range moved into it.
+ */
+template <std::ranges::range R>
+class owning_view : public std::ranges::view_interface<owning_view<R>> {
+public:
+    explicit owning_view(R&& range) : m_range(std2::move(range)) {}
+
+    owning_view(owning_view&&) = default;
+    owning_view& operator=(owning_view&&) = default;
+
+    iterator_t<R> begin() { return std::ranges::begin(m_range); }
+    sentinel_t<R> end() { return std::ranges::end(m_range); }
+    auto begin() const requires std::ranges::range<const R> { return std::ranges::begin(m_range); }
+    auto end() const requires std::ranges::range<const R> { return std::ranges::end(m_range); }
+
+    auto size() requires std::ranges::sized_range<R> { return std::ranges::size(m_range); }
+    auto size() const requires std::ranges::sized_range<const R> { return std::ranges::size(m_range); }
+
+private:
+    R m_range;
+};
+
+/**
+ *  @brief  Turn a range into a view: views pass through, lvalues are referred to, rvalues are owned.
+ *  @param  range  The source range.
+ *  @return a view of range.
+ */
+template <std::ranges::range R>
+auto all(R&& range) {
+    using plain = std::remove_cvref_t<R>;
+    if constexpr (std::ranges::view<plain> && (std::copy_constructible<plain> || !std::is_lvalue_reference_v<R>)) {
+        return plain(std2::forward<R>(range));
+    } else if constexpr (std::is_lvalue_reference_v<R>) {
+        return ref_view<std::remove_reference_t<R>>(range);
+    } else {
+        return owning_view<plain>(std2::move(range));
+    }
+}
+
+template <typename R>
+using all_t = decltype(ranges::all(std::declval<R>()));
+
+/*
+ * Right hand side of `range | adaptor`, holding the adaptor's arguments.
+ */
+template <typename Fn>
+struct adaptor_closure {
+    Fn m_fn;
+};
+
+template <typename Fn>
+adaptor_closure(Fn) -> adaptor_closure<Fn>;
+
+template <std::ranges::range R, typename Fn>
+auto operator|(R&& range, const adaptor_closure<Fn>& closure) {
+    return closure.m_fn(std2::forward<R>(range));
+}
+
+/*
+ * Elements of V for which Pred holds. Forward only; begin() searches for the
+ * first match each time it is called.
+ */
+template <std::ranges::input_range V, typename Pred>
+    requires std::ranges::view<V> && std::indirect_unary_predicate<const Pred, iterator_t<V>>
+class filter_view : public std::ranges::view_interface<filter_view<V, Pred>> {
+public:
+    class sentinel {
+    public:
+        sentinel() = default;
+        explicit sentinel(sentinel_t<V> end) : m_end(std2::move(end)) {}
+        const sentinel_t<V>& base() const { return m_end; }
+
+    private:
+        sentinel_t<V> m_end{};
+    };
+
+    class iterator {
+    public:
+        using iterator_concept = ranges_detail::iterator_concept_t<V, std::forward_iterator_tag>;
+        using value_type = std::ranges::range_value_t<V>;
+        using difference_type = std::ranges::range_difference_t<V>;
+
+        iterator() = default;
+        iterator(filter_view* parent, iterator_t<V> current) : m_parent(parent), m_current(std2::move(current)) {}
+
+        decltype(auto) operator*() const { return *m_current; }
+
+        iterator& operator++() {
+            m_current = m_parent->satisfy(++m_current);
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        bool operator==(const iterator& other) const requires std::equality_comparable<iterator_t<V>> {
+            return m_current == other.m_current;
+        }
+
+        friend bool operator==(const iterator& it, const sentinel& end) { return it.m_current == end.base(); }
+
+        const iterator_t<V>& base() const { return m_current; }
+
+    private:
+        filter_view* m_parent = nullptr;
+        iterator_t<V> m_current{};
+    };
+
+    filter_view(V base, Pred pred) : m_base(std2::move(base)), m_pred(std2::move(pred)) {}
+
+    iterator begin() { return iterator(this, satisfy(std::ranges::begin(m_base))); }
+    sentinel end() { return sentinel(std::ranges::end(m_base)); }
+
+private:
+    /* @brief  First position at or after it where the predicate holds. */
+    iterator_t<V> satisfy(iterator_t<V> it) {
+        const auto last = std::ranges::end(m_base);
+        while (it != last && !std::invoke(*m_pred, *it)) ++it;
+        return it;
+    }
+
+    V m_base;
+    ranges_detail::movable_box<Pred> m_pred;
+};
+
+/*
+ * Fn applied to every element of V, computed when the element is read.
+ * Keeps the iterator category of V.
+ */
+template <std::ranges::input_range V, typename Fn>
+    requires std::ranges::view<V>
+class transform_view : public std::ranges::view_interface<transform_view<V, Fn>> {
+    template <bool Const> class basic_iterator;
+
+    template <bool Const>
+    class basic_sentinel {
+        using base_t = ranges_detail::maybe_const<Const, V>;
+
+    public:
+        basic_sentinel() = default;
+        explicit basic_sentinel(sentinel_t<base_t> end) : m_end(std2::move(end)) {}
+        const sentinel_t<base_t>& base() const { return m_end; }
+
+    private:
+        sentinel_t<base_t> m_end{};
+    };
+
+    template <bool Const>
+    class basic_iterator {
+        using parent_t = ranges_detail::maybe_const<Const, transform_view>;
+        using base_t = ranges_detail::maybe_const<Const, V>;
+        using fn_t = ranges_detail::maybe_const<Const, Fn>;
+
+    public:
+        using iterator_concept = ranges_detail::iterator_concept_t<base_t>;
+        using value_type = std::remove_cvref_t<std::invoke_result_t<fn_t&, std::ranges::range_reference_t<base_t>>>;
+        using difference_type = std::ranges::range_difference_t<base_t>;
+
+        basic_iterator() = default;
+        basic_iterator(parent_t* parent, iterator_t<base_t> current) : m_parent(parent), m_current(std2::move(current)) {}
+
+        decltype(auto) operator*() const { return std::invoke(*m_parent->m_fn, *m_current); }
+
+        decltype(auto) operator[](difference_type n) const requires std::ranges::random_access_range<base_t> {
+            return std::invoke(*m_parent->m_fn, m_current[n]);
+        }
+
+        basic_iterator& operator++() { ++m_current; return *this; }
+        basic_iterator operator++(int) { basic_iterator temp = *this; ++m_current; return temp; }
+
+        basic_iterator& operator--() requires std::ranges::bidirectional_range<base_t> { --m_current; return *this; }
+        basic_iterator operator--(int) requires std::ranges::bidirectional_range<base_t> {
+            basic_iterator temp = *this;
+            --m_current;
+            return temp;
+        }
+
+        basic_iterator& operator+=(difference_type n) requires std::ranges::random_access_range<base_t> {
+            m_current += n;
+            return *this;
+        }
+        basic_iterator& operator-=(difference_type n) requires std::ranges::random_access_range<base_t> {
+            m_current -= n;
+            return *this;
+        }
+
+        friend basic_iterator operator+(basic_iterator it, difference_type n) requires std::ranges::random_access_range<base_t> {
+            return it += n;
+        }
+        friend basic_iterator operator+(difference_type n, basic_iterator it) requires std::ranges::random_access_range<base_t> {
+            return it += n;
+        }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) requires std::ranges::random_access_range<base_t> {
+            return it -= n;
+        }
+        friend difference_type operator-(const basic_iterator& a, const basic_iterator& b)
+            requires std::sized_sentinel_for<iterator_t<base_t>, iterator_t<base_t>> {
+            return a.m_current - b.m_current;
+        }
+
+        bool operator==(const basic_iterator& other) const requires std::equality_comparable<iterator_t<base_t>> {
+            return m_current == other.m_current;
+        }
+
+        friend bool operator<(const basic_iterator& a, const basic_iterator& b) requires std::ranges::random_access_range<base_t> {
+            return a.m_current < b.m_current;
+        }
+        friend bool operator>(const basic_iterator& a, const basic_iterator& b) requires std::ranges::random_access_range<base_t> {
+            return b < a;
+        }
+        friend bool operator<=(const basic_iterator& a, const basic_iterator& b) requires std::ranges::random_access_range<base_t> {
+            return !(b < a);
+        }
+        friend bool operator>=(const basic_iterator& a, const basic_iterator& b) requires std::ranges::random_access_range<base_t> {
+            return !(a < b);
+        }
+
+        friend bool operator==(const basic_iterator& it, const basic_sentinel<Const>& end) { return it.m_current == end.base(); }
+
+        const iterator_t<base_t>& base() const { return m_current; }
+
+    private:
+        parent_t* m_parent = nullptr;
+        iterator_t<base_t> m_current{};
+    };
+
+public:
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    transform_view(V base, Fn fn) : m_base(std2::move(base)), m_fn(std2::move(fn)) {}
+
+    iterator begin() { return iterator(this, std::ranges::begin(m_base)); }
+
+    // a common source gives a common view, so end() - begin() works for random access sources
+    auto end() {
+        if constexpr (std::ranges::common_range<V>) return iterator(this, std::ranges::end(m_base));
+        else return basic_sentinel<false>(std::ranges::end(m_base));
+    }
+
+    const_iterator begin() const requires std::ranges::range<const V> && std::regular_invocable<const Fn&, std::ranges::range_reference_t<const V>> {
+        return const_iterator(this, std::ranges::begin(m_base));
+    }
+    auto end() const requires std::ranges::range<const V> && std::regular_invocable<const Fn&, std::ranges::range_reference_t<const V>> {
+        if constexpr (std::ranges::common_range<const V>) return const_iterator(this, std::ranges::end(m_base));
+        else return basic_sentinel<true>(std::ranges::end(m_base));
+    }
+
+    auto size() requires std::ranges::sized_range<V> { return std::ranges::size(m_base); }
+    auto size() const requires std::ranges::sized_range<const V> { return std::ranges::size(m_base); }
+
+private:
+    V m_base;
+    ranges_detail::movable_box<Fn> m_fn;
+};
+
+/*
+ * The first count elements of V, or all of them if V is shorter. Never reads
+ * past the last element it yields, so it can cut off an infinite source.
+ */
+template <std::ranges::input_range V>
+    requires std::ranges::view<V>
+class take_view : public std::ranges::view_interface<take_view<V>> {
+    template <bool Const>
+    class basic_sentinel {
+        using base_t = ranges_detail::maybe_const<Const, V>;
+
+    public:
+        basic_sentinel() = default;
+        explicit basic_sentinel(sentinel_t<base_t> end) : m_end(std2::move(end)) {}
+        const sentinel_t<base_t>& base() const { return m_end; }
+
+    private:
+        sentinel_t<base_t> m_end{};
+    };
+
+    template <bool Const>
+    class basic_iterator {
+        using base_t = ranges_detail::maybe_const<Const, V>;
+
+    public:
+        using iterator_concept = ranges_detail::iterator_concept_t<base_t, std::forward_iterator_tag>;
+        using value_type = std::ranges::range_value_t<base_t>;
+        using difference_type = std::ranges::range_difference_t<base_t>;
+
+        basic_iterator() = default;
+        basic_iterator(iterator_t<base_t> current, difference_type remaining)
+            : m_current(std2::move(current)), m_remaining(remaining) {}
+
+        decltype(auto) operator*() const { return *m_current; }
+
+        basic_iterator& operator++() {
+            ++m_current;
+            --m_remaining;
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            basic_iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        bool operator==(const basic_iterator& other) const requires std::equality_comparable<iterator_t<base_t>> {
+            return m_current == other.m_current;
+        }
+
+        friend bool operator==(const basic_iterator& it, const basic_sentinel<Const>& end) {
+            return it.m_remaining == 0 || it.m_current == end.base();
+        }
+
+        const iterator_t<base_t>& base() const { return m_current; }
+
+    private:
+        iterator_t<base_t> m_current{};
+        difference_type m_remaining = 0;
+    };
+
+public:
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    take_view(V base, std::ranges::range_difference_t<V> count) : m_base(std2::move(base)), m_count(count) {}
+
+    iterator begin() { return iterator(std::ranges::begin(m_base), m_count); }
+    basic_sentinel<false> end() { return basic_sentinel<false>(std::ranges::end(m_base)); }
+
+    const_iterator begin() const requires std::ranges::range<const V> {
+        return const_iterator(std::ranges::begin(m_base), m_count);
+    }
+    basic_sentinel<true> end() const requires std::ranges::range<const V> {
+        return basic_sentinel<true>(std::ranges::end(m_base));
+    }
+
+    auto size() const requires std::ranges::sized_range<const V> {
+        const auto n = std::ranges::size(m_base);
+        const auto limit = static_cast<decltype(n)>(m_count);
+        return n < limit ? n : limit;
+    }
+
+private:
+    V m_base;
+    std::ranges::range_difference_t<V> m_count;
+};
+
+/*
+ * V split into consecutive subranges of count elements; the last one may be
+ * shorter. Each chunk is a subrange over V, nothing is copied.
+ */
+template <std::ranges::forward_range V>
+    requires std::ranges::view<V>
+class chunk_view : public std::ranges::view_interface<chunk_view<V>> {
+    template <bool Const>
+    class basic_sentinel {
+        using base_t = ranges_detail::maybe_const<Const, V>;
+
+    public:
+        basic_sentinel() = default;
+        explicit basic_sentinel(sentinel_t<base_t> end) : m_end(std2::move(end)) {}
+        const sentinel_t<base_t>& base() const { return m_end; }
+
+    private:
+        sentinel_t<base_t> m_end{};
+    };
+
+    template <bool Const>
+    class basic_iterator {
+        using base_t = ranges_detail::maybe_const<Const, V>;
+
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = subrange<iterator_t<base_t>>;
+        using difference_type = std::ranges::range_difference_t<base_t>;
+
+        basic_iterator() = default;
+        basic_iterator(iterator_t<base_t> current, sentinel_t<base_t> end, difference_type count)
+            : m_current(std2::move(current)), m_end(std2::move(end)), m_count(count) {
+            m_next = std::ranges::next(m_current, m_count, m_end);
+        }
+
+        value_type operator*() const { return value_type(m_current, m_next); }
+
+        basic_iterator& operator++() {
+            m_current = m_next;
+            m_next = std::ranges::next(m_current, m_count, m_end);
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            basic_iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        bool operator==(const basic_iterator& other) const { return m_current == other.m_current; }
+
+        friend bool operator==(const basic_iterator& it, const basic_sentinel<Const>& end) {
+            return it.m_current == end.base();
+        }
+
+    private:
+        iterator_t<base_t> m_current{};
+        iterator_t<base_t> m_next{};
+        sentinel_t<base_t> m_end{};
+        difference_type m_count = 0;
+    };
+
+public:
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    /**
+     *  @brief  Chunk a view.
+     *  @param  base  The source view.
+     *  @param  count  Elements per chunk.
+     *  @throws std::invalid_argument if count is not positive.
+     */
+    chunk_view(V base, std::ranges::range_difference_t<V> count) : m_base(std2::move(base)), m_count(count) {
+        if (count <= 0) throw std::invalid_argument("std2::views::chunk: count must be positive");
+    }
+
+    iterator begin() { return iterator(std::ranges::begin(m_base), std::ranges::end(m_base), m_count); }
+    basic_sentinel<false> end() { return basic_sentinel<false>(std::ranges::end(m_base)); }
+
+    const_iterator begin() const requires std::ranges::forward_range<const V> {
+        return const_iterator(std::ranges::begin(m_base), std::ranges::end(m_base), m_count);
+    }
+    basic_sentinel<true> end() const requires std::ranges::forward_range<const V> {
+        return basic_sentinel<true>(std::ranges::end(m_base));
+    }
+
+    auto size() const requires std::ranges::sized_range<const V> {
+        const auto n = std::ranges::size(m_base);
+        const auto count = static_cast<decltype(n)>(m_count);
+        return (n + count - 1) / count;
+    }
+
+private:
+    V m_base;
+    std::ranges::range_difference_t<V> m_count;
+};
+
+/*
+ * Elements of several ranges side by side as tuples of references; stops at
+ * the end of the shortest range.
+ */
+template <std::ranges::input_range... Vs>
+    requires (sizeof...(Vs) > 0) && (std::ranges::view<Vs> && ...)
+class zip_view : public std::ranges::view_interface<zip_view<Vs...>> {
+    using indices = std::index_sequence_for<Vs...>;
+
+    template <bool Const>
+    class basic_sentinel {
+    public:
+        basic_sentinel() = default;
+        explicit basic_sentinel(std::tuple<sentinel_t<ranges_detail::maybe_const<Const, Vs>>...> ends)
+            : m_ends(std2::move(ends)) {}
+        const auto& base() const { return m_ends; }
+
+    private:
+        std::tuple<sentinel_t<ranges_detail::maybe_const<Const, Vs>>...> m_ends{};
+    };
+
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_concept = std::conditional_t<(std::ranges::forward_range<ranges_detail::maybe_const<Const, Vs>> && ...),
+                                                    std::forward_iterator_tag, std::input_iterator_tag>;
+        using value_type = std::tuple<std::ranges::range_value_t<ranges_detail::maybe_const<Const, Vs>>...>;
+        using difference_type = std::common_type_t<std::ranges::range_difference_t<ranges_detail::maybe_const<Const, Vs>>...>;
+
+        basic_iterator() = default;
+        explicit basic_iterator(std::tuple<iterator_t<ranges_detail::maybe_const<Const, Vs>>...> current)
+            : m_current(std2::move(current)) {}
+
+        auto operator*() const {
+            return std::apply([](const auto&... its) {
+                return std::tuple<std::ranges::range_reference_t<ranges_detail::maybe_const<Const, Vs>>...>(*its...);
+            }, m_current);
+        }
+
+        basic_iterator& operator++() {
+            std::apply([](auto&... its) { (++its, ...); }, m_current);
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            basic_iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        bool operator==(const basic_iterator& other) const
+            requires (std::equality_comparable<iterator_t<ranges_detail::maybe_const<Const, Vs>>> && ...) {
+            return any_equal(m_current, other.m_current, indices{});
+        }
+
+        friend bool operator==(const basic_iterator& it, const basic_sentinel<Const>& end) {
+            return any_equal(it.m_current, end.base(), indices{});
+        }
+
+    private:
+        /* @brief  True once any of the iterators reached its bound. */
+        template <typename Lhs, typename Rhs, std::size_t... I>
+        static bool any_equal(const Lhs& lhs, const Rhs& rhs, std::index_sequence<I...>) {
+            return ((std::get<I>(lhs) == std::get<I>(rhs)) || ...);
+        }
+
+        std::tuple<iterator_t<ranges_detail::maybe_const<Const, Vs>>...> m_current{};
+    };
+
+public:
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    explicit zip_view(Vs... bases) : m_bases(std2::move(bases)...) {}
+
+    iterator begin() {
+        return iterator(std::apply([](auto&... bases) { return std::tuple(std::ranges::begin(bases)...); }, m_bases));
+    }
+    basic_sentinel<false> end() {
+        return basic_sentinel<false>(std::apply([](auto&... bases) { return std::tuple(std::ranges::end(bases)...); }, m_bases));
+    }
+
+    const_iterator begin() const requires (std::ranges::range<const Vs> && ...) {
+        return const_iterator(std::apply([](const auto&... bases) { return std::tuple(std::ranges::begin(bases)...); }, m_bases));
+    }
+    basic_sentinel<true> end() const requires (std::ranges::range<const Vs> && ...) {
+        return basic_sentinel<true>(std::apply([](const auto&... bases) { return std::tuple(std::ranges::end(bases)...); }, m_bases));
+    }
+
+    auto size() const requires (std::ranges::sized_range<const Vs> && ...) {
+        return std::apply([](const auto&... bases) {
+            return std::min({static_cast<std::size_t>(std::ranges::size(bases))...});
+        }, m_bases);
+    }
+
+private:
+    std::tuple<Vs...> m_bases;
+};
+
+/**
+ *  @brief  Copy a range into a container, reserving first when the size is known.
+ *  @return an adaptor: `range | ranges::to<std2::vector<int>>()`.
+ */
+template <typename Container>
+auto to() {
+    return adaptor_closure{[](auto&& range) {
+        Container out;
+        if constexpr (std::ranges::sized_range<decltype(range)> && requires { out.reserve(std::size_t(0)); }) {
+            out.reserve(static_cast<std::size_t>(std::ranges::size(range)));
+        }
+        for (auto&& value : range) out.push_back(std2::forward<decltype(value)>(value));
+        return out;
+    }};
+}
+
+} // namespace ranges
+
+namespace views {
+
+struct filter_fn {
+    template <std::ranges::input_range R, typename Pred>
+    auto operator()(R&& range, Pred pred) const {
+        return ranges::filter_view<ranges::all_t<R>, Pred>(ranges::all(std2::forward<R>(range)), std2::move(pred));
+    }
+
+    template <typename Pred>
+    auto operator()(Pred pred) const {
+        return ranges::adaptor_closure{[pred = std2::move(pred)](auto&& range) {
+            return filter_fn{}(std2::forward<decltype(range)>(range), pred);
+        }};
+    }
+};
+
+struct transform_fn {
+    template <std::ranges::input_range R, typename Fn>
+    auto operator()(R&& range, Fn fn) const {
+        return ranges::transform_view<ranges::all_t<R>, Fn>(ranges::all(std2::forward<R>(range)), std2::move(fn));
+    }
+
+    template <typename Fn>
+    auto operator()(Fn fn) const {
+        return ranges::adaptor_closure{[fn = std2::move(fn)](auto&& range) {
+            return transform_fn{}(std2::forward<decltype(range)>(range), fn);
+        }};
+    }
+};
+
+struct take_fn {
+    template <std::ranges::input_range R>
+    auto operator()(R&& range, std::ptrdiff_t count) const {
+        return ranges::take_view<ranges::all_t<R>>(ranges::all(std2::forward<R>(range)), count);
+    }
+
+    auto operator()(std::ptrdiff_t count) const {
+        return ranges::adaptor_closure{[count](auto&& range) {
+            return take_fn{}(std2::forward<decltype(range)>(range), count);
+        }};
+    }
+};
+
+struct chunk_fn {
+    template <std::ranges::forward_range R>
+    auto operator()(R&& range, std::ptrdiff_t count) const {
+        return ranges::chunk_view<ranges::all_t<R>>(ranges::all(std2::forward<R>(range)), count);
+    }
+
+    auto operator()(std::ptrdiff_t count) const {
+        return ranges::adaptor_closure{[count](auto&& range) {
+            return chunk_fn{}(std2::forward<decltype(range)>(range), count);
+        }};
+    }
+};
+
+struct zip_fn {
+    template <std::ranges::input_range... Rs>
+    auto operator()(Rs&&... sources) const {
+        return ranges::zip_view<ranges::all_t<Rs>...>(ranges::all(std2::forward<Rs>(sources))...);
+    }
+};
+
+inline constexpr filter_fn filter{};
+inline constexpr transform_fn transform{};
+inline constexpr take_fn take{};
+inline constexpr chunk_fn chunk{};
+inline constexpr zip_fn zip{};
+
+} // namespace views
+
+} // namespace std2
+
+#endif // STD2_RANGES_HPP
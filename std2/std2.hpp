@@ -1,6 +1,8 @@
 #ifndef STD2_H
 #define STD2_H
 
+#include <type_traits> // for std::bool_constant, std::is_trivially_copyable_v
+
 namespace std2 {
 
 // remove_reference type trait
@@ -54,6 +56,30 @@ constexpr T exchange(T& obj, U&& new_value) {
     return old_value;
 }
 
+/**
+ *  @brief  Whether a T can be moved to a new address by copying its bytes,
+ *          with the old copy then treated as gone (no destructor call).
+ *  Trivially copyable types qualify; types that own memory through pointers
+ *  that never point into the object itself opt in by specializing this.
+ */
+template <typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+/**
+ *  @brief  Hint that the cache line holding address will be read soon.
+ *          Compiles to nothing where the compiler has no prefetch builtin.
+ *  @param  address  Any address, it is never dereferenced.
+ *  @return void.
+ */
+inline void prefetch([[maybe_unused]] const void* address) noexcept {
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#endif
+}
+
 } // namespace std2
 
 #endif // STD2_H
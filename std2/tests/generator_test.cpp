@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../generator.hpp"
+#include "../ranges.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class GeneratorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+std2::generator<int> iota(int first, int last) {
+    for (int i = first; i < last; ++i) co_yield i;
+}
+
+std2::generator<unsigned long long> fibonacci() {
+    unsigned long long a = 0, b = 1;
+    while (true) {
+        co_yield a;
+        b = std2::exchange(a, b) + b;
+    }
+}
+
+// Test values come out in order and the body only runs as far as it is pulled
+TEST_F(GeneratorTest, YieldsOnDemand) {
+    std::vector<int> values;
+    for (int x : iota(3, 7)) values.push_back(x);
+    EXPECT_THAT(values, ::testing::ElementsAre(3, 4, 5, 6));
+
+    int steps = 0;
+    auto counted = [&steps]() -> std2::generator<int> {
+        for (int i = 0;; ++i) {
+            ++steps;
+            co_yield i;
+        }
+    };
+    auto gen = counted();
+    EXPECT_EQ(steps, 0);
+    auto it = gen.begin();
+    EXPECT_EQ(*it, 0);
+    ++it;
+    ++it;
+    EXPECT_EQ(*it, 2);
+    EXPECT_EQ(steps, 3);
+
+    std2::generator<int> empty = iota(5, 5);
+    EXPECT_TRUE(empty.begin() == empty.end());
+}
+
+// Test an infinite generator cut off by views
+TEST_F(GeneratorTest, InfiniteWithViews) {
+    std::vector<unsigned long long> evens;
+    for (auto x : fibonacci() | std2::views::filter([](unsigned long long x) { return x % 2 == 0; }) | std2::views::take(5)) {
+        evens.push_back(x);
+    }
+    EXPECT_THAT(evens, ::testing::ElementsAre(0ull, 2ull, 8ull, 34ull, 144ull));
+}
+
+// Test yielded lvalues are referred to, not copied
+TEST_F(GeneratorTest, YieldsReferences) {
+    std::vector<std::string> words{"one", "two"};
+    auto refs = [](std::vector<std::string>& source) -> std2::generator<std::string&> {
+        for (auto& word : source) co_yield word;
+    };
+    for (std::string& word : refs(words)) word += "!";
+    EXPECT_THAT(words, ::testing::ElementsAre("one!", "two!"));
+
+    auto names = []() -> std2::generator<std::string> {
+        std::string name = "x";
+        for (int i = 0; i < 3; ++i) {
+            co_yield name;
+            name += "x";
+        }
+    };
+    std::vector<std::string> out;
+    for (const std::string& name : names()) out.push_back(name);
+    EXPECT_THAT(out, ::testing::ElementsAre("x", "xx", "xxx"));
+}
+
+// Test exceptions leave the body through the iterator and moves hand over the frame
+TEST_F(GeneratorTest, ExceptionsAndMoves) {
+    auto failing = []() -> std2::generator<int> {
+        co_yield 1;
+        throw std::runtime_error("boom");
+    };
+    auto gen = failing();
+    auto it = gen.begin();
+    EXPECT_EQ(*it, 1);
+    EXPECT_THROW(++it, std::runtime_error);
+    EXPECT_TRUE(it == gen.end());
+
+    auto first = iota(0, 3);
+    std2::generator<int> second = std2::move(first);
+    std::vector<int> values;
+    for (int x : second) values.push_back(x);
+    EXPECT_THAT(values, ::testing::ElementsAre(0, 1, 2));
+    EXPECT_TRUE(first.begin() == first.end());
+
+    // destroying a suspended generator frees its frame
+    auto partial = iota(0, 100);
+    EXPECT_EQ(*partial.begin(), 0);
+}
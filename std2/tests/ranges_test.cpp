@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../ranges.hpp"
+#include "../generator.hpp"
+#include "../../vector/include/vector.hpp"
+#include "../../list/include/list.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <vector>
+
+class RangesTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    template <typename R>
+    static std::vector<std::ranges::range_value_t<R>> collect(R&& range) {
+        std::vector<std::ranges::range_value_t<R>> out;
+        for (auto&& value : range) out.push_back(value);
+        return out;
+    }
+};
+
+// The containers and views model the standard range concepts
+TEST_F(RangesTest, Concepts) {
+    static_assert(std::ranges::contiguous_range<std2::vector<int>>);
+    static_assert(std::ranges::contiguous_range<const std2::vector<int>>);
+    static_assert(std::ranges::bidirectional_range<std2::list<int>>);
+    static_assert(std::ranges::bidirectional_range<const std2::list<int>>);
+
+    std2::vector<int> vec;
+    auto evens = vec | std2::views::filter([](int x) { return x % 2 == 0; });
+    auto squares = vec | std2::views::transform([](int x) { return x * x; });
+    static_assert(std::ranges::view<decltype(evens)>);
+    static_assert(std::ranges::forward_range<decltype(evens)>);
+    static_assert(std::ranges::random_access_range<decltype(squares)>);
+    static_assert(std::ranges::forward_range<decltype(vec | std2::views::take(3))>);
+    static_assert(std::ranges::forward_range<decltype(vec | std2::views::chunk(3))>);
+    static_assert(std::ranges::input_range<std2::generator<int>>);
+    static_assert(std::ranges::view<std2::generator<int>>);
+}
+
+// Test filter, transform and take compose over std2::vector
+TEST_F(RangesTest, FilterTransformTake) {
+    std2::vector<int> vec;
+    for (int i = 0; i < 20; ++i) vec.push_back(i);
+
+    auto pipeline = vec
+        | std2::views::filter([](int x) { return x % 3 == 0; })
+        | std2::views::transform([](int x) { return x * 10; })
+        | std2::views::take(4);
+    EXPECT_THAT(collect(pipeline), ::testing::ElementsAre(0, 30, 60, 90));
+    EXPECT_THAT(collect(pipeline), ::testing::ElementsAre(0, 30, 60, 90)); // views can be iterated again
+
+    // transform keeps random access
+    auto doubled = std2::views::transform(vec, [](int x) { return 2 * x; });
+    EXPECT_EQ(doubled.size(), 20);
+    EXPECT_EQ(doubled[7], 14);
+    EXPECT_EQ(doubled.end() - doubled.begin(), 20);
+    EXPECT_EQ(*(doubled.begin() + 19), 38);
+
+    // standard algorithms accept the views
+    EXPECT_EQ(std::ranges::count_if(vec | std2::views::filter([](int x) { return x > 15; }), [](int) { return true; }), 4);
+
+    // writes through a filter reach the source
+    for (int& x : vec | std2::views::filter([](int x) { return x < 3; })) x = -x;
+    EXPECT_EQ(vec[1], -1);
+    EXPECT_EQ(vec[2], -2);
+
+    // take longer than the source stops at its end
+    EXPECT_EQ(collect(vec | std2::views::take(100)).size(), 20);
+    EXPECT_EQ((vec | std2::views::take(5)).size(), 5);
+}
+
+// Test views over std2::list, including a const list and moved-in temporaries
+TEST_F(RangesTest, ListSources) {
+    std2::list<std::string> words{"alpha", "beta", "gamma", "delta"};
+    const std2::list<std::string>& view_of = words;
+
+    auto lengths = view_of | std2::views::transform([](const std::string& s) { return s.size(); });
+    EXPECT_THAT(collect(lengths), ::testing::ElementsAre(5, 4, 5, 5));
+
+    auto short_words = std2::views::filter(std2::list<std::string>{"a", "bbb", "cc"},
+                                           [](const std::string& s) { return s.size() < 3; });
+    EXPECT_THAT(collect(short_words), ::testing::ElementsAre("a", "cc"));
+}
+
+// Test chunk splits into subranges with a short tail
+TEST_F(RangesTest, Chunk) {
+    std2::vector<int> vec;
+    for (int i = 0; i < 10; ++i) vec.push_back(i);
+
+    std::vector<int> sums;
+    for (auto chunk : vec | std2::views::chunk(4)) sums.push_back(std::accumulate(chunk.begin(), chunk.end(), 0));
+    EXPECT_THAT(sums, ::testing::ElementsAre(6, 22, 17));
+    EXPECT_EQ((vec | std2::views::chunk(4)).size(), 3);
+
+    std2::list<int> list{1, 2, 3};
+    std::vector<std::size_t> sizes;
+    for (auto chunk : list | std2::views::chunk(2)) sizes.push_back(std::ranges::distance(chunk));
+    EXPECT_THAT(sizes, ::testing::ElementsAre(2, 1));
+
+    EXPECT_THROW(vec | std2::views::chunk(0), std::invalid_argument);
+}
+
+// Test zip stops at the shortest source and hands out references
+TEST_F(RangesTest, Zip) {
+    std2::vector<int> ids;
+    for (int i = 0; i < 5; ++i) ids.push_back(i);
+    std2::list<std::string> names{"a", "b", "c"};
+
+    std::vector<std::string> joined;
+    for (auto [id, name] : std2::views::zip(ids, names)) joined.push_back(std::to_string(id) + name);
+    EXPECT_THAT(joined, ::testing::ElementsAre("0a", "1b", "2c"));
+
+    for (auto [id, name] : std2::views::zip(ids, names)) name += "!";
+    EXPECT_EQ(*names.begin(), "a!");
+    EXPECT_EQ(std2::views::zip(ids, ids).size(), 5);
+}
+
+// Test ranges::to materializes a view into a container
+TEST_F(RangesTest, ToContainer) {
+    std2::list<int> list{5, 6, 7, 8};
+    auto vec = list | std2::views::transform([](int x) { return x + 1; }) | std2::ranges::to<std2::vector<int>>();
+    ASSERT_EQ(vec.size(), 4);
+    EXPECT_EQ(vec[0], 6);
+    EXPECT_EQ(vec[3], 9);
+}
+
+// Fused views against building an intermediate std2::vector per stage
+TEST_F(RangesTest, PerformanceBenchmark) {
+    const int n = 10000000;
+    std2::vector<int> source;
+    source.reserve(n);
+    for (int i = 0; i < n; ++i) source.push_back(i);
+
+    auto keep = [](int x) { return x % 3 != 0; };
+    auto scale = [](int x) { return static_cast<long long>(x) * 7 + 1; };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std2::vector<int> filtered;
+    for (int x : source) if (keep(x)) filtered.push_back(x);
+    std2::vector<long long> scaled;
+    for (int x : filtered) scaled.push_back(scale(x));
+    long long materialized_sum = 0;
+    for (std::size_t i = 0; i < scaled.size() && i < std::size_t(n / 2); ++i) materialized_sum += scaled[i];
+    auto end = std::chrono::high_resolution_clock::now();
+    const auto materialized_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    long long fused_sum = 0;
+    for (long long x : source | std2::views::filter(keep) | std2::views::transform(scale) | std2::views::take(n / 2)) {
+        fused_sum += x;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    const auto fused_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    long long generated_sum = 0;
+    auto numbers = [](int count) -> std2::generator<int> {
+        for (int i = 0; i < count; ++i) co_yield i;
+    };
+    for (long long x : numbers(n) | std2::views::filter(keep) | std2::views::transform(scale) | std2::views::take(n / 2)) {
+        generated_sum += x;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    const auto generated_time = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    std::cout << "filter | transform | take over " << n << " ints\n"
+              << "  materialized std2::vector per stage: " << materialized_time << " us\n"
+              << "  fused views:                         " << fused_time << " us\n"
+              << "  fused views over a generator:        " << generated_time << " us\n";
+
+    EXPECT_EQ(materialized_sum, fused_sum);
+    EXPECT_EQ(fused_sum, generated_sum);
+}
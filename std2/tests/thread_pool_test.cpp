@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../thread_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+class ThreadPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+static long fib(std2::thread_pool& pool, int n) {
+    if (n < 2) return n;
+    if (n < 12) return fib(pool, n - 1) + fib(pool, n - 2); // sequential cut-off
+
+    long left = 0;
+    long right = 0;
+    std2::task_group group(pool);
+    group.run([&] { left = fib(pool, n - 1); });
+    right = fib(pool, n - 2);
+    group.wait();
+    return left + right;
+}
+
+// Test every submitted task runs exactly once before the destructor returns
+TEST_F(ThreadPoolTest, DeterministicShutdown) {
+    std::atomic<int> counter{0};
+    {
+        std2::thread_pool pool(4);
+        for (int i = 0; i < 10000; ++i) {
+            pool.submit([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+    EXPECT_EQ(counter.load(), 10000);
+}
+
+// Test tasks spawned while the pool is shutting down still run
+TEST_F(ThreadPoolTest, ShutdownRunsSpawnedTasks) {
+    std::atomic<int> counter{0};
+    {
+        std2::thread_pool pool(3);
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&pool, &counter] {
+                for (int j = 0; j < 10; ++j) {
+                    pool.submit([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+    }
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+// Test repeatedly creating and destroying idle pools does not hang
+TEST_F(ThreadPoolTest, IdleCreateDestroy) {
+    for (int i = 0; i < 50; ++i) {
+        std2::thread_pool pool(4);
+        if (i % 2) std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    SUCCEED();
+}
+
+// Test parallel_for visits every index exactly once
+TEST_F(ThreadPoolTest, ParallelFor) {
+    std2::thread_pool pool(4);
+    std::vector<int> hits(100003, 0);
+    std2::parallel_for(pool, 0, hits.size(), 1000, [&](std::size_t i) { hits[i] += 1; });
+
+    for (int h : hits) ASSERT_EQ(h, 1);
+
+    // empty range is a no-op
+    std2::parallel_for(pool, 5, 5, 1, [&](std::size_t) { FAIL(); });
+}
+
+// Test parallel_reduce against the closed form
+TEST_F(ThreadPoolTest, ParallelReduce) {
+    std2::thread_pool pool(4);
+    const std::size_t n = 1000000;
+    const long long sum = std2::parallel_reduce(pool, 0, n, 4096, 0LL,
+        [](std::size_t i) { return static_cast<long long>(i); },
+        [](long long a, long long b) { return a + b; });
+    EXPECT_EQ(sum, static_cast<long long>(n) * (n - 1) / 2);
+}
+
+// Test recursive fork/join through task groups
+TEST_F(ThreadPoolTest, RecursiveForkJoin) {
+    std2::thread_pool pool(4);
+    EXPECT_EQ(fib(pool, 24), 46368);
+}
+
+// Test nested parallel_for from inside pool tasks
+TEST_F(ThreadPoolTest, NestedParallelFor) {
+    std2::thread_pool pool(2);
+    std::atomic<int> counter{0};
+    std2::parallel_for(pool, 0, 16, 1, [&](std::size_t) {
+        std2::parallel_for(pool, 0, 100, 10, [&](std::size_t) {
+            counter.fetch_add(1, std::memory_order_relaxed);
+        });
+    });
+    EXPECT_EQ(counter.load(), 1600);
+}
+
+// Test continuation style join
+TEST_F(ThreadPoolTest, TaskGroupContinuation) {
+    std2::thread_pool pool(4);
+    std::atomic<int> counter{0};
+    std::atomic<int> seen_by_continuation{-1};
+
+    std2::task_group group(pool);
+    for (int i = 0; i < 100; ++i) {
+        group.run([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+    }
+    group.join([&] { seen_by_continuation.store(counter.load()); });
+
+    while (seen_by_continuation.load() < 0) std::this_thread::yield();
+    EXPECT_TRUE(group.done());
+    EXPECT_EQ(seen_by_continuation.load(), 100);
+}
+
+// Test joining a group that was already waited on or joined is rejected
+TEST_F(ThreadPoolTest, JoinAfterWait) {
+    std2::thread_pool pool(2);
+    std::atomic<int> continuations{0};
+
+    std2::task_group waited(pool);
+    waited.run([] {});
+    waited.wait();
+    EXPECT_THROW(waited.join([&] { continuations.fetch_add(1); }), std::logic_error);
+
+    std2::task_group joined(pool);
+    joined.run([] {});
+    joined.join([&] { continuations.fetch_add(1); });
+    EXPECT_THROW(joined.join([&] { continuations.fetch_add(1); }), std::logic_error);
+
+    while (continuations.load() < 1) std::this_thread::yield();
+    EXPECT_EQ(continuations.load(), 1);
+}
+
+// Test exceptions thrown by tasks reach the joining thread after every task finished
+TEST_F(ThreadPoolTest, ThrowingTasks) {
+    std2::thread_pool pool(4);
+
+    std::atomic<int> finished{0};
+    EXPECT_THROW(std2::parallel_for(pool, 0, 10000, 10, [&](std::size_t i) {
+        if (i == 5000) throw std::runtime_error("chunk");
+        finished.fetch_add(1, std::memory_order_relaxed);
+    }), std::runtime_error);
+    EXPECT_LT(finished.load(), 10000);
+
+    EXPECT_THROW(std2::parallel_reduce(pool, 0, 1000, 7, 0,
+        [](std::size_t i) -> int { if (i % 100 == 0) throw std::logic_error("map"); return 1; },
+        [](int a, int b) { return a + b; }), std::logic_error);
+
+    std::atomic<int> ran{0};
+    {
+        std2::task_group group(pool);
+        for (int i = 0; i < 100; ++i) {
+            group.run([&ran, i] {
+                ran.fetch_add(1, std::memory_order_relaxed);
+                if (i % 10 == 0) throw std::runtime_error("task");
+            });
+        }
+        EXPECT_THROW(group.wait(), std::runtime_error);
+        EXPECT_EQ(ran.load(), 100);
+        EXPECT_TRUE(group.done());
+    }
+
+    // the pool keeps working afterwards
+    std::vector<int> hits(1000, 0);
+    std2::parallel_for(pool, 0, hits.size(), 10, [&](std::size_t i) { hits[i] += 1; });
+    for (int h : hits) ASSERT_EQ(h, 1);
+}
+
+// Scaling benchmarks: embarrassingly parallel reduce and recursive fork/join
+TEST_F(ThreadPoolTest, PerformanceBenchmark) {
+    const std::size_t n = 20000000;
+    const std::size_t max_threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+
+    for (std::size_t threads = 1; threads <= max_threads * 2; threads *= 2) {
+        std2::thread_pool pool(threads);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        const double total = std2::parallel_reduce(pool, 0, n, 65536, 0.0,
+            [](std::size_t i) { return std::sqrt(static_cast<double>(i)); },
+            [](double a, double b) { return a + b; });
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << threads << " threads parallel_reduce: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+                  << " microseconds (" << total << ")\n";
+
+        start = std::chrono::high_resolution_clock::now();
+        const long result = fib(pool, 30);
+        end = std::chrono::high_resolution_clock::now();
+        std::cout << threads << " threads fork/join fib(30): "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+                  << " microseconds (" << result << ")\n";
+    }
+}
@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../trace.hpp"
+#include "../../vector/include/vector.hpp"
+#include "../../list/include/list.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std2::trace::set_enabled(true);
+        std2::trace::set_sample_rate(1);
+        std2::trace::reset();
+    }
+
+    void TearDown() override {
+        std2::trace::set_sample_rate(1);
+        std2::trace::reset();
+    }
+
+    static std::size_t count(const std::vector<std2::trace::event>& events, const char* name) {
+        std::size_t n = 0;
+        for (const auto& e : events) n += std::strcmp(e.name, name) == 0;
+        return n;
+    }
+};
+
+// Test vector growth, resize and large clears are recorded
+TEST_F(TraceTest, VectorHooks) {
+    static_assert(std2::trace::enabled, "std2_tests builds with STD2_ENABLE_TRACING");
+    {
+        std2::vector<int> vec;
+        for (int i = 0; i < 10000; ++i) vec.push_back(i);
+        vec.resize(20000);
+        vec.clear();
+
+        std2::vector<int> small;
+        small.push_back(1);
+        small.clear();
+    }
+
+    const auto events = std2::trace::collect();
+    EXPECT_GE(count(events, "std2::vector::reallocate"), 10);
+    EXPECT_EQ(count(events, "std2::vector::resize"), 1);
+    EXPECT_EQ(count(events, "std2::vector::clear"), 1); // the small clear is below the threshold
+
+    for (const auto& e : events) {
+        if (std::strcmp(e.name, "std2::vector::resize") == 0) {
+            EXPECT_EQ(e.arg, 20000);
+        }
+    }
+}
+
+// Test list node churn is recorded
+TEST_F(TraceTest, ListHooks) {
+    std2::list<int> list;
+    for (int i = 0; i < 5000; ++i) {
+        auto it = list.begin();
+        list.insert(it, i);
+    }
+    auto it = list.begin();
+    for (int i = 0; i < 10; ++i) list.erase(it);
+    EXPECT_EQ(list.size(), 4990);
+    list.clear();
+    EXPECT_EQ(list.size(), 0);
+
+    const auto events = std2::trace::collect();
+    EXPECT_EQ(count(events, "std2::list::add_node"), 5000);
+    EXPECT_EQ(count(events, "std2::list::erase"), 10);
+    EXPECT_EQ(count(events, "std2::list::clear"), 1);
+}
+
+// Test sampling, run time disabling and ring buffer overwrite
+TEST_F(TraceTest, SamplingAndOverwrite) {
+    std2::vector<int> vec;
+    std2::trace::set_sample_rate(10);
+    for (int i = 0; i < 1000; ++i) vec.resize(i % 7);
+    EXPECT_EQ(count(std2::trace::collect(), "std2::vector::resize"), 100);
+
+    std2::trace::reset();
+    std2::trace::set_enabled(false);
+    for (int i = 0; i < 1000; ++i) vec.resize(i % 7);
+    EXPECT_TRUE(std2::trace::collect().empty());
+    std2::trace::set_enabled(true);
+
+    std2::trace::set_sample_rate(1);
+    const std::size_t n = std2::trace::thread_buffer::CAPACITY + 500;
+    for (std::size_t i = 0; i < n; ++i) vec.resize(i % 7);
+    const auto events = std2::trace::collect();
+    ASSERT_EQ(events.size(), std2::trace::thread_buffer::CAPACITY);
+    EXPECT_EQ(events.back().arg, (n - 1) % 7);
+}
+
+// Test every thread gets its own buffer and the exporter can run while threads record
+TEST_F(TraceTest, PerThreadBuffers) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([] {
+            std2::vector<int> vec;
+            for (int i = 0; i < 20000; ++i) vec.resize(i % 5);
+        });
+    }
+    std::size_t seen_while_running = 0;
+    for (int i = 0; i < 20; ++i) seen_while_running += std2::trace::collect().size();
+    for (auto& t : threads) t.join();
+
+    const auto events = std2::trace::collect();
+    std::vector<std::uint32_t> ids;
+    for (const auto& e : events) {
+        if (std::find(ids.begin(), ids.end(), e.thread) == ids.end()) ids.push_back(e.thread);
+    }
+    EXPECT_EQ(ids.size(), 4);
+    EXPECT_EQ(count(events, "std2::vector::resize"), 4 * std2::trace::thread_buffer::CAPACITY);
+    (void)seen_while_running;
+}
+
+// Test buffers of exited threads are kept for export but bounded under thread churn
+TEST_F(TraceTest, ExitedThreadBuffers) {
+    const std::size_t baseline = std2::trace::registry::instance().buffer_count();
+
+    std::thread([] { std2::vector<int> vec; vec.resize(3); }).join();
+    EXPECT_EQ(count(std2::trace::collect(), "std2::vector::resize"), 1);
+
+    for (std::size_t i = 0; i < 2 * std2::trace::MAX_EXITED_BUFFERS; ++i) {
+        std::thread([] { std2::vector<int> vec; vec.resize(3); }).join();
+    }
+    EXPECT_EQ(std2::trace::registry::instance().buffer_count(), baseline + std2::trace::MAX_EXITED_BUFFERS);
+    EXPECT_EQ(count(std2::trace::collect(), "std2::vector::resize"), std2::trace::MAX_EXITED_BUFFERS);
+
+    std2::trace::reset();
+    EXPECT_EQ(std2::trace::registry::instance().buffer_count(), baseline);
+}
+
+// Test the Chrome trace-event export
+TEST_F(TraceTest, ChromeTraceExport) {
+    {
+        std2::vector<int> vec;
+        vec.resize(100);
+    }
+
+    std::ostringstream json;
+    std2::trace::write_chrome_trace(json);
+    const std::string text = json.str();
+    EXPECT_NE(text.find("{\"traceEvents\":["), std::string::npos);
+    EXPECT_NE(text.find("\"name\":\"std2::vector::resize\""), std::string::npos);
+    EXPECT_NE(text.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(text.find("\"args\":{\"n\":100}"), std::string::npos);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "std2_trace_test.json").string();
+    std2::trace::write_chrome_trace(path);
+    EXPECT_GT(std::filesystem::file_size(path), text.size() / 2);
+    std::filesystem::remove(path);
+
+    EXPECT_THROW(std2::trace::write_chrome_trace(std::string("/nonexistent/dir/trace.json")), std::runtime_error);
+}
+
+// Test timestamps far from the start keep sub-microsecond resolution in the export
+TEST_F(TraceTest, ChromeTraceLateTimestamps) {
+    auto& registry = std2::trace::registry::instance();
+    const double ticks_per_us = registry.ticks_per_us();
+    const auto at_us = [&](double us) { return registry.tick0() + static_cast<std::uint64_t>(us * ticks_per_us); };
+
+    // 2.5 s into the trace, 1 us apart
+    registry.local().record("std2::trace_test::late", at_us(2500000.0), at_us(0.5) - registry.tick0(), 0);
+    registry.local().record("std2::trace_test::late", at_us(2500001.0), at_us(0.5) - registry.tick0(), 1);
+
+    std::ostringstream json;
+    std2::trace::write_chrome_trace(json);
+    const std::string text = json.str();
+
+    std::vector<double> stamps;
+    for (std::size_t pos = text.find("std2::trace_test::late"); pos != std::string::npos;
+         pos = text.find("std2::trace_test::late", pos + 1)) {
+        const std::size_t ts = text.find("\"ts\":", pos) + 5;
+        const std::string value = text.substr(ts, text.find(',', ts) - ts);
+        EXPECT_EQ(value.find('e'), std::string::npos) << value;
+        EXPECT_EQ(value.size() - value.find('.'), 4) << value;
+        stamps.push_back(std::stod(value));
+    }
+    ASSERT_EQ(stamps.size(), 2);
+    // the exporter recalibrates the tick rate, so allow for drift but not for 10 us rounding
+    EXPECT_GT(stamps[0], 1000000.0);
+    EXPECT_GT(stamps[1] - stamps[0], 0.5);
+    EXPECT_LT(stamps[1] - stamps[0], 2.0);
+
+    // the stream's formatting is restored afterwards
+    EXPECT_EQ(json.precision(), 6);
+    EXPECT_FALSE(json.flags() & std::ios_base::fixed);
+}
+
+// Cost of the hooks: every scope recorded, 1-in-64 sampling, and switched off at run time
+TEST_F(TraceTest, PerformanceBenchmark) {
+    const int n = 5000000;
+
+    auto run = [n](const char* label) {
+        std2::vector<int> vec;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < n; ++i) vec.resize(i & 3);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << label << ": "
+                  << std::chrono::duration<double, std::nano>(end - start).count() / n << " ns per traced resize\n";
+    };
+
+    run("recording every scope ");
+    std2::trace::set_sample_rate(64);
+    run("sampling 1 in 64      ");
+    std2::trace::set_enabled(false);
+    run("disabled at run time  ");
+    std2::trace::set_enabled(true);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../trim.hpp"
+#include "../../vector/include/vector.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+class TrimTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / "std2_trim_test";
+        std::filesystem::create_directories(m_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_dir);
+    }
+
+    std::string write(const std::string& name, const std::string& text) {
+        const std::filesystem::path file = m_dir / name;
+        std::filesystem::create_directories(file.parent_path());
+        std::ofstream(file) << text;
+        return file.string();
+    }
+
+    std::filesystem::path m_dir;
+};
+
+// Test tracked containers enroll for their lifetime and reclaim reports the bytes released
+TEST_F(TrimTest, RegistryReclaim) {
+    auto& registry = std2::trim::registry::instance();
+    const std::size_t before = registry.size();
+    const std::uint64_t total_before = registry.reclaimed_total();
+    {
+        std2::trim::tracked<std2::vector<int>> a;
+        std2::trim::tracked<std2::vector<double>> b;
+        EXPECT_EQ(registry.size(), before + 2);
+
+        for (int i = 0; i < 4096; ++i) a->push_back(i);
+        for (int i = 0; i < 1024; ++i) b->push_back(i);
+        a->resize(100);
+        b->clear();
+
+        const std::size_t expected = (4096 - 100) * sizeof(int) + (1024 - 4) * sizeof(double);
+        EXPECT_EQ(std2::trim::reclaim(), expected);
+        EXPECT_EQ(a->capacity(), 100);
+        EXPECT_EQ((*a)[99], 99);
+        EXPECT_EQ(std2::trim::reclaim(), 0);
+        EXPECT_EQ(registry.reclaimed_total() - total_before, expected);
+
+        // moved and copied wrappers enroll their own container
+        std2::trim::tracked<std2::vector<int>> moved(std2::move(a));
+        std2::trim::tracked<std2::vector<int>> copied(moved);
+        EXPECT_EQ(registry.size(), before + 4);
+        moved->reserve(1000);
+        EXPECT_EQ(std2::trim::reclaim(), 900 * sizeof(int));
+    }
+    EXPECT_EQ(registry.size(), before);
+}
+
+// Test parsing of the PSI file
+TEST_F(TrimTest, PsiParsing) {
+    const std::string psi = write("pressure",
+        "some avg10=12.50 avg60=3.00 avg300=0.40 total=123456\n"
+        "full avg10=1.00 avg60=0.00 avg300=0.00 total=4567\n");
+    EXPECT_DOUBLE_EQ(*std2::trim::read_psi_some_avg10(psi), 12.5);
+    EXPECT_FALSE(std2::trim::read_psi_some_avg10((m_dir / "missing").string()));
+    EXPECT_FALSE(std2::trim::read_psi_some_avg10(write("bad", "some avg10=oops\n")));
+}
+
+// Test cgroup v2 and v1 limits, and "max" or an unlimited v1 group as no limit
+TEST_F(TrimTest, CgroupUsage) {
+    write("v2/memory.current", "900\n");
+    write("v2/memory.high", "1000\n");
+    EXPECT_DOUBLE_EQ(*std2::trim::read_cgroup_usage_ratio((m_dir / "v2").string()), 0.9);
+    write("v2/memory.high", "max\n");
+    EXPECT_FALSE(std2::trim::read_cgroup_usage_ratio((m_dir / "v2").string()));
+
+    write("v1/memory.usage_in_bytes", "250\n");
+    write("v1/memory.limit_in_bytes", "1000\n");
+    EXPECT_DOUBLE_EQ(*std2::trim::read_cgroup_usage_ratio((m_dir / "v1").string()), 0.25);
+    write("v1/memory.limit_in_bytes", "9223372036854771712\n");
+    EXPECT_FALSE(std2::trim::read_cgroup_usage_ratio((m_dir / "v1").string()));
+
+    EXPECT_FALSE(std2::trim::read_cgroup_usage_ratio(""));
+}
+
+// Test locating our cgroup from /proc/self/cgroup on v2, v1 and namespaced mounts
+TEST_F(TrimTest, DetectCgroupDir) {
+    const std::string root = (m_dir / "sys").string();
+    write("sys/app.slice/svc/memory.current", "1\n");
+    write("sys/memory/batch/job/memory.usage_in_bytes", "1\n");
+
+    const std::string v2 = write("cgroup_v2", "0::/app.slice/svc\n");
+    EXPECT_EQ(std2::trim::detect_cgroup_dir(v2, root), (m_dir / "sys/app.slice/svc").string());
+
+    const std::string v1 = write("cgroup_v1", "12:cpu,cpuacct:/batch/job\n7:memory:/batch/job\n0::/\n");
+    EXPECT_EQ(std2::trim::detect_cgroup_dir(v1, root), (m_dir / "sys/memory/batch/job").string());
+
+    const std::string elsewhere = write("cgroup_ns", "7:memory:/not/mounted/here\n");
+    EXPECT_EQ(std2::trim::detect_cgroup_dir(elsewhere, root), "");
+    write("sys/memory/memory.usage_in_bytes", "1\n");
+    EXPECT_EQ(std2::trim::detect_cgroup_dir(elsewhere, root), (m_dir / "sys/memory").string());
+}
+
+// Test reclaiming only happens once a threshold is crossed
+TEST_F(TrimTest, ReclaimIfPressured) {
+    std2::trim::tracked<std2::vector<int>> vec;
+    for (int i = 0; i < 1000; ++i) vec->push_back(i);
+    vec->clear();
+
+    std2::trim::sources calm{write("psi", "some avg10=1.00 avg60=0.00 avg300=0.00 total=1\n"), ""};
+    std2::trim::thresholds limits;
+    EXPECT_FALSE(std2::trim::read_pressure(calm).exceeds(limits));
+    EXPECT_EQ(std2::trim::reclaim_if_pressured(limits, calm), 0);
+    EXPECT_EQ(vec->capacity(), 1024);
+
+    write("cg/memory.current", "950\n");
+    write("cg/memory.high", "1000\n");
+    std2::trim::sources near_high{calm.psi_path, (m_dir / "cg").string()};
+    EXPECT_TRUE(std2::trim::read_pressure(near_high).exceeds(limits));
+    EXPECT_GE(std2::trim::reclaim_if_pressured(limits, near_high), (1024 - 4) * sizeof(int));
+    EXPECT_EQ(vec->capacity(), 4);
+
+    limits.cgroup_usage_ratio = 0.99;
+    EXPECT_FALSE(std2::trim::read_pressure(near_high).exceeds(limits));
+}
+
+// Test the kernel trigger where the kernel lets us register one
+TEST_F(TrimTest, PsiTrigger) {
+    EXPECT_THROW(std2::trim::psi_trigger(std::chrono::milliseconds(100), std::chrono::seconds(1),
+                                         (m_dir / "missing").string()),
+                 std::system_error);
+    try {
+        std2::trim::psi_trigger trigger(std::chrono::milliseconds(150), std::chrono::seconds(1));
+        (void)trigger.wait(std::chrono::milliseconds(0));
+    } catch (const std::system_error& e) {
+        GTEST_SKIP() << "PSI triggers unavailable: " << e.what();
+    }
+}
+
+// Cost of a reclaim pass over many enrolled vectors, with and without slack to release
+TEST_F(TrimTest, PerformanceBenchmark) {
+    const int n = 10000;
+    std::vector<std2::trim::tracked<std2::vector<int>>> containers(n);
+    for (auto& c : containers) {
+        for (int i = 0; i < 1000; ++i) c->push_back(i);
+        c->resize(10);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const std::size_t released = std2::trim::reclaim();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "reclaim over " << n << " vectors with slack: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+              << " us, " << released << " bytes released\n";
+    EXPECT_EQ(released, std::size_t(n) * (1024 - 10) * sizeof(int));
+
+    start = std::chrono::high_resolution_clock::now();
+    EXPECT_EQ(std2::trim::reclaim(), 0);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "reclaim over " << n << " vectors already trimmed: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    const auto sample = std2::trim::read_pressure();
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "pressure sample: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us (psi "
+              << (sample.psi_some_avg10 ? std::to_string(*sample.psi_some_avg10) : "n/a") << ", cgroup "
+              << (sample.cgroup_usage_ratio ? std::to_string(*sample.cgroup_usage_ratio) : "n/a") << ")\n";
+}
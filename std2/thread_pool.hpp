@@ -0,0 +1,637 @@
+#ifndef STD2_THREAD_POOL_HPP
+#define STD2_THREAD_POOL_HPP
+
+#include <atomic>     // for std::atomic, std::atomic_thread_fence
+#include <climits>    // for INT_MAX
+#include <cstddef>    // for std::size_t
+#include <cstdint>    // for std::int64_t, std::uint32_t
+#include <deque>      // for std::deque
+#include <exception>  // for std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <memory>     // for std::unique_ptr
+#include <mutex>      // for std::mutex, std::lock_guard
+#include <stdexcept>  // for std::logic_error
+#include <thread>     // for std::thread
+#include <type_traits> // for std::decay_t
+#include <vector>     // for std::vector
+
+#if defined(__linux__)
+#include <linux/futex.h> // for FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE
+#include <sys/syscall.h> // for SYS_futex
+#include <unistd.h>      // for syscall
+#endif
+
+#include "std2.hpp" // for std2::move, std2::forward, std2::exchange
+
+namespace std2 {
+
+namespace pool_detail {
+
+/*
+ * Type erased unit of work. Tasks are heap allocated and delete themselves
+ * after running, so the deques only ever move raw pointers around.
+ */
+struct task {
+    virtual ~task() = default;
+    virtual void run() = 0;
+};
+
+template <typename F>
+struct task_impl final : task {
+    explicit task_impl(F&& fn) : m_fn(std2::move(fn)) {}
+    explicit task_impl(const F& fn) : m_fn(fn) {}
+    void run() override { m_fn(); }
+    F m_fn;
+};
+
+template <typename F>
+task* make_task(F&& fn) {
+    return new task_impl<std::decay_t<F>>(std2::forward<F>(fn));
+}
+
+/*
+ * First exception thrown by the tasks of one join (task_group, parallel_for).
+ * Tasks capture into it before their completion decrement, so the joining
+ * thread sees the exception once the count it waits on reaches zero.
+ */
+class exception_slot {
+public:
+    // inside a catch block
+    void capture() noexcept {
+        bool expected = false;
+        if (m_raised.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            m_error = std::current_exception();
+        }
+    }
+
+    bool raised() const { return m_raised.load(std::memory_order_relaxed); }
+
+    // after the join, every task that could capture has finished
+    void rethrow() {
+        if (!m_error) return;
+        std::exception_ptr error = std2::exchange(m_error, nullptr);
+        m_raised.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(error);
+    }
+
+private:
+    std::atomic<bool> m_raised{false};
+    std::exception_ptr m_error;
+};
+
+/**
+ *  @brief  Block while the word still holds expected (futex on Linux).
+ *  @param  word  The futex word.
+ *  @param  expected  The value observed before deciding to sleep.
+ *  @return void.
+ */
+inline void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    word.wait(expected);
+#endif
+}
+
+/**
+ *  @brief  Wake up to count threads blocked in futex_wait on the word.
+ *  @param  word  The futex word.
+ *  @param  count  Number of waiters to wake.
+ *  @return void.
+ */
+inline void futex_wake(std::atomic<std::uint32_t>& word, int count) {
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+    if (count == 1) word.notify_one();
+    else word.notify_all();
+#endif
+}
+
+/*
+ * Chase-Lev work stealing deque (the C11 formulation by Le, Pop, Cohen and
+ * Zappa Nardelli). The owning worker pushes and pops at the bottom, other
+ * workers steal from the top. Retired buffers are kept until destruction
+ * because a thief may still be reading from them.
+ */
+class work_stealing_deque {
+public:
+    explicit work_stealing_deque(std::int64_t capacity = 256) {
+        m_buffer.store(new buffer(capacity), std::memory_order_relaxed);
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    ~work_stealing_deque() {
+        delete m_buffer.load(std::memory_order_relaxed);
+        for (buffer* old : m_retired) delete old;
+    }
+
+    // owner only
+    void push(task* item) {
+        const std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = m_top.load(std::memory_order_acquire);
+        buffer* buf = m_buffer.load(std::memory_order_relaxed);
+        if (b - t > buf->capacity - 1) buf = grow(buf, t, b);
+        buf->put(b, item);
+        m_bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // owner only
+    task* pop() {
+        const std::int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        buffer* buf = m_buffer.load(std::memory_order_relaxed);
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = m_top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // already empty
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        task* item = buf->get(b);
+        if (t == b) {
+            // last element - race against thieves for it
+            if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // any thread
+    task* steal() {
+        std::int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = m_bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+
+        buffer* buf = m_buffer.load(std::memory_order_acquire);
+        task* item = buf->get(t);
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr; // lost the race, the caller just tries elsewhere
+        }
+        return item;
+    }
+
+    bool empty() const {
+        return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct buffer {
+        explicit buffer(std::int64_t cap) : capacity(cap), mask(cap - 1), slots(new std::atomic<task*>[cap]) {}
+        ~buffer() { delete[] slots; }
+
+        // slots are release/acquire (free on x86) so the task publication is
+        // visible to race detectors that do not model standalone fences
+        task* get(std::int64_t i) const { return slots[i & mask].load(std::memory_order_acquire); }
+        void put(std::int64_t i, task* item) { slots[i & mask].store(item, std::memory_order_release); }
+
+        std::int64_t capacity;
+        std::int64_t mask;
+        std::atomic<task*>* slots;
+    };
+
+    buffer* grow(buffer* old, std::int64_t top, std::int64_t bottom) {
+        buffer* bigger = new buffer(old->capacity * 2);
+        for (std::int64_t i = top; i < bottom; ++i) bigger->put(i, old->get(i));
+        m_retired.push_back(old);
+        m_buffer.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<std::int64_t> m_top{0};
+    alignas(64) std::atomic<std::int64_t> m_bottom{0};
+    std::atomic<buffer*> m_buffer{nullptr};
+    std::vector<buffer*> m_retired;
+};
+
+} // namespace pool_detail
+
+/*
+ * Work stealing thread pool.
+ * Every worker owns a Chase-Lev deque: tasks spawned from a worker go to its
+ * own deque, idle workers steal from random victims. Tasks submitted from
+ * outside the pool go through a shared injection queue that workers drain in
+ * batches. Workers with nothing to do park on a futex instead of spinning.
+ * Destruction runs every task that was submitted (including tasks spawned
+ * during shutdown) before joining the workers.
+ */
+class thread_pool {
+public:
+    /**
+     *  @brief  Start the workers.
+     *  @param  thread_count  Number of workers, defaults to the hardware concurrency.
+     */
+    explicit thread_pool(std::size_t thread_count = std::thread::hardware_concurrency()) {
+        if (thread_count == 0) thread_count = 1;
+        m_workers.reserve(thread_count);
+        for (std::size_t i = 0; i < thread_count; ++i) {
+            m_workers.push_back(new worker());
+        }
+        for (std::size_t i = 0; i < thread_count; ++i) {
+            m_workers[i]->thread = std::thread([this, i] { worker_loop(i); });
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool() {
+        m_stopping.store(true, std::memory_order_seq_cst);
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        pool_detail::futex_wake(m_epoch, INT_MAX);
+
+        for (worker* w : m_workers) {
+            w->thread.join();
+        }
+        for (worker* w : m_workers) delete w;
+    }
+
+    /**
+     *  @brief  Schedule a callable to run on the pool.
+     *          fn must not throw, an escaping exception calls std::terminate.
+     *          Use task_group or parallel_for to get exceptions back on the joining thread.
+     *  @param  fn  Callable taking no arguments.
+     *  @return void.
+     */
+    template <typename F>
+    void submit(F&& fn) {
+        push_task(pool_detail::make_task(std2::forward<F>(fn)));
+    }
+
+    /**
+     *  @brief  Schedule count callables produced by make(i) with one wake up.
+     *          Outside the pool the batch takes the injection lock only once.
+     *  @param  count  Number of tasks.
+     *  @param  make  Callable mapping an index to the task callable.
+     *  @return void.
+     */
+    template <typename Factory>
+    void submit_batch(std::size_t count, Factory&& make) {
+        if (count == 0) return;
+        if (worker* self = current_worker()) {
+            for (std::size_t i = 0; i < count; ++i) self->tasks.push(pool_detail::make_task(make(i)));
+        } else {
+            std::lock_guard<std::mutex> lock(m_inject_mutex);
+            for (std::size_t i = 0; i < count; ++i) m_inject.push_back(pool_detail::make_task(make(i)));
+            m_inject_size.fetch_add(count, std::memory_order_relaxed);
+        }
+        notify(count);
+    }
+
+    /**
+     *  @brief  Run one pending task on the calling thread if there is one.
+     *          Used by blocking joins so a waiting worker keeps making progress.
+     *  @return true if a task was run.
+     */
+    bool try_run_one() {
+        worker* self = current_worker();
+        pool_detail::task* item = find_task(self ? self->index : 0, self != nullptr);
+        if (!item) return false;
+        execute(item);
+        return true;
+    }
+
+    std::size_t size() const { return m_workers.size(); }
+
+private:
+    struct worker {
+        pool_detail::work_stealing_deque tasks;
+        std::thread thread;
+        std::size_t index = 0;
+        thread_pool* owner = nullptr;
+    };
+
+    static constexpr std::size_t INJECT_BATCH = 32; // tasks moved from the injection queue at once
+
+    static worker*& tls_worker() {
+        static thread_local worker* current = nullptr;
+        return current;
+    }
+
+    worker* current_worker() const {
+        worker* w = tls_worker();
+        return (w && w->owner == this) ? w : nullptr;
+    }
+
+    void push_task(pool_detail::task* item) {
+        if (worker* self = current_worker()) {
+            self->tasks.push(item);
+        } else {
+            std::lock_guard<std::mutex> lock(m_inject_mutex);
+            m_inject.push_back(item);
+            m_inject_size.fetch_add(1, std::memory_order_relaxed);
+        }
+        notify(1);
+    }
+
+    /* @brief  Wake parked workers if there are any. Pairs with the sleeper
+     *         registration in park() through seq_cst fences so a wake up is never lost.
+     * @param  count  Number of new tasks.
+     * @return void.
+     */
+    void notify(std::size_t count) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleepers.load(std::memory_order_relaxed) == 0) return;
+        m_epoch.fetch_add(1, std::memory_order_release);
+        pool_detail::futex_wake(m_epoch, count >= m_workers.size() ? INT_MAX : static_cast<int>(count));
+    }
+
+    bool has_work() const {
+        if (m_inject_size.load(std::memory_order_relaxed) > 0) return true;
+        for (const worker* w : m_workers) {
+            if (!w->tasks.empty()) return true;
+        }
+        return false;
+    }
+
+    /* @brief  Find something to run: own deque, then the injection queue, then steal.
+     * @param  index  Index of the calling worker (start point for victim selection).
+     * @param  is_worker  True if the caller owns m_workers[index].
+     * @return a task or nullptr.
+     */
+    pool_detail::task* find_task(std::size_t index, bool is_worker) {
+        if (is_worker) {
+            if (pool_detail::task* item = m_workers[index]->tasks.pop()) return item;
+            if (pool_detail::task* item = take_injected(m_workers[index])) return item;
+        }
+
+        const std::size_t n = m_workers.size();
+        const std::size_t start = next_victim(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::size_t victim = (start + k) % n;
+            if (is_worker && victim == index) continue;
+            if (pool_detail::task* item = m_workers[victim]->tasks.steal()) return item;
+        }
+
+        if (!is_worker) return take_injected(nullptr);
+        return nullptr;
+    }
+
+    /* @brief  Take a batch of tasks from the injection queue. One task is
+     *         returned, the rest go to the worker's own deque where they can be stolen.
+     * @param  self  The calling worker, or nullptr for a helping external thread.
+     * @return a task or nullptr.
+     */
+    pool_detail::task* take_injected(worker* self) {
+        if (m_inject_size.load(std::memory_order_relaxed) == 0) return nullptr;
+
+        std::lock_guard<std::mutex> lock(m_inject_mutex);
+        if (m_inject.empty()) return nullptr;
+
+        pool_detail::task* first = m_inject.front();
+        m_inject.pop_front();
+        std::size_t taken = 1;
+        while (self && taken < INJECT_BATCH && !m_inject.empty()) {
+            self->tasks.push(m_inject.front());
+            m_inject.pop_front();
+            ++taken;
+        }
+        m_inject_size.fetch_sub(taken, std::memory_order_relaxed);
+        return first;
+    }
+
+    std::size_t next_victim(std::size_t n) {
+        // xorshift per thread, good enough to spread thieves
+        static thread_local std::uint32_t state = 0x9e3779b9u ^ static_cast<std::uint32_t>(
+            reinterpret_cast<std::uintptr_t>(&state));
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state % n;
+    }
+
+    // exceptions from bare submitted tasks terminate, same on workers and helping threads
+    static void execute(pool_detail::task* item) noexcept {
+        std::unique_ptr<pool_detail::task> owned(item);
+        owned->run();
+    }
+
+    void worker_loop(std::size_t index) {
+        worker* self = m_workers[index];
+        self->index = index;
+        self->owner = this;
+        tls_worker() = self;
+
+        for (;;) {
+            if (pool_detail::task* item = find_task(index, true)) {
+                execute(item);
+                continue;
+            }
+            if (m_stopping.load(std::memory_order_acquire) && !has_work()) break;
+            park();
+        }
+
+        tls_worker() = nullptr;
+    }
+
+    void park() {
+        const std::uint32_t epoch = m_epoch.load(std::memory_order_acquire);
+        m_sleepers.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // re-check after announcing ourselves, a submitter may have missed us
+        if (!has_work() && !m_stopping.load(std::memory_order_relaxed)) {
+            pool_detail::futex_wait(m_epoch, epoch);
+        }
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    std::vector<worker*> m_workers;
+    std::mutex m_inject_mutex;
+    std::deque<pool_detail::task*> m_inject;
+    std::atomic<std::size_t> m_inject_size{0};
+    std::atomic<bool> m_stopping{false};
+    alignas(64) std::atomic<std::uint32_t> m_epoch{0}; // futex word
+    std::atomic<std::uint32_t> m_sleepers{0};
+};
+
+/*
+ * Fork/join scope on a thread_pool.
+ * run() forks tasks, wait() joins them (helping to execute pending work while
+ * waiting, so it is safe to call from inside a task), and join() registers a
+ * continuation that is scheduled once all forked tasks have finished.
+ * The first exception thrown by a forked task is rethrown by wait(), the
+ * other tasks still run to completion. The destructor joins but drops it.
+ */
+class task_group {
+public:
+    explicit task_group(thread_pool& pool) : m_pool(pool) {}
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    ~task_group() { join_all(); }
+
+    /**
+     *  @brief  Fork a task into the group.
+     *  @param  fn  Callable taking no arguments.
+     *  @return void.
+     */
+    template <typename F>
+    void run(F&& fn) {
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+        m_pool.submit([this, fn = std2::forward<F>(fn)]() mutable {
+            try {
+                fn();
+            } catch (...) {
+                m_error.capture();
+            }
+            finish_one();
+        });
+    }
+
+    /**
+     *  @brief  Block until every forked task has finished, running pool work meanwhile.
+     *          Rethrows the first exception a forked task threw.
+     *  @return void.
+     */
+    void wait() {
+        join_all();
+        m_error.rethrow();
+    }
+
+    /**
+     *  @brief  Schedule a continuation to run once every forked task has finished.
+     *          Does not block. The group must outlive the continuation being scheduled.
+     *  @param  continuation  Callable taking no arguments.
+     *  @return void.
+     *  @throws std::logic_error if the group was already joined or waited on.
+     */
+    template <typename F>
+    void join(F&& continuation) {
+        // the bias is gone, so nothing would ever submit (or free) a continuation stored now
+        if (m_joined) throw std::logic_error("std2::task_group::join: group already joined or waited on");
+        m_continuation = pool_detail::make_task(std2::forward<F>(continuation));
+        release_bias();
+    }
+
+    /**
+     *  @brief  True once every forked task (and the bias held by the group) is done.
+     *  @return completion state.
+     */
+    bool done() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    void join_all() {
+        release_bias();
+        while (m_pending.load(std::memory_order_acquire) != 0) {
+            if (!m_pool.try_run_one()) std::this_thread::yield();
+        }
+    }
+
+    void release_bias() {
+        if (m_joined) return;
+        m_joined = true;
+        finish_one();
+    }
+
+    // Once the count reaches zero a waiter may return and destroy the group, so everything
+    // needed afterwards is read before the decrement. Seeing a count of one means the bias
+    // is already released, so a continuation stored by join() is visible at that point.
+    void finish_one() {
+        thread_pool& pool = m_pool;
+        pool_detail::task* continuation = nullptr;
+        std::size_t pending = m_pending.load(std::memory_order_acquire);
+        do {
+            continuation = pending == 1 ? m_continuation : nullptr;
+        } while (!m_pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel,
+                                                  std::memory_order_acquire));
+        if (continuation) {
+            pool.submit([continuation] {
+                std::unique_ptr<pool_detail::task> owned(continuation);
+                owned->run();
+            });
+        }
+    }
+
+    thread_pool& m_pool;
+    // starts at one: the group itself holds a reference until wait()/join()
+    std::atomic<std::size_t> m_pending{1};
+    pool_detail::task* m_continuation = nullptr;
+    pool_detail::exception_slot m_error;
+    bool m_joined = false;
+};
+
+/**
+ *  @brief  Run fn(i) for every i in [first, last) on the pool, split into chunks of grain.
+ *          If fn throws, chunks not yet started are skipped and the first
+ *          exception is rethrown once every chunk has finished.
+ *  @param  pool  The pool to run on.
+ *  @param  first  Start of the index range.
+ *  @param  last  End of the index range (exclusive).
+ *  @param  grain  Indices per task.
+ *  @param  fn  Callable taking a std::size_t index.
+ *  @return void.
+ */
+template <typename F>
+void parallel_for(thread_pool& pool, std::size_t first, std::size_t last, std::size_t grain, F&& fn) {
+    if (first >= last) return;
+    if (grain == 0) grain = 1;
+
+    const std::size_t chunks = (last - first + grain - 1) / grain;
+    std::atomic<std::size_t> remaining{chunks};
+    pool_detail::exception_slot error;
+
+    pool.submit_batch(chunks, [&](std::size_t c) {
+        return [&, c] {
+            if (!error.raised()) {
+                const std::size_t begin = first + c * grain;
+                const std::size_t end = begin + grain < last ? begin + grain : last;
+                try {
+                    for (std::size_t i = begin; i < end; ++i) fn(i);
+                } catch (...) {
+                    error.capture();
+                }
+            }
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        };
+    });
+
+    while (remaining.load(std::memory_order_acquire) != 0) {
+        if (!pool.try_run_one()) std::this_thread::yield();
+    }
+    error.rethrow();
+}
+
+/**
+ *  @brief  Parallel map/reduce over [first, last).
+ *  @param  pool  The pool to run on.
+ *  @param  first  Start of the index range.
+ *  @param  last  End of the index range (exclusive).
+ *  @param  grain  Indices per task.
+ *  @param  identity  Neutral element of reduce.
+ *  @param  map  Callable turning an index into a T.
+ *  @param  reduce  Associative callable combining two T.
+ *  @return the reduction of map(i) over the range.
+ */
+template <typename T, typename Map, typename Reduce>
+T parallel_reduce(thread_pool& pool, std::size_t first, std::size_t last, std::size_t grain,
+                  T identity, Map&& map, Reduce&& reduce) {
+    if (first >= last) return identity;
+    if (grain == 0) grain = 1;
+
+    const std::size_t chunks = (last - first + grain - 1) / grain;
+    std::vector<T> partials(chunks, identity);
+
+    parallel_for(pool, 0, chunks, 1, [&](std::size_t c) {
+        const std::size_t begin = first + c * grain;
+        const std::size_t end = begin + grain < last ? begin + grain : last;
+        T acc = identity;
+        for (std::size_t i = begin; i < end; ++i) acc = reduce(acc, map(i));
+        partials[c] = acc;
+    });
+
+    T result = identity;
+    for (const T& partial : partials) result = reduce(result, partial);
+    return result;
+}
+
+} // namespace std2
+
+#endif // STD2_THREAD_POOL_HPP
@@ -0,0 +1,408 @@
+#ifndef STD2_TRACE_HPP
+#define STD2_TRACE_HPP
+
+/*
+ * Hot-path tracing hooks.
+ * Containers mark interesting operations with STD2_TRACE_SCOPE. Unless the
+ * build defines STD2_ENABLE_TRACING (cmake -DSTD2_TRACING=ON) the macros
+ * expand to nothing and this header pulls in no code at all.
+ *
+ * When enabled, each traced scope takes two timestamps (rdtsc on x86,
+ * clock_gettime elsewhere) and writes one event into a per-thread ring
+ * buffer; the writer never blocks and old events are overwritten. A sampling
+ * rate keeps the overhead bounded under load. write_chrome_trace() exports
+ * every thread's buffer as Chrome trace-event JSON (chrome://tracing, Perfetto).
+ * Buffers of exited threads are kept for export until the next reset(), at
+ * most MAX_EXITED_BUFFERS of them; beyond that the oldest one is freed.
+ */
+
+#if defined(STD2_ENABLE_TRACING)
+
+#include <atomic>     // for std::atomic
+#include <cstddef>    // for std::size_t
+#include <cstdint>    // for std::uint64_t
+#include <deque>      // for std::deque
+#include <fstream>    // for std::ofstream
+#include <ios>        // for std::ios_base, std::fixed
+#include <iomanip>    // for std::setprecision
+#include <memory>     // for std::shared_ptr
+#include <mutex>      // for std::mutex
+#include <ostream>    // for std::ostream
+#include <stdexcept>  // for std::runtime_error
+#include <string>     // for std::string
+#include <utility>    // for std::move
+#include <vector>     // for std::vector
+#include <time.h>     // for clock_gettime
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // for __rdtsc
+#endif
+
+namespace std2 {
+namespace trace {
+
+inline constexpr bool enabled = true;
+
+// clear() calls on containers smaller than this are not traced
+inline constexpr std::size_t LARGE_CLEAR_THRESHOLD = 4096;
+
+// buffers of exited threads retained until reset(), bounds memory under thread churn
+inline constexpr std::size_t MAX_EXITED_BUFFERS = 64;
+
+/**
+ *  @brief  Monotonic wall clock in nanoseconds.
+ *  @return nanoseconds since an arbitrary epoch.
+ */
+inline std::uint64_t monotonic_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+/**
+ *  @brief  Raw event timestamp: the TSC on x86, monotonic nanoseconds elsewhere.
+ *  @return the tick count.
+ */
+inline std::uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return monotonic_ns();
+#endif
+}
+
+/*
+ * One completed scope. name must be a string with static storage duration.
+ */
+struct event {
+    const char* name;
+    std::uint64_t start;
+    std::uint64_t duration;
+    std::uint64_t arg;
+    std::uint32_t thread;
+};
+
+/*
+ * Single-producer ring of events owned by one thread.
+ * Each slot is a tiny seqlock: the stamp is cleared before the slot is
+ * rewritten and set to its sequence number + 1 afterwards, so a concurrent
+ * exporter can tell a stable slot from one that is being overwritten.
+ */
+class thread_buffer {
+public:
+    static constexpr std::size_t CAPACITY = std::size_t(1) << 14;
+    static constexpr std::size_t MASK = CAPACITY - 1;
+
+    explicit thread_buffer(std::uint32_t thread) : m_slots(CAPACITY), m_thread(thread) {}
+
+    /**
+     *  @brief  Append an event, called only by the owning thread.
+     *  @return void.
+     */
+    void record(const char* name, std::uint64_t start, std::uint64_t duration, std::uint64_t arg) {
+        const std::uint64_t seq = m_head.load(std::memory_order_relaxed);
+        slot& s = m_slots[seq & MASK];
+        s.stamp.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.name.store(name, std::memory_order_relaxed);
+        s.start.store(start, std::memory_order_relaxed);
+        s.duration.store(duration, std::memory_order_relaxed);
+        s.arg.store(arg, std::memory_order_relaxed);
+        s.stamp.store(seq + 1, std::memory_order_release);
+        m_head.store(seq + 1, std::memory_order_release);
+    }
+
+    /**
+     *  @brief  Copy the retained events into out, skipping slots overwritten mid-read.
+     *  @param  out  Destination.
+     *  @return void.
+     */
+    void snapshot(std::vector<event>& out) const {
+        const std::uint64_t head = m_head.load(std::memory_order_acquire);
+        std::uint64_t first = m_begin.load(std::memory_order_relaxed);
+        if (head - first > CAPACITY) first = head - CAPACITY;
+
+        for (std::uint64_t seq = first; seq < head; ++seq) {
+            const slot& s = m_slots[seq & MASK];
+            const std::uint64_t before = s.stamp.load(std::memory_order_acquire);
+            event e{ s.name.load(std::memory_order_relaxed), s.start.load(std::memory_order_relaxed),
+                     s.duration.load(std::memory_order_relaxed), s.arg.load(std::memory_order_relaxed), m_thread };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (before == seq + 1 && s.stamp.load(std::memory_order_relaxed) == before) out.push_back(e);
+        }
+    }
+
+    /**
+     *  @brief  Forget the events recorded so far.
+     *  @return void.
+     */
+    void reset() { m_begin.store(m_head.load(std::memory_order_acquire), std::memory_order_relaxed); }
+
+private:
+    struct slot {
+        std::atomic<std::uint64_t> stamp{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<std::uint64_t> start{0};
+        std::atomic<std::uint64_t> duration{0};
+        std::atomic<std::uint64_t> arg{0};
+    };
+
+    std::vector<slot> m_slots;
+    std::atomic<std::uint64_t> m_head{0};
+    std::atomic<std::uint64_t> m_begin{0};
+    std::uint32_t m_thread;
+};
+
+/*
+ * Process wide state: the list of thread buffers, the sampling rate and the
+ * clock calibration used to turn ticks into microseconds.
+ */
+class registry {
+public:
+    static registry& instance() {
+        static registry r;
+        return r;
+    }
+
+    /**
+     *  @brief  The calling thread's buffer, registered on first use.
+     *  Buffers are shared with the registry so they outlive their thread,
+     *  the thread retires its buffer on exit.
+     *  @return the buffer.
+     */
+    thread_buffer& local() {
+        thread_local buffer_owner owner(add_thread());
+        return *owner.buffer;
+    }
+
+    /**
+     *  @brief  Decide whether the calling thread records its next scope.
+     *  @return true for one in every sample_rate() calls.
+     */
+    bool sample() {
+        if (!m_enabled.load(std::memory_order_relaxed)) return false;
+        thread_local std::uint32_t counter = 0;
+        const std::uint32_t every = m_sample_every.load(std::memory_order_relaxed);
+        if (++counter < every) return false;
+        counter = 0;
+        return true;
+    }
+
+    void set_enabled(bool on) { m_enabled.store(on, std::memory_order_relaxed); }
+    void set_sample_rate(std::uint32_t every) { m_sample_every.store(every ? every : 1, std::memory_order_relaxed); }
+    std::uint32_t sample_rate() const { return m_sample_every.load(std::memory_order_relaxed); }
+
+    std::vector<event> collect() {
+        std::vector<event> events;
+        std::lock_guard<std::mutex> guard(m_lock);
+        for (const auto& buffer : m_buffers) buffer->snapshot(events);
+        return events;
+    }
+
+    /**
+     *  @brief  Forget every retained event and free the buffers of exited threads.
+     *  @return void.
+     */
+    void reset() {
+        std::lock_guard<std::mutex> guard(m_lock);
+        while (!m_exited.empty()) {
+            drop(m_exited.front());
+            m_exited.pop_front();
+        }
+        for (const auto& buffer : m_buffers) buffer->reset();
+    }
+
+    /**
+     *  @brief  Number of registered buffers, live and exited threads.
+     *  @return the buffer count.
+     */
+    std::size_t buffer_count() {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return m_buffers.size();
+    }
+
+    /**
+     *  @brief  Ticks per microsecond, measured against the monotonic clock since startup.
+     *  @return the conversion factor.
+     */
+    double ticks_per_us() const {
+        const std::uint64_t ticks = now() - m_tick0;
+        const std::uint64_t ns = monotonic_ns() - m_ns0;
+        return ns ? static_cast<double>(ticks) * 1000.0 / static_cast<double>(ns) : 1000.0;
+    }
+
+    std::uint64_t tick0() const { return m_tick0; }
+
+private:
+    // thread local handle, retires the buffer when its thread exits
+    struct buffer_owner {
+        explicit buffer_owner(std::shared_ptr<thread_buffer> b) : buffer(std::move(b)) {}
+        ~buffer_owner() { registry::instance().retire(buffer.get()); }
+        std::shared_ptr<thread_buffer> buffer;
+    };
+
+    registry() : m_tick0(now()), m_ns0(monotonic_ns()) {}
+
+    std::shared_ptr<thread_buffer> add_thread() {
+        std::lock_guard<std::mutex> guard(m_lock);
+        auto buffer = std::make_shared<thread_buffer>(++m_next_thread);
+        m_buffers.push_back(buffer);
+        return buffer;
+    }
+
+    /* @brief  Keep an exited thread's buffer for export, freeing the oldest one past the limit.
+     * @param  buffer  The exiting thread's buffer.
+     * @return void.
+     */
+    void retire(thread_buffer* buffer) {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_exited.push_back(buffer);
+        if (m_exited.size() > MAX_EXITED_BUFFERS) {
+            drop(m_exited.front());
+            m_exited.pop_front();
+        }
+    }
+
+    // m_lock held
+    void drop(const thread_buffer* buffer) {
+        for (std::size_t i = 0; i < m_buffers.size(); ++i) {
+            if (m_buffers[i].get() == buffer) {
+                m_buffers.erase(m_buffers.begin() + static_cast<std::ptrdiff_t>(i));
+                return;
+            }
+        }
+    }
+
+    std::mutex m_lock;
+    std::vector<std::shared_ptr<thread_buffer>> m_buffers;
+    std::deque<const thread_buffer*> m_exited;
+    std::uint32_t m_next_thread = 0;
+    std::atomic<bool> m_enabled{true};
+    std::atomic<std::uint32_t> m_sample_every{1};
+    const std::uint64_t m_tick0;
+    const std::uint64_t m_ns0;
+};
+
+/*
+ * RAII scope: timestamps construction and destruction and records the pair
+ * as one complete event. A null name, or losing the sampling draw, makes the
+ * scope a no-op that never reads the clock.
+ */
+class scoped_event {
+public:
+    scoped_event(const char* name, std::uint64_t arg)
+        : m_name(name && registry::instance().sample() ? name : nullptr),
+        m_arg(arg),
+        m_start(m_name ? now() : 0)
+    {}
+
+    scoped_event(const scoped_event&) = delete;
+    scoped_event& operator=(const scoped_event&) = delete;
+
+    ~scoped_event() {
+        if (m_name) registry::instance().local().record(m_name, m_start, now() - m_start, m_arg);
+    }
+
+private:
+    const char* m_name;
+    std::uint64_t m_arg;
+    std::uint64_t m_start;
+};
+
+/**
+ *  @brief  Record one event in every n traced scopes per thread.
+ *  @param  n  The sampling interval, 1 records everything.
+ *  @return void.
+ */
+inline void set_sample_rate(std::uint32_t n) { registry::instance().set_sample_rate(n); }
+
+/**
+ *  @brief  Turn recording on or off at run time.
+ *  @param  on  Whether to record.
+ *  @return void.
+ */
+inline void set_enabled(bool on) { registry::instance().set_enabled(on); }
+
+/**
+ *  @brief  All retained events from every thread.
+ *  @return the events, per thread in recording order.
+ */
+inline std::vector<event> collect() { return registry::instance().collect(); }
+
+/**
+ *  @brief  Drop all retained events.
+ *  @return void.
+ */
+inline void reset() { registry::instance().reset(); }
+
+/**
+ *  @brief  Write the retained events as Chrome trace-event JSON.
+ *          Timestamps are fixed-point microseconds with nanosecond digits.
+ *  @param  out  The stream to write to.
+ *  @return void.
+ */
+inline void write_chrome_trace(std::ostream& out) {
+    registry& r = registry::instance();
+    const std::vector<event> events = r.collect();
+    const double ticks_per_us = r.ticks_per_us();
+    const std::uint64_t tick0 = r.tick0();
+
+    const std::ios_base::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"traceEvents\":[";
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const event& e = events[i];
+        const double ts = static_cast<double>(e.start - tick0) / ticks_per_us;
+        const double dur = static_cast<double>(e.duration) / ticks_per_us;
+        out << (i ? ",\n" : "\n")
+            << "{\"name\":\"" << e.name << "\",\"cat\":\"std2\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+            << ",\"ts\":" << ts << ",\"dur\":" << dur << ",\"args\":{\"n\":" << e.arg << "}}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+/**
+ *  @brief  Write the retained events as Chrome trace-event JSON to a file.
+ *  @param  path  The output file.
+ *  @return void.
+ *  @throws std::runtime_error if the file cannot be written.
+ */
+inline void write_chrome_trace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) throw std::runtime_error("std2::trace: cannot open " + path);
+    write_chrome_trace(file);
+    if (!file) throw std::runtime_error("std2::trace: failed writing " + path);
+}
+
+} // namespace trace
+} // namespace std2
+
+#define STD2_TRACE_CONCAT_INNER(a, b) a##b
+#define STD2_TRACE_CONCAT(a, b) STD2_TRACE_CONCAT_INNER(a, b)
+
+// Trace the enclosing scope under name, with one numeric argument
+#define STD2_TRACE_SCOPE(name, arg) \
+    ::std2::trace::scoped_event STD2_TRACE_CONCAT(std2_trace_scope_, __LINE__)((name), static_cast<std::uint64_t>(arg))
+
+// Trace the enclosing scope only when cond holds
+#define STD2_TRACE_SCOPE_IF(cond, name, arg) \
+    ::std2::trace::scoped_event STD2_TRACE_CONCAT(std2_trace_scope_, __LINE__)((cond) ? (name) : nullptr, static_cast<std::uint64_t>(arg))
+
+#else
+
+namespace std2 {
+namespace trace {
+inline constexpr bool enabled = false;
+} // namespace trace
+} // namespace std2
+
+#define STD2_TRACE_SCOPE(name, arg) ((void)0)
+#define STD2_TRACE_SCOPE_IF(cond, name, arg) ((void)0)
+
+#endif // STD2_ENABLE_TRACING
+
+#endif // STD2_TRACE_HPP
@@ -0,0 +1,397 @@
+#ifndef STD2_TRIM_HPP
+#define STD2_TRIM_HPP
+
+#include <atomic>      // for std::atomic
+#include <cerrno>      // for errno
+#include <charconv>    // for std::from_chars
+#include <chrono>      // for std::chrono::microseconds, std::chrono::milliseconds
+#include <concepts>    // for std::convertible_to, std::constructible_from
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint64_t
+#include <filesystem>  // for std::filesystem::path, std::filesystem::exists
+#include <fstream>     // for std::ifstream
+#include <mutex>       // for std::mutex, std::lock_guard
+#include <optional>    // for std::optional
+#include <string>      // for std::string, std::getline
+#include <system_error> // for std::system_error
+#include <vector>      // for std::vector
+
+#if defined(__linux__)
+#include <fcntl.h>     // for open, O_RDWR, O_NONBLOCK
+#include <poll.h>      // for poll, POLLPRI
+#include <unistd.h>    // for write, close
+#endif
+
+#include "std2.hpp" // for std2::move, std2::forward
+
+namespace std2 {
+
+/*
+ * Memory pressure trimming. Containers opt in by being wrapped in
+ * trim::tracked<C>, which enrolls them in a process wide registry; when the
+ * kernel reports memory pressure, trim::reclaim() walks the registry and
+ * calls shrink_to_fit() on each one, returning the bytes given back.
+ *
+ * Pressure is read from PSI (/proc/pressure/memory, the share of time tasks
+ * stalled waiting for memory) and from the cgroup limit: memory.current
+ * against memory.high on cgroup v2, usage_in_bytes against limit_in_bytes
+ * on v1. Either signal crossing its threshold counts as pressure.
+ */
+namespace trim {
+
+/*
+ * Where pressure counts as high. PSI avg10 is a percentage of wall time over
+ * the last ten seconds, the cgroup ratio is usage divided by the limit.
+ */
+struct thresholds {
+    double psi_some_avg10 = 10.0;
+    double cgroup_usage_ratio = 0.9;
+};
+
+/**
+ *  @brief  Find the memory cgroup directory of this process.
+ *  @param  proc_cgroup  The /proc/<pid>/cgroup file to read.
+ *  @param  root  Where the cgroup file systems are mounted.
+ *  @return the directory holding the memory controller files, empty if none was found.
+ */
+inline std::string detect_cgroup_dir(const std::string& proc_cgroup = "/proc/self/cgroup",
+                                     const std::string& root = "/sys/fs/cgroup") {
+    namespace fs = std::filesystem;
+    std::ifstream in(proc_cgroup);
+    std::string line;
+    std::optional<std::string> unified;
+    std::optional<std::string> memory;
+
+    // every line is hierarchy-id:controller-list:path, v2 has id 0 and no controllers
+    while (std::getline(in, line)) {
+        const std::size_t first = line.find(':');
+        const std::size_t second = first == std::string::npos ? first : line.find(':', first + 1);
+        if (second == std::string::npos) continue;
+
+        const std::string id = line.substr(0, first);
+        const std::string controllers = "," + line.substr(first + 1, second - first - 1) + ",";
+        const std::string path = line.substr(second + 1);
+        if (id == "0" && controllers == ",,") unified = path;
+        else if (controllers.find(",memory,") != std::string::npos) memory = path;
+    }
+
+    if (unified) {
+        const fs::path dir = fs::path(root) / fs::path(*unified).relative_path();
+        if (fs::exists(dir / "memory.current")) return dir.string();
+    }
+    if (memory) {
+        const fs::path dir = fs::path(root) / "memory" / fs::path(*memory).relative_path();
+        if (fs::exists(dir / "memory.usage_in_bytes")) return dir.string();
+    }
+
+    // inside a cgroup namespace our own group is mounted at the root
+    if (fs::exists(fs::path(root) / "memory.current")) return root;
+    if (fs::exists(fs::path(root) / "memory" / "memory.usage_in_bytes")) return (fs::path(root) / "memory").string();
+    return {};
+}
+
+/*
+ * Files the pressure readings come from, overridable for tests and for
+ * processes that want to watch a cgroup other than their own.
+ */
+struct sources {
+    std::string psi_path = "/proc/pressure/memory";
+    std::string cgroup_dir = detect_cgroup_dir();
+};
+
+/* @brief  Read the first line of a file as an unsigned number, nullopt for "max" or garbage. */
+inline std::optional<std::uint64_t> read_counter(const std::filesystem::path& file) {
+    std::ifstream in(file);
+    std::string text;
+    if (!(in >> text)) return std::nullopt;
+
+    std::uint64_t value = 0;
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || end != text.data() + text.size()) return std::nullopt;
+    return value;
+}
+
+/**
+ *  @brief  Read the "some avg10" figure from a PSI file.
+ *  @param  path  The pressure file, normally /proc/pressure/memory.
+ *  @return the percentage of time some task stalled on memory, nullopt if unavailable.
+ */
+inline std::optional<double> read_psi_some_avg10(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("some ", 0) != 0) continue;
+        const std::size_t at = line.find("avg10=");
+        if (at == std::string::npos) return std::nullopt;
+
+        const char* first = line.data() + at + 6;
+        double value = 0.0;
+        if (std::from_chars(first, line.data() + line.size(), value).ec != std::errc()) return std::nullopt;
+        return value;
+    }
+    return std::nullopt;
+}
+
+/**
+ *  @brief  Read how close the cgroup is to its memory limit.
+ *  @param  dir  The cgroup directory, see detect_cgroup_dir.
+ *  @return usage divided by memory.high (v2) or limit_in_bytes (v1), nullopt if there is no limit.
+ */
+inline std::optional<double> read_cgroup_usage_ratio(const std::string& dir) {
+    if (dir.empty()) return std::nullopt;
+    const std::filesystem::path base(dir);
+
+    std::optional<std::uint64_t> usage = read_counter(base / "memory.current");
+    std::optional<std::uint64_t> limit;
+    if (usage) {
+        limit = read_counter(base / "memory.high"); // "max" reads as no limit
+    } else {
+        usage = read_counter(base / "memory.usage_in_bytes");
+        limit = read_counter(base / "memory.limit_in_bytes");
+        // v1 reports an unlimited group as a page rounded LONG_MAX
+        if (limit && *limit >= (std::uint64_t(1) << 62)) limit.reset();
+    }
+
+    if (!usage || !limit || *limit == 0) return std::nullopt;
+    return static_cast<double>(*usage) / static_cast<double>(*limit);
+}
+
+/*
+ * One sample of both pressure signals; a missing signal never counts as pressure.
+ */
+struct reading {
+    std::optional<double> psi_some_avg10;
+    std::optional<double> cgroup_usage_ratio;
+
+    bool exceeds(const thresholds& limits) const {
+        return (psi_some_avg10 && *psi_some_avg10 >= limits.psi_some_avg10) ||
+               (cgroup_usage_ratio && *cgroup_usage_ratio >= limits.cgroup_usage_ratio);
+    }
+};
+
+/**
+ *  @brief  Sample the pressure signals.
+ *  @param  from  The files to read.
+ *  @return the current reading.
+ */
+inline reading read_pressure(const sources& from = sources()) {
+    return reading{read_psi_some_avg10(from.psi_path), read_cgroup_usage_ratio(from.cgroup_dir)};
+}
+
+/*
+ * Process wide list of containers that agreed to be trimmed. Entries are
+ * type erased to a pointer and a function that shrinks it and returns the
+ * bytes released.
+ *
+ * reclaim() holds the registry lock, so a tracked container cannot be
+ * destroyed under it, but the containers themselves are not locked: call it
+ * where the enrolled containers are quiescent (an idle hook, or the owning
+ * thread's event loop), or trimming races with their users.
+ */
+class registry {
+public:
+    using trim_fn = std::size_t (*)(void*);
+
+    static registry& instance() {
+        static registry r;
+        return r;
+    }
+
+    /**
+     *  @brief  Add a container to the registry.
+     *  @param  object  The container.
+     *  @param  trim  Releases the container's spare capacity and returns the bytes freed.
+     *  @return a ticket for withdraw.
+     */
+    std::uint64_t enroll(void* object, trim_fn trim) {
+        std::lock_guard<std::mutex> guard(m_lock);
+        const std::uint64_t ticket = ++m_next_ticket;
+        m_entries.push_back(entry{ticket, object, trim});
+        return ticket;
+    }
+
+    /**
+     *  @brief  Remove a container from the registry.
+     *  @param  ticket  The value enroll returned.
+     *  @return void.
+     */
+    void withdraw(std::uint64_t ticket) {
+        std::lock_guard<std::mutex> guard(m_lock);
+        for (std::size_t i = 0; i < m_entries.size(); ++i) {
+            if (m_entries[i].ticket == ticket) {
+                m_entries[i] = m_entries.back(); // order does not matter, swap and pop
+                m_entries.pop_back();
+                return;
+            }
+        }
+    }
+
+    /**
+     *  @brief  Release the spare capacity of every enrolled container.
+     *  @return the number of bytes released.
+     */
+    std::size_t reclaim() {
+        std::lock_guard<std::mutex> guard(m_lock);
+        std::size_t released = 0;
+        for (const entry& e : m_entries) released += e.trim(e.object);
+        m_reclaimed.fetch_add(released, std::memory_order_relaxed);
+        return released;
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return m_entries.size();
+    }
+
+    /**
+     *  @brief  Bytes released by every reclaim so far.
+     *  @return the running total.
+     */
+    std::uint64_t reclaimed_total() const { return m_reclaimed.load(std::memory_order_relaxed); }
+
+private:
+    struct entry {
+        std::uint64_t ticket;
+        void* object;
+        trim_fn trim;
+    };
+
+    registry() = default;
+
+    mutable std::mutex m_lock;
+    std::vector<entry> m_entries;
+    std::uint64_t m_next_ticket = 0;
+    std::atomic<std::uint64_t> m_reclaimed{0};
+};
+
+template <typename Container>
+concept trimmable = requires(Container& c) {
+    { c.shrink_to_fit() } -> std::convertible_to<std::size_t>;
+};
+
+/*
+ * Owns a container and keeps it enrolled in the registry for its lifetime.
+ * Copies and moves enroll the new object under its own address.
+ */
+template <trimmable Container>
+class tracked {
+public:
+    template <typename... Args>
+        requires std::constructible_from<Container, Args...>
+    explicit tracked(Args&&... args) : m_container(std2::forward<Args>(args)...) { enroll(); }
+
+    tracked(const tracked& other) : m_container(other.m_container) { enroll(); }
+
+    tracked(tracked&& other) : m_container(std2::move(other.m_container)) { enroll(); }
+
+    tracked& operator=(const tracked& other) {
+        m_container = other.m_container;
+        return *this;
+    }
+
+    tracked& operator=(tracked&& other) {
+        m_container = std2::move(other.m_container);
+        return *this;
+    }
+
+    ~tracked() { registry::instance().withdraw(m_ticket); }
+
+    Container& get() { return m_container; }
+    const Container& get() const { return m_container; }
+
+    Container& operator*() { return m_container; }
+    const Container& operator*() const { return m_container; }
+
+    Container* operator->() { return &m_container; }
+    const Container* operator->() const { return &m_container; }
+
+private:
+    void enroll() {
+        m_ticket = registry::instance().enroll(&m_container, [](void* object) -> std::size_t {
+            return static_cast<Container*>(object)->shrink_to_fit();
+        });
+    }
+
+    Container m_container;
+    std::uint64_t m_ticket = 0;
+};
+
+/**
+ *  @brief  Trim every enrolled container now.
+ *  @return the number of bytes released.
+ */
+inline std::size_t reclaim() { return registry::instance().reclaim(); }
+
+/**
+ *  @brief  Trim every enrolled container if either pressure signal crossed its threshold.
+ *  @param  limits  Where pressure counts as high.
+ *  @param  from  The files to read.
+ *  @return the number of bytes released, 0 when there was no pressure.
+ */
+inline std::size_t reclaim_if_pressured(const thresholds& limits = thresholds(), const sources& from = sources()) {
+    return read_pressure(from).exceeds(limits) ? reclaim() : 0;
+}
+
+#if defined(__linux__)
+
+/*
+ * Kernel side PSI trigger: wait() wakes when tasks stalled on memory for at
+ * least stall out of every window, instead of polling the averages. Writing
+ * triggers needs a kernel with PSI enabled and, for windows under two
+ * seconds on recent kernels, CAP_SYS_RESOURCE.
+ */
+class psi_trigger {
+public:
+    /**
+     *  @brief  Register a trigger with the kernel.
+     *  @param  stall  Stall time within the window that fires the trigger.
+     *  @param  window  The tracking window, 500ms to 10s.
+     *  @param  path  The pressure file.
+     *  @throws std::system_error if the file cannot be opened or the kernel rejects the trigger.
+     */
+    psi_trigger(std::chrono::microseconds stall, std::chrono::microseconds window,
+                const std::string& path = "/proc/pressure/memory") {
+        m_fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK);
+        if (m_fd < 0) throw std::system_error(errno, std::generic_category(), "std2::trim::psi_trigger: open " + path);
+
+        const std::string spec = "some " + std::to_string(stall.count()) + " " + std::to_string(window.count());
+        if (::write(m_fd, spec.c_str(), spec.size() + 1) < 0) {
+            const int error = errno;
+            ::close(m_fd);
+            throw std::system_error(error, std::generic_category(), "std2::trim::psi_trigger: write " + path);
+        }
+    }
+
+    psi_trigger(const psi_trigger&) = delete;
+    psi_trigger& operator=(const psi_trigger&) = delete;
+
+    ~psi_trigger() { ::close(m_fd); }
+
+    /**
+     *  @brief  Block until the trigger fires or the timeout passes.
+     *  @param  timeout  How long to wait, negative waits forever.
+     *  @return true if the trigger fired.
+     *  @throws std::system_error if poll fails or the pressure file goes away.
+     */
+    bool wait(std::chrono::milliseconds timeout) {
+        pollfd fds{m_fd, POLLPRI, 0};
+        int ready;
+        do {
+            ready = ::poll(&fds, 1, static_cast<int>(timeout.count()));
+        } while (ready < 0 && errno == EINTR);
+
+        if (ready < 0) throw std::system_error(errno, std::generic_category(), "std2::trim::psi_trigger::wait");
+        if (fds.revents & POLLERR) throw std::system_error(ENODEV, std::generic_category(), "std2::trim::psi_trigger::wait");
+        return ready > 0 && (fds.revents & POLLPRI);
+    }
+
+private:
+    int m_fd = -1;
+};
+
+#endif // __linux__
+
+} // namespace trim
+} // namespace std2
+
+#endif // STD2_TRIM_HPP
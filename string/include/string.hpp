@@ -0,0 +1,691 @@
+#ifndef STRING_HPP
+#define STRING_HPP
+
+#include "../../std2/std2.hpp" // for std2::move, std2::is_trivially_relocatable
+#include <bit>         // for std::endian, std::countr_zero
+#include <compare>     // for std::strong_ordering
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint32_t, std::uint64_t
+#include <cstring>     // for std::memcpy, std::memchr, std::memcmp
+#include <functional>  // for std::hash
+#include <memory>      // for std::allocator
+#include <ostream>     // for std::ostream
+#include <stdexcept>   // for std::out_of_range, std::length_error
+#include <string_view> // for std::string_view
+#include <type_traits> // for std::is_empty_v
+#include <utility>     // for std::swap
+
+#if defined(__SSE2__)
+#include <emmintrin.h> // for the SSE2 byte compares
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h> // for the AVX2 byte compares
+#endif
+
+namespace std2 {
+
+/*
+ * Byte search and comparison helpers. SSE2 is part of the x86-64 baseline, so
+ * it is used unconditionally there; the AVX2 path is only compiled in when the
+ * build targets it (-mavx2 / -march). Everything falls back to the C library.
+ */
+namespace string_detail {
+
+    // long scans go to memchr, which the C library dispatches to the widest vector unit at run time
+    inline constexpr std::size_t INLINE_SCAN_LIMIT = 128;
+
+    inline const char* find_char(const char* first, std::size_t n, char ch) noexcept {
+#if defined(__SSE2__)
+        if (n >= 16 && n <= INLINE_SCAN_LIMIT) {
+            std::size_t i = 0;
+#if defined(__AVX2__)
+            const __m256i wide = _mm256_set1_epi8(ch);
+            for (; i + 32 <= n; i += 32) {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+                const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, wide)));
+                if (mask) return first + i + std::countr_zero(mask);
+            }
+#endif
+            const __m128i needle = _mm_set1_epi8(ch);
+            for (; i + 16 <= n; i += 16) {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+                const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+                if (mask) return first + i + std::countr_zero(mask);
+            }
+            if (i == n) return nullptr;
+            // the last block overlaps bytes already checked, so only the high bits are new
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + n - 16));
+            const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle))) >> (i + 16 - n);
+            return mask ? first + i + std::countr_zero(mask) : nullptr;
+        }
+#endif
+        if (n < 16) {
+            for (std::size_t i = 0; i < n; ++i) {
+                if (first[i] == ch) return first + i;
+            }
+            return nullptr;
+        }
+        return static_cast<const char*>(std::memchr(first, static_cast<unsigned char>(ch), n));
+    }
+
+    /*
+     * Substring search: compare the needle's first and last characters against
+     * sixteen candidate positions at once and only memcmp the middle of the
+     * positions where both match.
+     */
+    inline const char* find_substring(const char* first, std::size_t n, const char* needle, std::size_t m) noexcept {
+        if (m == 0) return first;
+        if (m > n) return nullptr;
+        if (m == 1) return find_char(first, n, needle[0]);
+
+        const std::size_t starts = n - m + 1; // candidate positions
+        std::size_t i = 0;
+#if defined(__SSE2__)
+        const __m128i head = _mm_set1_epi8(needle[0]);
+        const __m128i tail = _mm_set1_epi8(needle[m - 1]);
+        for (; i + 16 <= starts; i += 16) {
+            const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+            const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i + m - 1));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(block_first, head), _mm_cmpeq_epi8(block_last, tail))));
+            while (mask) {
+                const std::size_t at = i + std::countr_zero(mask);
+                if (std::memcmp(first + at + 1, needle + 1, m - 2) == 0) return first + at;
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; i < starts; ++i) {
+            if (first[i] == needle[0] && first[i + m - 1] == needle[m - 1] &&
+                std::memcmp(first + i + 1, needle + 1, m - 2) == 0) return first + i;
+        }
+        return nullptr;
+    }
+
+    /*
+     * Equality of two byte ranges of the same length. Short lengths use two
+     * overlapping word loads instead of a loop, long ones sixteen bytes a step.
+     */
+    inline bool equal_bytes(const char* a, const char* b, std::size_t n) noexcept {
+        if (n >= 16) {
+#if defined(__SSE2__)
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+                const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF) return false;
+            }
+            if (i == n) return true;
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + n - 16));
+            const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n - 16));
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) == 0xFFFF;
+#else
+            return std::memcmp(a, b, n) == 0;
+#endif
+        }
+        if (n >= 8) {
+            std::uint64_t a0, a1, b0, b1;
+            std::memcpy(&a0, a, 8);
+            std::memcpy(&b0, b, 8);
+            std::memcpy(&a1, a + n - 8, 8);
+            std::memcpy(&b1, b + n - 8, 8);
+            return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+        }
+        if (n >= 4) {
+            std::uint32_t a0, a1, b0, b1;
+            std::memcpy(&a0, a, 4);
+            std::memcpy(&b0, b, 4);
+            std::memcpy(&a1, a + n - 4, 4);
+            std::memcpy(&b1, b + n - 4, 4);
+            return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            if (a[i] != b[i]) return false;
+        }
+        return true;
+    }
+
+    // lexicographic order of two byte ranges, compared as unsigned char like std::char_traits<char>
+    inline std::strong_ordering compare_bytes(const char* a, std::size_t n, const char* b, std::size_t m) noexcept {
+        const std::size_t common = n < m ? n : m;
+        std::size_t i = 0;
+#if defined(__SSE2__)
+        for (; i + 16 <= common; i += 16) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            const unsigned differ = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) & 0xFFFF;
+            if (differ) {
+                const std::size_t at = i + std::countr_zero(differ);
+                return static_cast<unsigned char>(a[at]) <=> static_cast<unsigned char>(b[at]);
+            }
+        }
+#endif
+        for (; i < common; ++i) {
+            if (a[i] != b[i]) return static_cast<unsigned char>(a[i]) <=> static_cast<unsigned char>(b[i]);
+        }
+        return n <=> m;
+    }
+
+} // namespace string_detail
+
+/*
+ * A char string with a small-string buffer filling the whole 24-byte object.
+ *
+ * Long strings keep { pointer, size, capacity } on the heap. Short strings keep
+ * up to 23 characters inline; the last byte of the object holds 23 - size,
+ * which is zero - the terminator - exactly when the buffer is full. In long
+ * mode the high bit of that byte is set (it is the top byte of the capacity
+ * word), which no short size can produce, so one load tells the modes apart.
+ *
+ * The allocator is used like std2::vector uses its own: allocate(n) and
+ * deallocate(p, n) on a value_type of char. A stateless allocator takes no
+ * space. No pointer ever points into the object itself, so a string can be
+ * moved by copying its bytes and std2::vector relocates strings with memcpy.
+ */
+template <typename Allocator = std::allocator<char>>
+class basic_string {
+public:
+    using value_type = char;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using reference = char&;
+    using const_reference = const char&;
+    using iterator = char*;
+    using const_iterator = const char*;
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    static constexpr std::size_t SSO_CAPACITY = 23;
+
+    basic_string() noexcept : m_alloc(Allocator()) {
+        set_short_size(0);
+    }
+
+    explicit basic_string(const Allocator& alloc) noexcept : m_alloc(alloc) {
+        set_short_size(0);
+    }
+
+    basic_string(const char* s, const Allocator& alloc = Allocator()) : m_alloc(alloc) {
+        init(s, std::strlen(s));
+    }
+
+    basic_string(const char* s, std::size_t count, const Allocator& alloc = Allocator()) : m_alloc(alloc) {
+        init(s, count);
+    }
+
+    explicit basic_string(std::string_view sv, const Allocator& alloc = Allocator()) : m_alloc(alloc) {
+        init(sv.data(), sv.size());
+    }
+
+    basic_string(std::size_t count, char ch, const Allocator& alloc = Allocator()) : m_alloc(alloc) {
+        init(nullptr, 0);
+        resize(count, ch);
+    }
+
+    basic_string(const basic_string& other) : m_alloc(other.m_alloc) {
+        init(other.data(), other.size());
+    }
+
+    // takes the representation as is and leaves other empty
+    basic_string(basic_string&& other) noexcept : m_rep(other.m_rep), m_alloc(std2::move(other.m_alloc)) {
+        other.set_short_size(0);
+    }
+
+    basic_string& operator=(basic_string other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~basic_string() {
+        release();
+    }
+
+    void swap(basic_string& other) noexcept {
+        std::swap(m_rep, other.m_rep);
+        std::swap(m_alloc, other.m_alloc);
+    }
+
+    allocator_type get_allocator() const {
+        return m_alloc;
+    }
+
+    /**
+     *  @brief  Get the number of characters, not counting the terminator.
+     *  @return the length of the string.
+     */
+    std::size_t size() const noexcept {
+        return is_long() ? m_rep.l.size : SSO_CAPACITY - tag();
+    }
+
+    std::size_t length() const noexcept {
+        return size();
+    }
+
+    /**
+     *  @brief  Get the number of characters that fit before a reallocation.
+     *  @return the capacity, at least SSO_CAPACITY.
+     */
+    std::size_t capacity() const noexcept {
+        return is_long() ? decode_capacity(m_rep.l.cap) : SSO_CAPACITY;
+    }
+
+    static constexpr std::size_t max_size() noexcept {
+        return CAPACITY_MASK - 1;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    /**
+     *  @brief  Whether the characters live inside the object.
+     *  @return true while the string has never outgrown the small buffer.
+     */
+    bool is_small() const noexcept {
+        return !is_long();
+    }
+
+    char* data() noexcept {
+        return is_long() ? m_rep.l.ptr : m_rep.s;
+    }
+
+    const char* data() const noexcept {
+        return is_long() ? m_rep.l.ptr : m_rep.s;
+    }
+
+    const char* c_str() const noexcept {
+        return data();
+    }
+
+    operator std::string_view() const noexcept {
+        return std::string_view(data(), size());
+    }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + size(); }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + size(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    char& operator[](std::size_t index) noexcept { return data()[index]; }
+    const char& operator[](std::size_t index) const noexcept { return data()[index]; }
+
+    /**
+     *  @brief  Bounds checked access to a character.
+     *  @param  index  The index of the character to access.
+     *  @return reference to the character.
+     *  @throws std::out_of_range if index >= size().
+     */
+    char& at(std::size_t index) {
+        if (index >= size()) throw std::out_of_range("std2::string::at");
+        return data()[index];
+    }
+
+    const char& at(std::size_t index) const {
+        if (index >= size()) throw std::out_of_range("std2::string::at");
+        return data()[index];
+    }
+
+    char& front() noexcept { return data()[0]; }
+    const char& front() const noexcept { return data()[0]; }
+    char& back() noexcept { return data()[size() - 1]; }
+    const char& back() const noexcept { return data()[size() - 1]; }
+
+    /**
+     *  @brief  Make room for at least new_capacity characters.
+     *  @param  new_capacity The number of characters to make room for.
+     *  @return void.
+     *  @throws std::length_error if new_capacity exceeds max_size().
+     */
+    void reserve(std::size_t new_capacity) {
+        if (new_capacity > max_size()) throw std::length_error("std2::string::reserve");
+        if (new_capacity > capacity()) reallocate(new_capacity);
+    }
+
+    /**
+     *  @brief  Release unused capacity, moving back into the small buffer if the string fits.
+     *  @return the number of bytes released.
+     */
+    std::size_t shrink_to_fit() {
+        if (!is_long()) return 0;
+        const std::size_t n = m_rep.l.size;
+        const std::size_t old_capacity = decode_capacity(m_rep.l.cap);
+        if (n <= SSO_CAPACITY) {
+            char* block = m_rep.l.ptr;
+            std::memcpy(m_rep.s, block, n);
+            set_short_size(n);
+            m_alloc.deallocate(block, old_capacity + 1);
+            return old_capacity + 1;
+        }
+        if (old_capacity == n) return 0;
+        char* block = m_alloc.allocate(n + 1);
+        std::memcpy(block, m_rep.l.ptr, n + 1);
+        m_alloc.deallocate(m_rep.l.ptr, old_capacity + 1);
+        set_long(block, n, n);
+        return old_capacity - n;
+    }
+
+    /**
+     *  @brief  Remove all characters, keeping the capacity.
+     *  @return void.
+     */
+    void clear() noexcept {
+        set_size(0);
+    }
+
+    void push_back(char ch) {
+        const std::size_t n = size();
+        if (n == capacity()) reallocate(grown_capacity(n + 1));
+        data()[n] = ch;
+        set_size(n + 1);
+    }
+
+    void pop_back() noexcept {
+        if (const std::size_t n = size()) set_size(n - 1);
+    }
+
+    /**
+     *  @brief  Append count characters from s, which may point into this string.
+     *  @param  s  The characters to append.
+     *  @param  count  The number of characters.
+     *  @return reference to this string.
+     *  @throws std::length_error if the result would exceed max_size().
+     */
+    basic_string& append(const char* s, std::size_t count) {
+        const std::size_t n = size();
+        if (count > max_size() - n) throw std::length_error("std2::string::append");
+        if (count > capacity() - n) {
+            // the old block outlives the copy, so s may point into it
+            const std::size_t new_capacity = grown_capacity(n + count);
+            char* block = m_alloc.allocate(new_capacity + 1);
+            std::memcpy(block, data(), n);
+            std::memcpy(block + n, s, count);
+            release();
+            set_long(block, n, new_capacity);
+        } else {
+            std::memmove(data() + n, s, count);
+        }
+        set_size(n + count);
+        return *this;
+    }
+
+    basic_string& append(std::string_view sv) {
+        return append(sv.data(), sv.size());
+    }
+
+    basic_string& append(std::size_t count, char ch) {
+        resize(size() + count, ch);
+        return *this;
+    }
+
+    basic_string& operator+=(std::string_view sv) {
+        return append(sv.data(), sv.size());
+    }
+
+    basic_string& operator+=(const char* s) {
+        return append(s, std::strlen(s));
+    }
+
+    basic_string& operator+=(char ch) {
+        push_back(ch);
+        return *this;
+    }
+
+    /**
+     *  @brief  Set the size, filling new characters with ch.
+     *  @param  new_size The new size of the string.
+     *  @param  ch The character to fill new positions with.
+     *  @return void.
+     */
+    void resize(std::size_t new_size, char ch = char()) {
+        const std::size_t n = size();
+        if (new_size > n) {
+            reserve(new_size);
+            std::memset(data() + n, static_cast<unsigned char>(ch), new_size - n);
+        }
+        set_size(new_size);
+    }
+
+    /**
+     *  @brief  Resize without initializing, letting op write the characters.
+     *  op is called as op(data(), count) with room for count characters and
+     *  returns how many of them it wrote; that becomes the new size. Characters
+     *  already in the string are kept in front, as with resize.
+     *  @param  count  The number of characters op may write.
+     *  @param  op  The callable filling the buffer.
+     *  @return void.
+     *  @throws std::length_error if op reports more than count characters.
+     */
+    template <typename Operation>
+    void resize_and_overwrite(std::size_t count, Operation op) {
+        reserve(count);
+        const auto written = static_cast<std::size_t>(std2::move(op)(data(), count));
+        if (written > count) throw std::length_error("std2::string::resize_and_overwrite: op wrote past count");
+        set_size(written);
+    }
+
+    /**
+     *  @brief  Find the first occurrence of ch at or after pos.
+     *  @return the index of the match, or npos.
+     */
+    std::size_t find(char ch, std::size_t pos = 0) const noexcept {
+        const std::size_t n = size();
+        if (pos >= n) return npos;
+        const char* base = data();
+        const char* hit = string_detail::find_char(base + pos, n - pos, ch);
+        return hit ? static_cast<std::size_t>(hit - base) : npos;
+    }
+
+    /**
+     *  @brief  Find the first occurrence of sv at or after pos.
+     *  @return the index of the match, or npos.
+     */
+    std::size_t find(std::string_view sv, std::size_t pos = 0) const noexcept {
+        const std::size_t n = size();
+        if (pos > n) return npos;
+        const char* base = data();
+        const char* hit = string_detail::find_substring(base + pos, n - pos, sv.data(), sv.size());
+        return hit ? static_cast<std::size_t>(hit - base) : npos;
+    }
+
+    std::size_t find(const char* s, std::size_t pos = 0) const noexcept {
+        return find(std::string_view(s), pos);
+    }
+
+    bool contains(char ch) const noexcept { return find(ch) != npos; }
+    bool contains(std::string_view sv) const noexcept { return find(sv) != npos; }
+
+    bool starts_with(std::string_view sv) const noexcept {
+        return size() >= sv.size() && string_detail::equal_bytes(data(), sv.data(), sv.size());
+    }
+
+    bool ends_with(std::string_view sv) const noexcept {
+        const std::size_t n = size();
+        return n >= sv.size() && string_detail::equal_bytes(data() + n - sv.size(), sv.data(), sv.size());
+    }
+
+    /**
+     *  @brief  Copy out a part of the string.
+     *  @param  pos  The index of the first character.
+     *  @param  count  The maximum number of characters.
+     *  @return the substring, using a copy of this string's allocator.
+     *  @throws std::out_of_range if pos > size().
+     */
+    basic_string substr(std::size_t pos = 0, std::size_t count = npos) const {
+        const std::size_t n = size();
+        if (pos > n) throw std::out_of_range("std2::string::substr");
+        return basic_string(data() + pos, count < n - pos ? count : n - pos, m_alloc);
+    }
+
+    int compare(std::string_view sv) const noexcept {
+        const auto order = string_detail::compare_bytes(data(), size(), sv.data(), sv.size());
+        return order < 0 ? -1 : (order > 0 ? 1 : 0);
+    }
+
+    friend bool operator==(const basic_string& a, const basic_string& b) noexcept {
+        const std::size_t n = a.size();
+        return n == b.size() && string_detail::equal_bytes(a.data(), b.data(), n);
+    }
+
+    friend bool operator==(const basic_string& a, std::string_view b) noexcept {
+        const std::size_t n = a.size();
+        return n == b.size() && string_detail::equal_bytes(a.data(), b.data(), n);
+    }
+
+    friend bool operator==(const basic_string& a, const char* b) noexcept {
+        return a == std::string_view(b);
+    }
+
+    friend std::strong_ordering operator<=>(const basic_string& a, const basic_string& b) noexcept {
+        return string_detail::compare_bytes(a.data(), a.size(), b.data(), b.size());
+    }
+
+    friend std::strong_ordering operator<=>(const basic_string& a, std::string_view b) noexcept {
+        return string_detail::compare_bytes(a.data(), a.size(), b.data(), b.size());
+    }
+
+    friend std::strong_ordering operator<=>(const basic_string& a, const char* b) noexcept {
+        return a <=> std::string_view(b);
+    }
+
+    friend basic_string operator+(basic_string lhs, std::string_view rhs) {
+        lhs.append(rhs.data(), rhs.size());
+        return lhs;
+    }
+
+    friend basic_string operator+(basic_string lhs, char rhs) {
+        lhs.push_back(rhs);
+        return lhs;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const basic_string& s) {
+        return os << std::string_view(s);
+    }
+
+private:
+    // capacity word layout: the top byte of the object carries LONG_FLAG in long mode
+    static constexpr std::size_t TAG_INDEX = SSO_CAPACITY;
+    static constexpr unsigned char LONG_FLAG = 0x80;
+    static constexpr std::size_t CAPACITY_MASK = (std::size_t(1) << (8 * (sizeof(std::size_t) - 1))) - 1;
+
+    static constexpr std::size_t encode_capacity(std::size_t capacity) noexcept {
+        if constexpr (std::endian::native == std::endian::little) {
+            return capacity | (std::size_t(LONG_FLAG) << (8 * (sizeof(std::size_t) - 1)));
+        } else {
+            return (capacity << 8) | LONG_FLAG;
+        }
+    }
+
+    static constexpr std::size_t decode_capacity(std::size_t word) noexcept {
+        if constexpr (std::endian::native == std::endian::little) {
+            return word & CAPACITY_MASK;
+        } else {
+            return word >> 8;
+        }
+    }
+
+    struct long_rep {
+        char* ptr;
+        std::size_t size;
+        std::size_t cap; // encoded, see encode_capacity
+    };
+
+    union rep {
+        long_rep l;
+        char s[SSO_CAPACITY + 1];
+    };
+
+    // the last byte of the representation, read as part of its object representation
+    unsigned char tag() const noexcept {
+        return reinterpret_cast<const unsigned char*>(&m_rep)[TAG_INDEX];
+    }
+
+    bool is_long() const noexcept {
+        return tag() & LONG_FLAG;
+    }
+
+    void set_short_size(std::size_t n) noexcept {
+        m_rep.s[n] = '\0';
+        m_rep.s[TAG_INDEX] = static_cast<char>(SSO_CAPACITY - n); // zero, the terminator, when full
+    }
+
+    void set_long(char* block, std::size_t n, std::size_t capacity) noexcept {
+        m_rep.l.ptr = block;
+        m_rep.l.size = n;
+        m_rep.l.cap = encode_capacity(capacity);
+    }
+
+    // capacity must already hold n characters
+    void set_size(std::size_t n) noexcept {
+        if (is_long()) {
+            m_rep.l.size = n;
+            m_rep.l.ptr[n] = '\0';
+        } else {
+            set_short_size(n);
+        }
+    }
+
+    void init(const char* s, std::size_t n) {
+        if (n <= SSO_CAPACITY) {
+            if (n) std::memcpy(m_rep.s, s, n);
+            set_short_size(n);
+            return;
+        }
+        if (n > max_size()) throw std::length_error("std2::string");
+        char* block = m_alloc.allocate(n + 1);
+        std::memcpy(block, s, n);
+        block[n] = '\0';
+        set_long(block, n, n);
+    }
+
+    // grow geometrically so repeated appends stay amortized O(1)
+    std::size_t grown_capacity(std::size_t needed) const noexcept {
+        const std::size_t doubled = 2 * capacity();
+        return needed > doubled ? needed : (doubled > max_size() ? max_size() : doubled);
+    }
+
+    // move the characters into a heap block of new_capacity (> SSO_CAPACITY)
+    void reallocate(std::size_t new_capacity) {
+        const std::size_t n = size();
+        char* block = m_alloc.allocate(new_capacity + 1);
+        std::memcpy(block, data(), n + 1);
+        release();
+        set_long(block, n, new_capacity);
+    }
+
+    void release() noexcept {
+        if (is_long()) m_alloc.deallocate(m_rep.l.ptr, decode_capacity(m_rep.l.cap) + 1);
+    }
+
+    rep m_rep;
+    [[no_unique_address]] Allocator m_alloc;
+};
+
+using string = basic_string<>;
+
+static_assert(sizeof(std::size_t) == 8, "std2::string assumes a 64-bit size_t");
+static_assert(sizeof(string) == 24, "std2::string must stay three words");
+
+// no pointer refers into the object, so only the allocator can stop a byte copy
+template <typename Allocator>
+struct is_trivially_relocatable<basic_string<Allocator>>
+    : std::bool_constant<std::is_empty_v<Allocator> || is_trivially_relocatable_v<Allocator>> {};
+
+} // namespace std2
+
+// hashes like std::string and std::string_view with the same characters
+template <typename Allocator>
+struct std::hash<std2::basic_string<Allocator>> {
+    std::size_t operator()(const std2::basic_string<Allocator>& s) const noexcept {
+        return std::hash<std::string_view>{}(std::string_view(s));
+    }
+};
+
+#if defined(__GLIBCXX__)
+// like std::string's hash, too slow to recompute while walking a bucket, so
+// libstdc++'s unordered containers store it next to each key
+template <typename Allocator>
+struct std::__is_fast_hash<std::hash<std2::basic_string<Allocator>>> : std::false_type {};
+#endif
+
+#endif // STRING_HPP
@@ -0,0 +1,2 @@
+// Currently, there is no implementation needed in the .cpp file for string
+// All methods are implemented in the header file
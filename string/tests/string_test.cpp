@@ -0,0 +1,331 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/string.hpp"
+#include "../../vector/include/vector.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Allocator that counts the bytes it hands out, shared by all copies
+template <typename T>
+class CountingAllocator {
+public:
+    using value_type = T;
+
+    static inline std::size_t live_bytes = 0;
+    static inline std::size_t allocations = 0;
+
+    CountingAllocator() noexcept {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        ++allocations;
+        live_bytes += n * sizeof(T);
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        live_bytes -= n * sizeof(T);
+        ::operator delete(p);
+    }
+};
+
+class StringTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+        CountingAllocator<char>::live_bytes = 0;
+        CountingAllocator<char>::allocations = 0;
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    using counted_string = std2::basic_string<CountingAllocator<char>>;
+};
+
+// Test the layout and the small buffer boundary
+TEST_F(StringTest, SmallBufferBoundary) {
+    static_assert(sizeof(std2::string) == 24);
+    static_assert(sizeof(counted_string) == 24);
+    static_assert(std2::is_trivially_relocatable_v<std2::string>);
+    static_assert(!std2::is_trivially_relocatable_v<std::string>);
+
+    std2::string empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.capacity(), 23);
+    EXPECT_STREQ(empty.c_str(), "");
+
+    const std::string text = "abcdefghijklmnopqrstuvwxyz";
+    for (std::size_t n = 0; n <= text.size(); ++n) {
+        counted_string s(text.data(), n);
+        EXPECT_EQ(s.size(), n);
+        EXPECT_EQ(std::string_view(s), text.substr(0, n));
+        EXPECT_EQ(s.c_str()[n], '\0');
+        EXPECT_EQ(s.is_small(), n <= 23);
+    }
+    EXPECT_EQ(CountingAllocator<char>::allocations, 3); // only 24, 25 and 26 characters allocate
+    EXPECT_EQ(CountingAllocator<char>::live_bytes, 0);
+
+    // growing across the boundary one character at a time keeps the terminator
+    std2::string grown;
+    for (int i = 0; i < 40; ++i) {
+        grown.push_back(static_cast<char>('a' + i % 26));
+        ASSERT_EQ(std::strlen(grown.c_str()), grown.size());
+    }
+    while (!grown.empty()) {
+        grown.pop_back();
+        ASSERT_EQ(std::strlen(grown.c_str()), grown.size());
+    }
+}
+
+// Test copies, moves, swaps and allocator bookkeeping
+TEST_F(StringTest, CopyMoveAndAllocator) {
+    {
+        counted_string small("short");
+        counted_string large("a string that is too long for the buffer");
+        EXPECT_EQ(CountingAllocator<char>::live_bytes, large.capacity() + 1);
+
+        counted_string copy = large;
+        EXPECT_EQ(copy, large);
+        EXPECT_NE(copy.data(), large.data());
+
+        counted_string moved = std2::move(large);
+        EXPECT_TRUE(large.empty());
+        EXPECT_TRUE(large.is_small());
+        EXPECT_EQ(moved, copy);
+
+        small = moved;
+        EXPECT_EQ(small, "a string that is too long for the buffer");
+        moved = "tiny";
+        EXPECT_EQ(moved, "tiny");
+
+        small.swap(moved);
+        EXPECT_EQ(small, "tiny");
+        EXPECT_EQ(moved.size(), 40);
+
+        // shrink_to_fit moves a short enough string back into the object
+        moved.resize(10);
+        EXPECT_FALSE(moved.is_small());
+        EXPECT_GT(moved.shrink_to_fit(), 0);
+        EXPECT_TRUE(moved.is_small());
+        EXPECT_EQ(moved, "a string t");
+        EXPECT_EQ(moved.shrink_to_fit(), 0);
+    }
+    EXPECT_EQ(CountingAllocator<char>::live_bytes, 0);
+}
+
+// Test append, including appending the string to itself
+TEST_F(StringTest, Append) {
+    std2::string s("ab");
+    s += "cd";
+    s += 'e';
+    s.append(3, 'f');
+    EXPECT_EQ(s, "abcdefff");
+
+    std::string reference = "abcdefff";
+    for (int i = 0; i < 5; ++i) {
+        s.append(s.data(), s.size()); // aliases the buffer that is being replaced
+        reference += reference;
+        ASSERT_EQ(std::string_view(s), reference);
+    }
+    s.append(s.data() + 1, 2); // aliases without a reallocation
+    reference.append(reference, 1, 2);
+    EXPECT_EQ(std::string_view(s), reference);
+
+    EXPECT_EQ(std2::string("key") + "_" + std::string_view("suffix") + '!', "key_suffix!");
+
+    s.clear();
+    EXPECT_TRUE(s.empty());
+    EXPECT_GT(s.capacity(), 23);
+    EXPECT_THROW(s.at(0), std::out_of_range);
+    EXPECT_THROW(s.substr(1), std::out_of_range);
+}
+
+// Test find, compare and the prefix checks against std::string over many lengths
+TEST_F(StringTest, FindAndCompare) {
+    std::mt19937 rng(5);
+    for (int round = 0; round < 2000; ++round) {
+        const std::size_t n = rng() % 300;
+        std::string text(n, 'a');
+        for (char& c : text) c = static_cast<char>('a' + rng() % 4);
+        const std2::string s(text.data(), text.size());
+
+        const char ch = static_cast<char>('a' + rng() % 5); // 'e' never occurs
+        const std::size_t pos = n ? rng() % (n + 1) : 0;
+        ASSERT_EQ(s.find(ch, pos), text.find(ch, pos));
+
+        const std::size_t m = rng() % 6;
+        std::string needle(m, 'a');
+        for (char& c : needle) c = static_cast<char>('a' + rng() % 4);
+        ASSERT_EQ(s.find(needle, pos), text.find(needle, pos)) << text << " / " << needle;
+
+        std::string other = text;
+        if (n && rng() % 2) other[rng() % n] = static_cast<char>('a' + rng() % 4);
+        if (rng() % 4 == 0) other.resize(rng() % (n + 1));
+        const std2::string t(other.data(), other.size());
+        ASSERT_EQ(s == t, text == other);
+        ASSERT_EQ(s.compare(t), (text.compare(other) > 0) - (text.compare(other) < 0));
+        ASSERT_EQ(s.starts_with(other), text.starts_with(other));
+        ASSERT_EQ(s.ends_with(other), text.ends_with(other));
+    }
+
+    std2::string high("a\xff");
+    EXPECT_TRUE(high > "ab"); // bytes compare unsigned, like std::string
+    EXPECT_TRUE(std2::string("apple") < std2::string("apricot"));
+    EXPECT_TRUE(std2::string("app") < "apple");
+    EXPECT_TRUE(std2::string("contains a needle").contains("needle"));
+    EXPECT_EQ(std2::string("hello").substr(1, 3), "ell");
+}
+
+// Test resize_and_overwrite writes in place and keeps the returned count
+TEST_F(StringTest, ResizeAndOverwrite) {
+    std2::string s("id:");
+    s.resize_and_overwrite(64, [](char* buffer, std::size_t count) {
+        // the existing prefix is still there
+        EXPECT_EQ(std::string_view(buffer, 3), "id:");
+        return 3 + std::snprintf(buffer + 3, count - 3, "%d", 12345);
+    });
+    EXPECT_EQ(s, "id:12345");
+    EXPECT_GE(s.capacity(), 64);
+
+    std2::string small;
+    small.resize_and_overwrite(10, [](char* buffer, std::size_t) {
+        std::memcpy(buffer, "xyz", 3);
+        return 3;
+    });
+    EXPECT_EQ(small, "xyz");
+    EXPECT_TRUE(small.is_small());
+
+    EXPECT_THROW(small.resize_and_overwrite(4, [](char*, std::size_t count) { return count + 1; }), std::length_error);
+}
+
+// Test strings survive std2::vector growth, which copies their bytes
+TEST_F(StringTest, VectorRelocation) {
+    std2::vector<std2::string> names;
+    std::vector<std::string> reference;
+    for (int i = 0; i < 1000; ++i) {
+        std::string value = "name_" + std::to_string(i);
+        if (i % 3 == 0) value += std::string(30, 'x'); // mix small and heap strings
+        names.emplace_back(value.data(), value.size());
+        reference.push_back(value);
+    }
+    ASSERT_EQ(names.size(), reference.size());
+    for (std::size_t i = 0; i < reference.size(); ++i) ASSERT_EQ(std::string_view(names[i]), reference[i]);
+
+    std2::vector<std2::string> copy = names;
+    names.shrink_to_fit();
+    EXPECT_EQ(copy[999], names[999]);
+}
+
+// Test hashing agrees with std::string so keys can be looked up either way
+TEST_F(StringTest, HashAndStream) {
+    const std2::string key("lookup key");
+    EXPECT_EQ(std::hash<std2::string>{}(key), std::hash<std::string>{}("lookup key"));
+
+    std::unordered_map<std2::string, int> table;
+    table[std2::string("one")] = 1;
+    table[std2::string("a key longer than twenty three")] = 2;
+    EXPECT_EQ(table.at(std2::string("one")), 1);
+    EXPECT_EQ(table.at(std2::string("a key longer than twenty three")), 2);
+
+    std::ostringstream out;
+    out << key;
+    EXPECT_EQ(out.str(), "lookup key");
+}
+
+// Construction, append, lookup-key hashing and vector growth against std::string
+TEST_F(StringTest, PerformanceBenchmark) {
+    const int n = 1000000;
+    std::mt19937 rng(42);
+    std::vector<std::string> words(n);
+    for (auto& word : words) {
+        word.resize(4 + rng() % 20); // 4..23 characters: std::string allocates above 15
+        for (char& c : word) c = static_cast<char>('a' + rng() % 26);
+    }
+
+    auto time = [](auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        body();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+
+    std::size_t std_total = 0, std2_total = 0;
+    const auto std_construct = time([&] {
+        for (const auto& word : words) {
+            std::string s(word.data(), word.size());
+            std_total += s.size() + static_cast<unsigned char>(s[0]);
+        }
+    });
+    const auto std2_construct = time([&] {
+        for (const auto& word : words) {
+            std2::string s(word.data(), word.size());
+            std2_total += s.size() + static_cast<unsigned char>(s[0]);
+        }
+    });
+    EXPECT_EQ(std_total, std2_total);
+
+    std::size_t std_appended = 0, std2_appended = 0;
+    const auto std_append = time([&] {
+        for (int i = 0; i < n; i += 8) {
+            std::string s;
+            for (int j = 0; j < 8; ++j) s += words[i + j];
+            std_appended += s.size();
+        }
+    });
+    const auto std2_append = time([&] {
+        for (int i = 0; i < n; i += 8) {
+            std2::string s;
+            for (int j = 0; j < 8; ++j) s += words[i + j];
+            std2_appended += s.size();
+        }
+    });
+    EXPECT_EQ(std_appended, std2_appended);
+
+    // lookups: hash the key, then compare it against the stored one
+    std::unordered_map<std::string, int> std_table;
+    std::unordered_map<std2::string, int> std2_table;
+    std::vector<std::string> std_keys;
+    std::vector<std2::string> std2_keys;
+    for (int i = 0; i < 100000; ++i) {
+        std_table.emplace(words[i], i);
+        std2_table.emplace(std2::string(words[i].data(), words[i].size()), i);
+    }
+    for (int i = 0; i < n; ++i) {
+        const auto& word = words[rng() % 100000];
+        std_keys.push_back(word);
+        std2_keys.emplace_back(word.data(), word.size());
+    }
+    long long std_found = 0, std2_found = 0;
+    const auto std_lookup = time([&] {
+        for (const auto& key : std_keys) std_found += std_table.find(key)->second;
+    });
+    const auto std2_lookup = time([&] {
+        for (const auto& key : std2_keys) std2_found += std2_table.find(key)->second;
+    });
+    EXPECT_EQ(std_found, std2_found);
+
+    const auto std_vector = time([&] {
+        std2::vector<std::string> out;
+        for (const auto& word : words) out.emplace_back(word.data(), word.size());
+    });
+    const auto std2_vector = time([&] {
+        std2::vector<std2::string> out;
+        for (const auto& word : words) out.emplace_back(word.data(), word.size());
+    });
+
+    std::cout << n << " strings of 4-23 characters\n"
+              << "  construct + destroy   std::string " << std_construct << " us, std2::string " << std2_construct << " us\n"
+              << "  append 8 per string   std::string " << std_append << " us, std2::string " << std2_append << " us\n"
+              << "  unordered_map lookup  std::string " << std_lookup << " us, std2::string " << std2_lookup << " us\n"
+              << "  std2::vector growth   std::string " << std_vector << " us, std2::string " << std2_vector << " us\n";
+}
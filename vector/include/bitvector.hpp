@@ -0,0 +1,455 @@
+#ifndef BITVECTOR_HPP
+#define BITVECTOR_HPP
+
+#include <bit>         // for std::popcount, std::countr_zero
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint64_t
+#include <stdexcept>   // for std::out_of_range, std::invalid_argument
+#include "vector.hpp"
+#include "../../std2/std2.hpp" // for std2::move
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h> // for 256-bit bulk word operations and pdep
+#endif
+
+namespace std2 {
+
+/*
+ * Packed bit vector, 64 flags per word.
+ * Bits past size() in the last word are always kept zero, so whole-word
+ * operations (count, find, bitwise ops) never need to mask the tail.
+ */
+class bitvector {
+public:
+    using word_type = std::uint64_t;
+    static constexpr std::size_t WORD_BITS = 64;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /*
+     * Proxy reference to a single bit.
+     */
+    class reference {
+    public:
+        reference(word_type* word, word_type mask) : m_word(word), m_mask(mask) {}
+
+        operator bool() const { return (*m_word & m_mask) != 0; }
+        bool operator~() const { return (*m_word & m_mask) == 0; }
+
+        reference& operator=(bool value) {
+            if (value) *m_word |= m_mask;
+            else *m_word &= ~m_mask;
+            return *this;
+        }
+
+        reference& operator=(const reference& other) { return *this = static_cast<bool>(other); }
+
+        reference& flip() {
+            *m_word ^= m_mask;
+            return *this;
+        }
+
+    private:
+        word_type* m_word;
+        word_type m_mask;
+    };
+
+    bitvector() = default;
+
+    /**
+     *  @brief  Construct with n bits, all set to value.
+     *  @param  n  The number of bits.
+     *  @param  value  The initial value of every bit.
+     */
+    explicit bitvector(std::size_t n, bool value = false) {
+        resize(n, value);
+    }
+
+    /**
+     *  @brief  Append a bit.
+     *  @param  value  The bit.
+     *  @return void.
+     */
+    void push_back(bool value) {
+        if (m_size % WORD_BITS == 0) m_words.push_back(0);
+        if (value) m_words[m_size / WORD_BITS] |= word_type(1) << (m_size % WORD_BITS);
+        ++m_size;
+    }
+
+    /**
+     *  @brief  Remove the last bit.
+     *  @return void.
+     */
+    void pop_back() {
+        if (m_size == 0) return;
+        --m_size;
+        if (m_size % WORD_BITS == 0) m_words.pop_back();
+        else clear_tail();
+    }
+
+    /**
+     *  @brief  Set the number of bits, new bits take value.
+     *  @param  n  The new number of bits.
+     *  @param  value  The value of added bits.
+     *  @return void.
+     */
+    void resize(std::size_t n, bool value = false) {
+        const std::size_t old_size = m_size;
+        m_words.resize(word_count(n), 0);
+        m_size = n;
+        if (n > old_size && value) set(old_size, n);
+        clear_tail();
+    }
+
+    void clear() {
+        m_words.clear();
+        m_size = 0;
+    }
+
+    bool operator[](std::size_t pos) const { return test(pos); }
+
+    reference operator[](std::size_t pos) {
+        return reference(&m_words[pos / WORD_BITS], word_type(1) << (pos % WORD_BITS));
+    }
+
+    /**
+     *  @brief  Bounds checked access.
+     *  @param  pos  The bit index.
+     *  @return the bit.
+     *  @throws std::out_of_range if pos >= size().
+     */
+    bool at(std::size_t pos) const {
+        if (pos >= m_size) throw std::out_of_range("std2::bitvector::at");
+        return test(pos);
+    }
+
+    bool test(std::size_t pos) const {
+        return (m_words[pos / WORD_BITS] >> (pos % WORD_BITS)) & 1;
+    }
+
+    void set(std::size_t pos) { m_words[pos / WORD_BITS] |= word_type(1) << (pos % WORD_BITS); }
+    void reset(std::size_t pos) { m_words[pos / WORD_BITS] &= ~(word_type(1) << (pos % WORD_BITS)); }
+    void flip(std::size_t pos) { m_words[pos / WORD_BITS] ^= word_type(1) << (pos % WORD_BITS); }
+
+    /**
+     *  @brief  Set every bit in [first, last).
+     *  @param  first  First bit index.
+     *  @param  last  One past the last bit index.
+     *  @return void.
+     */
+    void set(std::size_t first, std::size_t last) {
+        apply_range(first, last, [](word_type& w, word_type mask) { w |= mask; });
+    }
+
+    /**
+     *  @brief  Clear every bit in [first, last).
+     *  @param  first  First bit index.
+     *  @param  last  One past the last bit index.
+     *  @return void.
+     */
+    void reset(std::size_t first, std::size_t last) {
+        apply_range(first, last, [](word_type& w, word_type mask) { w &= ~mask; });
+    }
+
+    /**
+     *  @brief  Toggle every bit in [first, last).
+     *  @param  first  First bit index.
+     *  @param  last  One past the last bit index.
+     *  @return void.
+     */
+    void flip(std::size_t first, std::size_t last) {
+        apply_range(first, last, [](word_type& w, word_type mask) { w ^= mask; });
+    }
+
+    void set() { set(0, m_size); }
+    void reset() { reset(0, m_size); }
+    void flip() { flip(0, m_size); }
+
+    /**
+     *  @brief  Number of set bits, summed over four independent accumulators.
+     *  std::popcount lowers to the popcnt instruction only when the target has it
+     *  (-mpopcnt, -march=native, or STD2_NATIVE_ARCH); the default x86-64 build uses
+     *  the portable bit-twiddling fallback.
+     *  @return the population count.
+     */
+    std::size_t count() const {
+        const word_type* words = m_words.data();
+        const std::size_t n = m_words.size();
+        std::size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            c0 += std::popcount(words[i]);
+            c1 += std::popcount(words[i + 1]);
+            c2 += std::popcount(words[i + 2]);
+            c3 += std::popcount(words[i + 3]);
+        }
+        for (; i < n; ++i) c0 += std::popcount(words[i]);
+        return c0 + c1 + c2 + c3;
+    }
+
+    bool any() const {
+        for (std::size_t i = 0; i < m_words.size(); ++i) {
+            if (m_words[i]) return true;
+        }
+        return false;
+    }
+
+    bool none() const { return !any(); }
+    bool all() const { return count() == m_size; }
+
+    /**
+     *  @brief  Index of the first set bit.
+     *  @return the index, or npos if no bit is set.
+     */
+    std::size_t find_first() const { return scan_from(0); }
+
+    /**
+     *  @brief  Index of the first set bit after pos.
+     *  @param  pos  The bit to search after.
+     *  @return the index, or npos if no later bit is set.
+     */
+    std::size_t find_next(std::size_t pos) const {
+        ++pos;
+        if (pos >= m_size) return npos;
+        const std::size_t w = pos / WORD_BITS;
+        const word_type masked = m_words[w] & (~word_type(0) << (pos % WORD_BITS));
+        if (masked) return w * WORD_BITS + std::countr_zero(masked);
+        return scan_from(w + 1);
+    }
+
+    /**
+     *  @brief  Bitwise operations, both operands must have the same size.
+     *  @param  other  The right hand side.
+     *  @return reference to this.
+     *  @throws std::invalid_argument on a size mismatch.
+     */
+    bitvector& operator&=(const bitvector& other) {
+        combine<word_op::AND>(other);
+        return *this;
+    }
+
+    bitvector& operator|=(const bitvector& other) {
+        combine<word_op::OR>(other);
+        return *this;
+    }
+
+    bitvector& operator^=(const bitvector& other) {
+        combine<word_op::XOR>(other);
+        return *this;
+    }
+
+    /**
+     *  @brief  Clear every bit that is set in other (this & ~other).
+     *  @param  other  The mask of bits to clear.
+     *  @return reference to this.
+     */
+    bitvector& and_not(const bitvector& other) {
+        combine<word_op::ANDNOT>(other);
+        return *this;
+    }
+
+    friend bitvector operator&(bitvector lhs, const bitvector& rhs) { return lhs &= rhs; }
+    friend bitvector operator|(bitvector lhs, const bitvector& rhs) { return lhs |= rhs; }
+    friend bitvector operator^(bitvector lhs, const bitvector& rhs) { return lhs ^= rhs; }
+
+    bool operator==(const bitvector& other) const {
+        if (m_size != other.m_size) return false;
+        for (std::size_t i = 0; i < m_words.size(); ++i) {
+            if (m_words[i] != other.m_words[i]) return false;
+        }
+        return true;
+    }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /**
+     *  @brief  The packed words, bit i lives in word i / 64 at position i % 64.
+     *  @return pointer to the first word.
+     */
+    const word_type* data() const { return m_words.data(); }
+    word_type* data() { return m_words.data(); }
+    std::size_t num_words() const { return m_words.size(); }
+
+private:
+    static std::size_t word_count(std::size_t bits) { return (bits + WORD_BITS - 1) / WORD_BITS; }
+
+    /* @brief  Zero the bits past size() in the last word. */
+    void clear_tail() {
+        const std::size_t used = m_size % WORD_BITS;
+        if (used) m_words[m_words.size() - 1] &= (word_type(1) << used) - 1;
+    }
+
+    std::size_t scan_from(std::size_t w) const {
+        for (; w < m_words.size(); ++w) {
+            if (m_words[w]) return w * WORD_BITS + std::countr_zero(m_words[w]);
+        }
+        return npos;
+    }
+
+    /* @brief  Apply op to the masked edge words and whole middle words of [first, last).
+     * @param  first  First bit index.
+     * @param  last  One past the last bit index.
+     * @param  op  Called with each word and the mask of bits in range.
+     * @return void.
+     */
+    template <typename Op>
+    void apply_range(std::size_t first, std::size_t last, Op op) {
+        if (last > m_size) throw std::out_of_range("std2::bitvector range");
+        if (first >= last) return;
+
+        const std::size_t first_word = first / WORD_BITS;
+        const std::size_t last_word = (last - 1) / WORD_BITS;
+        const word_type head = ~word_type(0) << (first % WORD_BITS);
+        const word_type tail = ~word_type(0) >> (WORD_BITS - 1 - (last - 1) % WORD_BITS);
+
+        if (first_word == last_word) {
+            op(m_words[first_word], head & tail);
+            return;
+        }
+        op(m_words[first_word], head);
+        word_type* words = m_words.data();
+        for (std::size_t w = first_word + 1; w < last_word; ++w) op(words[w], ~word_type(0));
+        op(m_words[last_word], tail);
+    }
+
+    enum class word_op { AND, OR, XOR, ANDNOT };
+
+    template <word_op Op>
+    static word_type scalar_op(word_type a, word_type b) {
+        if constexpr (Op == word_op::AND) return a & b;
+        else if constexpr (Op == word_op::OR) return a | b;
+        else if constexpr (Op == word_op::XOR) return a ^ b;
+        else return a & ~b;
+    }
+
+#if defined(__AVX2__)
+    template <word_op Op>
+    static __m256i vector_op(__m256i a, __m256i b) {
+        if constexpr (Op == word_op::AND) return _mm256_and_si256(a, b);
+        else if constexpr (Op == word_op::OR) return _mm256_or_si256(a, b);
+        else if constexpr (Op == word_op::XOR) return _mm256_xor_si256(a, b);
+        else return _mm256_andnot_si256(b, a);
+    }
+#endif
+
+    /* @brief  Word-wise binary operation, 256 bits per step when AVX2 is enabled.
+     * Iterations are independent, so without AVX2 the scalar loop is still
+     * vectorized by the compiler at whatever width the target allows.
+     * @param  other  The right hand side, same size as this.
+     * @return void.
+     */
+    template <word_op Op>
+    void combine(const bitvector& other) {
+        if (other.m_size != m_size) throw std::invalid_argument("std2::bitvector size mismatch");
+        word_type* a = m_words.data();
+        const word_type* b = other.m_words.data();
+        const std::size_t n = m_words.size();
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 4 <= n; i += 4) {
+            const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), vector_op<Op>(va, vb));
+        }
+#endif
+        for (; i < n; ++i) a[i] = scalar_op<Op>(a[i], b[i]);
+    }
+
+    std2::vector<word_type> m_words;
+    std::size_t m_size = 0;
+};
+
+/*
+ * Rank/select index over a bitvector.
+ * Keeps one cumulative count per 512-bit superblock (one cache line of words),
+ * so rank is a table load plus at most eight popcounts, and select is a binary
+ * search over superblocks followed by a short word scan.
+ * The index is a snapshot: rebuild it after modifying the bitvector.
+ */
+class rank_select_index {
+public:
+    static constexpr std::size_t WORDS_PER_BLOCK = 8;
+
+    /**
+     *  @brief  Build the index.
+     *  @param  bits  The bitvector to index, must outlive the index.
+     */
+    explicit rank_select_index(const bitvector& bits) : m_bits(&bits) {
+        const std::size_t words = bits.num_words();
+        const bitvector::word_type* data = bits.data();
+        m_blocks.reserve(words / WORDS_PER_BLOCK + 2);
+        std::size_t total = 0;
+        for (std::size_t w = 0; w < words; ++w) {
+            if (w % WORDS_PER_BLOCK == 0) m_blocks.push_back(total);
+            total += std::popcount(data[w]);
+        }
+        m_blocks.push_back(total);
+        m_ones = total;
+    }
+
+    /**
+     *  @brief  Number of set bits in [0, pos).
+     *  @param  pos  The bit index, at most size().
+     *  @return the rank.
+     */
+    std::size_t rank1(std::size_t pos) const {
+        const bitvector::word_type* data = m_bits->data();
+        const std::size_t word = pos / bitvector::WORD_BITS;
+        const std::size_t block = word / WORDS_PER_BLOCK;
+        std::size_t r = m_blocks[block];
+        for (std::size_t w = block * WORDS_PER_BLOCK; w < word; ++w) r += std::popcount(data[w]);
+        const std::size_t bit = pos % bitvector::WORD_BITS;
+        if (bit) r += std::popcount(data[word] & ((bitvector::word_type(1) << bit) - 1));
+        return r;
+    }
+
+    std::size_t rank0(std::size_t pos) const { return pos - rank1(pos); }
+
+    /**
+     *  @brief  Position of the k-th set bit (0 based).
+     *  @param  k  The rank to look up.
+     *  @return the bit index, or bitvector::npos if fewer than k + 1 bits are set.
+     */
+    std::size_t select1(std::size_t k) const {
+        if (k >= m_ones) return bitvector::npos;
+
+        // last superblock whose cumulative count is <= k
+        std::size_t lo = 0;
+        std::size_t hi = m_blocks.size() - 1;
+        while (hi - lo > 1) {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            if (m_blocks[mid] <= k) lo = mid;
+            else hi = mid;
+        }
+
+        const bitvector::word_type* data = m_bits->data();
+        std::size_t remaining = k - m_blocks[lo];
+        std::size_t w = lo * WORDS_PER_BLOCK;
+        for (;; ++w) {
+            const std::size_t ones = std::popcount(data[w]);
+            if (remaining < ones) break;
+            remaining -= ones;
+        }
+        return w * bitvector::WORD_BITS + select_in_word(data[w], remaining);
+    }
+
+    std::size_t ones() const { return m_ones; }
+
+private:
+    /* @brief  Position of the k-th set bit inside one word. */
+    static std::size_t select_in_word(bitvector::word_type word, std::size_t k) {
+#if defined(__BMI2__)
+        return std::countr_zero(_pdep_u64(bitvector::word_type(1) << k, word));
+#else
+        for (; k > 0; --k) word &= word - 1; // drop the lowest set bit
+        return std::countr_zero(word);
+#endif
+    }
+
+    const bitvector* m_bits;
+    std2::vector<std::size_t> m_blocks;
+    std::size_t m_ones = 0;
+};
+
+} // namespace std2
+
+#endif // BITVECTOR_HPP
@@ -0,0 +1,282 @@
+#ifndef CONCURRENT_VECTOR_HPP
+#define CONCURRENT_VECTOR_HPP
+
+#include <atomic>      // for std::atomic
+#include <bit>         // for std::bit_width
+#include <cstddef>     // for std::size_t
+#include <exception>   // for std::terminate
+#include <memory>      // for std::allocator
+#include <new>         // for placement new, std::nothrow
+#include <stdexcept>   // for std::out_of_range
+#include "../../std2/std2.hpp" // for std2::move, std2::forward, std2::exchange
+
+namespace std2 {
+
+/*
+ * Growable vector that many threads can append to at once.
+ * Storage is a fixed table of exponentially sized segments: segment 0 holds
+ * FIRST_SEGMENT elements and every later segment doubles the capacity, so an
+ * index maps to its segment with one bit_width. Segments are never moved or
+ * freed before destruction, so element addresses are stable.
+ *
+ * push_back/grow_by claim slots with a single fetch_add and allocate missing
+ * segments with a compare-and-swap, there are no locks. An element may be read
+ * from any thread once the push that created it has returned and that fact
+ * has been communicated to the reader (e.g. through the returned index);
+ * size() counts claimed slots, including ones still being constructed.
+ *
+ * A slot whose construction throws (or whose segment cannot be allocated)
+ * stays claimed, since other threads may already have claimed the slots after
+ * it. It is recorded as failed, holds no element and is skipped by clear();
+ * it must not be accessed.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class concurrent_vector {
+public:
+    static constexpr std::size_t FIRST_SEGMENT_BITS = 5;
+    static constexpr std::size_t FIRST_SEGMENT = std::size_t(1) << FIRST_SEGMENT_BITS;
+    static constexpr std::size_t MAX_SEGMENTS = 64 - FIRST_SEGMENT_BITS;
+
+    concurrent_vector() : m_alloc(Allocator()) {}
+
+    explicit concurrent_vector(const Allocator& alloc) : m_alloc(alloc) {}
+
+    concurrent_vector(const concurrent_vector&) = delete;
+    concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+    ~concurrent_vector() {
+        clear();
+        for (std::size_t s = 0; s < MAX_SEGMENTS; ++s) {
+            T* segment = m_segments[s].load(std::memory_order_relaxed);
+            if (segment) m_alloc.deallocate(segment, segment_size(s));
+        }
+    }
+
+    /**
+     *  @brief  Append an element, safe to call from many threads at once.
+     *  @param  value  The value to append.
+     *  @return reference to the new element, it never moves.
+     */
+    T& push_back(const T& value) { return emplace_back(value); }
+
+    T& push_back(T&& value) { return emplace_back(std2::move(value)); }
+
+    /**
+     *  @brief  Append an element constructed in place, safe to call from many threads at once.
+     *  @param  args  Arguments to forward to the constructor of T.
+     *  @return reference to the new element.
+     */
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        const std::size_t index = m_size.fetch_add(1, std::memory_order_relaxed);
+        try {
+            const std::size_t segment = segment_of(index);
+            T* slot = ensure_segment(segment) + (index - segment_base(segment));
+            return *new (slot) T(std2::forward<Args>(args)...);
+        } catch (...) {
+            mark_failed(index, 1);
+            throw;
+        }
+    }
+
+    /**
+     *  @brief  Reserve n consecutive slots with one atomic add and default construct them.
+     *  @param  n  The number of elements to append.
+     *  @return index of the first new element.
+     */
+    std::size_t grow_by(std::size_t n) {
+        return append_n(n, [](T* slot) { new (slot) T(); });
+    }
+
+    /**
+     *  @brief  Reserve n consecutive slots with one atomic add and copy construct them from value.
+     *  @param  n  The number of elements to append.
+     *  @param  value  The value to copy.
+     *  @return index of the first new element.
+     */
+    std::size_t grow_by(std::size_t n, const T& value) {
+        return append_n(n, [&value](T* slot) { new (slot) T(value); });
+    }
+
+    /**
+     *  @brief  Index operator - access element at the given index.
+     *  @param  index  The index of the element to access.
+     *  @return reference to the element.
+     */
+    T& operator[](std::size_t index) { return *slot_for(index); }
+    const T& operator[](std::size_t index) const { return *slot_for(index); }
+
+    /**
+     *  @brief  Bounds checked access.
+     *  @param  index  The index of the element to access.
+     *  @return reference to the element.
+     *  @throws std::out_of_range if index >= size().
+     */
+    T& at(std::size_t index) {
+        if (index >= size()) throw std::out_of_range("std2::concurrent_vector::at");
+        return (*this)[index];
+    }
+
+    const T& at(std::size_t index) const {
+        if (index >= size()) throw std::out_of_range("std2::concurrent_vector::at");
+        return (*this)[index];
+    }
+
+    /**
+     *  @brief  Allocate the segments needed for n elements up front.
+     *  @param  n  The number of elements.
+     *  @return void.
+     */
+    void reserve(std::size_t n) {
+        if (n == 0) return;
+        for (std::size_t s = 0; s <= segment_of(n - 1); ++s) ensure_segment(s);
+    }
+
+    /**
+     *  @brief  Destroy all elements, keeping the segments. Not safe concurrently with other calls.
+     *  @return void.
+     */
+    void clear() {
+        const std::size_t n = m_size.load(std::memory_order_relaxed);
+        std::size_t i = 0;
+        for (failed_range* failed = take_failed(); failed;) {
+            for (; i < failed->first; ++i) (*this)[i].~T();
+            i = failed->first + failed->count;
+            delete std2::exchange(failed, failed->next);
+        }
+        for (; i < n; ++i) (*this)[i].~T();
+        m_size.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     *  @brief  Number of claimed slots, failed ones included.
+     *  @return the size.
+     */
+    std::size_t size() const { return m_size.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+
+    /**
+     *  @brief  Number of elements the allocated segments can hold.
+     *  @return the capacity.
+     */
+    std::size_t capacity() const {
+        std::size_t total = 0;
+        for (std::size_t s = 0; s < MAX_SEGMENTS; ++s) {
+            if (m_segments[s].load(std::memory_order_acquire)) total += segment_size(s);
+        }
+        return total;
+    }
+
+private:
+    // slots claimed by an append that threw, they hold no element
+    struct failed_range {
+        std::size_t first;
+        std::size_t count;
+        failed_range* next;
+    };
+
+    static std::size_t segment_of(std::size_t index) {
+        return std::bit_width(index >> FIRST_SEGMENT_BITS);
+    }
+
+    static std::size_t segment_base(std::size_t segment) {
+        return segment == 0 ? 0 : FIRST_SEGMENT << (segment - 1);
+    }
+
+    static std::size_t segment_size(std::size_t segment) {
+        return segment == 0 ? FIRST_SEGMENT : FIRST_SEGMENT << (segment - 1);
+    }
+
+    /* @brief  Allocate a segment unless another thread already has; the loser frees its block.
+     * @param  segment  The segment number.
+     * @return the segment's storage.
+     */
+    T* ensure_segment(std::size_t segment) {
+        T* existing = m_segments[segment].load(std::memory_order_acquire);
+        if (existing) return existing;
+
+        T* fresh = m_alloc.allocate(segment_size(segment));
+        if (m_segments[segment].compare_exchange_strong(existing, fresh,
+                std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return fresh;
+        }
+        m_alloc.deallocate(fresh, segment_size(segment));
+        return existing;
+    }
+
+    T* slot_for(std::size_t index) const {
+        const std::size_t segment = segment_of(index);
+        return m_segments[segment].load(std::memory_order_acquire) + (index - segment_base(segment));
+    }
+
+    /* @brief  Claim n consecutive slots with one atomic add and construct each with construct(slot).
+     * If anything throws the elements built so far are destroyed and the range is marked failed.
+     * @return index of the first slot.
+     */
+    template <typename Construct>
+    std::size_t append_n(std::size_t n, Construct construct) {
+        const std::size_t first = m_size.fetch_add(n, std::memory_order_relaxed);
+        if (n == 0) return first;
+        std::size_t built = 0;
+        try {
+            for (std::size_t s = segment_of(first); s <= segment_of(first + n - 1); ++s) ensure_segment(s);
+            for_each_slot(first, n, [&construct, &built](T* slot) {
+                construct(slot);
+                ++built;
+            });
+        } catch (...) {
+            while (built) (*this)[first + --built].~T();
+            mark_failed(first, n);
+            throw;
+        }
+        return first;
+    }
+
+    /* @brief  Record a claimed range that holds no elements, lock free. */
+    void mark_failed(std::size_t first, std::size_t count) noexcept {
+        // without the record clear() would destroy the slots as if they held elements
+        failed_range* failed = new (std::nothrow) failed_range{first, count, nullptr};
+        if (!failed) std::terminate();
+        failed->next = m_failed.load(std::memory_order_relaxed);
+        while (!m_failed.compare_exchange_weak(failed->next, failed, std::memory_order_release,
+                                               std::memory_order_relaxed)) {}
+    }
+
+    /* @brief  Detach the failed ranges, sorted by index. Not safe concurrently with appends. */
+    failed_range* take_failed() {
+        failed_range* pending = m_failed.exchange(nullptr, std::memory_order_acquire);
+        failed_range* sorted = nullptr;
+        while (pending) {
+            failed_range* failed = std2::exchange(pending, pending->next);
+            failed_range** link = &sorted;
+            while (*link && (*link)->first < failed->first) link = &(*link)->next;
+            failed->next = *link;
+            *link = failed;
+        }
+        return sorted;
+    }
+
+    /* @brief  Visit the n slots starting at first, one contiguous run per segment. */
+    template <typename Fn>
+    void for_each_slot(std::size_t first, std::size_t n, Fn fn) {
+        std::size_t index = first;
+        const std::size_t last = first + n;
+        while (index < last) {
+            const std::size_t segment = segment_of(index);
+            T* base = m_segments[segment].load(std::memory_order_acquire);
+            const std::size_t offset = segment_base(segment);
+            const std::size_t segment_end = offset + segment_size(segment);
+            const std::size_t run_end = last < segment_end ? last : segment_end;
+            for (; index < run_end; ++index) fn(base + (index - offset));
+        }
+    }
+
+    std::atomic<T*> m_segments[MAX_SEGMENTS]{};
+    std::atomic<std::size_t> m_size{0};
+    std::atomic<failed_range*> m_failed{nullptr};
+    Allocator m_alloc;
+};
+
+} // namespace std2
+
+#endif // CONCURRENT_VECTOR_HPP
@@ -0,0 +1,317 @@
+#ifndef MAPPED_VECTOR_HPP
+#define MAPPED_VECTOR_HPP
+
+#include <cerrno>       // for errno
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t, std::uint64_t, SIZE_MAX
+#include <stdexcept>    // for std::logic_error, std::runtime_error, std::length_error
+#include <string>       // for std::string
+#include <system_error> // for std::system_error
+#include <type_traits>  // for std::is_trivially_copyable_v
+
+#include <fcntl.h>      // for open
+#include <sys/mman.h>   // for mmap, munmap, msync
+#include <sys/stat.h>   // for fstat
+#include <unistd.h>     // for close, ftruncate
+
+#include "../../std2/std2.hpp" // for std2::exchange
+
+namespace std2 {
+
+/*
+ * Persistent vector stored in a file-backed shared memory mapping.
+ * The file starts with a small header (magic, format version, element size,
+ * size, capacity) followed directly by the elements, so opening an existing
+ * file is just an mmap - no copy and no deserialization.
+ * Only trivially copyable T can be stored since the bytes in the file are the
+ * objects themselves.
+ */
+template <typename T>
+class mapped_vector {
+    static_assert(std::is_trivially_copyable_v<T>, "std2::mapped_vector requires a trivially copyable T");
+
+public:
+    using value_type = T;
+
+    enum class mode {
+        read_write, // create the file if needed, map it shared and writable
+        read_only   // map an existing file read only, safe to share between processes
+    };
+
+    /**
+     *  @brief  Open (or create) a mapped vector backed by the file at path.
+     *  @param  path  The backing file.
+     *  @param  open_mode  read_write or read_only.
+     */
+    explicit mapped_vector(const std::string& path, mode open_mode = mode::read_write)
+        : m_mode(open_mode) {
+        const bool writable = m_mode == mode::read_write;
+        m_fd = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+        if (m_fd < 0) throw std::system_error(errno, std::generic_category(), "std2::mapped_vector open " + path);
+
+        struct stat st;
+        if (::fstat(m_fd, &st) != 0) fail("fstat");
+
+        if (st.st_size == 0) {
+            if (!writable) fail_format("empty file opened read only");
+            // fresh file - lay down the header with room for a few elements
+            map(file_size_for(INITIAL_CAPACITY), true);
+            m_header->magic = MAGIC;
+            m_header->version = VERSION;
+            m_header->element_size = sizeof(T);
+            m_header->size = 0;
+            m_header->capacity = INITIAL_CAPACITY;
+            return;
+        }
+
+        if (static_cast<std::size_t>(st.st_size) < DATA_OFFSET) fail_format("file too small");
+        map(static_cast<std::size_t>(st.st_size), false);
+
+        if (m_header->magic != MAGIC) fail_format("bad magic");
+        if (m_header->version != VERSION) fail_format("unsupported version");
+        if (m_header->element_size != sizeof(T)) fail_format("element size mismatch");
+        // a corrupt capacity must not overflow the size check below, the same bound grow() uses
+        if (m_header->capacity > MAX_CAPACITY) fail_format("capacity out of range");
+        if (m_header->size > m_header->capacity) fail_format("size exceeds capacity");
+        if (file_size_for(m_header->capacity) > m_mapped_bytes) fail_format("truncated file");
+    }
+
+    mapped_vector(const mapped_vector&) = delete;
+    mapped_vector& operator=(const mapped_vector&) = delete;
+
+    mapped_vector(mapped_vector&& other) noexcept
+        : m_mode(other.m_mode),
+        m_fd(std2::exchange(other.m_fd, -1)),
+        m_header(std2::exchange(other.m_header, nullptr)),
+        m_mapped_bytes(std2::exchange(other.m_mapped_bytes, std::size_t(0)))
+    {}
+
+    ~mapped_vector() {
+        unmap();
+        if (m_fd >= 0) ::close(m_fd);
+    }
+
+    /**
+     *  @brief  Set the capacity - extends the file and remaps it.
+     *  @param  new_capacity The new capacity.
+     *  @return void.
+     */
+    void reserve(const std::size_t new_capacity) {
+        if (new_capacity > capacity()) grow(new_capacity);
+    }
+
+    /**
+     *  @brief  Set the size, new elements are value initialized.
+     *  @param  new_size The new size.
+     *  @return void.
+     */
+    void resize(const std::size_t new_size) {
+        resize(new_size, T());
+    }
+
+    /**
+     *  @brief  Set the size.
+     *  @param  new_size The new size.
+     *  @param  val The value to initialize new elements with.
+     *  @return void.
+     */
+    void resize(const std::size_t new_size, const T& val) {
+        check_writable();
+        if (new_size > capacity()) grow(new_size);
+        for (std::size_t i = size(); i < new_size; ++i) {
+            data()[i] = val;
+        }
+        m_header->size = new_size;
+    }
+
+    /**
+     *  @brief  Add an element to the end, growing the file if needed.
+     *  @param  value  The value to add.
+     *  @return void.
+     */
+    void push_back(const T& value) {
+        check_writable();
+        if (size() >= capacity()) grow(capacity() * GROWTH_FACTOR);
+        data()[m_header->size++] = value;
+    }
+
+    /**
+     *  @brief  Remove the last element.
+     *  @return void.
+     */
+    void pop_back() {
+        check_writable();
+        if (m_header->size > 0) m_header->size--;
+    }
+
+    /**
+     *  @brief  Remove all elements, the file keeps its capacity.
+     *  @return void.
+     */
+    void clear() {
+        check_writable();
+        m_header->size = 0;
+    }
+
+    /**
+     *  @brief  Write dirty pages back to the file (msync).
+     *  @param  wait  Block until the write back is done (MS_SYNC) instead of scheduling it (MS_ASYNC).
+     *  @return void.
+     */
+    void flush(bool wait = true) {
+        if (m_mode == mode::read_only) return;
+        if (::msync(m_header, m_mapped_bytes, wait ? MS_SYNC : MS_ASYNC) != 0) fail("msync");
+    }
+
+    /**
+     *  @brief  Number of elements. A read only vector never reports more than it has mapped,
+     *          even if another process grew the file since.
+     *  @return the element count.
+     */
+    std::size_t size() const {
+        const std::size_t stored = m_header->size;
+        if (m_mode != mode::read_only) return stored;
+        const std::size_t limit = capacity();
+        return stored < limit ? stored : limit;
+    }
+
+    /**
+     *  @brief  Number of elements the file has room for, clamped to the mapping when read only.
+     *  @return the capacity.
+     */
+    std::size_t capacity() const {
+        const std::size_t stored = m_header->capacity;
+        if (m_mode != mode::read_only) return stored;
+        const std::size_t mapped = (m_mapped_bytes - DATA_OFFSET) / sizeof(T);
+        return stored < mapped ? stored : mapped;
+    }
+
+    bool empty() const { return size() == 0; }
+    bool read_only() const { return m_mode == mode::read_only; }
+
+    T* data() { return reinterpret_cast<T*>(reinterpret_cast<char*>(m_header) + DATA_OFFSET); }
+    const T* data() const { return reinterpret_cast<const T*>(reinterpret_cast<const char*>(m_header) + DATA_OFFSET); }
+
+    /**
+     *  @brief  Index operator - access element at the given index.
+     *  @param  index  The index of the element to access.
+     *  @return the value at the index.
+     */
+    const T& operator[](std::size_t index) const { return data()[index]; }
+
+    /**
+     *  @brief  Index operator - access element at the given index.
+     *          Writing through the reference of a read only vector faults.
+     *  @param  index  The index of the element to access.
+     *  @return the reference to the value at the index.
+     */
+    T& operator[](std::size_t index) { return data()[index]; }
+
+private:
+    struct header {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t element_size;
+        std::uint64_t size;
+        std::uint64_t capacity;
+    };
+
+    static constexpr std::uint64_t MAGIC = 0x4345564d32445453ULL; // "STD2MVEC"
+    static constexpr std::uint32_t VERSION = 1;
+    // elements start on their own cache line (or stricter alignment)
+    static constexpr std::size_t DATA_OFFSET = alignof(T) > 64 ? alignof(T) : 64;
+    static constexpr std::size_t INITIAL_CAPACITY = 4;
+    static constexpr std::size_t GROWTH_FACTOR = 2;
+    static constexpr std::size_t MAX_CAPACITY = (SIZE_MAX - DATA_OFFSET) / sizeof(T);
+
+    static_assert(sizeof(header) <= DATA_OFFSET);
+
+    static std::size_t file_size_for(std::size_t capacity) {
+        return DATA_OFFSET + capacity * sizeof(T);
+    }
+
+    /* @brief  Map the first bytes of the file, optionally extending the file first.
+     * @param  bytes  Number of bytes to map.
+     * @param  extend  Truncate the file to bytes before mapping.
+     * @return void.
+     */
+    void map(std::size_t bytes, bool extend) {
+        if (extend && ::ftruncate(m_fd, static_cast<off_t>(bytes)) != 0) fail("ftruncate");
+
+        void* addr = map_file(bytes);
+        if (addr == MAP_FAILED) fail("mmap");
+
+        m_header = static_cast<header*>(addr);
+        m_mapped_bytes = bytes;
+    }
+
+    void* map_file(std::size_t bytes) const {
+        const int prot = m_mode == mode::read_write ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        return ::mmap(nullptr, bytes, prot, MAP_SHARED, m_fd, 0);
+    }
+
+    void unmap() {
+        if (m_header) ::munmap(m_header, m_mapped_bytes);
+        m_header = nullptr;
+        m_mapped_bytes = 0;
+    }
+
+    /* @brief  Extend the file and remap it - the data is never copied.
+     * The old mapping is only dropped once the new one exists, so on failure
+     * the vector is left as it was and the exception can be handled.
+     * @param  new_capacity  The new capacity.
+     * @return void.
+     */
+    void grow(std::size_t new_capacity) {
+        check_writable();
+        if (new_capacity < INITIAL_CAPACITY) new_capacity = INITIAL_CAPACITY;
+        if (new_capacity > MAX_CAPACITY) throw std::length_error("std2::mapped_vector");
+
+        const std::size_t bytes = file_size_for(new_capacity);
+        if (::ftruncate(m_fd, static_cast<off_t>(bytes)) != 0) throw_errno("ftruncate");
+        void* addr = map_file(bytes);
+        if (addr == MAP_FAILED) {
+            const int err = errno;
+            // give the space back, the old mapping still covers the old length; if that fails too the
+            // file is left longer than the header says, so report the ftruncate error instead
+            if (::ftruncate(m_fd, static_cast<off_t>(m_mapped_bytes)) != 0) throw_errno("ftruncate after failed mmap");
+            errno = err;
+            throw_errno("mmap");
+        }
+
+        ::munmap(m_header, m_mapped_bytes);
+        m_header = static_cast<header*>(addr);
+        m_mapped_bytes = bytes;
+        m_header->capacity = new_capacity;
+    }
+
+    void check_writable() const {
+        if (m_mode == mode::read_only) throw std::logic_error("std2::mapped_vector is read only");
+    }
+
+    [[noreturn]] static void throw_errno(const char* what) {
+        throw std::system_error(errno, std::generic_category(), std::string("std2::mapped_vector ") + what);
+    }
+
+    [[noreturn]] void fail(const char* what) {
+        const int err = errno;
+        unmap();
+        if (m_fd >= 0) ::close(std2::exchange(m_fd, -1));
+        throw std::system_error(err, std::generic_category(), std::string("std2::mapped_vector ") + what);
+    }
+
+    [[noreturn]] void fail_format(const char* what) {
+        unmap();
+        if (m_fd >= 0) ::close(std2::exchange(m_fd, -1));
+        throw std::runtime_error(std::string("std2::mapped_vector: ") + what);
+    }
+
+    mode m_mode;
+    int m_fd = -1;
+    header* m_header = nullptr;
+    std::size_t m_mapped_bytes = 0;
+};
+
+} // namespace std2
+
+#endif // MAPPED_VECTOR_HPP
@@ -0,0 +1,466 @@
+#ifndef PERSISTENT_VECTOR_HPP
+#define PERSISTENT_VECTOR_HPP
+
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for std::size_t, std::ptrdiff_t
+#include <cstdint>     // for std::uint32_t, std::uint64_t
+#include <iterator>    // for std::forward_iterator_tag
+#include <new>         // for placement new
+#include <stdexcept>   // for std::out_of_range
+#include <utility>     // for std::swap
+#include "../../std2/std2.hpp" // for std2::move, std2::exchange
+
+namespace std2 {
+
+namespace persistent_detail {
+
+static constexpr std::size_t BITS = 5;
+static constexpr std::size_t BRANCHES = std::size_t(1) << BITS;
+static constexpr std::size_t MASK = BRANCHES - 1;
+
+/*
+ * Common node header.
+ * refs counts the parents and handles pointing at the node. owner is the
+ * token of the transient builder that created it (0 if none), a builder may
+ * edit its own nodes in place without touching the reference count.
+ */
+struct node_header {
+    std::atomic<std::uint32_t> refs{1};
+    std::uint32_t count = 0;
+    std::uint64_t owner = 0;
+};
+
+struct inner_node : node_header {
+    node_header* children[BRANCHES];
+};
+
+template <typename T>
+struct leaf_node : node_header {
+    alignas(T) unsigned char storage[sizeof(T) * BRANCHES];
+
+    T* values() { return reinterpret_cast<T*>(storage); }
+    const T* values() const { return reinterpret_cast<const T*>(storage); }
+};
+
+/* @brief  A token no other builder has used, 0 is reserved for "none". */
+inline std::uint64_t next_token() {
+    static std::atomic<std::uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+} // namespace persistent_detail
+
+/*
+ * Persistent vector: a 32-way radix balanced trie of refcounted nodes plus a
+ * separate tail leaf that absorbs push_back/pop_back.
+ * Copying a persistent_vector only bumps two reference counts. Mutating a
+ * copy clones the nodes on the path to the change and shares everything
+ * else with the other copies, a node that is no longer shared is edited in
+ * place. transient() returns a builder for batch edits.
+ */
+template <typename T>
+class persistent_vector {
+    using header = persistent_detail::node_header;
+    using inner = persistent_detail::inner_node;
+    using leaf = persistent_detail::leaf_node<T>;
+
+    static constexpr std::size_t BITS = persistent_detail::BITS;
+    static constexpr std::size_t BRANCHES = persistent_detail::BRANCHES;
+    static constexpr std::size_t MASK = persistent_detail::MASK;
+
+public:
+    class const_iterator;
+    class transient_builder;
+
+    persistent_vector() = default;
+
+    persistent_vector(const persistent_vector& other)
+        : m_root(other.m_root), m_tail(other.m_tail), m_size(other.m_size), m_shift(other.m_shift) {
+        retain(m_root);
+        retain(m_tail);
+    }
+
+    persistent_vector(persistent_vector&& other) noexcept
+        : m_root(std2::exchange(other.m_root, nullptr)),
+        m_tail(std2::exchange(other.m_tail, nullptr)),
+        m_size(std2::exchange(other.m_size, std::size_t(0))),
+        m_shift(std2::exchange(other.m_shift, BITS))
+    {}
+
+    persistent_vector& operator=(persistent_vector other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~persistent_vector() {
+        release(m_root, m_shift);
+        release(m_tail, 0);
+    }
+
+    void swap(persistent_vector& other) noexcept {
+        std::swap(m_root, other.m_root);
+        std::swap(m_tail, other.m_tail);
+        std::swap(m_size, other.m_size);
+        std::swap(m_shift, other.m_shift);
+    }
+
+    /**
+     *  @brief  Index operator - access element at the given index.
+     *  @param  index  The index of the element to access.
+     *  @return const reference to the element.
+     */
+    const T& operator[](std::size_t index) const {
+        return leaf_for(index)[index & MASK];
+    }
+
+    /**
+     *  @brief  Bounds checked access.
+     *  @param  index  The index of the element to access.
+     *  @return const reference to the element.
+     *  @throws std::out_of_range if index >= size().
+     */
+    const T& at(std::size_t index) const {
+        if (index >= m_size) throw std::out_of_range("std2::persistent_vector::at");
+        return (*this)[index];
+    }
+
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[m_size - 1]; }
+
+    /**
+     *  @brief  Replace an element, cloning only the nodes shared with other copies.
+     *  @param  index  The index of the element.
+     *  @param  value  The new value.
+     *  @return void.
+     */
+    void set(std::size_t index, T value) { set_impl(index, std2::move(value), 0); }
+
+    /**
+     *  @brief  Append an element.
+     *  @param  value  The value.
+     *  @return void.
+     */
+    void push_back(T value) { push_back_impl(std2::move(value), 0); }
+
+    /**
+     *  @brief  Remove the last element.
+     *  @return void.
+     */
+    void pop_back() { pop_back_impl(0); }
+
+    /**
+     *  @brief  Start a batch of edits. The builder owns a copy of this vector.
+     *  @return a transient builder.
+     */
+    transient_builder transient() const { return transient_builder(*this); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /*
+     * Forward iterator that walks one leaf at a time.
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+        const_iterator(const persistent_vector* owner, std::size_t index) : m_owner(owner), m_index(index) {
+            if (index < owner->m_size) m_leaf = owner->leaf_for(index);
+        }
+
+        reference operator*() const { return m_leaf[m_index & MASK]; }
+        pointer operator->() const { return &m_leaf[m_index & MASK]; }
+
+        const_iterator& operator++() {
+            ++m_index;
+            if ((m_index & MASK) == 0 && m_index < m_owner->m_size) m_leaf = m_owner->leaf_for(m_index);
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+
+    private:
+        const persistent_vector* m_owner = nullptr;
+        std::size_t m_index = 0;
+        const T* m_leaf = nullptr;
+    };
+
+    /*
+     * Mutable builder for batch edits.
+     * Nodes the builder clones are tagged with its token and edited in place
+     * from then on, so a run of pushes or sets costs one clone per touched node.
+     * persistent() hands the result back as an ordinary persistent_vector.
+     */
+    class transient_builder {
+    public:
+        explicit transient_builder(const persistent_vector& from)
+            : m_vector(from), m_token(persistent_detail::next_token()) {}
+
+        transient_builder(const transient_builder&) = delete;
+        transient_builder& operator=(const transient_builder&) = delete;
+        transient_builder(transient_builder&&) = default;
+        transient_builder& operator=(transient_builder&&) = default;
+
+        const T& operator[](std::size_t index) const { return m_vector[index]; }
+        void set(std::size_t index, T value) { m_vector.set_impl(index, std2::move(value), m_token); }
+        void push_back(T value) { m_vector.push_back_impl(std2::move(value), m_token); }
+        void pop_back() { m_vector.pop_back_impl(m_token); }
+        std::size_t size() const { return m_vector.size(); }
+
+        /**
+         *  @brief  Finish the batch. The builder is empty afterwards.
+         *  @return the built vector.
+         */
+        persistent_vector persistent() {
+            m_token = persistent_detail::next_token(); // retire the token so no later edit reuses nodes
+            return std2::move(m_vector);
+        }
+
+    private:
+        persistent_vector m_vector;
+        std::uint64_t m_token;
+    };
+
+private:
+    /* @brief  Index of the first element stored in the tail. */
+    std::size_t tail_offset() const {
+        return m_size < BRANCHES ? 0 : ((m_size - 1) >> BITS) << BITS;
+    }
+
+    /* @brief  The values array of the leaf that holds index. */
+    const T* leaf_for(std::size_t index) const {
+        if (index >= tail_offset()) return static_cast<const leaf*>(m_tail)->values();
+        const header* node = m_root;
+        for (std::size_t level = m_shift; level > 0; level -= BITS) {
+            node = static_cast<const inner*>(node)->children[(index >> level) & MASK];
+        }
+        return static_cast<const leaf*>(node)->values();
+    }
+
+    static void retain(header* node) {
+        if (node) node->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /* @brief  Drop a reference, freeing the subtree when it was the last one.
+     * @param  node  The node, may be null.
+     * @param  level  0 for leaves, otherwise the inner node's shift.
+     * @return void.
+     */
+    static void release(header* node, std::size_t level) {
+        if (!node || node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        if (level == 0) {
+            leaf* l = static_cast<leaf*>(node);
+            for (std::uint32_t i = 0; i < l->count; ++i) l->values()[i].~T();
+            delete l;
+        } else {
+            inner* n = static_cast<inner*>(node);
+            for (std::uint32_t i = 0; i < n->count; ++i) release(n->children[i], level - BITS);
+            delete n;
+        }
+    }
+
+    static bool editable(const header* node, std::uint64_t token) {
+        return (token && node->owner == token) || node->refs.load(std::memory_order_acquire) == 1;
+    }
+
+    /* @brief  Make the node in slot safe to edit, cloning it if it is shared.
+     * @param  slot  Reference to the pointer holding the node.
+     * @param  level  0 for leaves, otherwise the inner node's shift.
+     * @param  token  The editing builder's token, or 0.
+     * @return void.
+     */
+    static void make_editable(header*& slot, std::size_t level, std::uint64_t token) {
+        if (editable(slot, token)) return;
+        header* copy;
+        if (level == 0) {
+            leaf* from = static_cast<leaf*>(slot);
+            leaf* to = new leaf;
+            for (std::uint32_t i = 0; i < from->count; ++i) new (&to->values()[i]) T(from->values()[i]);
+            copy = to;
+        } else {
+            inner* from = static_cast<inner*>(slot);
+            inner* to = new inner;
+            for (std::uint32_t i = 0; i < from->count; ++i) {
+                to->children[i] = from->children[i];
+                retain(to->children[i]);
+            }
+            copy = to;
+        }
+        copy->count = slot->count;
+        copy->owner = token;
+        release(slot, level);
+        slot = copy;
+    }
+
+    static leaf* new_leaf(std::uint64_t token) {
+        leaf* l = new leaf;
+        l->owner = token;
+        return l;
+    }
+
+    /* @brief  A chain of single-child inner nodes from level down to the leaf. */
+    static header* new_path(std::size_t level, header* node, std::uint64_t token) {
+        for (std::size_t l = BITS; l <= level; l += BITS) {
+            inner* parent = new inner;
+            parent->owner = token;
+            parent->children[0] = node;
+            parent->count = 1;
+            node = parent;
+        }
+        return node;
+    }
+
+    void set_impl(std::size_t index, T&& value, std::uint64_t token) {
+        if (index >= m_size) throw std::out_of_range("std2::persistent_vector::set");
+        if (index >= tail_offset()) {
+            make_editable(m_tail, 0, token);
+            static_cast<leaf*>(m_tail)->values()[index & MASK] = std2::move(value);
+            return;
+        }
+
+        header** slot = &m_root;
+        for (std::size_t level = m_shift; level > 0; level -= BITS) {
+            make_editable(*slot, level, token);
+            slot = &static_cast<inner*>(*slot)->children[(index >> level) & MASK];
+        }
+        make_editable(*slot, 0, token);
+        static_cast<leaf*>(*slot)->values()[index & MASK] = std2::move(value);
+    }
+
+    void push_back_impl(T&& value, std::uint64_t token) {
+        if (!m_tail) m_tail = new_leaf(token);
+
+        if (m_size - tail_offset() == BRANCHES) {
+            push_tail(token);
+            m_tail = new_leaf(token);
+        } else {
+            make_editable(m_tail, 0, token);
+        }
+
+        leaf* tail = static_cast<leaf*>(m_tail);
+        new (&tail->values()[tail->count]) T(std2::move(value));
+        ++tail->count;
+        ++m_size;
+    }
+
+    /* @brief  Move the full tail into the trie, growing a new root level if the trie is full. */
+    void push_tail(std::uint64_t token) {
+        const std::size_t index = tail_offset();
+        header* full = std2::exchange(m_tail, nullptr);
+
+        if (!m_root) {
+            m_root = new_path(BITS, full, token);
+            m_shift = BITS;
+            return;
+        }
+
+        if (index == std::size_t(1) << (m_shift + BITS)) {
+            inner* root = new inner;
+            root->owner = token;
+            root->children[0] = m_root;
+            root->children[1] = new_path(m_shift, full, token);
+            root->count = 2;
+            m_root = root;
+            m_shift += BITS;
+            return;
+        }
+
+        header** slot = &m_root;
+        for (std::size_t level = m_shift; ; level -= BITS) {
+            make_editable(*slot, level, token);
+            inner* node = static_cast<inner*>(*slot);
+            const std::size_t sub = (index >> level) & MASK;
+            if (sub == node->count) {
+                node->children[sub] = new_path(level - BITS, full, token);
+                node->count = sub + 1;
+                return;
+            }
+            slot = &node->children[sub];
+        }
+    }
+
+    void pop_back_impl(std::uint64_t token) {
+        if (m_size == 0) return;
+
+        if (m_size - tail_offset() > 1) {
+            make_editable(m_tail, 0, token);
+            leaf* tail = static_cast<leaf*>(m_tail);
+            tail->values()[--tail->count].~T();
+            --m_size;
+            return;
+        }
+
+        // the tail is about to become empty, drop it and promote the last leaf of the trie
+        release(m_tail, 0);
+        m_tail = nullptr;
+        --m_size;
+        if (m_size == 0) {
+            release(m_root, m_shift);
+            m_root = nullptr;
+            m_shift = BITS;
+            return;
+        }
+
+        m_tail = pop_tail(m_root, m_shift, m_size - 1, token);
+        if (static_cast<inner*>(m_root)->count == 0) {
+            release(m_root, m_shift);
+            m_root = nullptr;
+            m_shift = BITS;
+            return;
+        }
+
+        // collapse single-child roots
+        while (m_shift > BITS && static_cast<inner*>(m_root)->count == 1) {
+            inner* old_root = static_cast<inner*>(m_root);
+            header* child = old_root->children[0];
+            retain(child);
+            release(old_root, m_shift);
+            m_root = child;
+            m_shift -= BITS;
+        }
+    }
+
+    /* @brief  Detach the leaf holding index from the subtree in slot, pruning emptied nodes.
+     * @return the detached leaf, its reference is transferred to the caller.
+     */
+    static header* pop_tail(header*& slot, std::size_t level, std::size_t index, std::uint64_t token) {
+        make_editable(slot, level, token);
+        inner* node = static_cast<inner*>(slot);
+        const std::size_t sub = (index >> level) & MASK;
+
+        if (level == BITS) {
+            node->count = static_cast<std::uint32_t>(sub);
+            return node->children[sub];
+        }
+
+        header* detached = pop_tail(node->children[sub], level - BITS, index, token);
+        if (static_cast<inner*>(node->children[sub])->count == 0) {
+            release(node->children[sub], level - BITS);
+            node->count = static_cast<std::uint32_t>(sub);
+        }
+        return detached;
+    }
+
+    header* m_root = nullptr;
+    header* m_tail = nullptr;
+    std::size_t m_size = 0;
+    std::size_t m_shift = BITS;
+};
+
+} // namespace std2
+
+#endif // PERSISTENT_VECTOR_HPP
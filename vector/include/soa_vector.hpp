@@ -0,0 +1,376 @@
+#ifndef SOA_VECTOR_HPP
+#define SOA_VECTOR_HPP
+
+#include <algorithm>   // for std::max
+#include <array>       // for std::array
+#include <cstddef>     // for std::size_t, std::byte
+#include <cstdint>     // for SIZE_MAX
+#include <iterator>    // for std::random_access_iterator_tag
+#include <memory>      // for std::destroy_n
+#include <new>         // for ::operator new with std::align_val_t, std::bad_array_new_length
+#include <span>        // for std::span
+#include <tuple>       // for std::tuple, std::tuple_element_t
+#include <type_traits> // for std::conditional_t, std::is_nothrow_move_constructible_v
+#include <utility>     // for std::index_sequence, std::move_if_noexcept
+#include "../../std2/std2.hpp" // for std2::move, std2::forward, std2::exchange
+
+namespace std2 {
+
+/*
+ * Structure-of-arrays vector.
+ * Every field type gets its own contiguous column, all columns share one size
+ * and capacity and live in a single allocation. Each column starts on a cache
+ * line boundary so get<I>() spans can be fed straight to vectorized kernels.
+ * Indexing and iteration yield tuples of references (proxy references).
+ */
+template <typename... Ts>
+class soa_vector {
+    static_assert(sizeof...(Ts) > 0, "std2::soa_vector needs at least one column");
+
+    template <bool IsConst> class basic_iterator;
+
+public:
+    static constexpr std::size_t COLUMN_COUNT = sizeof...(Ts);
+    static constexpr std::size_t COLUMN_ALIGNMENT = 64;
+
+    template <std::size_t I>
+    using column_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    using value_type = std::tuple<Ts...>;
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<const Ts&...>;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    soa_vector() = default;
+
+    soa_vector(const soa_vector& other) {
+        reserve(other.m_size);
+        for (std::size_t i = 0; i < other.m_size; ++i) push_back(other[i]);
+    }
+
+    soa_vector(soa_vector&& other) noexcept
+        : m_block(std2::exchange(other.m_block, nullptr)),
+        m_columns(other.m_columns),
+        m_size(std2::exchange(other.m_size, std::size_t(0))),
+        m_capacity(std2::exchange(other.m_capacity, std::size_t(0)))
+    {}
+
+    soa_vector& operator=(soa_vector other) noexcept {
+        std::swap(m_block, other.m_block);
+        std::swap(m_columns, other.m_columns);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+        return *this;
+    }
+
+    ~soa_vector() {
+        clear();
+        if (m_block) ::operator delete(m_block, std::align_val_t(BLOCK_ALIGNMENT));
+    }
+
+    /**
+     *  @brief  Set the capacity of every column.
+     *  @param  new_capacity The new capacity.
+     *  @return void.
+     */
+    void reserve(const std::size_t new_capacity) {
+        if (new_capacity > m_capacity) reallocate(new_capacity);
+    }
+
+    /**
+     *  @brief  Set the size, new rows are value initialized.
+     *  @param  new_size The new size.
+     *  @return void.
+     */
+    void resize(const std::size_t new_size) {
+        if (new_size > m_capacity) reallocate(new_size);
+        while (m_size > new_size) pop_back();
+        while (m_size < new_size) emplace_back(Ts()...);
+    }
+
+    /**
+     *  @brief  Append a row.
+     *  @param  values  One value per column.
+     *  @return void.
+     */
+    void push_back(const Ts&... values) {
+        emplace_back(values...);
+    }
+
+    /**
+     *  @brief  Append a row given as a tuple (or a tuple of references).
+     *  @param  row  The row.
+     *  @return void.
+     */
+    template <typename... Us>
+    void push_back(const std::tuple<Us...>& row) {
+        std::apply([this](const auto&... values) { emplace_back(values...); }, row);
+    }
+
+    /**
+     *  @brief  Append a row, constructing each column value from the matching argument.
+     *  @param  args  One argument per column.
+     *  @return reference to the new row.
+     */
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        static_assert(sizeof...(Args) == COLUMN_COUNT, "std2::soa_vector::emplace_back needs one argument per column");
+        if (m_size < m_capacity) {
+            construct_row(m_columns, m_size, std::index_sequence_for<Ts...>(), std2::forward<Args>(args)...);
+        } else {
+            // args may refer into this vector, so the row is built in the new block before the old rows move
+            pending_block next(m_capacity ? m_capacity * GROWTH_FACTOR : INITIAL_CAPACITY);
+            construct_row(next.columns, m_size, std::index_sequence_for<Ts...>(), std2::forward<Args>(args)...);
+            next.row = m_size;
+            adopt_block(next);
+        }
+        return (*this)[m_size++];
+    }
+
+    /**
+     *  @brief  Remove the last row.
+     *  @return void.
+     */
+    void pop_back() {
+        if (m_size == 0) return;
+        --m_size;
+        destroy_row(m_size, std::index_sequence_for<Ts...>());
+    }
+
+    /**
+     *  @brief  Remove all rows, the capacity is kept.
+     *  @return void.
+     */
+    void clear() {
+        while (m_size > 0) pop_back();
+    }
+
+    /**
+     *  @brief  Contiguous view of one column.
+     *  @return span over the column's elements.
+     */
+    template <std::size_t I>
+    std::span<column_type<I>> get() { return { column<I>(), m_size }; }
+
+    template <std::size_t I>
+    std::span<const column_type<I>> get() const { return { column<I>(), m_size }; }
+
+    /**
+     *  @brief  Index operator - access a row.
+     *  @param  index  The row index.
+     *  @return tuple of references to the row's fields.
+     */
+    reference operator[](std::size_t index) { return row(index, std::index_sequence_for<Ts...>()); }
+    const_reference operator[](std::size_t index) const { return row(index, std::index_sequence_for<Ts...>()); }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, m_size); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+
+    std::size_t size() const { return m_size; }
+    std::size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+
+private:
+    static constexpr std::size_t INITIAL_CAPACITY = 4;
+    static constexpr std::size_t GROWTH_FACTOR = 2;
+
+    // the block and every column in it start on this boundary, over-aligned columns raise it
+    static constexpr std::size_t BLOCK_ALIGNMENT = std::max({COLUMN_ALIGNMENT, alignof(Ts)...});
+
+    static constexpr std::size_t align_up(std::size_t offset, std::size_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    template <std::size_t I>
+    column_type<I>* column() const { return static_cast<column_type<I>*>(m_columns[I]); }
+
+    template <std::size_t... Is>
+    reference row(std::size_t index, std::index_sequence<Is...>) {
+        return reference(column<Is>()[index]...);
+    }
+
+    template <std::size_t... Is>
+    const_reference row(std::size_t index, std::index_sequence<Is...>) const {
+        return const_reference(column<Is>()[index]...);
+    }
+
+    /* @brief  Construct row index in the given columns, on a throw the columns already built are destroyed.
+     * @param  columns  The column base pointers.
+     * @param  index  The row index.
+     * @param  args  One argument per column.
+     * @return void.
+     */
+    template <std::size_t... Is, typename... Args>
+    static void construct_row(const std::array<void*, COLUMN_COUNT>& columns, std::size_t index,
+                              std::index_sequence<Is...>, Args&&... args) {
+        std::size_t built = 0;
+        try {
+            ((new (static_cast<column_type<Is>*>(columns[Is]) + index) column_type<Is>(std2::forward<Args>(args)), ++built), ...);
+        } catch (...) {
+            ((Is < built ? static_cast<column_type<Is>*>(columns[Is])[index].~column_type<Is>() : void()), ...);
+            throw;
+        }
+    }
+
+    template <std::size_t... Is>
+    void destroy_row(std::size_t index, std::index_sequence<Is...>) {
+        (column<Is>()[index].~column_type<Is>(), ...);
+    }
+
+    template <std::size_t... Is>
+    void destroy_rows(std::index_sequence<Is...>) {
+        ((std::destroy_n(column<Is>(), m_size)), ...);
+    }
+
+    /*
+     * A freshly allocated block that has not been adopted yet. It counts the
+     * elements built in each column (and the appended row, if any), so a throw
+     * while filling it destroys exactly those and frees the block, leaving the
+     * vector on its old block.
+     */
+    struct pending_block {
+        static constexpr std::size_t NO_ROW = SIZE_MAX;
+
+        std::size_t capacity;
+        std::array<void*, COLUMN_COUNT> columns{};
+        std::byte* block;
+        std::array<std::size_t, COLUMN_COUNT> built{}; // leading elements constructed per column
+        std::size_t row = NO_ROW;                      // index of the appended row once it is built
+
+        explicit pending_block(std::size_t new_capacity)
+            : capacity(new_capacity), block(allocate_block(new_capacity, columns)) {}
+
+        pending_block(const pending_block&) = delete;
+        pending_block& operator=(const pending_block&) = delete;
+
+        ~pending_block() {
+            if (!block) return;
+            unwind(std::index_sequence_for<Ts...>());
+            ::operator delete(block, std::align_val_t(BLOCK_ALIGNMENT));
+        }
+
+        template <std::size_t... Is>
+        void unwind(std::index_sequence<Is...>) {
+            ((std::destroy_n(static_cast<column_type<Is>*>(columns[Is]), built[Is])), ...);
+            if (row != NO_ROW) ((static_cast<column_type<Is>*>(columns[Is])[row].~column_type<Is>()), ...);
+        }
+    };
+
+    /* @brief  Move column I into the pending block, copying instead when the move could throw.
+     * @param  next  The pending block.
+     * @return void.
+     */
+    template <std::size_t I>
+    void transfer_column(pending_block& next) {
+        using T = column_type<I>;
+        T* from = column<I>();
+        T* to = static_cast<T*>(next.columns[I]);
+        for (std::size_t& i = next.built[I]; i < m_size; ++i) {
+            new (to + i) T(std::move_if_noexcept(from[i]));
+        }
+    }
+
+    template <std::size_t... Is>
+    void transfer_columns(pending_block& next, std::index_sequence<Is...>) {
+        // columns that may throw go first, so nothing has been moved out of the old block when one does
+        ((std::is_nothrow_move_constructible_v<column_type<Is>> ? void() : transfer_column<Is>(next)), ...);
+        ((std::is_nothrow_move_constructible_v<column_type<Is>> ? transfer_column<Is>(next) : void()), ...);
+    }
+
+    /* @brief  Allocate one block sized for new_capacity rows and lay the columns out in it.
+     * @param  new_capacity  The capacity of the block.
+     * @param  columns  Receives the column base pointers.
+     * @return the block.
+     * @throws std::bad_array_new_length if the block size does not fit in std::size_t.
+     */
+    static std::byte* allocate_block(std::size_t new_capacity, std::array<void*, COLUMN_COUNT>& columns) {
+        constexpr std::array<std::size_t, COLUMN_COUNT> sizes{ sizeof(Ts)... };
+        std::array<std::size_t, COLUMN_COUNT> offsets{};
+        std::size_t total = 0;
+        for (std::size_t c = 0; c < COLUMN_COUNT; ++c) {
+            if (total > SIZE_MAX - (BLOCK_ALIGNMENT - 1)) throw std::bad_array_new_length();
+            offsets[c] = align_up(total, BLOCK_ALIGNMENT);
+            if (new_capacity > (SIZE_MAX - offsets[c]) / sizes[c]) throw std::bad_array_new_length();
+            total = offsets[c] + new_capacity * sizes[c];
+        }
+
+        std::byte* block = static_cast<std::byte*>(::operator new(total, std::align_val_t(BLOCK_ALIGNMENT)));
+        for (std::size_t c = 0; c < COLUMN_COUNT; ++c) columns[c] = block + offsets[c];
+        return block;
+    }
+
+    /* @brief  Move every column into one new block sized for new_capacity rows.
+     * @param  new_capacity  The new capacity.
+     * @return void.
+     */
+    void reallocate(std::size_t new_capacity) {
+        pending_block next(new_capacity);
+        adopt_block(next);
+    }
+
+    /* @brief  Fill the pending block with the existing rows, then switch to it and release the old block.
+     *         The old rows are only destroyed once every column has been built, so a throw leaves the vector as it was.
+     * @param  next  The pending block.
+     * @return void.
+     */
+    void adopt_block(pending_block& next) {
+        if (m_block) {
+            transfer_columns(next, std::index_sequence_for<Ts...>());
+            destroy_rows(std::index_sequence_for<Ts...>());
+            ::operator delete(m_block, std::align_val_t(BLOCK_ALIGNMENT));
+        }
+
+        m_block = std2::exchange(next.block, nullptr);
+        m_columns = next.columns;
+        m_capacity = next.capacity;
+    }
+
+    template <bool IsConst>
+    class basic_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = soa_vector::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, soa_vector::const_reference, soa_vector::reference>;
+        using container = std::conditional_t<IsConst, const soa_vector, soa_vector>;
+
+        basic_iterator() = default;
+        basic_iterator(container* owner, std::size_t index) : m_owner(owner), m_index(index) {}
+
+        reference operator*() const { return (*m_owner)[m_index]; }
+        reference operator[](difference_type n) const { return (*m_owner)[m_index + n]; }
+
+        basic_iterator& operator++() { ++m_index; return *this; }
+        basic_iterator operator++(int) { basic_iterator temp = *this; ++m_index; return temp; }
+        basic_iterator& operator--() { --m_index; return *this; }
+        basic_iterator operator--(int) { basic_iterator temp = *this; --m_index; return temp; }
+
+        basic_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+        basic_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+        basic_iterator operator+(difference_type n) const { return basic_iterator(m_owner, m_index + n); }
+        friend basic_iterator operator+(difference_type n, const basic_iterator& it) { return it + n; }
+        basic_iterator operator-(difference_type n) const { return basic_iterator(m_owner, m_index - n); }
+        difference_type operator-(const basic_iterator& other) const {
+            return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+        }
+
+        bool operator==(const basic_iterator& other) const { return m_index == other.m_index; }
+        auto operator<=>(const basic_iterator& other) const { return m_index <=> other.m_index; }
+
+    private:
+        container* m_owner = nullptr;
+        std::size_t m_index = 0;
+    };
+
+    std::byte* m_block = nullptr;
+    std::array<void*, COLUMN_COUNT> m_columns{};
+    std::size_t m_size = 0;
+    std::size_t m_capacity = 0;
+};
+
+} // namespace std2
+
+#endif // SOA_VECTOR_HPP
@@ -2,13 +2,27 @@
 #define VECTOR_HPP
 
 #include <cstddef>  // for std::size_t - utility library
-#include "../../std2/std2.hpp" // for std2::move, std2::forward
+#include <cstring>  // for std::memcpy
+#include <iterator> // for std::reverse_iterator
+#include <memory>   // for std::allocator
+#include <new>      // for placement new
+#include <utility>  // for std::swap
+#include "../../std2/std2.hpp" // for std2::move, std2::forward, std2::is_trivially_relocatable_v
+#include "../../std2/trace.hpp" // for STD2_TRACE_SCOPE
 
 namespace std2 {
 
 template <typename T, typename Allocator = std::allocator<T>>
 class vector {
 public:
+    // storage is contiguous, so plain pointers are the iterators
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
     vector() : m_alloc(Allocator()) {
         reallocate(INITIAL_CAPACITY);
@@ -18,9 +32,37 @@ public:
         reallocate(INITIAL_CAPACITY);
     }
 
+    vector(const vector& other) : m_alloc(other.m_alloc), m_auto_shrink(other.m_auto_shrink) {
+        reallocate(other.m_size > INITIAL_CAPACITY ? other.m_size : INITIAL_CAPACITY);
+        for (std::size_t i = 0; i < other.m_size; ++i) {
+            new (&m_data[i]) T(other.m_data[i]);
+        }
+        m_size = other.m_size;
+    }
+
+    vector(vector&& other) noexcept
+        : m_data(std2::exchange(other.m_data, nullptr)),
+        m_size(std2::exchange(other.m_size, std::size_t(0))),
+        m_capacity(std2::exchange(other.m_capacity, std::size_t(0))),
+        m_alloc(std2::move(other.m_alloc)),
+        m_auto_shrink(other.m_auto_shrink)
+    {}
+
+    vector& operator=(vector other) noexcept {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_alloc, other.m_alloc);
+        std::swap(m_auto_shrink, other.m_auto_shrink);
+        return *this;
+    }
+
     ~vector() {
-        // delete[] m_data; // free memory in destructor
-        m_alloc.deallocate(m_data, m_capacity);
+        // destroy and free directly, clear() could reallocate under the auto shrink policy
+        for (std::size_t i = 0; i < m_size; ++i) {
+            m_data[i].~T(); // call destructors of the remaining elements
+        }
+        if (m_data) m_alloc.deallocate(m_data, m_capacity);
     }
 
     /**
@@ -43,6 +85,7 @@ public:
      *  @return void.
      */
     void resize(const std::size_t new_size) {
+        STD2_TRACE_SCOPE("std2::vector::resize", new_size);
         // resize affects size and capacity
         // therefore a resizing an amount smaller than size will shrink the vector
 
@@ -60,6 +103,7 @@ public:
         }
         
         m_size = new_size;
+        maybe_shrink();
     }
 
     /**
@@ -69,6 +113,7 @@ public:
      *  @return void.
      */
     void resize(const std::size_t new_size, const T& val) {
+        STD2_TRACE_SCOPE("std2::vector::resize", new_size);
 
         // reserve more space if needed
         if (new_size > m_capacity) reallocate(new_size);
@@ -84,6 +129,7 @@ public:
         }
         
         m_size = new_size;
+        maybe_shrink();
     }
 
     /**
@@ -93,11 +139,11 @@ public:
      */
     void push_back(const T& value) {
         if (m_size >= m_capacity) {
-            reallocate(m_capacity * GROWTH_FACTOR); // double the capacity - TODO: use an allcoater to be dynamic
+            reallocate(m_capacity ? m_capacity * GROWTH_FACTOR : INITIAL_CAPACITY); // double the capacity - TODO: use an allcoater to be dynamic
         }
 
         // add element to the end of the vector
-        m_data[m_size] = value;
+        new (&m_data[m_size]) T(value);
         m_size++;
     }
 
@@ -108,11 +154,11 @@ public:
      */
     void push_back(T&& value) {
         if (m_size >= m_capacity) {
-            reallocate(m_capacity * GROWTH_FACTOR); // double the capacity - TODO: use an allcoater to be dynamic
+            reallocate(m_capacity ? m_capacity * GROWTH_FACTOR : INITIAL_CAPACITY); // double the capacity - TODO: use an allcoater to be dynamic
         }
 
         // add element to the end of the vector
-        m_data[m_size] = std2::move(value);
+        new (&m_data[m_size]) T(std2::move(value));
         m_size++;
     }
 
@@ -124,12 +170,13 @@ public:
     template <typename... Args> //variadic template
     T& emplace_back(Args&&... args) {
         if (m_size >= m_capacity) {
-            reallocate(m_capacity * GROWTH_FACTOR); // double the capacity - TODO: use an allcoater to be dynamic
+            reallocate(m_capacity ? m_capacity * GROWTH_FACTOR : INITIAL_CAPACITY); // double the capacity - TODO: use an allcoater to be dynamic
         }
 
-        // add element to the end of the vector
-        m_data[m_size] = T(std2::forward<Args>(args)...);
-        return m_data[m_size++];
+        // construct the element in place at the end of the vector
+        T* slot = new (&m_data[m_size]) T(std2::forward<Args>(args)...);
+        m_size++;
+        return *slot;
     }
 
     /**
@@ -140,6 +187,7 @@ public:
         if (m_size > 0) {
             m_size--;
             m_data[m_size].~T(); // call destructor explicitly
+            maybe_shrink();
         }
     }
 
@@ -148,10 +196,41 @@ public:
      *  @return void.
      */
     void clear() {
+        STD2_TRACE_SCOPE_IF(m_size >= trace::LARGE_CLEAR_THRESHOLD, "std2::vector::clear", m_size);
         for (size_t i = 0; i < m_size; ++i) {
             m_data[i].~T(); // call destructor explicitly
         }
         m_size = 0;
+        maybe_shrink();
+    }
+
+    /**
+     *  @brief  Release unused capacity, keeping room for the current elements.
+     *  @return the number of bytes released.
+     */
+    std::size_t shrink_to_fit() {
+        const std::size_t target = m_size > INITIAL_CAPACITY ? m_size : INITIAL_CAPACITY;
+        if (m_capacity <= target) return 0;
+        const std::size_t released = (m_capacity - target) * sizeof(T);
+        reallocate(target);
+        return released;
+    }
+
+    /**
+     *  @brief  Opt in to giving capacity back as elements are removed.
+     *  Capacity is halved once the size falls to a quarter of it, leaving the
+     *  vector half full, so a size hovering around a boundary cannot make it
+     *  alternate between growing and shrinking.
+     *  @param  enabled  Whether pop_back, resize and clear may shrink.
+     *  @return void.
+     */
+    void set_auto_shrink(bool enabled) {
+        m_auto_shrink = enabled;
+        maybe_shrink();
+    }
+
+    bool auto_shrink() const {
+        return m_auto_shrink;
     }
 
     /**
@@ -162,6 +241,46 @@ public:
         return m_size;
     }
 
+    /**
+     *  @brief  Get the number of elements that fit before a reallocation.
+     *  @return the capacity of the vector.
+     */
+    std::size_t capacity() const {
+        return m_capacity;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    /**
+     *  @brief  Iterators over the elements, invalidated by any reallocation.
+     *  @return pointer to the first element, or one past the last.
+     */
+    iterator begin() { return m_data; }
+    iterator end() { return m_data + m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+    const_iterator cbegin() const { return m_data; }
+    const_iterator cend() const { return m_data + m_size; }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    /**
+     *  @brief  Direct access to the contiguous storage.
+     *  @return pointer to the first element.
+     */
+    T* data() {
+        return m_data;
+    }
+
+    const T* data() const {
+        return m_data;
+    }
+
     /**
      *  @brief  Index operator - access element at the given index.
      *  @param  index  The index of the element to access.
@@ -182,28 +301,51 @@ public:
 
 private:
 
+    /* @brief  Apply the auto shrink policy after elements were removed.
+     * @return void.
+     */
+    void maybe_shrink() {
+        if (!m_auto_shrink) return;
+
+        std::size_t target = m_capacity;
+        while (target > INITIAL_CAPACITY && m_size <= target / SHRINK_THRESHOLD) {
+            target /= GROWTH_FACTOR;
+        }
+        if (target < INITIAL_CAPACITY) target = INITIAL_CAPACITY;
+        if (target < m_capacity) reallocate(target);
+    }
+
     /* @brief  Reallocate the internal storage to a new capacity.
      * @param  new_capacity  The new capacity for the vector.
      * @return void.
      */
     void reallocate(std::size_t new_capacity) {
+        STD2_TRACE_SCOPE("std2::vector::reallocate", new_capacity);
 
-        // reserc
-
-        // TODO: handle reallocation for shrinking
-        if (new_capacity <= m_size) {
+        // shrinking below the size ends the lifetime of the elements that no longer fit
+        for (std::size_t i = new_capacity; i < m_size; ++i) {
+            m_data[i].~T();
+        }
+        if (new_capacity < m_size) {
             m_size = new_capacity;
         }
 
         // allocate a new block of heap memory
         T* new_block = m_alloc.allocate(new_capacity);
 
-        for (std::size_t i = 0; i < m_size; ++i) {
-            new_block[i] = std2::move(m_data[i]);
+        if constexpr (std2::is_trivially_relocatable_v<T>) {
+            // relocating is a byte copy, the old bytes are simply released
+            if (m_size) std::memcpy(static_cast<void*>(new_block), static_cast<const void*>(m_data), m_size * sizeof(T));
+        } else {
+            // move construct into the new block, then end the lifetime of the old elements
+            for (std::size_t i = 0; i < m_size; ++i) {
+                new (&new_block[i]) T(std2::move(m_data[i]));
+                m_data[i].~T();
+            }
         }
 
         // delete[] m_data; // free old memory block
-        m_alloc.deallocate(m_data, m_capacity);
+        if (m_data) m_alloc.deallocate(m_data, m_capacity);
         m_data = new_block;
         m_capacity = new_capacity;
     }
@@ -212,9 +354,11 @@ private:
     std::size_t m_size = 0;
     std::size_t m_capacity = 0;
     Allocator m_alloc;
+    bool m_auto_shrink = false;
 
-    const std::size_t INITIAL_CAPACITY = 4;
-    const std::size_t GROWTH_FACTOR = 2;
+    static constexpr std::size_t INITIAL_CAPACITY = 4;
+    static constexpr std::size_t GROWTH_FACTOR = 2;
+    static constexpr std::size_t SHRINK_THRESHOLD = 4; // auto shrink once size <= capacity / SHRINK_THRESHOLD
 };
 
 } // namespace std2
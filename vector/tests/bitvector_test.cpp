@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/bitvector.hpp"
+#include "../include/vector.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+class BitvectorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    // a random bitvector and its std::vector<bool> reference model
+    static std2::bitvector make_random(std::size_t n, unsigned seed, std::vector<bool>& model) {
+        std::mt19937 rng(seed);
+        std2::bitvector bits;
+        model.clear();
+        for (std::size_t i = 0; i < n; ++i) {
+            const bool b = rng() % 3 == 0;
+            bits.push_back(b);
+            model.push_back(b);
+        }
+        return bits;
+    }
+};
+
+// Test push_back, proxy references and pop_back
+TEST_F(BitvectorTest, ProxyReferences) {
+    std2::bitvector bits(130);
+    EXPECT_EQ(bits.size(), 130);
+    EXPECT_EQ(bits.num_words(), 3);
+    EXPECT_TRUE(bits.none());
+
+    bits[0] = true;
+    bits[64] = true;
+    bits[129] = bits[0];
+    EXPECT_TRUE(bits[129]);
+    EXPECT_TRUE(~bits[1]);
+    bits[64].flip();
+    EXPECT_FALSE(bits[64]);
+    EXPECT_EQ(bits.count(), 2);
+
+    bits.pop_back();
+    EXPECT_EQ(bits.size(), 129);
+    EXPECT_EQ(bits.count(), 1);
+    EXPECT_THROW(bits.at(129), std::out_of_range);
+
+    bits.resize(200, true);
+    EXPECT_EQ(bits.count(), 1 + 71);
+    bits.resize(10);
+    EXPECT_EQ(bits.count(), 1);
+    EXPECT_EQ(bits.num_words(), 1);
+}
+
+// Test range set/reset/flip across word boundaries against a reference model
+TEST_F(BitvectorTest, RangeOperations) {
+    std::mt19937 rng(3);
+    std::vector<bool> model;
+    std2::bitvector bits = make_random(1000, 1, model);
+
+    for (int round = 0; round < 500; ++round) {
+        std::size_t a = rng() % 1001;
+        std::size_t b = rng() % 1001;
+        if (a > b) std::swap(a, b);
+        const int op = round % 3;
+        if (op == 0) bits.set(a, b);
+        else if (op == 1) bits.reset(a, b);
+        else bits.flip(a, b);
+        for (std::size_t i = a; i < b; ++i) model[i] = op == 0 ? true : op == 1 ? false : !model[i];
+
+        for (std::size_t i = 0; i < model.size(); ++i) ASSERT_EQ(bits[i], model[i]) << "round " << round;
+    }
+
+    bits.set();
+    EXPECT_TRUE(bits.all());
+    bits.flip();
+    EXPECT_TRUE(bits.none());
+    EXPECT_THROW(bits.set(0, 1001), std::out_of_range);
+}
+
+// Test popcount and set bit iteration
+TEST_F(BitvectorTest, CountAndFind) {
+    std::vector<bool> model;
+    const std2::bitvector bits = make_random(10007, 5, model);
+
+    std::size_t expected_count = 0;
+    for (bool b : model) expected_count += b;
+    EXPECT_EQ(bits.count(), expected_count);
+
+    std::size_t visited = 0;
+    std::size_t previous = 0;
+    for (std::size_t i = bits.find_first(); i != std2::bitvector::npos; i = bits.find_next(i)) {
+        ASSERT_TRUE(model[i]);
+        for (std::size_t j = visited ? previous + 1 : 0; j < i; ++j) ASSERT_FALSE(model[j]);
+        previous = i;
+        ++visited;
+    }
+    EXPECT_EQ(visited, expected_count);
+
+    std2::bitvector empty(100);
+    EXPECT_EQ(empty.find_first(), std2::bitvector::npos);
+    empty.set(99);
+    EXPECT_EQ(empty.find_first(), 99);
+    EXPECT_EQ(empty.find_next(99), std2::bitvector::npos);
+}
+
+// Test AND/OR/XOR/ANDNOT
+TEST_F(BitvectorTest, BitwiseOperations) {
+    std::vector<bool> ma, mb;
+    const std2::bitvector a = make_random(777, 7, ma);
+    const std2::bitvector b = make_random(777, 8, mb);
+
+    const std2::bitvector both = a & b;
+    const std2::bitvector either = a | b;
+    const std2::bitvector differ = a ^ b;
+    std2::bitvector only_a = a;
+    only_a.and_not(b);
+
+    for (std::size_t i = 0; i < ma.size(); ++i) {
+        ASSERT_EQ(both[i], ma[i] && mb[i]);
+        ASSERT_EQ(either[i], ma[i] || mb[i]);
+        ASSERT_EQ(differ[i], ma[i] != mb[i]);
+        ASSERT_EQ(only_a[i], ma[i] && !mb[i]);
+    }
+    EXPECT_EQ(both.count() + differ.count(), either.count());
+    EXPECT_FALSE(a == b);
+    EXPECT_TRUE((a ^ a).none());
+
+    std2::bitvector shorter(10);
+    EXPECT_THROW(shorter &= a, std::invalid_argument);
+}
+
+// Test rank and select against a linear scan
+TEST_F(BitvectorTest, RankSelect) {
+    std::vector<bool> model;
+    const std2::bitvector bits = make_random(5000, 9, model);
+    const std2::rank_select_index index(bits);
+
+    std::size_t rank = 0;
+    for (std::size_t i = 0; i <= model.size(); ++i) {
+        ASSERT_EQ(index.rank1(i), rank) << i;
+        ASSERT_EQ(index.rank0(i), i - rank);
+        if (i < model.size() && model[i]) {
+            ASSERT_EQ(index.select1(rank), i);
+            ++rank;
+        }
+    }
+    EXPECT_EQ(index.ones(), rank);
+    EXPECT_EQ(index.select1(rank), std2::bitvector::npos);
+}
+
+// Throughput in bits per nanosecond, with std2::vector<bool> (a byte per flag) as the baseline
+TEST_F(BitvectorTest, PerformanceBenchmark) {
+    const std::size_t n = std::size_t(1) << 28;
+    const int passes = 4;
+
+    std2::bitvector a(n);
+    std2::bitvector b(n);
+    std::mt19937_64 rng(11);
+    for (std::size_t w = 0; w < a.num_words(); ++w) {
+        a.data()[w] = rng();
+        b.data()[w] = rng();
+    }
+
+    auto report = [n](const char* name, auto&& fn) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int p = 0; p < passes; ++p) fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        std::cout << name << ": " << (static_cast<double>(n) * passes / ns) << " bits/ns\n";
+    };
+
+    std::size_t total = 0;
+    report("std2::bitvector count      ", [&] { total += a.count(); });
+    report("std2::bitvector and        ", [&] { a &= b; });
+    report("std2::bitvector xor        ", [&] { a ^= b; });
+    report("std2::bitvector set range  ", [&] { a.set(3, n - 3); });
+    report("std2::bitvector find_next  ", [&] {
+        std2::bitvector sparse(n);
+        for (std::size_t i = 0; i < n; i += 4099) sparse.set(i);
+        for (std::size_t i = sparse.find_first(); i != std2::bitvector::npos; i = sparse.find_next(i)) ++total;
+    });
+
+    const std::size_t small = n / 16;
+    std2::vector<bool> bytes;
+    bytes.resize(small);
+    for (std::size_t i = 0; i < small; ++i) bytes[i] = rng() & 1;
+    auto start = std::chrono::high_resolution_clock::now();
+    std::size_t byte_total = 0;
+    for (std::size_t i = 0; i < small; ++i) byte_total += bytes[i];
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "std2::vector<bool> count   : "
+              << (static_cast<double>(small) / std::chrono::duration<double, std::nano>(end - start).count())
+              << " bits/ns\n";
+
+    const std2::rank_select_index index(a);
+    start = std::chrono::high_resolution_clock::now();
+    std::size_t sink = 0;
+    for (std::size_t i = 0; i < 1000000; ++i) sink += index.rank1(rng() % n);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "rank1: " << std::chrono::duration<double, std::nano>(end - start).count() / 1000000 << " ns/op\n";
+
+    EXPECT_GT(total + byte_total + sink, 0);
+}
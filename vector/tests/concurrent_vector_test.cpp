@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/concurrent_vector.hpp"
+#include "../include/vector.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ConcurrentVectorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+// Test single threaded use across many segments
+TEST_F(ConcurrentVectorTest, SingleThreaded) {
+    std2::concurrent_vector<std::string> vec;
+    EXPECT_TRUE(vec.empty());
+    for (int i = 0; i < 5000; ++i) vec.push_back(std::to_string(i));
+
+    ASSERT_EQ(vec.size(), 5000);
+    for (int i = 0; i < 5000; ++i) ASSERT_EQ(vec[i], std::to_string(i));
+    EXPECT_GE(vec.capacity(), 5000);
+    EXPECT_THROW(vec.at(5000), std::out_of_range);
+
+    const std::size_t first = vec.grow_by(100, std::string("x"));
+    EXPECT_EQ(first, 5000);
+    EXPECT_EQ(vec[5099], "x");
+    EXPECT_EQ(vec.size(), 5100);
+
+    vec.clear();
+    EXPECT_TRUE(vec.empty());
+    vec.emplace_back(3, 'y');
+    EXPECT_EQ(vec[0], "yyy");
+}
+
+// Test element addresses never change while the vector grows
+TEST_F(ConcurrentVectorTest, StableAddresses) {
+    std2::concurrent_vector<int> vec;
+    std::vector<int*> addresses;
+    for (int i = 0; i < 100000; ++i) addresses.push_back(&vec.push_back(i));
+    for (int i = 0; i < 100000; ++i) {
+        ASSERT_EQ(&vec[i], addresses[i]);
+        ASSERT_EQ(*addresses[i], i);
+    }
+
+    vec.reserve(1000000);
+    EXPECT_GE(vec.capacity(), 1000000);
+    EXPECT_EQ(&vec[50000], addresses[50000]);
+}
+
+// element that counts live instances and throws from its constructor on request
+struct Fragile {
+    static inline int live = 0;
+    static inline int throw_after = -1;
+    int value;
+    Fragile(int v = 0) : value(v) {
+        if (throw_after == 0) throw std::runtime_error("construct");
+        if (throw_after > 0) --throw_after;
+        ++live;
+    }
+    Fragile(const Fragile& other) : Fragile(other.value) {}
+    ~Fragile() { --live; }
+};
+
+// Test slots whose construction threw are not destroyed as if they held elements
+TEST_F(ConcurrentVectorTest, ThrowingConstruction) {
+    {
+        std2::concurrent_vector<Fragile> vec;
+        for (int i = 0; i < 10; ++i) vec.emplace_back(i);
+
+        Fragile::throw_after = 0;
+        EXPECT_THROW(vec.emplace_back(10), std::runtime_error);
+        Fragile::throw_after = 20;
+        EXPECT_THROW(vec.grow_by(50), std::runtime_error);
+        Fragile::throw_after = -1;
+        EXPECT_EQ(Fragile::live, 10);
+
+        // the failed slots stay claimed, appends carry on after them
+        EXPECT_EQ(vec.size(), 61);
+        EXPECT_EQ(vec.push_back(Fragile(61)).value, 61);
+        EXPECT_EQ(vec.grow_by(5, Fragile(7)), 62);
+        EXPECT_EQ(vec[66].value, 7);
+        EXPECT_EQ(Fragile::live, 16);
+
+        vec.clear();
+        EXPECT_EQ(Fragile::live, 0);
+        vec.emplace_back(1);
+        Fragile::throw_after = 0;
+        EXPECT_THROW(vec.emplace_back(2), std::runtime_error);
+        Fragile::throw_after = -1;
+    }
+    EXPECT_EQ(Fragile::live, 0);
+}
+
+// Test concurrent push_back and grow_by from many threads: every value lands exactly once
+TEST_F(ConcurrentVectorTest, ConcurrentAppend) {
+    std2::concurrent_vector<int> vec;
+    const int threads = 8;
+    const int per_thread = 20000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&vec, t] {
+            for (int i = 0; i < per_thread; i += 100) {
+                if (i % 200 == 0) {
+                    for (int j = 0; j < 100; ++j) vec.push_back(t * per_thread + i + j);
+                } else {
+                    const std::size_t first = vec.grow_by(100);
+                    for (int j = 0; j < 100; ++j) vec[first + j] = t * per_thread + i + j;
+                }
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    ASSERT_EQ(vec.size(), static_cast<std::size_t>(threads * per_thread));
+    std::vector<int> seen(threads * per_thread, 0);
+    for (std::size_t i = 0; i < vec.size(); ++i) ++seen[vec[i]];
+    for (int count : seen) ASSERT_EQ(count, 1);
+}
+
+// Test readers see published elements while writers keep growing the vector
+TEST_F(ConcurrentVectorTest, ReadersDuringGrowth) {
+    std2::concurrent_vector<std::size_t> vec;
+    std::atomic<std::size_t> published{0};
+    std::atomic<bool> done{false};
+    const std::size_t n = 200000;
+
+    std::thread writer([&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            vec.push_back(i * 3);
+            published.store(i + 1, std::memory_order_release);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    std::vector<std::thread> readers;
+    std::atomic<bool> ok{true};
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire)) {
+                const std::size_t visible = published.load(std::memory_order_acquire);
+                if (visible == 0) continue;
+                const std::size_t i = visible - 1;
+                if (vec[i] != i * 3 || vec[i / 2] != (i / 2) * 3) ok.store(false);
+            }
+        });
+    }
+
+    writer.join();
+    for (auto& r : readers) r.join();
+    EXPECT_TRUE(ok.load());
+}
+
+// Multi-threaded append scaling against a mutex protected std2::vector
+TEST_F(ConcurrentVectorTest, PerformanceBenchmark) {
+    const std::size_t total = 8000000;
+    const std::size_t max_threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+    auto run = [](std::size_t threads, auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) workers.emplace_back(body, t);
+        for (auto& w : workers) w.join();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+
+    for (std::size_t threads = 1; threads <= max_threads * 2; threads *= 2) {
+        const std::size_t per_thread = total / threads;
+
+        std2::vector<std::size_t> locked;
+        std::mutex lock;
+        const auto locked_time = run(threads, [&](std::size_t t) {
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                std::lock_guard<std::mutex> guard(lock);
+                locked.push_back(t + i);
+            }
+        });
+
+        std2::concurrent_vector<std::size_t> pushed;
+        const auto push_time = run(threads, [&](std::size_t t) {
+            for (std::size_t i = 0; i < per_thread; ++i) pushed.push_back(t + i);
+        });
+
+        std2::concurrent_vector<std::size_t> batched;
+        const auto batch_time = run(threads, [&](std::size_t t) {
+            for (std::size_t i = 0; i < per_thread; i += 256) {
+                const std::size_t first = batched.grow_by(256);
+                for (std::size_t j = 0; j < 256; ++j) batched[first + j] = t + i + j;
+            }
+        });
+
+        std::cout << threads << " threads: mutex + std2::vector " << locked_time
+                  << " us, concurrent_vector::push_back " << push_time
+                  << " us, concurrent_vector::grow_by(256) " << batch_time << " us\n";
+
+        EXPECT_EQ(locked.size(), pushed.size());
+    }
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/mapped_vector.hpp"
+#include "../include/vector.hpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+struct Entry {
+    std::uint64_t key;
+    double value;
+};
+
+class MappedVectorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = (std::filesystem::temp_directory_path() /
+                ("std2_mapped_vector_" + std::to_string(::getpid()) + ".bin")).string();
+        std::filesystem::remove(path);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    std::string path;
+};
+
+// Test creating a new file and reading it back after reopening
+TEST_F(MappedVectorTest, PersistsAcrossReopen) {
+    {
+        std2::mapped_vector<int> vals(path);
+        EXPECT_EQ(vals.size(), 0);
+        for (int i = 0; i < 1000; ++i) vals.push_back(i * 3);
+        vals.flush();
+    }
+
+    std2::mapped_vector<int> vals(path);
+    EXPECT_EQ(vals.size(), 1000);
+    EXPECT_GE(vals.capacity(), 1000);
+    EXPECT_EQ(vals[999], 2997);
+
+    vals.push_back(1);
+    EXPECT_EQ(vals.size(), 1001);
+}
+
+// Test resize, pop_back and clear
+TEST_F(MappedVectorTest, ResizePopClear) {
+    std2::mapped_vector<Entry> vals(path);
+    vals.resize(10, Entry{7, 1.5});
+    EXPECT_EQ(vals.size(), 10);
+    EXPECT_EQ(vals[9].key, 7);
+
+    vals.resize(3);
+    EXPECT_EQ(vals.size(), 3);
+    vals.resize(5);
+    EXPECT_EQ(vals[4].key, 0);
+
+    vals.pop_back();
+    EXPECT_EQ(vals.size(), 4);
+
+    vals.clear();
+    EXPECT_TRUE(vals.empty());
+}
+
+// Test read only mode shares the data and rejects writes
+TEST_F(MappedVectorTest, ReadOnlyMode) {
+    {
+        std2::mapped_vector<int> vals(path);
+        vals.resize(100, 42);
+    }
+
+    std2::mapped_vector<int> reader1(path, std2::mapped_vector<int>::mode::read_only);
+    std2::mapped_vector<int> reader2(path, std2::mapped_vector<int>::mode::read_only);
+    EXPECT_TRUE(reader1.read_only());
+    EXPECT_EQ(reader1.size(), 100);
+    EXPECT_EQ(reader2[50], 42);
+    EXPECT_THROW(reader1.push_back(1), std::logic_error);
+
+    // a writer growing the shared file past the readers' mappings does not make them read past the end
+    std2::mapped_vector<int> writer(path);
+    for (int i = 0; i < 10000; ++i) writer.push_back(i);
+    EXPECT_EQ(reader1.capacity(), 100);
+    EXPECT_EQ(reader1.size(), 100);
+    EXPECT_EQ(reader2[99], 42);
+
+    std2::mapped_vector<int> reader3(path, std2::mapped_vector<int>::mode::read_only);
+    EXPECT_EQ(reader3.size(), 10100);
+}
+
+// Test a failed grow leaves the vector as it was
+TEST_F(MappedVectorTest, FailedGrowKeepsMapping) {
+    std2::mapped_vector<int> vals(path);
+    for (int i = 0; i < 100; ++i) vals.push_back(i);
+
+    EXPECT_THROW(vals.reserve(std::size_t(1) << 58), std::system_error);
+    EXPECT_THROW(vals.reserve(SIZE_MAX / 2), std::length_error);
+    EXPECT_EQ(vals.size(), 100);
+    EXPECT_EQ(vals[99], 99);
+    vals.push_back(100);
+    EXPECT_EQ(vals[100], 100);
+    EXPECT_EQ(std::filesystem::file_size(path), 64 + vals.capacity() * sizeof(int));
+}
+
+// Test files written for another element type are rejected
+TEST_F(MappedVectorTest, RejectsMismatchedFile) {
+    {
+        std2::mapped_vector<int> vals(path);
+        vals.push_back(1);
+    }
+    EXPECT_THROW(std2::mapped_vector<Entry> entries(path), std::runtime_error);
+    EXPECT_THROW(std2::mapped_vector<int> missing(path + ".missing", std2::mapped_vector<int>::mode::read_only),
+                 std::system_error);
+}
+
+// Test corrupted size and capacity fields in the header are rejected on open
+TEST_F(MappedVectorTest, RejectsCorruptedHeader) {
+    // header layout: magic, version, element size, then size at byte 16 and capacity at byte 24
+    auto write_field = [this](std::streamoff offset, std::uint64_t value) {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    auto reset = [this] {
+        std::filesystem::remove(path);
+        std2::mapped_vector<int> vals(path);
+        for (int i = 0; i < 10; ++i) vals.push_back(i);
+    };
+    using mode = std2::mapped_vector<int>::mode;
+
+    reset();
+    write_field(16, 1000); // size past capacity
+    EXPECT_THROW(std2::mapped_vector<int> vals(path), std::runtime_error);
+    EXPECT_THROW(std2::mapped_vector<int> vals(path, mode::read_only), std::runtime_error);
+
+    reset();
+    // 64 + capacity * 4 wraps around to a small file size
+    write_field(24, (std::uint64_t(1) << 62) + 4);
+    EXPECT_THROW(std2::mapped_vector<int> vals(path), std::runtime_error);
+    EXPECT_THROW(std2::mapped_vector<int> vals(path, mode::read_only), std::runtime_error);
+
+    reset();
+    write_field(24, 1000); // larger than the file
+    EXPECT_THROW(std2::mapped_vector<int> vals(path), std::runtime_error);
+
+    reset();
+    std2::mapped_vector<int> vals(path);
+    EXPECT_EQ(vals.size(), 10);
+    EXPECT_EQ(vals[9], 9);
+}
+
+// Startup benchmark: open a mapped table vs. rebuilding a std2::vector from disk
+TEST_F(MappedVectorTest, PerformanceBenchmark) {
+    const std::size_t count = 4000000;
+    const std::string raw_path = path + ".raw";
+    {
+        std2::mapped_vector<Entry> table(path);
+        table.reserve(count);
+        std::FILE* raw = std::fopen(raw_path.c_str(), "wb");
+        for (std::size_t i = 0; i < count; ++i) {
+            Entry e{i, static_cast<double>(i) * 0.5};
+            table.push_back(e);
+            std::fwrite(&e, sizeof(e), 1, raw);
+        }
+        std::fclose(raw);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std2::vector<Entry> rebuilt;
+    {
+        std::FILE* raw = std::fopen(raw_path.c_str(), "rb");
+        Entry e;
+        while (std::fread(&e, sizeof(e), 1, raw) == 1) rebuilt.push_back(e);
+        std::fclose(raw);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "std2::vector rebuild from disk: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " microseconds\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    std2::mapped_vector<Entry> mapped(path, std2::mapped_vector<Entry>::mode::read_only);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "std2::mapped_vector open: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " microseconds\n";
+
+    EXPECT_EQ(mapped.size(), rebuilt.size());
+    EXPECT_EQ(mapped[count - 1].key, rebuilt[count - 1].key);
+    std::filesystem::remove(raw_path);
+}
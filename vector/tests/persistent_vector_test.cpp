@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/persistent_vector.hpp"
+#include "../include/vector.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+class PersistentVectorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+
+    template <typename T>
+    static void expect_equal(const std2::persistent_vector<T>& actual, const std::vector<T>& expected) {
+        ASSERT_EQ(actual.size(), expected.size());
+        std::size_t i = 0;
+        for (const T& value : actual) {
+            ASSERT_EQ(value, expected[i]) << "index " << i;
+            ASSERT_EQ(actual[i], expected[i]) << "index " << i;
+            ++i;
+        }
+        ASSERT_EQ(i, expected.size());
+    }
+};
+
+// Test push_back and pop_back across several trie levels
+TEST_F(PersistentVectorTest, PushPopAcrossLevels) {
+    std2::persistent_vector<int> vec;
+    std::vector<int> model;
+    const int n = 32 * 32 * 32 + 100; // forces a three level trie
+    for (int i = 0; i < n; ++i) {
+        vec.push_back(i);
+        model.push_back(i);
+    }
+    expect_equal(vec, model);
+    EXPECT_EQ(vec.front(), 0);
+    EXPECT_EQ(vec.back(), n - 1);
+    EXPECT_THROW(vec.at(n), std::out_of_range);
+
+    while (!model.empty()) {
+        vec.pop_back();
+        model.pop_back();
+        if (model.size() % 997 == 0) expect_equal(vec, model);
+    }
+    EXPECT_TRUE(vec.empty());
+    vec.push_back(7);
+    EXPECT_EQ(vec[0], 7);
+}
+
+// Test snapshots are unaffected by later edits to either copy
+TEST_F(PersistentVectorTest, SnapshotsAreIndependent) {
+    std2::persistent_vector<std::string> vec;
+    std::vector<std::string> model;
+    for (int i = 0; i < 5000; ++i) {
+        vec.push_back(std::to_string(i));
+        model.push_back(std::to_string(i));
+    }
+
+    std::mt19937 rng(42);
+    std::vector<std2::persistent_vector<std::string>> snapshots;
+    std::vector<std::vector<std::string>> models;
+    for (int round = 0; round < 200; ++round) {
+        snapshots.push_back(vec);
+        models.push_back(model);
+
+        const int op = rng() % 4;
+        if (op == 0 && !model.empty()) {
+            vec.pop_back();
+            model.pop_back();
+        } else if (op == 1) {
+            vec.push_back("pushed" + std::to_string(round));
+            model.push_back("pushed" + std::to_string(round));
+        } else if (!model.empty()) {
+            const std::size_t index = rng() % model.size();
+            vec.set(index, "set" + std::to_string(round));
+            model[index] = "set" + std::to_string(round);
+        }
+    }
+
+    expect_equal(vec, model);
+    for (std::size_t s = 0; s < snapshots.size(); s += 17) expect_equal(snapshots[s], models[s]);
+
+    // editing an old snapshot leaves the newer ones alone
+    snapshots[0].set(0, "old");
+    EXPECT_EQ(snapshots[1][0], models[1][0]);
+}
+
+// Test the transient builder for batch edits
+TEST_F(PersistentVectorTest, TransientBuilder) {
+    std2::persistent_vector<int> base;
+    for (int i = 0; i < 3000; ++i) base.push_back(i);
+
+    auto builder = base.transient();
+    for (int i = 0; i < 3000; ++i) builder.set(i, i * 2);
+    for (int i = 0; i < 100; ++i) builder.push_back(-i);
+    builder.pop_back();
+    EXPECT_EQ(builder.size(), 3099);
+    EXPECT_EQ(builder[10], 20);
+
+    const std2::persistent_vector<int> built = builder.persistent();
+    EXPECT_EQ(built.size(), 3099);
+    EXPECT_EQ(built[2999], 5998);
+    EXPECT_EQ(built[3098], -98);
+
+    // the source is untouched
+    ASSERT_EQ(base.size(), 3000);
+    for (int i = 0; i < 3000; ++i) ASSERT_EQ(base[i], i);
+
+    // the result behaves as an ordinary persistent vector
+    std2::persistent_vector<int> copy = built;
+    copy.set(0, 99);
+    EXPECT_EQ(built[0], 0);
+}
+
+// Test readers on other threads while the writer keeps editing its copy
+TEST_F(PersistentVectorTest, ConcurrentSnapshotReaders) {
+    std2::persistent_vector<int> vec;
+    for (int i = 0; i < 10000; ++i) vec.push_back(i);
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([snapshot = vec] {
+            long long sum = 0;
+            for (int round = 0; round < 20; ++round) {
+                for (int v : snapshot) sum += v;
+            }
+            EXPECT_EQ(sum, 20LL * 10000 * 9999 / 2);
+        });
+    }
+    for (int i = 0; i < 10000; ++i) vec.set(i, -1);
+    for (auto& r : readers) r.join();
+    EXPECT_EQ(vec[5000], -1);
+}
+
+// Snapshot, point update and iteration cost against copying std2::vector
+TEST_F(PersistentVectorTest, PerformanceBenchmark) {
+    const std::size_t n = 1000000;
+    const int snapshots = 100;
+
+    std2::vector<int> flat;
+    auto builder = std2::persistent_vector<int>().transient();
+    for (std::size_t i = 0; i < n; ++i) {
+        flat.push_back(static_cast<int>(i));
+        builder.push_back(static_cast<int>(i));
+    }
+    std2::persistent_vector<int> persistent = builder.persistent();
+
+    auto time = [](auto&& fn) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+
+    // snapshot then edit one element, the typical reader/writer pattern
+    std::cout << "std2::vector copy + update x" << snapshots << ":            " << time([&] {
+        for (int s = 0; s < snapshots; ++s) {
+            std2::vector<int> snapshot = flat;
+            flat[s] = -s;
+        }
+    }) << " microseconds\n";
+
+    std::vector<std2::persistent_vector<int>> kept;
+    std::cout << "std2::persistent_vector snapshot + update x" << snapshots << ": " << time([&] {
+        for (int s = 0; s < snapshots; ++s) {
+            kept.push_back(persistent);
+            persistent.set(s, -s);
+        }
+    }) << " microseconds\n";
+
+    std::mt19937 rng(3);
+    std::cout << "std2::persistent_vector 1M point updates (unshared): " << time([&] {
+        for (std::size_t i = 0; i < 1000000; ++i) persistent.set(rng() % n, static_cast<int>(i));
+    }) << " microseconds\n";
+
+    long long flat_sum = 0;
+    long long persistent_sum = 0;
+    std::cout << "std2::vector iteration:            " << time([&] {
+        for (std::size_t i = 0; i < flat.size(); ++i) flat_sum += flat[i];
+    }) << " microseconds\n";
+    std::cout << "std2::persistent_vector iteration: " << time([&] {
+        for (int v : kept.back()) persistent_sum += v;
+    }) << " microseconds\n";
+
+    EXPECT_EQ(kept.back()[snapshots - 2], -(snapshots - 2));
+    EXPECT_NE(flat_sum + persistent_sum, 0);
+}
@@ -0,0 +1,297 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../include/soa_vector.hpp"
+#include "../include/vector.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <version>
+
+struct Trade {
+    double price;
+    std::int32_t quantity;
+    std::int32_t venue;
+    std::uint64_t id;
+    std::uint64_t timestamp;
+    char symbol[24];
+};
+
+class SoaVectorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code if needed
+    }
+
+    void TearDown() override {
+        // Cleanup code if needed
+    }
+};
+
+// Test push_back, emplace_back and row access
+TEST_F(SoaVectorTest, PushAndIndex) {
+    std2::soa_vector<int, double, std::string> rows;
+    EXPECT_TRUE(rows.empty());
+
+    rows.push_back(1, 1.5, std::string("one"));
+    rows.push_back(std::make_tuple(2, 2.5, std::string("two")));
+    rows.emplace_back(3, 3.5, "three");
+
+    ASSERT_EQ(rows.size(), 3);
+    EXPECT_EQ(std::get<0>(rows[1]), 2);
+    EXPECT_EQ(std::get<1>(rows[2]), 3.5);
+    EXPECT_EQ(std::get<2>(rows[0]), "one");
+
+    // proxy references write through to the columns
+    std::get<0>(rows[0]) = 10;
+    EXPECT_EQ(rows.get<0>()[0], 10);
+
+    rows.pop_back();
+    EXPECT_EQ(rows.size(), 2);
+    EXPECT_EQ(std::get<2>(rows[1]), "two");
+}
+
+// Test columns stay aligned and consistent across growth
+TEST_F(SoaVectorTest, ColumnsAlignedAcrossGrowth) {
+    std2::soa_vector<char, double, std::uint16_t> rows;
+    for (int i = 0; i < 1000; ++i) {
+        rows.push_back(static_cast<char>(i % 128), i * 0.5, static_cast<std::uint16_t>(i));
+
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(rows.get<0>().data()) % rows.COLUMN_ALIGNMENT, 0);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(rows.get<1>().data()) % rows.COLUMN_ALIGNMENT, 0);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(rows.get<2>().data()) % rows.COLUMN_ALIGNMENT, 0);
+    }
+    EXPECT_GE(rows.capacity(), rows.size());
+
+    auto halves = rows.get<1>();
+    auto ids = rows.get<2>();
+    ASSERT_EQ(halves.size(), 1000);
+    for (std::size_t i = 0; i < halves.size(); ++i) {
+        ASSERT_EQ(halves[i], i * 0.5);
+        ASSERT_EQ(ids[i], i);
+    }
+
+    // a column aligned beyond COLUMN_ALIGNMENT raises the alignment of the whole block
+    struct alignas(256) page {
+        int value;
+    };
+    std2::soa_vector<char, page> wide;
+    for (int i = 0; i < 100; ++i) {
+        wide.push_back(static_cast<char>(i), page{i});
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(wide.get<1>().data()) % alignof(page), 0);
+    }
+    EXPECT_EQ(wide.get<1>()[99].value, 99);
+}
+
+// Test iteration with structured bindings through proxy references
+TEST_F(SoaVectorTest, ProxyIteration) {
+    static_assert(std::random_access_iterator<std2::soa_vector<int, int>::iterator>);
+#if defined(__cpp_lib_ranges_zip)
+    // const proxy references need the C++23 pair/tuple common_reference specializations
+    static_assert(std::random_access_iterator<std2::soa_vector<int, int>::const_iterator>);
+#endif
+
+    std2::soa_vector<int, int> rows;
+    for (int i = 0; i < 10; ++i) rows.push_back(i, 0);
+
+    for (auto [a, b] : rows) b = a * a;
+
+    const auto& view = rows;
+    int expected = 0;
+    for (auto [a, b] : view) {
+        EXPECT_EQ(b, a * a);
+        ++expected;
+    }
+    EXPECT_EQ(expected, 10);
+    EXPECT_EQ(rows.end() - rows.begin(), 10);
+    EXPECT_EQ(std::get<1>(rows.begin()[3]), 9);
+    EXPECT_EQ(std::get<1>(*(4 + rows.begin())), 16);
+}
+
+// Test copy, move and resize with non trivial columns
+TEST_F(SoaVectorTest, CopyMoveResize) {
+    std2::soa_vector<std::unique_ptr<int>, std::string> owned;
+    owned.emplace_back(std::make_unique<int>(7), "seven");
+    owned.resize(5);
+    EXPECT_EQ(owned.size(), 5);
+    EXPECT_EQ(*owned.get<0>()[0], 7);
+    EXPECT_EQ(owned.get<0>()[4], nullptr);
+
+    std2::soa_vector<std::unique_ptr<int>, std::string> moved = std2::move(owned);
+    EXPECT_EQ(owned.size(), 0);
+    EXPECT_EQ(moved.get<1>()[0], "seven");
+
+    std2::soa_vector<int, std::string> a;
+    a.push_back(1, std::string("a"));
+    a.push_back(2, std::string("b"));
+    std2::soa_vector<int, std::string> b = a;
+    std::get<1>(b[0]) = "changed";
+    EXPECT_EQ(a.get<1>()[0], "a");
+    EXPECT_EQ(b.get<0>()[1], 2);
+
+    b.resize(1);
+    EXPECT_EQ(b.size(), 1);
+    b.clear();
+    EXPECT_TRUE(b.empty());
+}
+
+// Test appending a row built from the vector's own elements while it grows
+TEST_F(SoaVectorTest, PushOwnRowAtCapacity) {
+    std2::soa_vector<int, std::string> rows;
+    rows.push_back(1, std::string("a long enough string to live on the heap"));
+    while (rows.size() < rows.capacity()) rows.push_back(2, std::string("filler"));
+
+    rows.push_back(std::get<0>(rows[0]), std::get<1>(rows[0]));
+    EXPECT_EQ(rows.get<0>().back(), 1);
+    EXPECT_EQ(rows.get<1>().back(), "a long enough string to live on the heap");
+
+    while (rows.size() < rows.capacity()) rows.push_back(3, std::string("filler"));
+    rows.push_back(rows[0]);
+    EXPECT_EQ(rows.get<0>().back(), 1);
+    EXPECT_EQ(rows.get<1>().back(), rows.get<1>()[0]);
+}
+
+// column value that counts live instances and throws from its constructor on request
+struct Counted {
+    static inline int live = 0;
+    static inline bool fail = false;
+
+    Counted() { ++live; }
+    explicit Counted(int) {
+        if (fail) throw std::runtime_error("construct");
+        ++live;
+    }
+    Counted(const Counted&) { ++live; }
+    Counted(Counted&&) noexcept { ++live; }
+    ~Counted() { --live; }
+};
+
+// Test a throwing column constructor destroys the columns already built
+TEST_F(SoaVectorTest, ThrowingColumnRollsBack) {
+    {
+        std2::soa_vector<Counted, Counted> rows;
+        rows.emplace_back(0, 0);
+        EXPECT_EQ(Counted::live, 2);
+
+        // second column throws with room left
+        Counted::fail = true;
+        EXPECT_THROW(rows.emplace_back(Counted(), 0), std::runtime_error);
+        Counted::fail = false;
+        EXPECT_EQ(Counted::live, 2);
+
+        // and while growing, the old block stays in use
+        while (rows.size() < rows.capacity()) rows.emplace_back(0, 0);
+        const std::size_t full = rows.size();
+        const std::size_t capacity = rows.capacity();
+        Counted::fail = true;
+        EXPECT_THROW(rows.emplace_back(Counted(), 0), std::runtime_error);
+        Counted::fail = false;
+        EXPECT_EQ(Counted::live, static_cast<int>(2 * full));
+        EXPECT_EQ(rows.size(), full);
+        EXPECT_EQ(rows.capacity(), capacity);
+
+        rows.emplace_back(0, 0);
+        EXPECT_EQ(Counted::live, static_cast<int>(2 * full + 2));
+    }
+    EXPECT_EQ(Counted::live, 0);
+}
+
+// column value whose move may throw, so growth copies it, and whose copy throws on request
+struct CopyOnGrow {
+    static inline int live = 0;
+    static inline int copies_left = -1;
+
+    int value;
+    explicit CopyOnGrow(int v) : value(v) { ++live; }
+    CopyOnGrow(const CopyOnGrow& other) : value(other.value) {
+        if (copies_left == 0) throw std::runtime_error("copy");
+        if (copies_left > 0) --copies_left;
+        ++live;
+    }
+    CopyOnGrow(CopyOnGrow&& other) : value(other.value) { ++live; }
+    ~CopyOnGrow() { --live; }
+};
+
+// Test growth copies columns with a throwing move and keeps the old rows when a copy throws
+TEST_F(SoaVectorTest, ThrowingGrowthKeepsOldRows) {
+    {
+        std2::soa_vector<std::string, CopyOnGrow> rows;
+        rows.emplace_back(std::string(40, 'x'), 0);
+        while (rows.size() < rows.capacity()) rows.emplace_back(std::string(40, 'x'), static_cast<int>(rows.size()));
+        const std::size_t full = rows.size();
+        const std::size_t capacity = rows.capacity();
+
+        // the second column throws half way through, after the first one was fully built
+        CopyOnGrow::copies_left = static_cast<int>(full / 2);
+        EXPECT_THROW(rows.emplace_back(std::string("new"), 99), std::runtime_error);
+        EXPECT_THROW(rows.reserve(capacity * 4), std::runtime_error);
+        CopyOnGrow::copies_left = -1;
+
+        EXPECT_EQ(CopyOnGrow::live, static_cast<int>(full));
+        ASSERT_EQ(rows.size(), full);
+        EXPECT_EQ(rows.capacity(), capacity);
+        for (std::size_t i = 0; i < full; ++i) {
+            EXPECT_EQ(rows.get<0>()[i], std::string(40, 'x'));
+            EXPECT_EQ(rows.get<1>()[i].value, static_cast<int>(i));
+        }
+
+        rows.emplace_back(std::string("new"), 99);
+        EXPECT_EQ(rows.get<1>().back().value, 99);
+        EXPECT_EQ(CopyOnGrow::live, static_cast<int>(full + 1));
+    }
+    EXPECT_EQ(CopyOnGrow::live, 0);
+}
+
+// Test a capacity whose block size overflows is rejected before allocating
+TEST_F(SoaVectorTest, OversizedCapacityThrows) {
+    std2::soa_vector<double, std::int32_t> rows;
+    rows.push_back(1.0, 1);
+    EXPECT_THROW(rows.reserve(SIZE_MAX / 8), std::bad_array_new_length);
+    EXPECT_THROW(rows.reserve(SIZE_MAX), std::bad_array_new_length);
+    EXPECT_EQ(rows.size(), 1);
+    EXPECT_EQ(std::get<0>(rows[0]), 1.0);
+}
+
+// Column scans: array-of-structs std2::vector vs structure-of-arrays
+TEST_F(SoaVectorTest, PerformanceBenchmark) {
+    const std::size_t n = 2000000;
+    const int passes = 10;
+
+    std2::vector<Trade> aos;
+    aos.reserve(n);
+    std2::soa_vector<double, std::int32_t, std::int32_t, std::uint64_t, std::uint64_t> soa;
+    soa.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        Trade t{};
+        t.price = static_cast<double>(i % 1000) * 0.25;
+        t.quantity = static_cast<std::int32_t>(i % 100);
+        t.id = i;
+        aos.push_back(t);
+        soa.push_back(t.price, t.quantity, t.venue, t.id, t.timestamp);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    double aos_total = 0;
+    for (int p = 0; p < passes; ++p) {
+        for (std::size_t i = 0; i < aos.size(); ++i) aos_total += aos[i].price * aos[i].quantity;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "std2::vector<Trade> price*quantity scan: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " microseconds\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    double soa_total = 0;
+    for (int p = 0; p < passes; ++p) {
+        const auto prices = soa.get<0>();
+        const auto quantities = soa.get<1>();
+        for (std::size_t i = 0; i < prices.size(); ++i) soa_total += prices[i] * quantities[i];
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "std2::soa_vector price*quantity scan: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " microseconds\n";
+
+    EXPECT_DOUBLE_EQ(aos_total, soa_total);
+}
@@ -2,6 +2,9 @@
 #include <gmock/gmock.h>
 #include "../include/vector.hpp"
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 template <typename T>
 void print_vector(const std2::vector<T>& vect) {
@@ -266,3 +269,99 @@ TEST_F(VectorTest, ResizeWithValue) {
         EXPECT_EQ(points[i].z, 1.0f);
     }
 }
+
+TEST_F(VectorTest, ShrinkToFit) {
+    std2::vector<std::string> vec;
+    for (int i = 0; i < 1000; ++i) vec.push_back(std::to_string(i));
+    const std::size_t peak = vec.capacity();
+
+    vec.resize(10);
+    EXPECT_EQ(vec.capacity(), peak); // no policy, capacity is kept
+
+    EXPECT_EQ(vec.shrink_to_fit(), (peak - 10) * sizeof(std::string));
+    EXPECT_EQ(vec.capacity(), 10);
+    EXPECT_EQ(vec.shrink_to_fit(), 0);
+    for (int i = 0; i < 10; ++i) EXPECT_EQ(vec[i], std::to_string(i));
+
+    vec.clear();
+    vec.shrink_to_fit();
+    EXPECT_EQ(vec.capacity(), 4); // never below the initial capacity
+    vec.push_back("again");
+    EXPECT_EQ(vec[0], "again");
+}
+
+TEST_F(VectorTest, AutoShrinkHysteresis) {
+    std2::vector<int> vec;
+    vec.set_auto_shrink(true);
+    for (int i = 0; i < 1024; ++i) vec.push_back(i);
+    EXPECT_EQ(vec.capacity(), 1024);
+
+    // down to half full nothing moves
+    while (vec.size() > 512) vec.pop_back();
+    EXPECT_EQ(vec.capacity(), 1024);
+
+    // at a quarter the capacity halves
+    while (vec.size() > 256) vec.pop_back();
+    EXPECT_EQ(vec.capacity(), 512);
+
+    // bouncing around the boundary does not reallocate again
+    for (int round = 0; round < 100; ++round) {
+        vec.push_back(0);
+        vec.pop_back();
+    }
+    EXPECT_EQ(vec.capacity(), 512);
+    for (int i = 0; i < 256; ++i) ASSERT_EQ(vec[i], i);
+
+    vec.resize(3);
+    EXPECT_EQ(vec.capacity(), 8);
+    vec.clear();
+    EXPECT_EQ(vec.capacity(), 4);
+
+    std2::vector<int> off;
+    for (int i = 0; i < 1024; ++i) off.push_back(i);
+    off.clear();
+    EXPECT_EQ(off.capacity(), 1024);
+    off.set_auto_shrink(true);
+    EXPECT_EQ(off.capacity(), 4);
+}
+
+// allocator counting the allocations made through it
+template <typename T>
+struct counting_allocator : std::allocator<T> {
+    static inline int allocations = 0;
+    template <typename U> struct rebind { using other = counting_allocator<U>; };
+    T* allocate(std::size_t n) {
+        ++allocations;
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+// Test destroying an auto shrinking vector frees its storage without reallocating first
+TEST_F(VectorTest, DestructorDoesNotAllocate) {
+    {
+        std2::vector<std::string, counting_allocator<std::string>> vec;
+        vec.set_auto_shrink(true);
+        for (int i = 0; i < 1024; ++i) vec.push_back(std::string(40, 'x'));
+        counting_allocator<std::string>::allocations = 0;
+    }
+    EXPECT_EQ(counting_allocator<std::string>::allocations, 0);
+}
+
+TEST_F(VectorTest, Iterators) {
+    std2::vector<int> vec;
+    for (int i = 1; i <= 5; ++i) vec.push_back(i);
+
+    int sum = 0;
+    for (int& x : vec) sum += x;
+    EXPECT_EQ(sum, 15);
+    EXPECT_EQ(vec.end() - vec.begin(), 5);
+
+    std::vector<int> reversed(vec.rbegin(), vec.rend());
+    EXPECT_EQ(reversed.front(), 5);
+    EXPECT_EQ(reversed.back(), 1);
+
+    const std2::vector<int>& view = vec;
+    EXPECT_EQ(*view.cbegin(), 1);
+    EXPECT_EQ(*(view.end() - 1), 5);
+    EXPECT_FALSE(view.empty());
+}